@@ -80,6 +80,24 @@ if (MSVC)
     set(CMAKE_SHARED_LINKER_FLAGS_RELWITHDEBINFO  "${CMAKE_EXE_LINKER_FLAGS_RELWITHDEBINFO}"  CACHE STRING "" FORCE)
     set(CMAKE_SHARED_LINKER_FLAGS_RELEASE         "${CMAKE_EXE_LINKER_FLAGS_RELEASE}"         CACHE STRING "" FORCE)
 
+else()
+    message(STATUS "Configuring for ${CMAKE_CXX_COMPILER_ID} compiler")
+
+    add_compile_options(
+        -Wall # Enables most compiler warnings
+        -Wextra # Enables extra compiler warnings
+        "$<$<CONFIG:Debug>:-O0>"
+        "$<$<CONFIG:Debug>:-g>"
+        "$<$<CONFIG:RelWithDebInfo>:-O2>"
+        "$<$<CONFIG:RelWithDebInfo>:-g>"
+        "$<$<CONFIG:RelWithDebInfo>:-DNDEBUG>"
+        "$<$<CONFIG:Release>:-O2>"
+        "$<$<CONFIG:Release>:-DNDEBUG>"
+    )
+
+    # asio and render threads
+    find_package(Threads REQUIRED)
+    link_libraries(Threads::Threads)
 endif()
 
 set(CMAKE_CXX_STANDARD 23)
@@ -23,10 +23,16 @@ function(silence_warnings)
 
         get_target_property(type ${real_target} TYPE)
 
+        if(MSVC)
+            set(no_warnings_option /W0)
+        else()
+            set(no_warnings_option -w)
+        endif()
+
         if("${type}" STREQUAL "INTERFACE_LIBRARY")
-            target_compile_options(${real_target} INTERFACE /W0)
+            target_compile_options(${real_target} INTERFACE ${no_warnings_option})
         else()
-            target_compile_options(${real_target} PRIVATE /W0)
+            target_compile_options(${real_target} PRIVATE ${no_warnings_option})
         endif()
     endforeach()
 endfunction()
@@ -34,57 +40,69 @@ endfunction()
 # ---------------------------------------------------------
 # GLEW
 # ---------------------------------------------------------
-message(STATUS "Fetching dependency `GLEW` ...")
-ExternalProject_Add(glew_build
-    URL https://github.com/nigels-com/glew/releases/download/glew-2.2.0/glew-2.2.0.tgz
-    URL_HASH SHA256=d4fc82893cfb00109578d0a1a2337fb8ca335b3ceccf97b97e5cc7f08e4353e1
-    PREFIX ${CMAKE_BINARY_DIR}/_deps/glew
-    SOURCE_DIR ${CMAKE_BINARY_DIR}/_deps/glew/src
-    STAMP_DIR ${CMAKE_BINARY_DIR}/_deps/glew/stamp
-    LOG_DIR ${CMAKE_BINARY_DIR}/_deps/glew/log
-    DOWNLOAD_DIR ${CMAKE_BINARY_DIR}/_deps/glew/download
-    CONFIGURE_COMMAND 
-        ${CMAKE_COMMAND} 
-            -S ${CMAKE_BINARY_DIR}/_deps/glew/src/build/cmake
-            -B ${CMAKE_BINARY_DIR}/_deps/glew/build
-            -DCMAKE_MSVC_RUNTIME_LIBRARY="MultiThreaded$<$<CONFIG:Debug>:Debug>"
-            -DCMAKE_POLICY_DEFAULT_CMP0091=NEW
-            -DCMAKE_C_FLAGS_RELEASE="/MT"
-            -DCMAKE_C_FLAGS_DEBUG="/MTd"
-            -DCMAKE_CXX_FLAGS_RELEASE="/MT"
-            -DCMAKE_CXX_FLAGS_DEBUG="/MTd"
-            -DCMAKE_C_FLAGS_MINSIZEREL="/MT"
-            -DCMAKE_C_FLAGS_RELWITHDEBINFO="/MT"
-            -DCMAKE_STATIC_LINKER_FLAGS="/IGNORE:4281"
-            -DCMAKE_SHARED_LINKER_FLAGS="/IGNORE:4281"
-            -DCMAKE_MODULE_LINKER_FLAGS="/IGNORE:4281"
-            -DCMAKE_EXE_LINKER_FLAGS="/IGNORE:4281"
-            -DCMAKE_INSTALL_PREFIX=${CMAKE_BINARY_DIR}/_deps/glew/install 
-            -DBUILD_UTILS=OFF 
-            -DGLEW_STATIC=ON 
-            -DBUILD_SHARED_LIBS=OFF
-            -DCMAKE_POLICY_VERSION_MINIMUM=3.5
+if(VELORA_OPENGL_EGL)
+    message(STATUS "Using system `GLEW` and `EGL` ...")
+    find_package(GLEW REQUIRED)
+    find_package(OpenGL REQUIRED COMPONENTS OpenGL EGL)
+
+    add_library(glew INTERFACE)
+    target_link_libraries(glew INTERFACE GLEW::GLEW OpenGL::OpenGL OpenGL::EGL)
+
+    # OpenGL modules depend on glew_build target
+    add_custom_target(glew_build)
+elseif(VELORA_OPENGL)
+    message(STATUS "Fetching dependency `GLEW` ...")
+    ExternalProject_Add(glew_build
+        URL https://github.com/nigels-com/glew/releases/download/glew-2.2.0/glew-2.2.0.tgz
+        URL_HASH SHA256=d4fc82893cfb00109578d0a1a2337fb8ca335b3ceccf97b97e5cc7f08e4353e1
+        PREFIX ${CMAKE_BINARY_DIR}/_deps/glew
+        SOURCE_DIR ${CMAKE_BINARY_DIR}/_deps/glew/src
+        STAMP_DIR ${CMAKE_BINARY_DIR}/_deps/glew/stamp
+        LOG_DIR ${CMAKE_BINARY_DIR}/_deps/glew/log
+        DOWNLOAD_DIR ${CMAKE_BINARY_DIR}/_deps/glew/download
+        CONFIGURE_COMMAND 
+            ${CMAKE_COMMAND} 
+                -S ${CMAKE_BINARY_DIR}/_deps/glew/src/build/cmake
+                -B ${CMAKE_BINARY_DIR}/_deps/glew/build
+                -DCMAKE_MSVC_RUNTIME_LIBRARY="MultiThreaded$<$<CONFIG:Debug>:Debug>"
+                -DCMAKE_POLICY_DEFAULT_CMP0091=NEW
+                -DCMAKE_C_FLAGS_RELEASE="/MT"
+                -DCMAKE_C_FLAGS_DEBUG="/MTd"
+                -DCMAKE_CXX_FLAGS_RELEASE="/MT"
+                -DCMAKE_CXX_FLAGS_DEBUG="/MTd"
+                -DCMAKE_C_FLAGS_MINSIZEREL="/MT"
+                -DCMAKE_C_FLAGS_RELWITHDEBINFO="/MT"
+                -DCMAKE_STATIC_LINKER_FLAGS="/IGNORE:4281"
+                -DCMAKE_SHARED_LINKER_FLAGS="/IGNORE:4281"
+                -DCMAKE_MODULE_LINKER_FLAGS="/IGNORE:4281"
+                -DCMAKE_EXE_LINKER_FLAGS="/IGNORE:4281"
+                -DCMAKE_INSTALL_PREFIX=${CMAKE_BINARY_DIR}/_deps/glew/install 
+                -DBUILD_UTILS=OFF 
+                -DGLEW_STATIC=ON 
+                -DBUILD_SHARED_LIBS=OFF
+                -DCMAKE_POLICY_VERSION_MINIMUM=3.5
     
-    BUILD_COMMAND 
-        ${CMAKE_COMMAND} --build ${CMAKE_BINARY_DIR}/_deps/glew/build --config Release
-    BUILD_ALWAYS TRUE
-    BINARY_DIR ${CMAKE_BINARY_DIR}/_deps/glew/build
+        BUILD_COMMAND 
+            ${CMAKE_COMMAND} --build ${CMAKE_BINARY_DIR}/_deps/glew/build --config Release
+        BUILD_ALWAYS TRUE
+        BINARY_DIR ${CMAKE_BINARY_DIR}/_deps/glew/build
     
-    INSTALL_COMMAND 
-        ${CMAKE_COMMAND} --install ${CMAKE_BINARY_DIR}/_deps/glew/build
+        INSTALL_COMMAND 
+            ${CMAKE_COMMAND} --install ${CMAKE_BINARY_DIR}/_deps/glew/build
     
-    UPDATE_DISCONNECTED TRUE
-    DOWNLOAD_EXTRACT_TIMESTAMP FALSE
-)
-add_library(glew INTERFACE)
-target_compile_options(glew INTERFACE /wd4459)
-target_include_directories(glew INTERFACE "${CMAKE_BINARY_DIR}/_deps/glew/install/include")
-target_link_directories(glew INTERFACE "${CMAKE_BINARY_DIR}/_deps/glew/install/lib")
-target_link_libraries(glew INTERFACE libglew32 glu32 opengl32)
-add_dependencies(glew glew_build)
+        UPDATE_DISCONNECTED TRUE
+        DOWNLOAD_EXTRACT_TIMESTAMP FALSE
+    )
+    add_library(glew INTERFACE)
+    target_compile_options(glew INTERFACE /wd4459)
+    target_include_directories(glew INTERFACE "${CMAKE_BINARY_DIR}/_deps/glew/install/include")
+    target_link_directories(glew INTERFACE "${CMAKE_BINARY_DIR}/_deps/glew/install/lib")
+    target_link_libraries(glew INTERFACE libglew32 glu32 opengl32)
+    add_dependencies(glew glew_build)
 
-install(DIRECTORY ${CMAKE_BINARY_DIR}/_deps/glew/install/include/ DESTINATION include)
-install(DIRECTORY ${CMAKE_BINARY_DIR}/_deps/glew/install/lib/     DESTINATION lib)
+    install(DIRECTORY ${CMAKE_BINARY_DIR}/_deps/glew/install/include/ DESTINATION include)
+    install(DIRECTORY ${CMAKE_BINARY_DIR}/_deps/glew/install/lib/     DESTINATION lib)
+endif()
 
 # ---------------------------------------------------------
 # spdlog
@@ -110,7 +128,9 @@ FetchContent_Declare(
 )
 FetchContent_MakeAvailable(asio)
 add_library(asio INTERFACE)
-target_compile_options(asio INTERFACE /wd4459)
+if(MSVC)
+    target_compile_options(asio INTERFACE /wd4459)
+endif()
 target_include_directories(asio INTERFACE "${asio_SOURCE_DIR}/asio/include")
 install(DIRECTORY ${asio_SOURCE_DIR}/asio/include/asio DESTINATION include)
 
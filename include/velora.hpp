@@ -16,12 +16,19 @@ using namespace std::chrono_literals;
 #include "game.hpp"
 #include "asset.hpp"
 
-#ifdef WIN32
+#include "process_headless.hpp"
+#include "window_headless.hpp"
+
+#if defined(WIN32) && !defined(VELORA_HEADLESS)
 #include "process_winapi.hpp"
 #include "window_winapi.hpp"
 #endif
 
+#ifdef VELORA_OPENGL
 #include "opengl.hpp"
+#endif
+#include "null_renderer.hpp"
+#include "software_renderer.hpp"
 
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
@@ -1,12 +1,17 @@
-#version 330 core
+#version 450
 
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aUV;
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
+
+layout(std140, binding = 0) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec4 cameraPosition;    // w unused
+    float time;
+} frame;
 
 out vec3 FragPos;
 out vec3 Normal;
@@ -18,5 +23,5 @@ void main()
     Normal = mat3(transpose(inverse(uModel))) * aNormal;
     TexCoord = aUV;
 
-    gl_Position = uProjection * uView * vec4(FragPos, 1.0);
+    gl_Position = frame.projection * frame.view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
@@ -1,7 +1,12 @@
 #version 450
 
 // Camera
-uniform vec3 viewPos;
+layout(std140, binding = 0) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec4 cameraPosition;    // w unused
+    float time;
+} frame;
 
 // G-buffer inputs
 layout(binding = 0) uniform sampler2D gPosition;
@@ -25,26 +30,50 @@ struct GPULight {
 layout(std430, binding = 2) buffer LightBuffer {
     GPULight lights[];
 };
-uniform int lightCount;
+
+// Light clusters, equal to LightClusterGrid of LightSystem
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+
+layout(std430, binding = 4) buffer LightClusterBuffer {
+    uvec2 clusters[CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z];  // x: offset, y: count into lightIndices
+    uint lightIndices[];
+};
 
 // Shadow Map
-#define MAX_SHADOW_CASTERS 16
+#define MAX_SHADOW_CASTERS 32
 
-layout(binding = 3) uniform sampler2DShadow shadowMaps[MAX_SHADOW_CASTERS];
-uniform mat4 lightSpaceMatrices[MAX_SHADOW_CASTERS];
-uniform int shadowCastersCount;
+layout(std140, binding = 1) uniform LightSetBlock {
+    mat4 lightSpaceMatrices[MAX_SHADOW_CASTERS];
+    vec4 shadowTiles[MAX_SHADOW_CASTERS];   // tile of shadow caster in shadow atlas, xy: uv offset, zw: uv scale
+    vec4 clusterDepthSlicing;               // x: near, y: far, slice of view depth d is floor(log(d) * z + w)
+    int lightCount;
+    int shadowCastersCount;
+    int globalLightsCount;                  // lights at the start of lightIndices, shaded by every pixel
+} lightSet;
+
+layout(binding = 3) uniform sampler2DShadow shadowAtlas;
 
 in vec2 TexCoord;
 out vec4 FragColor;
 
 float calculateShadow(vec3 fragPosWorld, int shadow_caster_id)
 {
-    vec4 fragPosLightSpace = lightSpaceMatrices[shadow_caster_id] * vec4(fragPosWorld, 1.0);
+    vec4 fragPosLightSpace = lightSet.lightSpaceMatrices[shadow_caster_id] * vec4(fragPosWorld, 1.0);
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
     projCoords = projCoords * 0.5 + 0.5;
     projCoords.z -= 0.005;
 
-    return texture(shadowMaps[shadow_caster_id], projCoords); // 0 = in shadow, 1 = lit
+    // outside of light frustum, neighbouring texels of atlas belong to other lights
+    if (any(lessThan(projCoords.xy, vec2(0.0))) || any(greaterThan(projCoords.xy, vec2(1.0)))) return 1.0;
+
+    // comparison stays half texel inside of tile, so filtering never reads neighbouring tile
+    vec4 tile = lightSet.shadowTiles[shadow_caster_id];
+    vec2 halfTexel = 0.5 / vec2(textureSize(shadowAtlas, 0));
+    projCoords.xy = clamp(tile.xy + projCoords.xy * tile.zw, tile.xy + halfTexel, tile.xy + tile.zw - halfTexel);
+
+    return texture(shadowAtlas, projCoords); // 0 = in shadow, 1 = lit
 }
 
 vec3 calculateLight(GPULight light, vec3 normal, vec3 fragPos, vec3 viewDir)
@@ -75,26 +104,50 @@ vec3 calculateLight(GPULight light, vec3 normal, vec3 fragPos, vec3 viewDir)
     return diffuse;
 }
 
+uvec2 findCluster(vec3 fragPosWorld)
+{
+    float depth = max(-(frame.view * vec4(fragPosWorld, 1.0)).z, lightSet.clusterDepthSlicing.x);
+    int slice = int(floor(log(depth) * lightSet.clusterDepthSlicing.z + lightSet.clusterDepthSlicing.w));
+    ivec3 cluster = clamp(
+        ivec3(ivec2(TexCoord * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y)), slice),
+        ivec3(0),
+        ivec3(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1, CLUSTER_GRID_Z - 1));
+    return clusters[cluster.x + CLUSTER_GRID_X * (cluster.y + CLUSTER_GRID_Y * cluster.z)];
+}
+
+vec3 shadeLight(int i, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    float shadow = 1.0;
+    if (lights[i].castShadows.x > 0 && int(lights[i].castShadows.y) < lightSet.shadowCastersCount)
+    {
+        int shadowIndex = int(lights[i].castShadows.y);
+        shadow = calculateShadow(fragPos, shadowIndex);
+        shadow = mix(0.2, 1.0, shadow); // 0.2 = minimum ambient in shadow
+    }
+
+    return calculateLight(lights[i], normal, fragPos, viewDir) * shadow;
+}
+
 void main()
 {
     vec3 FragPos = texture(gPosition, TexCoord).rgb;
     vec3 Normal  = normalize(texture(gNormal, TexCoord).rgb);
     vec4 Albedo  = texture(gAlbedoSpec, TexCoord);
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(frame.cameraPosition.xyz - FragPos);
 
     vec3 lighting = vec3(0.0);
-    for (int i = 0; i < lightCount; ++i)
+
+    // global lights reach every pixel
+    for (int i = 0; i < lightSet.globalLightsCount; ++i)
     {
-        float shadow = 1.0;
-        if (lights[i].castShadows.x > 0 && int(lights[i].castShadows.y) < shadowCastersCount)
-        {
-            int shadowIndex = int(lights[i].castShadows.y);
-            shadow = calculateShadow(FragPos, shadowIndex);
-            shadow = mix(0.2, 1.0, shadow); // 0.2 = minimum ambient in shadow
-        }
+        lighting += shadeLight(int(lightIndices[i]), Normal, FragPos, viewDir);
+    }
 
-        vec3 lightColor = calculateLight(lights[i], Normal, FragPos, viewDir);
-        lighting += lightColor * shadow;
+    // only lights whose bounds touch cluster of this pixel
+    uvec2 cluster = findCluster(FragPos);
+    for (uint i = 0; i < cluster.y; ++i)
+    {
+        lighting += shadeLight(int(lightIndices[cluster.x + i]), Normal, FragPos, viewDir);
     }
 
     FragColor = vec4(lighting * Albedo.rgb, Albedo.a);
@@ -5,8 +5,13 @@ layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aUV;
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
+
+layout(std140, binding = 0) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec4 cameraPosition;    // w unused
+    float time;
+} frame;
 
 out vec3 FragPos;
 out vec3 Normal;
@@ -19,5 +24,5 @@ void main()
     Normal = mat3(transpose(inverse(uModel))) * aNormal;
     TexCoord = aUV;
 
-    gl_Position = uProjection * uView * worldPos;
+    gl_Position = frame.projection * frame.view * worldPos;
 }
\ No newline at end of file
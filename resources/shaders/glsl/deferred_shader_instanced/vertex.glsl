@@ -0,0 +1,42 @@
+#version 450
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aUV;
+// first instance of draw + gl_InstanceID, per instance attribute of geometry arena
+layout(location = 3) in uint aInstance;
+
+struct Instance {
+    mat4 model;
+    vec4 color;
+};
+
+layout(std430, binding = 3) readonly buffer InstanceBuffer {
+    Instance instances[];
+};
+
+
+layout(std140, binding = 0) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec4 cameraPosition;    // w unused
+    float time;
+} frame;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+flat out vec4 InstanceColor;
+
+void main()
+{
+    Instance instance = instances[aInstance];
+
+    vec4 worldPos = instance.model * vec4(aPos, 1.0);
+    FragPos = worldPos.xyz;
+    Normal = mat3(transpose(inverse(instance.model))) * aNormal;
+    TexCoord = aUV;
+    InstanceColor = instance.color;
+
+    gl_Position = frame.projection * frame.view * worldPos;
+}
@@ -17,7 +17,17 @@ struct GPULight {
 layout(std430, binding = 2) buffer LightBuffer {
     GPULight lights[];
 };
-uniform int lightCount;
+
+#define MAX_SHADOW_CASTERS 32
+
+layout(std140, binding = 1) uniform LightSetBlock {
+    mat4 lightSpaceMatrices[MAX_SHADOW_CASTERS];
+    vec4 shadowTiles[MAX_SHADOW_CASTERS];   // tile of shadow caster in shadow atlas, xy: uv offset, zw: uv scale
+    vec4 clusterDepthSlicing;               // x: near, y: far, slice of view depth d is floor(log(d) * z + w)
+    int lightCount;
+    int shadowCastersCount;
+    int globalLightsCount;                  // lights at the start of lightIndices, shaded by every pixel
+} lightSet;
 
 in vec3 FragPos;
 in vec3 Normal;
@@ -63,7 +73,7 @@ void main()
     vec4 baseColor = useTexture ? texture(uTexture, TexCoord) : uColor;
     vec3 lighting = vec3(0.0);
 
-    for (int i = 0; i < lightCount; ++i) {
+    for (int i = 0; i < lightSet.lightCount; ++i) {
         lighting += calculateLight(lights[i], norm, FragPos, viewDir);
     }
 
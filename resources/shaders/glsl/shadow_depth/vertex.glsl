@@ -1,11 +1,23 @@
-#version 330 core
+#version 450
 
 layout(location = 0) in vec3 aPos;
 
 uniform mat4 uModel;
-uniform mat4 uLightSpaceMatrix;
+// shadow map being rendered, index into light space matrices
+uniform int uShadowCaster;
+
+#define MAX_SHADOW_CASTERS 32
+
+layout(std140, binding = 1) uniform LightSetBlock {
+    mat4 lightSpaceMatrices[MAX_SHADOW_CASTERS];
+    vec4 shadowTiles[MAX_SHADOW_CASTERS];   // tile of shadow caster in shadow atlas, xy: uv offset, zw: uv scale
+    vec4 clusterDepthSlicing;               // x: near, y: far, slice of view depth d is floor(log(d) * z + w)
+    int lightCount;
+    int shadowCastersCount;
+    int globalLightsCount;                  // lights at the start of lightIndices, shaded by every pixel
+} lightSet;
 
 void main()
 {
-    gl_Position = uLightSpaceMatrix * uModel * vec4(aPos, 1.0);
+    gl_Position = lightSet.lightSpaceMatrices[uShadowCaster] * uModel * vec4(aPos, 1.0);
 }
@@ -0,0 +1,6 @@
+#version 450
+
+void main()
+{
+    // no output; depth is automatically written
+}
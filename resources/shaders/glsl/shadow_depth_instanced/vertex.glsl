@@ -0,0 +1,33 @@
+#version 450
+
+layout(location = 0) in vec3 aPos;
+// first instance of draw + gl_InstanceID, per instance attribute of geometry arena
+layout(location = 3) in uint aInstance;
+
+struct Instance {
+    mat4 model;
+    vec4 color;
+};
+
+layout(std430, binding = 3) readonly buffer InstanceBuffer {
+    Instance instances[];
+};
+
+// shadow map being rendered, index into light space matrices
+uniform int uShadowCaster;
+
+#define MAX_SHADOW_CASTERS 32
+
+layout(std140, binding = 1) uniform LightSetBlock {
+    mat4 lightSpaceMatrices[MAX_SHADOW_CASTERS];
+    vec4 shadowTiles[MAX_SHADOW_CASTERS];   // tile of shadow caster in shadow atlas, xy: uv offset, zw: uv scale
+    vec4 clusterDepthSlicing;               // x: near, y: far, slice of view depth d is floor(log(d) * z + w)
+    int lightCount;
+    int shadowCastersCount;
+    int globalLightsCount;                  // lights at the start of lightIndices, shaded by every pixel
+} lightSet;
+
+void main()
+{
+    gl_Position = lightSet.lightSpaceMatrices[uShadowCaster] * instances[aInstance].model * vec4(aPos, 1.0);
+}
@@ -69,6 +69,13 @@ namespace velora
 
     asio::awaitable<bool> loadVertexBuffersPrefabs(IRenderer & renderer);
 
+    /**
+     * @brief Constructs vertex buffer of mesh and vertex buffers of its lower levels of detail, named by getMeshLODName.
+     * @param lods levels from finest to coarsest, generated from first level when it is the only one
+     * @return ID of full detail vertex buffer, std::nullopt when it cannot be constructed, missing lower levels are only reported
+     */
+    asio::awaitable<std::optional<std::size_t>> loadVertexBufferWithLODs(IRenderer & renderer, std::string name, std::vector<Mesh> lods);
+
     asio::awaitable<std::optional<std::size_t>> loadShaderFromFile(IRenderer & renderer, std::filesystem::path shader_path);
     asio::awaitable<bool> loadShadersFromDir(IRenderer & renderer, std::filesystem::path shader_path);
 
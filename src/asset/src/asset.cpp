@@ -2,6 +2,28 @@
 
 namespace velora
 {
+    asio::awaitable<std::optional<std::size_t>> loadVertexBufferWithLODs(IRenderer & renderer, std::string name, std::vector<Mesh> lods)
+    {
+        if(lods.empty())co_return std::nullopt;
+        if(lods.size() == 1)lods = generateLODChain(lods.front(), MAX_MESH_LODS);
+
+        const auto vertex_buffer = co_await renderer.constructVertexBuffer(name, lods.front());
+        if(vertex_buffer == std::nullopt)co_return std::nullopt;
+
+        for(uint32_t level = 1; level < std::min<std::size_t>(lods.size(), MAX_MESH_LODS); ++level)
+        {
+            const std::string lod_name = getMeshLODName(name, level);
+            if((co_await renderer.constructVertexBuffer(lod_name, lods[level])) == std::nullopt)
+            {
+                spdlog::warn("Failed to create {} vertex buffer, {} is drawn with finer levels only", lod_name, name);
+                break;
+            }
+        }
+
+        spdlog::debug("Loaded vertex buffer {} with {} levels of detail", name, lods.size());
+        co_return vertex_buffer;
+    }
+
     asio::awaitable<bool> loadVertexBuffersPrefabs(IRenderer & renderer)
     {
         bool success = true;
@@ -18,37 +40,37 @@ namespace velora
             success = false;
         }
 
-        if((co_await renderer.constructVertexBuffer("cube_prefab", getCubePrefab())) == std::nullopt)
+        if((co_await loadVertexBufferWithLODs(renderer, "cube_prefab", {getCubePrefab()})) == std::nullopt)
         {
             spdlog::error("Failed to create cube_prefab vertex buffer");
             success = false;
         }
 
-        if((co_await renderer.constructVertexBuffer("cone_prefab", getConePrefab())) == std::nullopt)
+        if((co_await loadVertexBufferWithLODs(renderer, "cone_prefab", {getConePrefab(32), getConePrefab(16), getConePrefab(8)})) == std::nullopt)
         {
             spdlog::error("Failed to create cone_prefab vertex buffer");
             success = false;
         }
 
-        if((co_await renderer.constructVertexBuffer("cylinder_prefab", getCylinderPrefab())) == std::nullopt)
+        if((co_await loadVertexBufferWithLODs(renderer, "cylinder_prefab", {getCylinderPrefab(32), getCylinderPrefab(16), getCylinderPrefab(8)})) == std::nullopt)
         {
             spdlog::error("Failed to create cylinder_prefab vertex buffer");
             success = false;
         }
 
-        if((co_await renderer.constructVertexBuffer("icosphere1_prefab", getIcoSpherePrefab(1))) == std::nullopt)
+        if((co_await loadVertexBufferWithLODs(renderer, "icosphere1_prefab", {getIcoSpherePrefab(1), getIcoSpherePrefab(0)})) == std::nullopt)
         {
             spdlog::error("Failed to create icosphere1_prefab vertex buffer");
             success = false;
         }
 
-        if((co_await renderer.constructVertexBuffer("icosphere2_prefab", getIcoSpherePrefab(2))) == std::nullopt)
+        if((co_await loadVertexBufferWithLODs(renderer, "icosphere2_prefab", {getIcoSpherePrefab(2), getIcoSpherePrefab(1), getIcoSpherePrefab(0)})) == std::nullopt)
         {
             spdlog::error("Failed to create icosphere2_prefab vertex buffer");
             success = false;
         }
         
-        if((co_await renderer.constructVertexBuffer("icosphere3_prefab", getIcoSpherePrefab(3))) == std::nullopt)
+        if((co_await loadVertexBufferWithLODs(renderer, "icosphere3_prefab", {getIcoSpherePrefab(3), getIcoSpherePrefab(2), getIcoSpherePrefab(1), getIcoSpherePrefab(0)})) == std::nullopt)
         {
             spdlog::error("Failed to create icosphere3_prefab vertex buffer");
             success = false;
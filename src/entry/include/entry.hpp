@@ -5,7 +5,9 @@
 #include "process.hpp"
 #include "version.hpp"
 
-#if defined(_WIN32) || defined(_WIN64)
+#include "process_headless.hpp"
+
+#if (defined(_WIN32) || defined(_WIN64)) && !defined(VELORA_HEADLESS)
 #include "process_winapi.hpp"
 #endif
 
@@ -16,6 +18,8 @@
 #include "native.hpp"
 #include <asio.hpp>
 
+#include "frame_pacer.hpp"
+#include "frame_time_recorder.hpp"
 #include "fixed_step_loop.hpp"
 
 namespace velora
@@ -23,6 +27,9 @@ namespace velora
     std::filesystem::path getBinPath();
     std::filesystem::path getResourcesPath();
 
+    // true when started with `--headless` argument or built with VELORA_HEADLESS
+    bool isHeadless();
+
     // Must be defined by executable.
     // Engine will call this function on startup
     extern asio::awaitable<int> main(asio::io_context & io_context, IProcess & process);
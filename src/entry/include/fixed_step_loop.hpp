@@ -1,41 +1,223 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 using namespace std::chrono_literals;
 
 #include "native.hpp"
 #include <asio.hpp>
+#include <asio/experimental/awaitable_operators.hpp>
+using namespace asio::experimental::awaitable_operators;
 #include <spdlog/spdlog.h>
 
+#include "frame_pacer.hpp"
+#include "frame_time_recorder.hpp"
+
 namespace velora
 {
     /**
      * @brief Fixed Step Loop
-     * 
+     *
+     * Runs any number of fixed rate updates (eg. physics 60 Hz, scripts 30 Hz, AI 10 Hz)
+     * and one priority update as often as possible, interpolated with alpha of primary rate.
+     * Primary rate is the one passed to constructor and has RateID 0.
+     * Priority may be empty, then only fixed rates run (eg. dedicated server without rendering).
      */
     struct FixedStepLoop
     {
         using clock = std::chrono::high_resolution_clock;
+        using RateID = std::size_t;
+
+        constexpr static const RateID PRIMARY_RATE = 0;
+        constexpr static const uint32_t DEFAULT_MAX_SUBSTEPS = 5;
+
+        /**
+         * @brief Sequential - logic and priority run one after another on the same strand.
+         * Decoupled - logic runs at fixed step on its own strand,
+         * priority runs at its own rate on separate strand in parallel with logic.
+         * Priority must then only read state published by logic (eg. render snapshot).
+         */
+        enum class Mode
+        {
+            Sequential,
+            Decoupled
+        };
+
+        /**
+         * @brief What to do with time that could not be simulated within max substeps of one frame.
+         * Clamp - drop whole steps left after max substeps, keep fraction of step for interpolation.
+         * CarryOver - keep leftover and catch up during next frames, bounded by _MAX_CARRY_OVER_FRAMES.
+         * Reset - when more than max substeps are due, drop whole backlog and run single step.
+         */
+        enum class CatchUpPolicy : uint8_t
+        {
+            Clamp,
+            CarryOver,
+            Reset
+        };
+
+        /**
+         * @brief Frame pacing, parks loop until next deadline instead of running frames back-to-back.
+         * Deadline is next due step of any rate or target frame interval, whichever comes first.
+         * Zero target frame interval means priority is not limited on its own,
+         * so sequential loop runs one frame per due step and decoupled priority is paced only by renderer (eg. vsync).
+         * Decoupled logic is always paced.
+         */
+        struct PacingConfig
+        {
+            bool enabled = false;
+            std::chrono::duration<double> target_frame_interval = std::chrono::duration<double>::zero();
+            std::chrono::duration<double> spin_threshold = 300us;
+        };
 
-        FixedStepLoop(asio::io_context & io_context, 
+        struct RateConfig
+        {
+            std::string name;
+            std::chrono::duration<double> step;
+            uint32_t max_substeps = DEFAULT_MAX_SUBSTEPS;
+            CatchUpPolicy policy = CatchUpPolicy::Clamp;
+            std::function<asio::awaitable<void>(std::chrono::duration<double>)> update;
+        };
+
+        struct FastForwardReport
+        {
+            uint64_t ticks = 0;
+            std::chrono::duration<double> simulated_time = std::chrono::duration<double>::zero();
+            std::chrono::duration<double> wall_time = std::chrono::duration<double>::zero();
+            double ticks_per_second = 0.0;
+        };
+
+        FixedStepLoop(asio::io_context & io_context,
                 const std::chrono::duration<double> fixed_logic_step,
                 std::function<bool()> condition,
                 std::function<asio::awaitable<void>(std::chrono::duration<double>)> logic,
-                std::function<asio::awaitable<void>(float)> priority);
+                std::function<asio::awaitable<void>(float)> priority,
+                Mode mode = Mode::Sequential);
 
         asio::awaitable<void> run();
 
+        /**
+         * @brief Headless fast forward, steps logic as fast as CPU allows.
+         * Uses synthetic clock advanced by exactly one primary step per tick, so every rate
+         * receives deterministic delta regardless of wall clock. Priority is never executed.
+         * Stops after max_ticks primary ticks, when stop predicate returns true or when loop condition fails.
+         * @param max_ticks maximum number of primary rate ticks
+         * @param stop optional predicate checked before every tick
+         * @return number of ticks executed, simulated and wall time and achieved ticks per second
+         */
+        asio::awaitable<FastForwardReport> fastForward(uint64_t max_ticks, std::function<bool()> stop = nullptr);
+
+        /**
+         * @brief Registers additional fixed rate update. Must be called before run.
+         * Rates are updated in registration order, primary rate first.
+         */
+        RateID addRate(RateConfig config);
+
+        // runtime adjustable rate parameters, safe to call from any thread
+        void setRateStep(RateID rate, std::chrono::duration<double> step);
+        void setRateMaxSubsteps(RateID rate, uint32_t max_substeps);
+        void setRateCatchUpPolicy(RateID rate, CatchUpPolicy policy);
+
+        std::chrono::duration<double> getRateStep(RateID rate) const;
+        const std::string & getRateName(RateID rate) const;
+        std::size_t getRatesCount() const;
+
+        // number of executed fixed steps of rate
+        uint64_t getTick(RateID rate) const;
+
+        // number of fixed steps dropped by catch up policy
+        uint64_t getDroppedTicks(RateID rate) const;
+
+        // interpolation factor between last two steps of rate for current time, in [0, 1]
+        float getAlpha(RateID rate) const;
+
+        /**
+         * @brief Interpolation factor for current time of state produced by step ending at tick time, in [0, 1].
+         * In decoupled mode alpha passed to priority belongs to latest step of primary rate,
+         * priority reading state published by logic should use this with tick time stored in that state.
+         */
+        static float getAlpha(clock::time_point tick_time, std::chrono::duration<double> step);
+
+        /**
+         * @brief Time point that state of step being executed by rate corresponds to.
+         * Valid only inside of update of rate, lets logic stamp state it publishes.
+         */
+        clock::time_point getStepTime(RateID rate) const;
+
+        // frame interval as seen by priority (start to start)
+        const FrameTimeRecorder & getFrameRecorder() const;
+        // time spent in logic per frame, all due steps of all rates together
+        const FrameTimeRecorder & getLogicRecorder() const;
+        // time spent in priority per frame
+        const FrameTimeRecorder & getPriorityRecorder() const;
+        // time spent in single step of rate
+        const FrameTimeRecorder & getRateRecorder(RateID rate) const;
+
+        // must be called before run
+        void setPacing(PacingConfig pacing);
+
+        // how late logic and priority woke up after parking, safe to call from any thread
+        FramePacer::Jitter getLogicWakeUpJitter() const;
+        FramePacer::Jitter getPriorityWakeUpJitter() const;
+
         private:
+            struct Rate
+            {
+                std::string name;
+                std::function<asio::awaitable<void>(std::chrono::duration<double>)> update;
+
+                std::atomic<double> step_seconds;
+                std::atomic<uint32_t> max_substeps;
+                std::atomic<CatchUpPolicy> policy;
+
+                std::atomic<uint64_t> ticks = 0;
+                std::atomic<uint64_t> dropped_ticks = 0;
+
+                // time point that corresponds to state of last executed step, in clock ticks
+                std::atomic<clock::rep> tick_time = 0;
+
+                std::unique_ptr<FrameTimeRecorder> recorder;
+
+                // accessed only from logic strand
+                std::chrono::duration<double> lag = std::chrono::duration<double>::zero();
+                clock::time_point step_time = clock::now();
+            };
+
+            asio::awaitable<void> runSequential();
+            asio::awaitable<void> runLogic();
+            asio::awaitable<void> runPriority();
+
+            // accumulates frame delta into rate and executes due steps according to its policy
+            asio::awaitable<void> updateRate(Rate & rate, std::chrono::duration<double> frame_delta, clock::time_point now);
+
+            // time left until next step of any rate is due
+            std::chrono::duration<double> getTimeToNextStep() const;
+
+            float getAlpha(const Rate & rate, clock::time_point now) const;
+            static float getAlpha(clock::time_point tick_time, std::chrono::duration<double> step, clock::time_point now);
+
+            const Mode _mode;
+
             asio::strand<asio::any_io_executor> _strand;
+            asio::strand<asio::any_io_executor> _priority_strand;
 
-            const std::chrono::duration<double> _fixed_logic_step;
+            PacingConfig _pacing;
+            FramePacer _logic_pacer;
+            FramePacer _priority_pacer;
 
             const std::function<bool()> _condition;
-            const std::function<asio::awaitable<void>(std::chrono::duration<double>)> _logic;
             const std::function<asio::awaitable<void>(float)> _priority;
 
-            constexpr static const std::chrono::duration<double> _MAX_ACCUMULATED_TIME = std::chrono::milliseconds(25); // avoid spiral of death
-            uint64_t _simulation_tick = 0;
+            // unique_ptr keeps atomics at stable address, vector is not modified after run starts
+            std::vector<std::unique_ptr<Rate>> _rates;
+
+            constexpr static const uint32_t _MAX_CARRY_OVER_FRAMES = 4;
 
             struct TimeSpent
             {
@@ -47,9 +229,12 @@ namespace velora
             TimeSpent _total_time;
             TimeSpent _logic_time;
             TimeSpent _priority_time;
+            TimeSpent _tick_time;
 
-            std::chrono::duration<double> _lag = std::chrono::duration<double>::zero();
+            FrameTimeRecorder _frame_recorder;
+            FrameTimeRecorder _logic_recorder;
+            FrameTimeRecorder _priority_recorder;
 
             float _alpha = 0.0f;
     };
-}
\ No newline at end of file
+}
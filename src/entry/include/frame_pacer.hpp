@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+using namespace std::chrono_literals;
+
+#include "native.hpp"
+#include <asio.hpp>
+
+namespace velora
+{
+    /**
+     * @brief Parks coroutine until deadline instead of spinning.
+     * Sleeps on steady timer for most of the wait and spins only for final spin threshold,
+     * because timer wake ups on most platforms are late by up to few hundred microseconds.
+     * Measures how late coroutine woke up compared to requested deadline.
+     */
+    class FramePacer
+    {
+        public:
+            using clock = std::chrono::high_resolution_clock;
+
+            struct Jitter
+            {
+                uint64_t samples = 0;
+                std::chrono::duration<double> mean = std::chrono::duration<double>::zero();
+                std::chrono::duration<double> max = std::chrono::duration<double>::zero();
+            };
+
+            FramePacer(asio::any_io_executor executor, std::chrono::duration<double> spin_threshold = 300us);
+            FramePacer(const FramePacer&) = delete;
+            FramePacer(FramePacer&&) = delete;
+            FramePacer& operator=(const FramePacer&) = delete;
+            FramePacer& operator=(FramePacer&&) = delete;
+            ~FramePacer() = default;
+
+            /**
+             * @brief Waits until deadline. Returns immediately if deadline already passed.
+             */
+            asio::awaitable<void> waitUntil(clock::time_point deadline);
+
+            void setSpinThreshold(std::chrono::duration<double> spin_threshold);
+
+            // wake up lateness statistics, safe to call from any thread
+            Jitter getJitter() const;
+            void resetJitter();
+
+        private:
+            asio::steady_timer _timer;
+
+            std::atomic<int64_t> _spin_threshold_ns;
+
+            std::atomic<uint64_t> _jitter_samples = 0;
+            std::atomic<int64_t> _jitter_sum_ns = 0;
+            std::atomic<int64_t> _jitter_max_ns = 0;
+    };
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <vector>
+using namespace std::chrono_literals;
+
+namespace velora
+{
+    /**
+     * @brief Frame / tick timing recorder.
+     *
+     * Keeps last samples in lock-free ring buffer and all samples since reset
+     * in HDR-style log-linear histogram (exact below 128ns, then ~1.6% relative precision),
+     * so percentiles stay cheap and accurate no matter how long recording runs.
+     * Recording and reading are lock-free and may happen from different threads.
+     */
+    class FrameTimeRecorder
+    {
+        public:
+            constexpr static const std::size_t DEFAULT_CAPACITY = 4096;
+
+            struct Hitches
+            {
+                std::chrono::duration<double> threshold;
+                uint64_t count = 0;
+            };
+
+            struct Summary
+            {
+                std::string name;
+                uint64_t samples = 0;
+
+                std::chrono::duration<double> mean = std::chrono::duration<double>::zero();
+                std::chrono::duration<double> p50 = std::chrono::duration<double>::zero();
+                std::chrono::duration<double> p90 = std::chrono::duration<double>::zero();
+                std::chrono::duration<double> p99 = std::chrono::duration<double>::zero();
+                std::chrono::duration<double> max = std::chrono::duration<double>::zero();
+
+                std::vector<Hitches> hitches;
+            };
+
+            /**
+             * @brief Construct a new Frame Time Recorder object
+             * @param name name used in summaries and dumps
+             * @param hitch_thresholds samples longer than threshold are counted as hitch of that threshold
+             * @param capacity number of last samples kept in ring buffer
+             */
+            FrameTimeRecorder(std::string name,
+                std::vector<std::chrono::duration<double>> hitch_thresholds = {16.667ms, 33.333ms, 100ms},
+                std::size_t capacity = DEFAULT_CAPACITY);
+            FrameTimeRecorder(const FrameTimeRecorder&) = delete;
+            FrameTimeRecorder(FrameTimeRecorder&&) = delete;
+            FrameTimeRecorder& operator=(const FrameTimeRecorder&) = delete;
+            FrameTimeRecorder& operator=(FrameTimeRecorder&&) = delete;
+            ~FrameTimeRecorder() = default;
+
+            void record(std::chrono::duration<double> sample);
+
+            const std::string & getName() const;
+
+            /**
+             * @brief Percentile from histogram, returns upper bound of bucket containing it
+             * @param percentile in range [0, 100]
+             */
+            std::chrono::duration<double> getPercentile(double percentile) const;
+
+            Summary getSummary() const;
+
+            // ring buffer samples, oldest first
+            std::string dumpCSV() const;
+
+            // summary and ring buffer samples
+            std::string dumpJSON() const;
+
+            /**
+             * @brief Writes dump into file, format is chosen by extension (.csv or .json)
+             */
+            bool dump(const std::filesystem::path & path) const;
+
+            void reset();
+
+        private:
+            constexpr static const uint32_t _SUB_BUCKET_BITS = 7;
+            constexpr static const uint64_t _SUB_BUCKET_COUNT = 1ull << _SUB_BUCKET_BITS;
+            constexpr static const uint64_t _SUB_BUCKET_HALF = _SUB_BUCKET_COUNT / 2;
+            constexpr static const std::size_t _BUCKET_COUNT = _SUB_BUCKET_COUNT + (64 - _SUB_BUCKET_BITS) * _SUB_BUCKET_HALF;
+
+            static std::size_t getBucketIndex(uint64_t value_ns);
+            static uint64_t getBucketUpperBound(std::size_t index);
+
+            std::vector<int64_t> getLastSamples() const;
+
+            const std::string _name;
+            const std::vector<std::chrono::duration<double>> _hitch_thresholds;
+
+            std::vector<std::atomic<int64_t>> _samples;
+            std::atomic<uint64_t> _write_index = 0;
+
+            std::vector<std::atomic<uint64_t>> _histogram;
+            std::atomic<uint64_t> _count = 0;
+            std::atomic<uint64_t> _sum_ns = 0;
+            std::atomic<uint64_t> _max_ns = 0;
+
+            std::vector<std::atomic<uint64_t>> _hitch_counts;
+    };
+}
+
+template <>
+struct std::formatter<velora::FrameTimeRecorder::Summary> : std::formatter<std::string> {
+  auto format(const velora::FrameTimeRecorder::Summary & summary, format_context& ctx) const {
+    std::string hitches;
+    for(const auto & hitch : summary.hitches)
+    {
+        hitches += std::format(" >{:.1f}ms:{}", hitch.threshold.count() * 1000.0, hitch.count);
+    }
+    return formatter<string>::format(
+      std::format("{} n={} mean={:.3f}ms p50={:.3f}ms p90={:.3f}ms p99={:.3f}ms max={:.3f}ms hitches:{}",
+        summary.name, summary.samples,
+        summary.mean.count() * 1000.0, summary.p50.count() * 1000.0, summary.p90.count() * 1000.0,
+        summary.p99.count() * 1000.0, summary.max.count() * 1000.0, hitches), ctx);
+  }
+};
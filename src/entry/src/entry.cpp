@@ -6,6 +6,11 @@ namespace velora
 {
     static std::filesystem::path BIN_PATH = "";
     static std::filesystem::path RESOURCES_PATH = "";
+    #ifdef VELORA_HEADLESS
+    static bool HEADLESS = true;
+    #else
+    static bool HEADLESS = false;
+    #endif
 
     std::filesystem::path getBinPath()
     {
@@ -16,6 +21,11 @@ namespace velora
     {
         return RESOURCES_PATH;
     }
+
+    bool isHeadless()
+    {
+        return HEADLESS;
+    }
 }
 
 const std::string & getAsciiLogo()
@@ -53,6 +63,8 @@ int main(int argc, char* argv[])
     for(int i = 0; i < argc; ++i)
     {
         spdlog::info("Argument at [{}] = {}", i, argv[i]);
+
+        if(std::string_view(argv[i]) == "--headless") HEADLESS = true;
     }
 
     BIN_PATH = std::filesystem::path(argv[0]).parent_path();
@@ -65,7 +77,15 @@ int main(int argc, char* argv[])
     asio::io_context io_context(used_cores);
 
     // Create a process
-    Process process = Process::construct<winapi::WinapiProcess>();
+    #ifdef VELORA_HEADLESS
+    Process process = Process::construct<headless::HeadlessProcess>(io_context);
+    #else
+    Process process = isHeadless() ?
+        Process::construct<headless::HeadlessProcess>(io_context) :
+        Process::construct<winapi::WinapiProcess>();
+    #endif
+
+    spdlog::info("Headless: {}", isHeadless());
 
     // start external entry point
     std::promise<int> external_main_promise;
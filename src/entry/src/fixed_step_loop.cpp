@@ -5,13 +5,152 @@ namespace velora
     FixedStepLoop::FixedStepLoop(asio::io_context & io_context, const std::chrono::duration<double> fixed_logic_step,
                 std::function<bool()> condition,
                 std::function<asio::awaitable<void>(std::chrono::duration<double>)> logic,
-                std::function<asio::awaitable<void>(float)> priority) 
-        :   _strand(asio::make_strand(io_context)),
-            _fixed_logic_step(std::move(fixed_logic_step)),
+                std::function<asio::awaitable<void>(float)> priority,
+                Mode mode)
+        :   _mode(mode),
+            _strand(asio::make_strand(io_context)),
+            _priority_strand(asio::make_strand(io_context)),
+            _logic_pacer(_strand),
+            _priority_pacer(_priority_strand),
             _condition(std::move(condition)),
-            _logic(std::move(logic)),
-            _priority(std::move(priority)) 
-    {}
+            _priority(std::move(priority)),
+            _frame_recorder("frame"),
+            _logic_recorder("logic"),
+            _priority_recorder("priority")
+    {
+        addRate(RateConfig{
+            .name = "logic",
+            .step = fixed_logic_step,
+            .update = std::move(logic)
+        });
+    }
+
+    FixedStepLoop::RateID FixedStepLoop::addRate(RateConfig config)
+    {
+        assert(config.step > std::chrono::duration<double>::zero() && "Rate step must be positive");
+        assert(config.update && "Rate must have update function");
+
+        auto rate = std::make_unique<Rate>();
+        rate->name = std::move(config.name);
+        rate->update = std::move(config.update);
+        rate->step_seconds.store(config.step.count());
+        rate->max_substeps.store(std::max<uint32_t>(config.max_substeps, 1));
+        rate->policy.store(config.policy);
+        rate->tick_time.store(clock::now().time_since_epoch().count());
+        rate->recorder = std::make_unique<FrameTimeRecorder>("tick:" + rate->name);
+
+        _rates.emplace_back(std::move(rate));
+        return _rates.size() - 1;
+    }
+
+    void FixedStepLoop::setRateStep(RateID rate, std::chrono::duration<double> step)
+    {
+        assert(step > std::chrono::duration<double>::zero() && "Rate step must be positive");
+        _rates.at(rate)->step_seconds.store(step.count(), std::memory_order_relaxed);
+    }
+
+    void FixedStepLoop::setRateMaxSubsteps(RateID rate, uint32_t max_substeps)
+    {
+        _rates.at(rate)->max_substeps.store(std::max<uint32_t>(max_substeps, 1), std::memory_order_relaxed);
+    }
+
+    void FixedStepLoop::setRateCatchUpPolicy(RateID rate, CatchUpPolicy policy)
+    {
+        _rates.at(rate)->policy.store(policy, std::memory_order_relaxed);
+    }
+
+    std::chrono::duration<double> FixedStepLoop::getRateStep(RateID rate) const
+    {
+        return std::chrono::duration<double>(_rates.at(rate)->step_seconds.load(std::memory_order_relaxed));
+    }
+
+    const std::string & FixedStepLoop::getRateName(RateID rate) const
+    {
+        return _rates.at(rate)->name;
+    }
+
+    std::size_t FixedStepLoop::getRatesCount() const
+    {
+        return _rates.size();
+    }
+
+    uint64_t FixedStepLoop::getTick(RateID rate) const
+    {
+        return _rates.at(rate)->ticks.load(std::memory_order_relaxed);
+    }
+
+    uint64_t FixedStepLoop::getDroppedTicks(RateID rate) const
+    {
+        return _rates.at(rate)->dropped_ticks.load(std::memory_order_relaxed);
+    }
+
+    void FixedStepLoop::setPacing(PacingConfig pacing)
+    {
+        _pacing = std::move(pacing);
+        _logic_pacer.setSpinThreshold(_pacing.spin_threshold);
+        _priority_pacer.setSpinThreshold(_pacing.spin_threshold);
+    }
+
+    FramePacer::Jitter FixedStepLoop::getLogicWakeUpJitter() const
+    {
+        return _logic_pacer.getJitter();
+    }
+
+    FramePacer::Jitter FixedStepLoop::getPriorityWakeUpJitter() const
+    {
+        return _priority_pacer.getJitter();
+    }
+
+    const FrameTimeRecorder & FixedStepLoop::getFrameRecorder() const
+    {
+        return _frame_recorder;
+    }
+
+    const FrameTimeRecorder & FixedStepLoop::getLogicRecorder() const
+    {
+        return _logic_recorder;
+    }
+
+    const FrameTimeRecorder & FixedStepLoop::getPriorityRecorder() const
+    {
+        return _priority_recorder;
+    }
+
+    const FrameTimeRecorder & FixedStepLoop::getRateRecorder(RateID rate) const
+    {
+        return *_rates.at(rate)->recorder;
+    }
+
+    float FixedStepLoop::getAlpha(RateID rate) const
+    {
+        return getAlpha(*_rates.at(rate), clock::now());
+    }
+
+    float FixedStepLoop::getAlpha(clock::time_point tick_time, std::chrono::duration<double> step)
+    {
+        return getAlpha(tick_time, step, clock::now());
+    }
+
+    FixedStepLoop::clock::time_point FixedStepLoop::getStepTime(RateID rate) const
+    {
+        return _rates.at(rate)->step_time;
+    }
+
+    float FixedStepLoop::getAlpha(const Rate & rate, clock::time_point now) const
+    {
+        const clock::time_point tick_time = clock::time_point(clock::duration(rate.tick_time.load(std::memory_order_acquire)));
+        const std::chrono::duration<double> step(rate.step_seconds.load(std::memory_order_relaxed));
+
+        return getAlpha(tick_time, step, now);
+    }
+
+    float FixedStepLoop::getAlpha(clock::time_point tick_time, std::chrono::duration<double> step, clock::time_point now)
+    {
+        float alpha = (float)((now - tick_time) / step);
+        alpha = std::clamp(alpha, 0.0f, 1.0f);
+        if (std::isnan(alpha)) alpha = 0.0f;
+        return alpha;
+    }
 
     asio::awaitable<void> FixedStepLoop::run()
     {
@@ -21,55 +160,299 @@ namespace velora
             co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
         }
 
-        spdlog::debug(std::format("[t:{}] Fixed step loop started", std::this_thread::get_id())); 
+        spdlog::debug(std::format("[t:{}] Fixed step loop started", std::this_thread::get_id()));
 
         _alpha = 0.0f;
 
-        while (_condition()) 
+        for(auto & rate : _rates)
+        {
+            rate->lag = std::chrono::duration<double>::zero();
+            rate->tick_time.store(clock::now().time_since_epoch().count(), std::memory_order_release);
+        }
+
+        // first frame delta starts now, not at construction or end of previous run
+        _total_time.start = clock::now();
+
+        if(!_priority)
+        {
+            // nothing to render, only fixed rates run, parked until next due step
+            co_await runLogic();
+        }
+        else if(_mode == Mode::Decoupled)
+        {
+            // logic and priority run in parallel, each bound to its own strand
+            co_await (
+                asio::co_spawn(_strand, runLogic(), asio::use_awaitable) &&
+                asio::co_spawn(_priority_strand, runPriority(), asio::use_awaitable)
+            );
+        }
+        else
+        {
+            co_await runSequential();
+        }
+
+        // make sure to end executing loop from strand associated to provided io_context
+        if(_strand.running_in_this_thread() == false)
+        {
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        spdlog::debug(std::format("[t:{}] Fixed step loop ended", std::this_thread::get_id()));
+
+        co_return;
+    }
+
+    asio::awaitable<FixedStepLoop::FastForwardReport> FixedStepLoop::fastForward(uint64_t max_ticks, std::function<bool()> stop)
+    {
+        if(_strand.running_in_this_thread() == false)
+        {
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        spdlog::debug(std::format("[t:{}] Fixed step loop fast forward started", std::this_thread::get_id()));
+
+        FastForwardReport report;
+
+        // steps are read once so delta stays deterministic for the whole run
+        std::vector<std::chrono::duration<double>> steps;
+        steps.reserve(_rates.size());
+        for(auto & rate : _rates)
+        {
+            rate->lag = std::chrono::duration<double>::zero();
+            steps.emplace_back(rate->step_seconds.load(std::memory_order_relaxed));
+        }
+        const std::chrono::duration<double> primary_step = steps.at(PRIMARY_RATE);
+
+        const clock::time_point start = clock::now();
+
+        while(report.ticks < max_ticks && _condition() && !(stop && stop()))
+        {
+            // synthetic clock advances by exactly one primary step
+            // slower and faster rates run as many whole steps as became due
+            for(std::size_t i = 0; i < _rates.size(); ++i)
+            {
+                Rate & rate = *_rates[i];
+                rate.lag += primary_step;
+                while(rate.lag >= steps[i])
+                {
+                    _tick_time.start = clock::now();
+                    // synthetic clock, state is stamped with wall clock so interpolation continues from it after fast forward
+                    rate.step_time = _tick_time.start;
+                    co_await rate.update(steps[i]);
+                    _tick_time.end = clock::now();
+                    _tick_time.duration = _tick_time.end - _tick_time.start;
+                    rate.recorder->record(_tick_time.duration);
+
+                    rate.ticks.fetch_add(1, std::memory_order_relaxed);
+                    rate.lag -= steps[i];
+                }
+            }
+            report.ticks++;
+        }
+
+        report.wall_time = clock::now() - start;
+        report.simulated_time = primary_step * (double)report.ticks;
+        if(report.wall_time > std::chrono::duration<double>::zero())
+        {
+            report.ticks_per_second = (double)report.ticks / report.wall_time.count();
+        }
+
+        // interpolation restarts from current wall clock
+        for(auto & rate : _rates)
+        {
+            rate->lag = std::chrono::duration<double>::zero();
+            rate->tick_time.store(clock::now().time_since_epoch().count(), std::memory_order_release);
+        }
+        // wall time of fast forward is not replayed by next frame
+        _total_time.start = clock::now();
+
+        spdlog::info(std::format("[t:{}] Fast forward: {} ticks, simulated {:.3f}s in {:.3f}s ({:.1f} ticks/s, {:.1f}x real time)", 
+            std::this_thread::get_id(), report.ticks, report.simulated_time.count(), report.wall_time.count(), report.ticks_per_second,
+            report.wall_time.count() > 0.0 ? report.simulated_time.count() / report.wall_time.count() : 0.0));
+
+        co_return report;
+    }
+
+    asio::awaitable<void> FixedStepLoop::updateRate(Rate & rate, std::chrono::duration<double> frame_delta, clock::time_point now)
+    {
+        // read runtime adjustable parameters once per frame
+        const std::chrono::duration<double> step(rate.step_seconds.load(std::memory_order_relaxed));
+        const uint32_t max_substeps = rate.max_substeps.load(std::memory_order_relaxed);
+        const CatchUpPolicy policy = rate.policy.load(std::memory_order_relaxed);
+
+        rate.lag += frame_delta;
+
+        uint64_t dropped = 0;
+        if(policy == CatchUpPolicy::Reset && rate.lag > step * max_substeps)
+        {
+            // too far behind, drop backlog but keep phase and execute single step
+            dropped = (uint64_t)(rate.lag / step) - 1;
+            rate.lag = step + std::chrono::duration<double>(std::fmod(rate.lag.count(), step.count()));
+        }
+
+        // apply fixed time steps
+        uint32_t substeps = 0;
+        while (rate.lag >= step && substeps < max_substeps)
+        {
+            // state after this step corresponds to time point lag left after it before now
+            rate.step_time = now - std::chrono::duration_cast<clock::duration>(rate.lag - step);
+
+            // fixed time update
+            _tick_time.start = clock::now();
+            co_await rate.update(step);
+            _tick_time.end = clock::now();
+            _tick_time.duration = _tick_time.end - _tick_time.start;
+            rate.recorder->record(_tick_time.duration);
+
+            rate.ticks.fetch_add(1, std::memory_order_relaxed);
+            rate.lag -= step;
+            substeps++;
+        }
+
+        // avoid spiral of death
+        if(rate.lag >= step)
+        {
+            if(policy == CatchUpPolicy::CarryOver)
+            {
+                // catch up during next frames, but never more than few frames worth of steps
+                const std::chrono::duration<double> max_lag = step * max_substeps * _MAX_CARRY_OVER_FRAMES;
+                if(rate.lag > max_lag)
+                {
+                    dropped += (uint64_t)((rate.lag - max_lag) / step);
+                    rate.lag = max_lag;
+                }
+            }
+            else
+            {
+                // drop whole steps, keep fraction of step for interpolation
+                dropped += (uint64_t)(rate.lag / step);
+                rate.lag = std::chrono::duration<double>(std::fmod(rate.lag.count(), step.count()));
+            }
+        }
+
+        if(dropped > 0)
+        {
+            rate.dropped_ticks.fetch_add(dropped, std::memory_order_relaxed);
+        }
+
+        // state of last step corresponds to time point lag before now
+        const clock::time_point tick_time = now - std::chrono::duration_cast<clock::duration>(std::min(rate.lag, step));
+        rate.tick_time.store(tick_time.time_since_epoch().count(), std::memory_order_release);
+
+        co_return;
+    }
+
+    std::chrono::duration<double> FixedStepLoop::getTimeToNextStep() const
+    {
+        std::chrono::duration<double> time_to_next_step = std::chrono::duration<double>::max();
+        for(const auto & rate : _rates)
+        {
+            const std::chrono::duration<double> step(rate->step_seconds.load(std::memory_order_relaxed));
+            time_to_next_step = std::min(time_to_next_step, step - rate->lag);
+        }
+        return std::max(time_to_next_step, std::chrono::duration<double>::zero());
+    }
+
+    asio::awaitable<void> FixedStepLoop::runSequential()
+    {
+        while (_condition())
         {
             _total_time.end = _total_time.start;
             _total_time.start = clock::now();
 
             _total_time.duration = _total_time.start - _total_time.end;
+            _frame_recorder.record(_total_time.duration);
 
-            // clamp to avoid spiral of death
-            _lag += std::min(_total_time.duration, _MAX_ACCUMULATED_TIME);
-                
-            _logic_time.duration = _logic_time.end - _logic_time.start;
             _logic_time.start = clock::now();
 
-            // apply fixed time steps
-            while (_lag >= _fixed_logic_step) 
+            for(auto & rate : _rates)
             {
-                // fixed time update
-                co_await _logic(_fixed_logic_step);
-
-                _simulation_tick++;
-                _lag -= _fixed_logic_step;
+                co_await updateRate(*rate, _total_time.duration, _total_time.start);
             }
 
             _logic_time.end = clock::now();
+            _logic_time.duration = _logic_time.end - _logic_time.start;
+            _logic_recorder.record(_logic_time.duration);
 
-            _priority_time.duration = _priority_time.end - _priority_time.start;
             _priority_time.start = clock::now();
-                
-            _alpha = (float)(_lag / _fixed_logic_step);
-            _alpha  = std::clamp(_alpha, 0.0f, 1.0f);
-            if (std::isnan(_alpha)) _alpha = 0.0f;
+
+            _alpha = getAlpha(*_rates.at(PRIMARY_RATE), _total_time.start);
 
             co_await _priority(_alpha);
 
             _priority_time.end = clock::now();
+            _priority_time.duration = _priority_time.end - _priority_time.start;
+            _priority_recorder.record(_priority_time.duration);
+
+            if(_pacing.enabled)
+            {
+                // lags were updated at frame start, so deadlines are relative to it
+                clock::time_point deadline = _total_time.start + std::chrono::duration_cast<clock::duration>(getTimeToNextStep());
+                if(_pacing.target_frame_interval > std::chrono::duration<double>::zero())
+                {
+                    deadline = std::min(deadline, _total_time.start + std::chrono::duration_cast<clock::duration>(_pacing.target_frame_interval));
+                }
+                co_await _logic_pacer.waitUntil(deadline);
+            }
         }
 
-        // make sure to end executing loop from strand associated to provided io_context
-        if(_strand.running_in_this_thread() == false)
+        co_return;
+    }
+
+    asio::awaitable<void> FixedStepLoop::runLogic()
+    {
+        while (_condition())
         {
-            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+            _total_time.end = _total_time.start;
+            _total_time.start = clock::now();
+
+            _total_time.duration = _total_time.start - _total_time.end;
+
+            _logic_time.start = _total_time.start;
+
+            for(auto & rate : _rates)
+            {
+                co_await updateRate(*rate, _total_time.duration, _total_time.start);
+            }
+
+            _logic_time.end = clock::now();
+            _logic_time.duration = _logic_time.end - _logic_time.start;
+            _logic_recorder.record(_logic_time.duration);
+
+            // park until next step of any rate is due so logic does not burn whole core
+            co_await _logic_pacer.waitUntil(_total_time.start + std::chrono::duration_cast<clock::duration>(getTimeToNextStep()));
         }
 
-        spdlog::debug(std::format("[t:{}] Fixed step loop ended", std::this_thread::get_id())); 
+        co_return;
+    }
+
+    asio::awaitable<void> FixedStepLoop::runPriority()
+    {
+        clock::time_point previous_frame_start = clock::now();
+
+        while (_condition())
+        {
+            _priority_time.start = clock::now();
+
+            // in decoupled mode frame is paced by priority
+            _frame_recorder.record(_priority_time.start - previous_frame_start);
+            previous_frame_start = _priority_time.start;
+
+            // interpolate between last two logic ticks based on time elapsed since last one
+            _alpha = getAlpha(*_rates.at(PRIMARY_RATE), _priority_time.start);
+
+            co_await _priority(_alpha);
+
+            _priority_time.end = clock::now();
+            _priority_time.duration = _priority_time.end - _priority_time.start;
+            _priority_recorder.record(_priority_time.duration);
+
+            if(_pacing.enabled && _pacing.target_frame_interval > std::chrono::duration<double>::zero())
+            {
+                co_await _priority_pacer.waitUntil(_priority_time.start + std::chrono::duration_cast<clock::duration>(_pacing.target_frame_interval));
+            }
+        }
 
         co_return;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,65 @@
+#include "frame_pacer.hpp"
+
+namespace velora
+{
+    FramePacer::FramePacer(asio::any_io_executor executor, std::chrono::duration<double> spin_threshold)
+        :   _timer(std::move(executor)),
+            _spin_threshold_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(spin_threshold).count())
+    {}
+
+    void FramePacer::setSpinThreshold(std::chrono::duration<double> spin_threshold)
+    {
+        _spin_threshold_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(spin_threshold).count(), std::memory_order_relaxed);
+    }
+
+    asio::awaitable<void> FramePacer::waitUntil(clock::time_point deadline)
+    {
+        clock::time_point now = clock::now();
+        if(now >= deadline) co_return;
+
+        const std::chrono::nanoseconds spin_threshold(_spin_threshold_ns.load(std::memory_order_relaxed));
+
+        // sleep for most of the wait, worker thread is free to run other handlers
+        if(deadline - now > spin_threshold)
+        {
+            _timer.expires_after(std::chrono::duration_cast<asio::steady_timer::duration>(deadline - now - spin_threshold));
+            co_await _timer.async_wait(asio::use_awaitable);
+        }
+
+        // spin only for the final part of the wait
+        now = clock::now();
+        while(now < deadline)
+        {
+            std::this_thread::yield();
+            now = clock::now();
+        }
+
+        const int64_t late_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count();
+        _jitter_samples.fetch_add(1, std::memory_order_relaxed);
+        _jitter_sum_ns.fetch_add(late_ns, std::memory_order_relaxed);
+
+        int64_t max_ns = _jitter_max_ns.load(std::memory_order_relaxed);
+        while(late_ns > max_ns && !_jitter_max_ns.compare_exchange_weak(max_ns, late_ns, std::memory_order_relaxed));
+
+        co_return;
+    }
+
+    FramePacer::Jitter FramePacer::getJitter() const
+    {
+        const uint64_t samples = _jitter_samples.load(std::memory_order_relaxed);
+        if(samples == 0) return Jitter{};
+
+        return Jitter{
+            .samples = samples,
+            .mean = std::chrono::nanoseconds(_jitter_sum_ns.load(std::memory_order_relaxed) / (int64_t)samples),
+            .max = std::chrono::nanoseconds(_jitter_max_ns.load(std::memory_order_relaxed))
+        };
+    }
+
+    void FramePacer::resetJitter()
+    {
+        _jitter_samples.store(0, std::memory_order_relaxed);
+        _jitter_sum_ns.store(0, std::memory_order_relaxed);
+        _jitter_max_ns.store(0, std::memory_order_relaxed);
+    }
+}
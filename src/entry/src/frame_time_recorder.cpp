@@ -0,0 +1,208 @@
+#include "frame_time_recorder.hpp"
+
+#include <bit>
+#include <fstream>
+
+#include <spdlog/spdlog.h>
+
+namespace velora
+{
+    FrameTimeRecorder::FrameTimeRecorder(std::string name,
+                std::vector<std::chrono::duration<double>> hitch_thresholds,
+                std::size_t capacity)
+        :   _name(std::move(name)),
+            _hitch_thresholds(std::move(hitch_thresholds)),
+            _samples(std::max<std::size_t>(capacity, 1)),
+            _histogram(_BUCKET_COUNT),
+            _hitch_counts(_hitch_thresholds.size())
+    {}
+
+    std::size_t FrameTimeRecorder::getBucketIndex(uint64_t value_ns)
+    {
+        // values below sub bucket count are stored exactly
+        if(value_ns < _SUB_BUCKET_COUNT) return (std::size_t)value_ns;
+
+        // above that every power of two range is split into half sub bucket count linear buckets
+        const uint32_t msb = (uint32_t)std::bit_width(value_ns) - 1;
+        const uint32_t exponent = msb - (_SUB_BUCKET_BITS - 1);
+        const uint64_t mantissa = value_ns >> exponent; // in [_SUB_BUCKET_HALF, _SUB_BUCKET_COUNT)
+
+        return (std::size_t)(_SUB_BUCKET_COUNT + (exponent - 1) * _SUB_BUCKET_HALF + (mantissa - _SUB_BUCKET_HALF));
+    }
+
+    uint64_t FrameTimeRecorder::getBucketUpperBound(std::size_t index)
+    {
+        if(index < _SUB_BUCKET_COUNT) return (uint64_t)index;
+
+        const uint64_t exponent = (index - _SUB_BUCKET_COUNT) / _SUB_BUCKET_HALF + 1;
+        const uint64_t mantissa = (index - _SUB_BUCKET_COUNT) % _SUB_BUCKET_HALF + _SUB_BUCKET_HALF;
+
+        return ((mantissa + 1) << exponent) - 1;
+    }
+
+    void FrameTimeRecorder::record(std::chrono::duration<double> sample)
+    {
+        const int64_t sample_ns = std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sample).count(), 0);
+
+        // ring buffer of last samples
+        const uint64_t write_index = _write_index.fetch_add(1, std::memory_order_relaxed);
+        _samples[write_index % _samples.size()].store(sample_ns, std::memory_order_relaxed);
+
+        // histogram of all samples
+        _histogram[getBucketIndex((uint64_t)sample_ns)].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _sum_ns.fetch_add((uint64_t)sample_ns, std::memory_order_relaxed);
+
+        uint64_t max_ns = _max_ns.load(std::memory_order_relaxed);
+        while((uint64_t)sample_ns > max_ns && !_max_ns.compare_exchange_weak(max_ns, (uint64_t)sample_ns, std::memory_order_relaxed));
+
+        for(std::size_t i = 0; i < _hitch_thresholds.size(); ++i)
+        {
+            if(sample > _hitch_thresholds[i])
+            {
+                _hitch_counts[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const std::string & FrameTimeRecorder::getName() const
+    {
+        return _name;
+    }
+
+    std::chrono::duration<double> FrameTimeRecorder::getPercentile(double percentile) const
+    {
+        const uint64_t count = _count.load(std::memory_order_relaxed);
+        if(count == 0) return std::chrono::duration<double>::zero();
+
+        const uint64_t target = std::max<uint64_t>((uint64_t)std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * (double)count), 1);
+
+        uint64_t cumulative = 0;
+        for(std::size_t i = 0; i < _histogram.size(); ++i)
+        {
+            cumulative += _histogram[i].load(std::memory_order_relaxed);
+            if(cumulative >= target)
+            {
+                // never report more than largest recorded sample
+                return std::chrono::nanoseconds(std::min(getBucketUpperBound(i), _max_ns.load(std::memory_order_relaxed)));
+            }
+        }
+        return std::chrono::nanoseconds(_max_ns.load(std::memory_order_relaxed));
+    }
+
+    FrameTimeRecorder::Summary FrameTimeRecorder::getSummary() const
+    {
+        Summary summary;
+        summary.name = _name;
+        summary.samples = _count.load(std::memory_order_relaxed);
+
+        if(summary.samples > 0)
+        {
+            summary.mean = std::chrono::nanoseconds(_sum_ns.load(std::memory_order_relaxed) / summary.samples);
+            summary.p50 = getPercentile(50.0);
+            summary.p90 = getPercentile(90.0);
+            summary.p99 = getPercentile(99.0);
+            summary.max = std::chrono::nanoseconds(_max_ns.load(std::memory_order_relaxed));
+        }
+
+        summary.hitches.reserve(_hitch_thresholds.size());
+        for(std::size_t i = 0; i < _hitch_thresholds.size(); ++i)
+        {
+            summary.hitches.emplace_back(Hitches{
+                .threshold = _hitch_thresholds[i],
+                .count = _hitch_counts[i].load(std::memory_order_relaxed)
+            });
+        }
+
+        return summary;
+    }
+
+    std::vector<int64_t> FrameTimeRecorder::getLastSamples() const
+    {
+        const uint64_t written = _write_index.load(std::memory_order_relaxed);
+        const uint64_t available = std::min<uint64_t>(written, _samples.size());
+
+        std::vector<int64_t> samples;
+        samples.reserve(available);
+        for(uint64_t i = written - available; i < written; ++i)
+        {
+            samples.emplace_back(_samples[i % _samples.size()].load(std::memory_order_relaxed));
+        }
+        return samples;
+    }
+
+    std::string FrameTimeRecorder::dumpCSV() const
+    {
+        const std::vector<int64_t> samples = getLastSamples();
+
+        std::string csv = "sample,duration_ms\n";
+        for(std::size_t i = 0; i < samples.size(); ++i)
+        {
+            csv += std::format("{},{:.6f}\n", i, (double)samples[i] / 1'000'000.0);
+        }
+        return csv;
+    }
+
+    std::string FrameTimeRecorder::dumpJSON() const
+    {
+        const Summary summary = getSummary();
+        const std::vector<int64_t> samples = getLastSamples();
+
+        std::string json = std::format(
+            "{{\n  \"name\": \"{}\",\n  \"samples\": {},\n  \"mean_ms\": {:.6f},\n  \"p50_ms\": {:.6f},\n  \"p90_ms\": {:.6f},\n  \"p99_ms\": {:.6f},\n  \"max_ms\": {:.6f},\n",
+            summary.name, summary.samples,
+            summary.mean.count() * 1000.0, summary.p50.count() * 1000.0, summary.p90.count() * 1000.0,
+            summary.p99.count() * 1000.0, summary.max.count() * 1000.0);
+
+        json += "  \"hitches\": [";
+        for(std::size_t i = 0; i < summary.hitches.size(); ++i)
+        {
+            json += std::format("{}{{\"threshold_ms\": {:.3f}, \"count\": {}}}",
+                i == 0 ? "" : ", ", summary.hitches[i].threshold.count() * 1000.0, summary.hitches[i].count);
+        }
+        json += "],\n";
+
+        json += "  \"last_samples_ms\": [";
+        for(std::size_t i = 0; i < samples.size(); ++i)
+        {
+            json += std::format("{}{:.6f}", i == 0 ? "" : ", ", (double)samples[i] / 1'000'000.0);
+        }
+        json += "]\n}\n";
+
+        return json;
+    }
+
+    bool FrameTimeRecorder::dump(const std::filesystem::path & path) const
+    {
+        // format is checked before opening, so unknown extension does not truncate existing file
+        const std::filesystem::path extension = path.extension();
+        if(extension != ".json" && extension != ".csv")
+        {
+            spdlog::error("Unknown frame time dump format: {}", path.string());
+            return false;
+        }
+
+        std::ofstream out(path, std::ios::out | std::ios::trunc);
+        if(!out.is_open())
+        {
+            spdlog::error("Failed to open frame time dump file: {}", path.string());
+            return false;
+        }
+
+        if(extension == ".json")out << dumpJSON();
+        else out << dumpCSV();
+
+        return true;
+    }
+
+    void FrameTimeRecorder::reset()
+    {
+        for(auto & bucket : _histogram) bucket.store(0, std::memory_order_relaxed);
+        for(auto & hitch_count : _hitch_counts) hitch_count.store(0, std::memory_order_relaxed);
+
+        _write_index.store(0, std::memory_order_relaxed);
+        _count.store(0, std::memory_order_relaxed);
+        _sum_ns.store(0, std::memory_order_relaxed);
+        _max_ns.store(0, std::memory_order_relaxed);
+    }
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <optional>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
@@ -8,15 +11,29 @@
 #include "ecs.hpp"
 #include "camera_component.pb.h"
 #include "transform_system.hpp"
+#include "render_snapshot.hpp"
 #include "render.hpp"
 #include "resolution.hpp"
 
 namespace velora::game
 {
+    // std140 layout of FrameBlock in glsl shaders
+    #pragma pack(push, 1)
+    struct GPUFrame {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec4 camera_position;  // w unused
+        float time;
+        float padding[3];
+    };
+    #pragma pack(pop)
+
     class CameraSystem
     {
     public:
         static const uint32_t MASK_POSITION_BIT;
+        // binding point of FrameBlock in shader
+        static constexpr const unsigned int FRAME_UNIFORM_BINDING = 0;
 
         constexpr static const char * NAME = "CameraSystem";
         constexpr static inline const char * getName() { return NAME; }
@@ -31,7 +48,9 @@ namespace velora::game
         CameraSystem& operator=(CameraSystem&&) = default;
         ~CameraSystem() = default;
 
-        asio::awaitable<void> run(const ComponentManager& components, const EntityManager& entities, float alpha);
+        // interpolated run, reads primary camera from render snapshot
+        // and uploads frame uniform block shared by all draws of frame
+        asio::awaitable<void> run(const RenderSnapshot & snapshot, float alpha);
 
         const glm::mat4 & getView() const;
         const glm::mat4 & getProjection () const;
@@ -45,5 +64,9 @@ namespace velora::game
         glm::vec3 _position;
         glm::mat4 _view;
         glm::mat4 _projection;
+
+        // created on first run, renderer has to be initialized
+        std::optional<std::size_t> _frame_uniform_buffer;
+        std::chrono::steady_clock::time_point _start_time = std::chrono::steady_clock::now();
     };
 }
\ No newline at end of file
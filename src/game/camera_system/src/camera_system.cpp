@@ -25,7 +25,7 @@ namespace velora::game
         return _position;
     }
 
-    asio::awaitable<void> CameraSystem::run(const ComponentManager& components, const EntityManager& entities, float alpha)
+    asio::awaitable<void> CameraSystem::run(const RenderSnapshot & snapshot, float alpha)
     {
         if(!_strand.running_in_this_thread()){
             co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
@@ -34,52 +34,45 @@ namespace velora::game
         const Resolution & viewport = _renderer.getViewport();
         if(viewport.getWidth() == 0 || viewport.getHeight() == 0) co_return;
 
-        const float aspect = (float)viewport.getWidth() / (float)viewport.getHeight();
-
-        glm::vec3 position;
-        glm::quat rotation;
-        
-        glm::vec3 prev_position;
-        glm::quat prev_rotation;
-
-        glm::vec3 interpolated_pos;
-        glm::quat interpolated_rot;
-
-        glm::mat4 rotation_matrix;
-        glm::mat4 translation_matrix;
-
-        for (const auto& [entity, mask] : entities.getAllEntities())
-        {
-            if (mask.test(MASK_POSITION_BIT) == false) continue;
+        if(snapshot.camera.valid == false) co_return;
 
-            auto* cam = components.getComponent<CameraComponent>(entity);
-            auto* transform = components.getComponent<TransformComponent>(entity);
-
-            if (!cam || !transform) continue;
-            if (!cam->is_primary()) continue;
-
-            position = glm::vec3{transform->position().x(), transform->position().y(), transform->position().z()};
-            rotation = glm::quat{transform->rotation().w(), transform->rotation().x(), transform->rotation().y(), transform->rotation().z()};
-            rotation = glm::normalize(rotation);
-
-            prev_position = glm::vec3{transform->prev_position().x(), transform->prev_position().y(), transform->prev_position().z()};
+        const float aspect = (float)viewport.getWidth() / (float)viewport.getHeight();
 
-            prev_rotation = glm::quat{transform->prev_rotation().w(), transform->prev_rotation().x(), transform->prev_rotation().y(), transform->prev_rotation().z()};
-            prev_rotation = glm::normalize(prev_rotation);
+        const glm::vec3 interpolated_pos = interpolatePosition(snapshot.camera.transform, alpha);
+        const glm::quat interpolated_rot = interpolateRotation(snapshot.camera.transform, alpha);
+        _position = interpolated_pos;
 
-            interpolated_pos = glm::mix(prev_position, position, alpha);
-            _position = interpolated_pos;
-            interpolated_rot = glm::slerp(prev_rotation, rotation, alpha);
+        const glm::mat4 rotation_matrix = glm::toMat4(glm::conjugate(interpolated_rot));
+        const glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), -interpolated_pos);
+        _view = rotation_matrix * translation_matrix;
 
-            rotation_matrix = glm::toMat4(glm::conjugate(interpolated_rot));
-            translation_matrix = glm::translate(glm::mat4(1.0f), -interpolated_pos);
-            _view = rotation_matrix * translation_matrix;
+        _projection = glm::perspective(glm::radians(snapshot.camera.fov), aspect, snapshot.camera.near_plane, snapshot.camera.far_plane);
 
-            _projection = glm::perspective(glm::radians(cam->fov()), aspect, cam->near_plane(), cam->far_plane());
+        const GPUFrame frame{
+            .view = _view,
+            .projection = _projection,
+            .camera_position = glm::vec4(_position, 1.0f),
+            .time = std::chrono::duration<float>(std::chrono::steady_clock::now() - _start_time).count()
+        };
 
-            break; // only first active camera
+        if(!_frame_uniform_buffer)
+        {
+            _frame_uniform_buffer = co_await _renderer.constructUniformBuffer(
+                "CameraSystem::ubo::frame", FRAME_UNIFORM_BINDING, sizeof(GPUFrame), &frame);
+
+            if(!_strand.running_in_this_thread()){
+                co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+            }
+
+            if(!_frame_uniform_buffer)
+            {
+                spdlog::error("Failed to create frame uniform buffer");
+            }
+            co_return;
         }
 
+        co_await _renderer.updateUniformBuffer(*_frame_uniform_buffer, sizeof(GPUFrame), &frame);
+
         co_return;
     }
 }
\ No newline at end of file
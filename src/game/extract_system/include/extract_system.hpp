@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+
+#include "native.hpp"
+#include <asio.hpp>
+
+#include "ecs.hpp"
+
+#include "transform_component.pb.h"
+#include "visual_component.pb.h"
+#include "light_component.pb.h"
+#include "camera_component.pb.h"
+
+#include "render_snapshot.hpp"
+
+namespace velora::game
+{
+    /**
+     * @brief Extract phase between logic and rendering.
+     * Once per logic tick copies transforms, visuals, lights and primary camera
+     * into triple buffered render snapshot, so render loop never reads live ECS data.
+     */
+    class ExtractSystem
+    {
+        public:
+            constexpr static const char * NAME = "ExtractSystem";
+            constexpr static inline const char * getName() { return NAME; }
+
+            constexpr static const std::initializer_list<const char *> DEPS = {"TransformSystem"};
+            constexpr static inline const std::initializer_list<const char *> & getDependencies() {return DEPS;}
+
+            ExtractSystem(asio::io_context & io_context);
+            ExtractSystem(const ExtractSystem&) = delete;
+            ExtractSystem(ExtractSystem&&) = default;
+            ExtractSystem& operator=(const ExtractSystem&) = delete;
+            ExtractSystem& operator=(ExtractSystem&&) = default;
+            ~ExtractSystem() = default;
+
+            /**
+             * @brief Logic side, writes and publishes new snapshot.
+             * @param tick_time time point state of current logic step corresponds to
+             * @param step logic step
+             */
+            asio::awaitable<void> run(const ComponentManager& components, const EntityManager& entities,
+                std::chrono::high_resolution_clock::time_point tick_time, std::chrono::duration<double> step);
+
+            /**
+             * @brief Render side. Returns latest published snapshot.
+             * Must be called only from one render loop.
+             */
+            const RenderSnapshot & acquireSnapshot();
+
+        private:
+            asio::strand<asio::io_context::executor_type> _strand;
+
+            uint64_t _tick = 0;
+            std::unique_ptr<RenderSnapshotBuffer> _snapshots;
+    };
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/quaternion.hpp>
+
+#include "ecs.hpp"
+
+#include "light_component.pb.h"
+
+namespace velora::game
+{
+    /**
+     * @brief Transform state of one entity at the previous and current logic tick.
+     * Render side interpolates between both using alpha.
+     */
+    struct SnapshotTransform
+    {
+        glm::vec3 prev_position = glm::vec3(0.0f);
+        glm::quat prev_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::vec3 prev_scale = glm::vec3(1.0f);
+
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::vec3 scale = glm::vec3(1.0f);
+    };
+
+    glm::vec3 interpolatePosition(const SnapshotTransform & transform, float alpha);
+    glm::quat interpolateRotation(const SnapshotTransform & transform, float alpha);
+    glm::mat4 calculateInterpolatedTransformMatrix(const SnapshotTransform & transform, float alpha);
+
+    // true when entity did not move between previous and current logic tick, so interpolation yields the same matrix
+    bool isStationary(const SnapshotTransform & transform);
+
+    /**
+     * @brief Render relevant state of visible entity with visual component
+     */
+    struct SnapshotVisual
+    {
+        Entity entity = INVALID_ENTITY;
+
+        std::string vertex_buffer_name;
+        std::string shader_name;
+        glm::vec4 color = glm::vec4(0.5f, 0.5f, 0.5f, 1.0f);
+
+        // identity matrix is used when entity has no transform component
+        bool has_transform = false;
+        SnapshotTransform transform;
+    };
+
+    /**
+     * @brief Render relevant state of entity with light component
+     */
+    struct SnapshotLight
+    {
+        Entity entity = INVALID_ENTITY;
+
+        LightType type = LightType::UNKNOWN_LightType;
+        bool cast_shadows = false;
+
+        glm::vec4 color = glm::vec4(0.0f);          // w = intensity
+        glm::vec3 attenuation = glm::vec3(0.0f);    // x=constant, y=linear, z=quadratic
+        glm::vec2 cutoff = glm::vec2(0.0f);         // x=inner, y=outer
+
+        bool has_transform = false;
+        SnapshotTransform transform;
+    };
+
+    /**
+     * @brief Render relevant state of primary camera
+     */
+    struct SnapshotCamera
+    {
+        bool valid = false;
+
+        float fov = 45.0f;
+        float near_plane = 0.1f;
+        float far_plane = 100.0f;
+
+        SnapshotTransform transform;
+    };
+
+    /**
+     * @brief Compact copy of render relevant ECS state taken once per logic tick.
+     * Render systems read only from snapshot so logic can mutate ECS in parallel.
+     */
+    struct RenderSnapshot
+    {
+        uint64_t tick = 0;
+        // time point state of snapshot corresponds to and logic step it was produced with,
+        // render side computes alpha from them so it always matches acquired snapshot
+        std::chrono::high_resolution_clock::time_point tick_time;
+        std::chrono::duration<double> step = std::chrono::duration<double>::zero();
+
+        std::vector<SnapshotVisual> visuals;
+        std::vector<SnapshotLight> lights;
+        SnapshotCamera camera;
+    };
+
+    /**
+     * @brief Lock-free triple buffer of render snapshots.
+     * Single writer (logic) fills back buffer and publishes it,
+     * single reader (render) acquires latest published snapshot.
+     * Writer never blocks reader and reader never observes partially written snapshot.
+     */
+    class RenderSnapshotBuffer
+    {
+        public:
+            RenderSnapshotBuffer();
+            RenderSnapshotBuffer(const RenderSnapshotBuffer&) = delete;
+            RenderSnapshotBuffer(RenderSnapshotBuffer&&) = delete;
+            RenderSnapshotBuffer& operator=(const RenderSnapshotBuffer&) = delete;
+            RenderSnapshotBuffer& operator=(RenderSnapshotBuffer&&) = delete;
+            ~RenderSnapshotBuffer() = default;
+
+            /**
+             * @brief Writer side. Returns snapshot that can be freely overwritten.
+             */
+            RenderSnapshot & getBack();
+
+            /**
+             * @brief Writer side. Makes back snapshot visible to reader.
+             */
+            void publish();
+
+            /**
+             * @brief Reader side. Returns latest published snapshot.
+             * Returned reference stays valid until next call to acquire.
+             */
+            const RenderSnapshot & acquire();
+
+        private:
+            constexpr static const uint8_t _INDEX_MASK = 0b011;
+            constexpr static const uint8_t _DIRTY_BIT = 0b100;
+
+            std::array<RenderSnapshot, 3> _snapshots;
+
+            uint8_t _back = 0;
+            std::atomic<uint8_t> _middle = 1;
+            uint8_t _front = 2;
+    };
+}
@@ -0,0 +1,136 @@
+#include "extract_system.hpp"
+
+namespace velora::game
+{
+    void extractTransform(const TransformComponent & transform_component, SnapshotTransform & transform)
+    {
+        transform.prev_position = glm::vec3(transform_component.prev_position().x(), 
+                                    transform_component.prev_position().y(), 
+                                    transform_component.prev_position().z());
+
+        transform.prev_rotation = glm::normalize(glm::quat(transform_component.prev_rotation().w(), 
+                                    transform_component.prev_rotation().x(), 
+                                    transform_component.prev_rotation().y(), 
+                                    transform_component.prev_rotation().z()));
+
+        transform.prev_scale = glm::vec3(transform_component.prev_scale().x(), 
+                                    transform_component.prev_scale().y(), 
+                                    transform_component.prev_scale().z());
+
+        transform.position = glm::vec3(transform_component.position().x(), 
+                                    transform_component.position().y(), 
+                                    transform_component.position().z());
+
+        transform.rotation = glm::normalize(glm::quat(transform_component.rotation().w(), 
+                                    transform_component.rotation().x(), 
+                                    transform_component.rotation().y(), 
+                                    transform_component.rotation().z()));
+
+        transform.scale = glm::vec3(transform_component.scale().x(), 
+                                    transform_component.scale().y(), 
+                                    transform_component.scale().z());
+    }
+
+    ExtractSystem::ExtractSystem(asio::io_context & io_context)
+        :   _strand(asio::make_strand(io_context)),
+            _snapshots(std::make_unique<RenderSnapshotBuffer>())
+    {
+    }
+
+    const RenderSnapshot & ExtractSystem::acquireSnapshot()
+    {
+        return _snapshots->acquire();
+    }
+
+    asio::awaitable<void> ExtractSystem::run(const ComponentManager& components, const EntityManager& entities,
+        std::chrono::high_resolution_clock::time_point tick_time, std::chrono::duration<double> step)
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        const uint32_t transform_bit = ComponentTypeManager::getTypeID<TransformComponent>();
+        const uint32_t visual_bit = ComponentTypeManager::getTypeID<VisualComponent>();
+        const uint32_t light_bit = ComponentTypeManager::getTypeID<LightComponent>();
+        const uint32_t camera_bit = ComponentTypeManager::getTypeID<CameraComponent>();
+
+        // back snapshot is owned exclusively by writer
+        // clear keeps vectors capacity so steady state extraction does not allocate
+        RenderSnapshot & snapshot = _snapshots->getBack();
+        snapshot.tick = _tick++;
+        snapshot.tick_time = tick_time;
+        snapshot.step = step;
+        snapshot.visuals.clear();
+        snapshot.lights.clear();
+        snapshot.camera.valid = false;
+
+        const TransformComponent * transform_component = nullptr;
+
+        for (const auto& [entity, mask] : entities.getAllEntities())
+        {
+            transform_component = mask.test(transform_bit) ? components.getComponent<TransformComponent>(entity) : nullptr;
+
+            if(mask.test(visual_bit))
+            {
+                const VisualComponent * visual_component = components.getComponent<VisualComponent>(entity);
+                assert(visual_component != nullptr);
+
+                if(visual_component->visible())
+                {
+                    SnapshotVisual & visual = snapshot.visuals.emplace_back();
+                    visual.entity = entity;
+                    visual.vertex_buffer_name.assign(visual_component->vertex_buffer_name());
+                    visual.shader_name.assign(visual_component->shader_name());
+
+                    if(visual_component->has_color())
+                    {
+                        visual.color = glm::vec4(visual_component->color().x(), 
+                                                 visual_component->color().y(), 
+                                                 visual_component->color().z(), 
+                                                 visual_component->color().w());
+                    }
+
+                    visual.has_transform = transform_component != nullptr;
+                    if(visual.has_transform) extractTransform(*transform_component, visual.transform);
+                }
+            }
+
+            if(mask.test(light_bit))
+            {
+                const LightComponent * light_component = components.getComponent<LightComponent>(entity);
+                assert(light_component != nullptr);
+
+                SnapshotLight & light = snapshot.lights.emplace_back();
+                light.entity = entity;
+                light.type = light_component->type();
+                light.cast_shadows = light_component->cast_shadows();
+                light.color = glm::vec4(light_component->color_r(), light_component->color_g(), light_component->color_b(), light_component->intensity());
+                light.attenuation = glm::vec3(light_component->constant(), light_component->linear(), light_component->quadratic());
+                light.cutoff = glm::vec2(light_component->inner_cutoff(), light_component->outer_cutoff());
+
+                light.has_transform = transform_component != nullptr;
+                if(light.has_transform) extractTransform(*transform_component, light.transform);
+            }
+
+            if(mask.test(camera_bit) && transform_component != nullptr && snapshot.camera.valid == false)
+            {
+                const CameraComponent * camera_component = components.getComponent<CameraComponent>(entity);
+                assert(camera_component != nullptr);
+
+                // only first primary camera
+                if(camera_component->is_primary())
+                {
+                    snapshot.camera.valid = true;
+                    snapshot.camera.fov = camera_component->fov();
+                    snapshot.camera.near_plane = camera_component->near_plane();
+                    snapshot.camera.far_plane = camera_component->far_plane();
+                    extractTransform(*transform_component, snapshot.camera.transform);
+                }
+            }
+        }
+
+        _snapshots->publish();
+
+        co_return;
+    }
+}
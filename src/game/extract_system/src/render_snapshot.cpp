@@ -0,0 +1,54 @@
+#include "render_snapshot.hpp"
+
+namespace velora::game
+{
+    glm::vec3 interpolatePosition(const SnapshotTransform & transform, float alpha)
+    {
+        return glm::mix(transform.prev_position, transform.position, alpha);
+    }
+
+    glm::quat interpolateRotation(const SnapshotTransform & transform, float alpha)
+    {
+        return glm::slerp(transform.prev_rotation, transform.rotation, alpha);
+    }
+
+    glm::mat4 calculateInterpolatedTransformMatrix(const SnapshotTransform & transform, float alpha)
+    {
+        return glm::translate(glm::mat4(1.0f), interpolatePosition(transform, alpha))
+                * glm::toMat4(interpolateRotation(transform, alpha))
+                * glm::scale(glm::mat4(1.0f), glm::mix(transform.prev_scale, transform.scale, alpha));
+    }
+
+    bool isStationary(const SnapshotTransform & transform)
+    {
+        return transform.prev_position == transform.position &&
+            transform.prev_rotation == transform.rotation &&
+            transform.prev_scale == transform.scale;
+    }
+
+    RenderSnapshotBuffer::RenderSnapshotBuffer()
+    {}
+
+    RenderSnapshot & RenderSnapshotBuffer::getBack()
+    {
+        return _snapshots[_back];
+    }
+
+    void RenderSnapshotBuffer::publish()
+    {
+        // swap back with middle and mark middle as fresh
+        const uint8_t previous = _middle.exchange(_back | _DIRTY_BIT, std::memory_order_acq_rel);
+        _back = previous & _INDEX_MASK;
+    }
+
+    const RenderSnapshot & RenderSnapshotBuffer::acquire()
+    {
+        // only swap when writer published something new since last acquire
+        if(_middle.load(std::memory_order_relaxed) & _DIRTY_BIT)
+        {
+            const uint8_t previous = _middle.exchange(_front, std::memory_order_acq_rel);
+            _front = previous & _INDEX_MASK;
+        }
+        return _snapshots[_front];
+    }
+}
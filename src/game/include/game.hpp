@@ -1,6 +1,7 @@
 #pragma once
 
 #include "transform_system.hpp"
+#include "extract_system.hpp"
 #include "visual_system.hpp"
 #include "health_system.hpp"
 #include "input_system.hpp"
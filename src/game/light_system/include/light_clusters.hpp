@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "native.hpp"
+#include <asio.hpp>
+
+#include <glm/glm.hpp>
+
+#include "bounds.hpp"
+
+namespace velora::game
+{
+    /**
+     * @brief Light cluster work of last build
+     */
+    struct LightClusterStats
+    {
+        // clusters with at least one light
+        uint32_t occupied_clusters = 0;
+        // entries of all cluster light lists
+        uint32_t light_indices = 0;
+        uint32_t max_cluster_lights = 0;
+        // lights without bounds, shaded by every pixel
+        uint32_t global_lights = 0;
+        // lights outside of camera depth range, not referenced by any cluster
+        uint32_t culled_lights = 0;
+        std::chrono::microseconds build_time{0};
+    };
+
+    /**
+     * @brief Assigns lights to froxels of camera frustum.
+     *
+     * Screen is split into GRID_X * GRID_Y tiles and view depth into GRID_Z exponential slices.
+     * Every light bounding sphere is tested against view space box of each cluster, lights with
+     * infinite radius are global and shaded everywhere.
+     * Slices are built in parallel by helpers posted to shared io_context, caller thread works as well.
+     * Caller waits only for slices already taken by helpers, so build finishes even when no io_context thread is free.
+     * Not thread safe, meant to be built from single strand.
+     *
+     * Result is single buffer of uint32 matching std430 LightClusterBuffer of deferred lighting pass:
+     * CLUSTERS_COUNT pairs of (offset, count) into light indices, followed by light indices.
+     * Global lights come first in light indices.
+     */
+    class LightClusterGrid
+    {
+        public:
+            static constexpr const uint32_t GRID_X = 16;
+            static constexpr const uint32_t GRID_Y = 9;
+            static constexpr const uint32_t GRID_Z = 24;
+            static constexpr const uint32_t CLUSTERS_COUNT = GRID_X * GRID_Y * GRID_Z;
+            // below this many bounded lights slices are built on caller thread only
+            static constexpr const std::size_t PARALLEL_MIN_LIGHTS = 32;
+            static constexpr const std::size_t DEFAULT_HELPERS = 3;
+
+            /**
+             * @param io_context executes helpers, shared with rest of engine
+             * @param helpers most jobs posted per build, 0 builds on caller thread only
+             */
+            LightClusterGrid(asio::io_context & io_context, std::size_t helpers = DEFAULT_HELPERS);
+            LightClusterGrid(const LightClusterGrid&) = delete;
+            LightClusterGrid(LightClusterGrid&&) = delete;
+            LightClusterGrid& operator=(const LightClusterGrid&) = delete;
+            LightClusterGrid& operator=(LightClusterGrid&&) = delete;
+            ~LightClusterGrid();
+
+            /**
+             * @brief Assigns lights to clusters of perspective camera.
+             * @param light_bounds world space bounds indexed by light, infinite radius for lights reaching everywhere
+             * @param projection symmetric perspective projection, all lights are global when it cannot be clustered
+             */
+            void build(std::span<const BoundingSphere> light_bounds, const glm::mat4 & view, const glm::mat4 & projection,
+                float near_plane, float far_plane);
+
+            // cluster records followed by light indices, valid until next build
+            std::span<const uint32_t> getBuffer() const;
+
+            // x = near plane, y = far plane, slice of view depth d is floor(log(d) * z + w)
+            glm::vec4 getDepthSlicing() const;
+
+            uint32_t getGlobalLightsCount() const;
+
+            LightClusterStats getStats() const;
+
+        private:
+            void runParallel(std::size_t count, const std::function<void(std::size_t)> & job);
+
+            // fills records and light indices of single depth slice, indices are local to slice
+            void buildSlice(uint32_t slice);
+
+            asio::io_context & _io_context;
+            const std::size_t _helpers;
+
+            std::vector<uint32_t> _buffer;
+            glm::vec4 _depth_slicing = glm::vec4(0.0f);
+            uint32_t _global_lights_count = 0;
+            LightClusterStats _stats;
+
+            // view space bounds of bounded lights and their light index
+            std::vector<glm::vec4> _view_spheres;
+            std::vector<uint32_t> _view_sphere_lights;
+            // first and last slice of every view sphere
+            std::vector<uint32_t> _first_slice;
+            std::vector<uint32_t> _last_slice;
+
+            // view space x and y of tile edges at depth 1
+            std::array<float, GRID_X + 1> _tile_x;
+            std::array<float, GRID_Y + 1> _tile_y;
+            std::array<float, GRID_Z + 1> _slice_depth;
+
+            // scratch of every slice, reused between builds
+            std::vector<std::vector<uint32_t>> _slice_spheres;
+            std::vector<std::vector<uint32_t>> _slice_indices;
+    };
+}
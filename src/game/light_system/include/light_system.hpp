@@ -1,6 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <span>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -13,7 +18,11 @@
 
 #include "light_component.pb.h"
 #include "transform_system.hpp"
+#include "camera_system.hpp"
 #include "visual_system.hpp"
+#include "render_snapshot.hpp"
+
+#include "light_clusters.hpp"
 
 namespace velora::game
 {
@@ -28,20 +37,59 @@ namespace velora::game
     };
     #pragma pack(pop)
 
+    // std140 layout of LightSetBlock in glsl shaders, 32 equals MAX_SHADOW_CASTERS of LightSystem
+    #pragma pack(push, 1)
+    struct GPULightSet {
+        glm::mat4 light_space_matrices[32];
+        glm::vec4 shadow_tiles[32];     // xy = uv offset, zw = uv scale of tile in shadow atlas
+        glm::vec4 cluster_depth_slicing;    // x = near, y = far, slice = floor(log(depth) * z + w)
+        int32_t light_count;
+        int32_t shadow_casters_count;
+        int32_t global_lights_count;    // lights at the start of light cluster indices, shaded by every pixel
+        int32_t padding;
+    };
+    #pragma pack(pop)
+
+    /**
+     * @brief Shadow map work of last run
+     */
+    struct ShadowCacheStats
+    {
+        // shadow maps rendered this frame
+        uint32_t rendered = 0;
+        // unchanged shadow maps kept from previous frames
+        uint32_t cached = 0;
+        // out of date shadow maps of distant lights left for next frames by update budget
+        uint32_t deferred = 0;
+        // static layers rendered and static layers copied instead of drawing static casters again
+        uint32_t static_layer_updates = 0;
+        uint32_t static_layer_reuses = 0;
+    };
+
     class LightSystem 
     {
     public:
         static const uint32_t MASK_POSITION_BIT;
         static constexpr const uint16_t MAX_LIGHTS = 256;
-        static constexpr const uint16_t MAX_SHADOW_CASTERS = 16;
+        static constexpr const uint16_t MAX_SHADOW_CASTERS = 32;
+        // every shadow map is square power of two tile of single depth atlas
+        static constexpr const uint32_t SHADOW_ATLAS_SIZE = 4096;
+        static constexpr const uint32_t MIN_SHADOW_TILE_SIZE = 256;
+        // point and spot lights never get more than this, largest tiles are left for directional lights
+        static constexpr const uint32_t MAX_LOCAL_SHADOW_TILE_SIZE = 1024;
+        static constexpr const uint32_t MAX_SHADOW_TILE_SIZE = 2048;
+        // binding points in shader
+        static constexpr const unsigned int LIGHT_SET_UNIFORM_BINDING = 1;
+        static constexpr const unsigned int LIGHT_BUFFER_BINDING = 2;
+        static constexpr const unsigned int LIGHT_CLUSTER_BUFFER_BINDING = 4;
 
         constexpr static const char * NAME = "LightSystem";
         constexpr static inline const char * getName() { return NAME; }
 
-        constexpr static const std::initializer_list<const char *> DEPS = {"TransformSystem", "VisualSystem"};
+        constexpr static const std::initializer_list<const char *> DEPS = {"TransformSystem", "CameraSystem", "VisualSystem"};
         constexpr static inline const std::initializer_list<const char *> & getDependencies() {return DEPS;}
 
-        static asio::awaitable<LightSystem> asyncConstructor(asio::io_context & io_context, VisualSystem & visual_system);
+        static asio::awaitable<LightSystem> asyncConstructor(asio::io_context & io_context, CameraSystem & camera_system, VisualSystem & visual_system);
 
         LightSystem(const LightSystem&) = delete;
         LightSystem(LightSystem&&) = default;
@@ -49,41 +97,227 @@ namespace velora::game
         LightSystem& operator=(LightSystem&&) = default;
         ~LightSystem() = default;
 
-        asio::awaitable<void> run(const ComponentManager& components, const EntityManager& entities, float alpha);
+        // interpolated run, reads lights from render snapshot
+        // must run after visual system rendered the same snapshot
+        asio::awaitable<void> run(const RenderSnapshot & snapshot, float alpha);
 
         std::size_t getLightShaderBufferID() const;
         std::size_t getLightsCount() const;
 
-        std::vector<std::size_t> getShadowMapTextures() const;
-        std::vector<glm::mat4> getShadowMapLightSpaceMatrices() const;
+        // cluster records and light indices read by deferred lighting pass
+        std::size_t getLightClusterBufferID() const;
+        LightClusterStats getLightClusterStats() const;
+
+        // depth texture holding shadow maps of all shadow casters
+        std::size_t getShadowAtlasTexture() const;
+
+        // views of shadow casters of last run, valid until next run
+        std::span<const glm::mat4> getShadowMapLightSpaceMatrices() const;
+        // tile of every shadow caster in shadow atlas, in pixels
+        std::span<const RenderRegion> getShadowMapTiles() const;
         std::size_t getShadowCastersCount() const;
 
+        // visuals tested against light frusta in last run, summed over all shadow casters
+        FrustumCuller::Stats getShadowCullingStats() const;
+
+        ShadowCacheStats getShadowCacheStats() const;
+
+        // triangles of shadow draws in last run, with and without level of detail selection
+        MeshLODStats getShadowLODStats() const;
+
     protected:
         LightSystem(
             asio::io_context & io_context,
             IRenderer & renderer,
+            CameraSystem & camera_system,
             VisualSystem & visual_system,
             std::size_t light_shader_buffer_id,
-            Resolution shadow_map_resolution,
-            std::vector<std::size_t> shadow_map_fbos);
+            std::size_t light_set_uniform_buffer_id,
+            std::size_t light_cluster_buffer_id,
+            std::size_t shadow_instance_buffer_id,
+            std::size_t shadow_atlas_fbo);
+
+        void collectLights(const RenderSnapshot & snapshot, float alpha);
+
+        /**
+         * @brief Distance where attenuated intensity falls under one step of 8 bit color.
+         * std::nullopt for directional lights and lights without falloff.
+         */
+        std::optional<float> calculateLightReach(const GPULight & light) const;
+
+        // world space sphere around lit volume, infinite radius for lights reaching everywhere
+        BoundingSphere calculateLightBounds(const GPULight & light) const;
+
+        // assigns collected lights to clusters of camera frustum
+        void buildLightClusters(const RenderSnapshot & snapshot);
+
+        // resolves shadow pass shaders by name, again whenever renderer objects change
+        bool resolveShadowShaders();
+        asio::awaitable<void> renderShadows(const RenderSnapshot & snapshot, float alpha);
+
+        // fills shadow culler with world bounds of visuals with mesh, sorted by mesh
+        void collectShadowCasters(const RenderSnapshot & snapshot);
+
+        // light projection times light view, std::nullopt for unknown light type
+        // shadow map tiles are square, so projections have aspect 1
+        std::optional<glm::mat4> calculateLightSpaceMatrix(const GPULight & light) const;
+
+        /**
+         * @brief Rough share of screen light can affect, 1 when camera is inside of lit volume.
+         * Directional lights rank above every point and spot light.
+         */
+        float calculateShadowImportance(const GPULight & light, const glm::vec3 & camera_position) const;
 
-        void collectLights(const ComponentManager& components, const EntityManager& entities, float alpha);
-        asio::awaitable<void> renderShadows(const ComponentManager& components, const EntityManager& entities, float alpha);
+        /**
+         * @brief Places tiles of shadow passes into shadow atlas.
+         * Tiles are shrunk from least important until all fit, then placed from largest in Morton order,
+         * so power of two tiles never overlap and the same tile sizes always get the same places.
+         */
+        void allocateShadowTiles();
+
+        // writing tile overwrites cached content of other shadow maps and static layers overlapping it
+        void invalidateOverlappingShadowMaps(uint32_t shadow_caster, const RenderRegion & tile, bool static_layer);
+
+        // visible caster of shadow pass with level of detail selected for its size in shadow map tile
+        struct ShadowPassCaster
+        {
+            // shadow culler sphere
+            uint32_t caster = 0;
+            uint32_t lod = 0;
+            std::size_t vertex_buffer = 0;
+        };
+
+        // draws of casters into tile of fbo, casters must be sorted by vertex buffer so draws of the same mesh are consecutive
+        void appendShadowDraws(std::span<const ShadowPassCaster> casters, uint32_t shadow_caster, std::size_t fbo, const RenderRegion & tile,
+            const RenderSnapshot & snapshot, std::vector<DrawItem> & draw_list);
+
+        // uploads light count, cluster depth slicing and light space matrices of shadow casters, read by shadow and lighting passes
+        asio::awaitable<void> uploadLightSet(uint32_t shadow_casters_count);
 
     private:
         asio::strand<asio::io_context::executor_type> _strand;
         IRenderer & _renderer;
+        CameraSystem & _camera_system;
         VisualSystem & _visual_system;
 
         std::vector<GPULight> _gpu_lights;
         std::size_t _light_shader_buffer_id;
+        std::size_t _light_set_uniform_buffer_id;
+        GPULightSet _gpu_light_set;
+
+        // owns thread pool, kept behind pointer so light system stays movable
+        std::unique_ptr<LightClusterGrid> _light_clusters;
+        std::vector<BoundingSphere> _light_bounds;
+        std::size_t _light_cluster_buffer_id;
 
         std::size_t _shadow_pass_shader;
+        // draws instance groups built from shadow instance buffer, per entity draws are used when missing
+        std::optional<std::size_t> _shadow_pass_instanced_shader;
+        // renderer object generation shadow pass shaders were resolved for
+        uint64_t _object_generation = 0;
+
+        // shadow pass shader uniforms, interned once
+        inline static const ShaderUniform _MODEL{"uModel"};
+        // index into light space matrices of light set block
+        inline static const ShaderUniform _SHADOW_CASTER{"uShadowCaster"};
         
-        Resolution _shadow_map_resolution;
-        std::vector<std::size_t> _shadow_map_fbos;
-        std::vector<std::size_t> _shadow_map_textures;
+        std::size_t _shadow_atlas_fbo;
+        std::size_t _shadow_atlas_texture;
+        // depth of stationary casters only, copied into tiles of shadow atlas before moving casters are drawn
+        // created on first use, most scenes never have lights with both kinds of casters
+        std::optional<std::size_t> _shadow_static_atlas_fbo;
+
         std::vector<glm::mat4> _shadow_map_light_space_matrices;
-        std::size_t _shadow_casters_count;
+        std::vector<RenderRegion> _shadow_map_tiles;
+        // shadow pass draws, reused between frames
+        std::vector<DrawItem> _shadow_draw_list;
+        std::size_t _shadow_casters_count = 0;
+
+        // visuals outside of camera frustum still cast shadows, so shadow passes cull on their own
+        // and cannot reuse camera culled instance groups of visual system
+        FrustumCuller _shadow_culler;
+        // index of snapshot visual of every shadow culler sphere
+        std::vector<std::size_t> _shadow_culler_visuals;
+        // shadow culler spheres inside frustum of current light
+        std::vector<uint32_t> _shadow_visible;
+        FrustumCuller::Stats _shadow_culling_stats;
+
+        // instances of all shadow maps, bound to instance buffer binding point of instanced shaders
+        std::size_t _shadow_instance_buffer_id;
+        std::vector<GPUInstance> _shadow_instances;
+
+        /**
+         * @brief Content of shadow map kept between frames.
+         * Shadow map is rendered again only when hash of light, its visible casters and their transforms changes.
+         */
+        struct ShadowMapCache
+        {
+            bool valid = false;
+            Entity light = INVALID_ENTITY;
+            uint64_t content_hash = 0;
+            // matrix and tile shadow map was rendered with, lighting pass must sample with the same ones
+            glm::mat4 light_space_matrix = glm::mat4(1.0f);
+            RenderRegion tile;
+            uint64_t updated_frame = 0;
+
+            // static layer lives in the same tile of static atlas
+            std::optional<uint64_t> static_layer_hash;
+            RenderRegion static_layer_tile;
+        };
+        std::vector<ShadowMapCache> _shadow_map_caches;
+
+        // shadow map of current frame, casters are range of _shadow_pass_casters with stationary casters first
+        struct ShadowPass
+        {
+            uint32_t shadow_caster = 0;
+            Entity light = INVALID_ENTITY;
+            glm::mat4 light_space_matrix = glm::mat4(1.0f);
+            bool distant = false;
+            float importance = 0.0f;
+
+            uint32_t tile_size = 0;
+            RenderRegion tile;
+
+            std::size_t casters_begin = 0;
+            std::size_t static_casters_count = 0;
+            std::size_t casters_count = 0;
+
+            uint64_t static_hash = 0;
+            uint64_t content_hash = 0;
+
+            bool update = false;
+            bool copy_static_layer = false;
+        };
+        std::vector<ShadowPass> _shadow_passes;
+        std::vector<ShadowPassCaster> _shadow_pass_casters;
+        // out of date shadow passes of distant lights competing for update budget
+        std::vector<std::size_t> _distant_shadow_passes;
+        // shadow passes ordered for tile shrinking and placement
+        std::vector<std::size_t> _shadow_tile_order;
+
+        // draws into static layers, submitted before layers are copied into shadow maps
+        std::vector<DrawItem> _shadow_static_draw_list;
+        // tiles cleared and copied with one render thread call per atlas, reused between frames
+        std::vector<RenderRegion> _shadow_static_clear_tiles;
+        std::vector<RenderRegion> _shadow_clear_tiles;
+        std::vector<RenderRegion> _shadow_copy_tiles;
+
+        ShadowCacheStats _shadow_cache_stats;
+        uint64_t _frame = 0;
+
+        // level of every caster from its projected size in shadow map tile, per light and caster
+        // shadow maps need less detail than camera, so casters switch to coarser levels sooner
+        LODSelector _shadow_lod_selector{_SHADOW_LOD_THRESHOLDS, _SHADOW_LOD_HYSTERESIS};
+        MeshLODStats _shadow_lod_stats;
+
+        // lights farther from camera share per frame budget of shadow map updates, directional lights are never distant
+        constexpr static const float _DISTANT_SHADOW_DISTANCE = 64.0f;
+        constexpr static const std::size_t _DISTANT_SHADOW_UPDATES_PER_FRAME = 2;
+        constexpr static const uint64_t _SHADOW_HASH_SEED = 14695981039346656037ull;
+
+        // projected diameters in shadow map pixels where casters switch to coarser level
+        constexpr static const LODSelector::Thresholds _SHADOW_LOD_THRESHOLDS = {384.0f, 128.0f, 48.0f};
+        // changed level renders cached shadow map again, so levels stick longer than in camera pass
+        constexpr static const float _SHADOW_LOD_HYSTERESIS = 0.25f;
     };
 }
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "light_clusters.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+namespace velora::game
+{
+    LightClusterGrid::LightClusterGrid(asio::io_context & io_context, std::size_t helpers)
+    :   _io_context(io_context),
+        _helpers(helpers)
+    {
+        _buffer.reserve(CLUSTERS_COUNT * 2);
+        _slice_spheres.resize(GRID_Z);
+        _slice_indices.resize(GRID_Z);
+    }
+
+    LightClusterGrid::~LightClusterGrid() = default;
+
+    void LightClusterGrid::runParallel(std::size_t count, const std::function<void(std::size_t)> & job)
+    {
+        if(count == 0)return;
+
+        // helper may start after caller already finished every job, so it only touches shared state
+        struct Work
+        {
+            std::function<void(std::size_t)> job;
+            std::size_t count = 0;
+            std::atomic<std::size_t> next = 0;
+            std::atomic<std::size_t> finished = 0;
+        };
+
+        auto work = std::make_shared<Work>();
+        work->job = job;
+        work->count = count;
+
+        const auto worker = [](Work & work)
+        {
+            for(std::size_t i = work.next.fetch_add(1, std::memory_order_relaxed); i < work.count; i = work.next.fetch_add(1, std::memory_order_relaxed))
+            {
+                work.job(i);
+                if(work.finished.fetch_add(1, std::memory_order_acq_rel) + 1 == work.count)work.finished.notify_all();
+            }
+        };
+
+        // caller thread works as well, helpers only help
+        const std::size_t helpers = std::min(_helpers, count - 1);
+        for(std::size_t i = 0; i < helpers; ++i)
+        {
+            asio::post(_io_context, [work, worker](){ worker(*work); });
+        }
+
+        worker(*work);
+
+        // only jobs taken by running helpers are left
+        for(std::size_t finished = work->finished.load(std::memory_order_acquire); finished < count;
+            finished = work->finished.load(std::memory_order_acquire))
+        {
+            work->finished.wait(finished, std::memory_order_acquire);
+        }
+    }
+
+    void LightClusterGrid::build(std::span<const BoundingSphere> light_bounds, const glm::mat4 & view, const glm::mat4 & projection,
+        float near_plane, float far_plane)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        _stats = LightClusterStats{};
+        _global_lights_count = 0;
+        _view_spheres.clear();
+        _view_sphere_lights.clear();
+        _first_slice.clear();
+        _last_slice.clear();
+
+        // records of empty clusters stay zero
+        _buffer.assign(CLUSTERS_COUNT * 2, 0);
+
+        // tiles are mapped to view space by scale of symmetric perspective projection only
+        const bool clusterable = projection[0][0] > 0.0f && projection[1][1] > 0.0f &&
+            projection[2][0] == 0.0f && projection[2][1] == 0.0f && projection[2][3] == -1.0f &&
+            near_plane > 0.0f && far_plane > near_plane;
+
+        // log(1) * 0 + 0 puts every pixel into first slice, whose clusters are empty
+        _depth_slicing = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+        if(clusterable)
+        {
+            const float log_range = std::log(far_plane / near_plane);
+            _depth_slicing = glm::vec4(near_plane, far_plane,
+                (float)GRID_Z / log_range,
+                -(float)GRID_Z * std::log(near_plane) / log_range);
+
+            for(uint32_t x = 0; x <= GRID_X; ++x)_tile_x[x] = (-1.0f + 2.0f * (float)x / (float)GRID_X) / projection[0][0];
+            for(uint32_t y = 0; y <= GRID_Y; ++y)_tile_y[y] = (-1.0f + 2.0f * (float)y / (float)GRID_Y) / projection[1][1];
+            for(uint32_t z = 0; z <= GRID_Z; ++z)_slice_depth[z] = near_plane * std::pow(far_plane / near_plane, (float)z / (float)GRID_Z);
+        }
+
+        const auto sliceOf = [this](float depth)
+        {
+            const float slice = std::floor(std::log(depth) * _depth_slicing.z + _depth_slicing.w);
+            return (uint32_t)std::clamp(slice, 0.0f, (float)(GRID_Z - 1));
+        };
+
+        // global lights first, they are shaded by every pixel before lights of its cluster
+        for(uint32_t l = 0; l < light_bounds.size(); ++l)
+        {
+            const BoundingSphere & sphere = light_bounds[l];
+            if(clusterable && std::isfinite(sphere.radius))
+            {
+                const glm::vec3 center = glm::vec3(view * glm::vec4(sphere.center, 1.0f));
+                // camera looks down negative z
+                const float depth = -center.z;
+                if(depth + sphere.radius < near_plane || depth - sphere.radius > far_plane)
+                {
+                    _stats.culled_lights++;
+                    continue;
+                }
+
+                _view_spheres.emplace_back(center, sphere.radius);
+                _view_sphere_lights.emplace_back(l);
+                _first_slice.emplace_back(sliceOf(std::max(depth - sphere.radius, near_plane)));
+                _last_slice.emplace_back(sliceOf(std::min(depth + sphere.radius, far_plane)));
+                continue;
+            }
+
+            _buffer.emplace_back(l);
+            _global_lights_count++;
+        }
+        _stats.global_lights = _global_lights_count;
+
+        if(_view_spheres.empty() == false)
+        {
+            if(_view_spheres.size() >= PARALLEL_MIN_LIGHTS)
+            {
+                runParallel(GRID_Z, [this](std::size_t slice){ buildSlice((uint32_t)slice); });
+            }
+            else
+            {
+                for(uint32_t slice = 0; slice < GRID_Z; ++slice)buildSlice(slice);
+            }
+
+            // move slice local offsets behind global lights and indices of previous slices
+            for(uint32_t slice = 0; slice < GRID_Z; ++slice)
+            {
+                const uint32_t base = (uint32_t)(_buffer.size() - CLUSTERS_COUNT * 2);
+                for(uint32_t cluster = slice * GRID_X * GRID_Y; cluster < (slice + 1) * GRID_X * GRID_Y; ++cluster)
+                {
+                    const uint32_t count = _buffer[cluster * 2 + 1];
+                    if(count == 0)continue;
+
+                    _buffer[cluster * 2] += base;
+                    _stats.occupied_clusters++;
+                    _stats.max_cluster_lights = std::max(_stats.max_cluster_lights, count);
+                }
+
+                _buffer.insert(_buffer.end(), _slice_indices[slice].begin(), _slice_indices[slice].end());
+            }
+        }
+
+        _stats.light_indices = (uint32_t)(_buffer.size() - CLUSTERS_COUNT * 2) - _global_lights_count;
+        _stats.build_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    void LightClusterGrid::buildSlice(uint32_t slice)
+    {
+        std::vector<uint32_t> & spheres = _slice_spheres[slice];
+        std::vector<uint32_t> & indices = _slice_indices[slice];
+        spheres.clear();
+        indices.clear();
+
+        for(uint32_t s = 0; s < _view_spheres.size(); ++s)
+        {
+            if(_first_slice[s] <= slice && slice <= _last_slice[s])spheres.emplace_back(s);
+        }
+        if(spheres.empty())return;
+
+        const float near_depth = _slice_depth[slice];
+        const float far_depth = _slice_depth[slice + 1];
+
+        for(uint32_t y = 0; y < GRID_Y; ++y)
+        {
+            // box of frustum piece, edges of tile are lines through camera so extremes are at near or far depth
+            const float min_y = std::min(_tile_y[y] * near_depth, _tile_y[y] * far_depth);
+            const float max_y = std::max(_tile_y[y + 1] * near_depth, _tile_y[y + 1] * far_depth);
+
+            for(uint32_t x = 0; x < GRID_X; ++x)
+            {
+                const glm::vec3 box_min(std::min(_tile_x[x] * near_depth, _tile_x[x] * far_depth), min_y, -far_depth);
+                const glm::vec3 box_max(std::max(_tile_x[x + 1] * near_depth, _tile_x[x + 1] * far_depth), max_y, -near_depth);
+
+                const uint32_t cluster = x + GRID_X * (y + GRID_Y * slice);
+                const uint32_t begin = (uint32_t)indices.size();
+
+                for(const uint32_t s : spheres)
+                {
+                    const glm::vec4 & sphere = _view_spheres[s];
+                    const glm::vec3 delta = glm::clamp(glm::vec3(sphere), box_min, box_max) - glm::vec3(sphere);
+                    if(glm::dot(delta, delta) <= sphere.w * sphere.w)indices.emplace_back(_view_sphere_lights[s]);
+                }
+
+                // offset is local to slice until build merges slices
+                _buffer[cluster * 2] = begin;
+                _buffer[cluster * 2 + 1] = (uint32_t)indices.size() - begin;
+            }
+        }
+    }
+
+    std::span<const uint32_t> LightClusterGrid::getBuffer() const
+    {
+        return _buffer;
+    }
+
+    glm::vec4 LightClusterGrid::getDepthSlicing() const
+    {
+        return _depth_slicing;
+    }
+
+    uint32_t LightClusterGrid::getGlobalLightsCount() const
+    {
+        return _global_lights_count;
+    }
+
+    LightClusterStats LightClusterGrid::getStats() const
+    {
+        return _stats;
+    }
+}
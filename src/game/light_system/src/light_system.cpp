@@ -2,44 +2,47 @@
 
 namespace velora::game
 {
-    const uint32_t LightSystem::MASK_POSITION_BIT = ComponentTypeManager::getTypeID<LightComponent>();
-
-    glm::mat4 loadModelMatrixField(const VisualComponent * visual_component)
+    namespace
     {
-        if(visual_component == nullptr) return glm::mat4(1.0f);
-        if(!visual_component->has_model_matrix()) return glm::mat4(1.0f);
-        glm::mat4 model_matrix;
-
-        model_matrix[0][0] = visual_component->model_matrix().data(0);
-        model_matrix[0][1] = visual_component->model_matrix().data(1);
-        model_matrix[0][2] = visual_component->model_matrix().data(2);
-        model_matrix[0][3] = visual_component->model_matrix().data(3);
-
-        model_matrix[1][0] = visual_component->model_matrix().data(4);
-        model_matrix[1][1] = visual_component->model_matrix().data(5);
-        model_matrix[1][2] = visual_component->model_matrix().data(6);
-        model_matrix[1][3] = visual_component->model_matrix().data(7);
-
-        model_matrix[2][0] = visual_component->model_matrix().data(8);
-        model_matrix[2][1] = visual_component->model_matrix().data(9);
-        model_matrix[2][2] = visual_component->model_matrix().data(10);
-        model_matrix[2][3] = visual_component->model_matrix().data(11);
-
-        model_matrix[3][0] = visual_component->model_matrix().data(12);
-        model_matrix[3][1] = visual_component->model_matrix().data(13);
-        model_matrix[3][2] = visual_component->model_matrix().data(14);
-        model_matrix[3][3] = visual_component->model_matrix().data(15);
-
-        return model_matrix;
+        // FNV-1a, matrices are hashed bitwise so any movement of light or caster changes hash
+        template<class T>
+        uint64_t hashValue(uint64_t hash, const T & value)
+        {
+            const auto * bytes = reinterpret_cast<const unsigned char *>(&value);
+            for(std::size_t i = 0; i < sizeof(T); ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        // every second bit of value packed together, decodes one coordinate of Morton index
+        uint32_t compactBits(uint32_t value)
+        {
+            value &= 0x55555555u;
+            value = (value | (value >> 1)) & 0x33333333u;
+            value = (value | (value >> 2)) & 0x0f0f0f0fu;
+            value = (value | (value >> 4)) & 0x00ff00ffu;
+            value = (value | (value >> 8)) & 0x0000ffffu;
+            return value;
+        }
     }
 
-    asio::awaitable<LightSystem> LightSystem::asyncConstructor(asio::io_context & io_context, VisualSystem & visual_system)
+    const uint32_t LightSystem::MASK_POSITION_BIT = ComponentTypeManager::getTypeID<LightComponent>();
+
+    static_assert(std::size(GPULightSet{}.light_space_matrices) == LightSystem::MAX_SHADOW_CASTERS, "GPULightSet must hold matrix of every shadow caster");
+    static_assert(std::size(GPULightSet{}.shadow_tiles) == LightSystem::MAX_SHADOW_CASTERS, "GPULightSet must hold tile of every shadow caster");
+    static_assert((std::size_t)LightSystem::MAX_SHADOW_CASTERS * LightSystem::MIN_SHADOW_TILE_SIZE * LightSystem::MIN_SHADOW_TILE_SIZE <=
+        (std::size_t)LightSystem::SHADOW_ATLAS_SIZE * LightSystem::SHADOW_ATLAS_SIZE, "Smallest tiles of all shadow casters must fit into shadow atlas");
+    static_assert(sizeof(GPULightSet) % 16 == 0, "std140 block size must be multiple of vec4");
+
+    asio::awaitable<LightSystem> LightSystem::asyncConstructor(asio::io_context & io_context, CameraSystem & camera_system, VisualSystem & visual_system)
     {
         IRenderer & renderer = visual_system.getRenderer();
 
-        // binding point 2 in shader
         auto light_shader_buffer = co_await renderer.constructShaderStorageBuffer(
-                "LightSystem::ssbo::light", 2, 0, nullptr);
+                "LightSystem::ssbo::light", LIGHT_BUFFER_BINDING, 0, nullptr);
         
         if(!light_shader_buffer)
         {
@@ -47,66 +50,105 @@ namespace velora::game
             throw std::runtime_error("Failed to create light shader storage buffer");
         }
 
-        // create shadow map frame buffer objects
-        // for all shadow casters
-        const Resolution shadow_map_resolution{1024, 1024};
-        std::vector<std::size_t> shadow_map_fbos;
-        std::optional<std::size_t> fbo_creaton_result;
-        for(unsigned int i = 0; i < MAX_SHADOW_CASTERS; ++i)
+        const GPULightSet empty_light_set{};
+        auto light_set_uniform_buffer = co_await renderer.constructUniformBuffer(
+                "LightSystem::ubo::light_set", LIGHT_SET_UNIFORM_BINDING, sizeof(GPULightSet), &empty_light_set);
+
+        if(!light_set_uniform_buffer)
         {
-            fbo_creaton_result = co_await renderer.constructFrameBufferObject(
-                "LightSystem::fbo::shadow_map" + std::to_string(i), shadow_map_resolution,
-                {{FBOAttachment::Type::Texture, FBOAttachment::Point::Depth, TextureFormat::Depth_32F}});
-            
-            if(!fbo_creaton_result)
-            {
-                spdlog::error("Failed to create shadow map fbo {}", i);
-                throw std::runtime_error("Failed to create shadow map fbo " + std::to_string(i));
-            }
+            spdlog::error("Failed to create light set uniform buffer");
+            throw std::runtime_error("Failed to create light set uniform buffer");
+        }
+
+        auto light_cluster_buffer = co_await renderer.constructShaderStorageBuffer(
+                "LightSystem::ssbo::light_clusters", LIGHT_CLUSTER_BUFFER_BINDING, 0, nullptr);
 
-            shadow_map_fbos.emplace_back(*fbo_creaton_result);
+        if(!light_cluster_buffer)
+        {
+            spdlog::error("Failed to create light cluster shader storage buffer");
+            throw std::runtime_error("Failed to create light cluster shader storage buffer");
+        }
+
+        // shadow passes bind it to the same binding point as visual system instance buffer
+        auto shadow_instance_buffer = co_await renderer.constructShaderStorageBuffer(
+                "LightSystem::ssbo::shadow_instances", VisualSystem::INSTANCE_BUFFER_BINDING, 0, nullptr);
+
+        if(!shadow_instance_buffer)
+        {
+            spdlog::error("Failed to create shadow instance shader storage buffer");
+            throw std::runtime_error("Failed to create shadow instance shader storage buffer");
+        }
+
+        // single depth atlas for shadow maps of all shadow casters
+        auto shadow_atlas_fbo = co_await renderer.constructFrameBufferObject(
+            "LightSystem::fbo::shadow_atlas", Resolution{SHADOW_ATLAS_SIZE, SHADOW_ATLAS_SIZE},
+            {{FBOAttachment::Type::Texture, FBOAttachment::Point::Depth, TextureFormat::Depth_32F}});
+
+        if(!shadow_atlas_fbo)
+        {
+            spdlog::error("Failed to create shadow atlas fbo");
+            throw std::runtime_error("Failed to create shadow atlas fbo");
         }
 
-        co_return LightSystem(io_context, renderer, visual_system, *light_shader_buffer, shadow_map_resolution, std::move(shadow_map_fbos));
+        co_return LightSystem(io_context, renderer, camera_system, visual_system, *light_shader_buffer, *light_set_uniform_buffer,
+            *light_cluster_buffer, *shadow_instance_buffer, *shadow_atlas_fbo);
     }
 
     LightSystem::LightSystem(
             asio::io_context & io_context,
             IRenderer & renderer,
+            CameraSystem & camera_system,
             VisualSystem & visual_system,
             std::size_t light_shader_buffer_id,
-            Resolution shadow_map_resolution,
-            std::vector<std::size_t> shadow_map_fbos
+            std::size_t light_set_uniform_buffer_id,
+            std::size_t light_cluster_buffer_id,
+            std::size_t shadow_instance_buffer_id,
+            std::size_t shadow_atlas_fbo
     )
     :   _strand(asio::make_strand(io_context)),
         _renderer(renderer),
+        _camera_system(camera_system),
         _visual_system(visual_system),
         _light_shader_buffer_id(light_shader_buffer_id),
-        _shadow_map_resolution(std::move(shadow_map_resolution)),
-        _shadow_map_fbos(std::move(shadow_map_fbos))
+        _light_set_uniform_buffer_id(light_set_uniform_buffer_id),
+        _gpu_light_set{},
+        _light_clusters(std::make_unique<LightClusterGrid>(io_context)),
+        _light_cluster_buffer_id(light_cluster_buffer_id),
+        _shadow_atlas_fbo(shadow_atlas_fbo),
+        _shadow_instance_buffer_id(shadow_instance_buffer_id)
     {
         _gpu_lights.reserve(MAX_LIGHTS);
+        _light_bounds.reserve(MAX_LIGHTS);
 
-        auto shadow_shader_result = _renderer.getShader("shadow_depth");
-        if(!shadow_shader_result)
+        if(resolveShadowShaders() == false)
         {
-            spdlog::error("Failed to get shadow pass shader");
             throw std::runtime_error("Failed to get shadow pass shader");
         }
-        _shadow_pass_shader = *shadow_shader_result;
 
-        assert(shadow_map_fbos.size() <= MAX_SHADOW_CASTERS && "Too many shadow casters! Increase MAX_SHADOW_CASTERS in light_system.hpp" );
+        // fetch shadow atlas texture from frame buffer object
+        auto tex_res = _renderer.getFrameBufferObjectTextures(_shadow_atlas_fbo);
+        assert(tex_res.size() == 1 && "Shadow atlas fbo should only have one texture" );
+        _shadow_atlas_texture = tex_res.at(0);
 
-        // fetch shadow map textures from frame buffer objects
-        _shadow_map_textures.reserve(MAX_SHADOW_CASTERS);
-        for(const auto & shader_map_fbo : _shadow_map_fbos)
+        _shadow_map_light_space_matrices.resize(MAX_SHADOW_CASTERS);
+        _shadow_map_tiles.resize(MAX_SHADOW_CASTERS);
+        _shadow_map_caches.resize(MAX_SHADOW_CASTERS);
+    }
+
+    bool LightSystem::resolveShadowShaders()
+    {
+        _object_generation = _renderer.getObjectGeneration();
+
+        auto shadow_shader_result = _renderer.getShader("shadow_depth");
+        if(!shadow_shader_result)
         {
-            auto tex_res = _renderer.getFrameBufferObjectTextures(shader_map_fbo);
-            assert(tex_res.size() == 1 && "Shadow map fbo should only have one texture" );
-            _shadow_map_textures.emplace_back(tex_res.at(0));
+            spdlog::error("Failed to get shadow pass shader");
+            return false;
         }
+        _shadow_pass_shader = *shadow_shader_result;
 
-        _shadow_map_light_space_matrices.resize(MAX_SHADOW_CASTERS);
+        _shadow_pass_instanced_shader = _renderer.getShader(std::string("shadow_depth") + VisualSystem::INSTANCED_SHADER_SUFFIX);
+        return true;
     }
 
     std::size_t LightSystem::getLightShaderBufferID() const 
@@ -119,14 +161,29 @@ namespace velora::game
         return _gpu_lights.size();
     }
 
-    std::vector<std::size_t> LightSystem::getShadowMapTextures() const
+    std::size_t LightSystem::getLightClusterBufferID() const
+    {
+        return _light_cluster_buffer_id;
+    }
+
+    LightClusterStats LightSystem::getLightClusterStats() const
     {
-        return std::vector<std::size_t>(_shadow_map_textures.begin(), _shadow_map_textures.begin() + _shadow_casters_count);
+        return _light_clusters->getStats();
     }
 
-    std::vector<glm::mat4> LightSystem::getShadowMapLightSpaceMatrices() const
+    std::size_t LightSystem::getShadowAtlasTexture() const
     {
-        return std::vector<glm::mat4>(_shadow_map_light_space_matrices.begin(), _shadow_map_light_space_matrices.begin() + _shadow_casters_count);
+        return _shadow_atlas_texture;
+    }
+
+    std::span<const glm::mat4> LightSystem::getShadowMapLightSpaceMatrices() const
+    {
+        return std::span<const glm::mat4>(_shadow_map_light_space_matrices).first(_shadow_casters_count);
+    }
+
+    std::span<const RenderRegion> LightSystem::getShadowMapTiles() const
+    {
+        return std::span<const RenderRegion>(_shadow_map_tiles).first(_shadow_casters_count);
     }
 
     std::size_t LightSystem::getShadowCastersCount() const
@@ -134,31 +191,46 @@ namespace velora::game
         return _shadow_casters_count;
     }
 
-    asio::awaitable<void> LightSystem::run(const ComponentManager& components, const EntityManager& entities, float alpha)
+    FrustumCuller::Stats LightSystem::getShadowCullingStats() const
+    {
+        return _shadow_culling_stats;
+    }
+
+    ShadowCacheStats LightSystem::getShadowCacheStats() const
+    {
+        return _shadow_cache_stats;
+    }
+
+    MeshLODStats LightSystem::getShadowLODStats() const
+    {
+        return _shadow_lod_stats;
+    }
+
+    asio::awaitable<void> LightSystem::run(const RenderSnapshot & snapshot, float alpha)
     {
         if(!_strand.running_in_this_thread()){
             co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
         }
         
-        collectLights(components, entities, alpha);
+        collectLights(snapshot, alpha);
 
-        co_await renderShadows(components, entities, alpha);
+        // depth slicing of clusters is uploaded with light set by shadow pass
+        buildLightClusters(snapshot);
+
+        co_await renderShadows(snapshot, alpha);
 
         co_await _renderer.updateShaderStorageBuffer(_light_shader_buffer_id, sizeof(GPULight) * _gpu_lights.size(), _gpu_lights.data());
 
+        const std::span<const uint32_t> light_clusters = _light_clusters->getBuffer();
+        co_await _renderer.updateShaderStorageBuffer(_light_cluster_buffer_id, sizeof(uint32_t) * light_clusters.size(), light_clusters.data());
+
         co_return;
     }
 
-    void LightSystem::collectLights(const ComponentManager& components, const EntityManager& entities, float alpha)
+    void LightSystem::collectLights(const RenderSnapshot & snapshot, float alpha)
     {
         _gpu_lights.clear();
 
-        glm::vec3 position;
-        glm::quat rotation;
-
-        glm::vec3 prev_position;
-        glm::quat prev_rotation;
-
         glm::vec3 interpolated_pos;
         glm::quat interpolated_rot;
 
@@ -166,29 +238,14 @@ namespace velora::game
 
         GPULight gpu_light{};
         uint32_t light_id = 0;
-        for (const auto& [entity, mask] : entities.getAllEntities())
+        for (const SnapshotLight & light : snapshot.lights)
         {
             if(light_id >= MAX_LIGHTS)return;
 
-            if (mask.test(MASK_POSITION_BIT) == false) continue;
-
-            const LightComponent * light_component = components.getComponent<LightComponent>(entity);
-            assert(light_component != nullptr);
-            
-            auto* transform = components.getComponent<TransformComponent>(entity);
-            if(transform)
+            if(light.has_transform)
             {
-                position = glm::vec3{transform->position().x(), transform->position().y(), transform->position().z()};
-                rotation = glm::quat{transform->rotation().w(), transform->rotation().x(), transform->rotation().y(), transform->rotation().z()};
-                rotation = glm::normalize(rotation);
-
-                prev_position = glm::vec3{transform->prev_position().x(), transform->prev_position().y(), transform->prev_position().z()};
-
-                prev_rotation = glm::quat{transform->prev_rotation().w(), transform->prev_rotation().x(), transform->prev_rotation().y(), transform->prev_rotation().z()};
-                prev_rotation = glm::normalize(prev_rotation);
-
-                interpolated_pos = glm::mix(prev_position, position, alpha);
-                interpolated_rot = glm::slerp(prev_rotation, rotation, alpha);
+                interpolated_pos = interpolatePosition(light.transform, alpha);
+                interpolated_rot = interpolateRotation(light.transform, alpha);
 
                 direction = glm::normalize(interpolated_rot * BASE_FORWARD_DIRECTION);
                 if(direction == glm::vec3{0.0f, 0.0f, 0.0f}) direction = BASE_FORWARD_DIRECTION;
@@ -203,20 +260,20 @@ namespace velora::game
 
                 // w component is used to determine the type of light
                 gpu_light.direction = glm::vec4(direction.x, direction.y, direction.z, 
-                    static_cast<float>(light_component->type()));
+                    static_cast<float>(light.type));
             }
             else
             {
                 gpu_light.position = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
                 // w component is used to determine the type of light
                 gpu_light.direction = glm::vec4(BASE_FORWARD_DIRECTION.x, BASE_FORWARD_DIRECTION.y, BASE_FORWARD_DIRECTION.z, 
-                    static_cast<float>(light_component->type()));
+                    static_cast<float>(light.type));
             }
 
-            gpu_light.color = glm::vec4(light_component->color_r(), light_component->color_g(), light_component->color_b(), light_component->intensity());
-            gpu_light.attenuation = glm::vec4(light_component->constant(), light_component->linear(), light_component->quadratic(), 0.0f);
-            gpu_light.cutoff = glm::vec2(light_component->inner_cutoff(), light_component->outer_cutoff());
-            gpu_light.castShadows.x = static_cast<uint32_t>(light_component->cast_shadows());
+            gpu_light.color = light.color;
+            gpu_light.attenuation = glm::vec4(light.attenuation, 0.0f);
+            gpu_light.cutoff = light.cutoff;
+            gpu_light.castShadows.x = static_cast<uint32_t>(light.cast_shadows);
             
             _gpu_lights.emplace_back(std::move(gpu_light));
             light_id++;
@@ -225,112 +282,636 @@ namespace velora::game
         assert(_gpu_lights.size() == light_id);
     }
 
-    asio::awaitable<void> LightSystem::renderShadows(const ComponentManager& components, const EntityManager& entities, float alpha)
+    std::optional<float> LightSystem::calculateLightReach(const GPULight & light) const
     {
-        if(!_strand.running_in_this_thread()){
-            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        if(light.direction.w == static_cast<float>(LightType::DIRECTIONAL))return std::nullopt;
+
+        // solves constant + linear * d + quadratic * d^2 = intensity * 256
+        const float constant = light.attenuation.x;
+        const float linear = light.attenuation.y;
+        const float quadratic = light.attenuation.z;
+        const float threshold = light.color.w * 256.0f - constant;
+        if(threshold <= 0.0f)return 0.0f;
+
+        if(quadratic > 0.0f)
+        {
+            return (-linear + std::sqrt(linear * linear + 4.0f * quadratic * threshold)) / (2.0f * quadratic);
+        }
+        if(linear > 0.0f)
+        {
+            return threshold / linear;
+        }
+        // no falloff, light reaches everywhere
+        return std::nullopt;
+    }
+
+    BoundingSphere LightSystem::calculateLightBounds(const GPULight & light) const
+    {
+        const std::optional<float> reach = calculateLightReach(light);
+        if(!reach)return BoundingSphere{.center = glm::vec3(light.position), .radius = std::numeric_limits<float>::infinity()};
+
+        const BoundingSphere sphere{.center = glm::vec3(light.position), .radius = *reach};
+        if(light.direction.w != static_cast<float>(LightType::SPOT))return sphere;
+
+        // smallest sphere around cone of spot light, whole sphere for cones wider than half space
+        const float cos_angle = glm::clamp(light.cutoff.y, -1.0f, 1.0f);
+        if(cos_angle <= 0.0f)return sphere;
+
+        const glm::vec3 direction = glm::normalize(glm::vec3(light.direction));
+        if(cos_angle >= glm::one_over_root_two<float>())
+        {
+            // narrow cone, sphere through apex and rim of cone base
+            const float radius = *reach / (2.0f * cos_angle);
+            return BoundingSphere{.center = sphere.center + direction * radius, .radius = radius};
         }
 
-        const float shadow_map_aspect = (float)_shadow_map_resolution.getWidth() / (float)_shadow_map_resolution.getHeight();
+        // wide cone, sphere around cone base
+        const float sin_angle = std::sqrt(1.0f - cos_angle * cos_angle);
+        return BoundingSphere{.center = sphere.center + direction * (*reach * cos_angle), .radius = *reach * sin_angle};
+    }
 
-        glm::mat4 view_matrix;
+    void LightSystem::buildLightClusters(const RenderSnapshot & snapshot)
+    {
+        _light_bounds.clear();
+        for(const GPULight & light : _gpu_lights)
+        {
+            _light_bounds.emplace_back(calculateLightBounds(light));
+        }
+
+        // without camera every light is global
+        if(snapshot.camera.valid)
+        {
+            _light_clusters->build(_light_bounds, _camera_system.getView(), _camera_system.getProjection(),
+                snapshot.camera.near_plane, snapshot.camera.far_plane);
+        }
+        else
+        {
+            _light_clusters->build(_light_bounds, glm::mat4(1.0f), glm::mat4(1.0f), 0.0f, 0.0f);
+        }
+
+        _gpu_light_set.cluster_depth_slicing = _light_clusters->getDepthSlicing();
+        _gpu_light_set.global_lights_count = static_cast<int32_t>(_light_clusters->getGlobalLightsCount());
+    }
+
+    void LightSystem::collectShadowCasters(const RenderSnapshot & snapshot)
+    {
+        // handles and world bounds resolved by visual system for the same snapshot
+        const std::vector<VisualHandles> & visual_handles = _visual_system.getVisualHandles();
+        const std::vector<BoundingSphere> & world_bounds = _visual_system.getWorldBounds();
+
+        _shadow_culler_visuals.clear();
+        for(std::size_t i = 0; i < snapshot.visuals.size(); ++i)
+        {
+            if(visual_handles[i].vertex_buffer)_shadow_culler_visuals.emplace_back(i);
+        }
+
+        // cull reports visible spheres in ascending order, so visible casters of every light stay grouped by mesh
+        std::stable_sort(_shadow_culler_visuals.begin(), _shadow_culler_visuals.end(),
+            [&visual_handles](std::size_t lhs, std::size_t rhs)
+            {
+                return *visual_handles[lhs].vertex_buffer < *visual_handles[rhs].vertex_buffer;
+            });
+
+        _shadow_culler.clear();
+        _shadow_culler.reserve(_shadow_culler_visuals.size());
+        for(const std::size_t i : _shadow_culler_visuals)
+        {
+            _shadow_culler.add(world_bounds[i]);
+        }
+    }
+
+    std::optional<glm::mat4> LightSystem::calculateLightSpaceMatrix(const GPULight & light) const
+    {
+        const glm::mat4 view_matrix = glm::lookAt(glm::vec3(light.position), glm::vec3(light.position) + glm::normalize(glm::vec3(light.direction)), BASE_UP_DIRECTION);
         glm::mat4 projection_matrix;
-        glm::mat4 light_space_matrix;
-        glm::mat4 model_matrix;
 
-        // for every light
-        uint32_t light_id = 0;
-        for (auto& light : _gpu_lights)
+        if(light.direction.w == static_cast<float>(LightType::DIRECTIONAL))
         {
-            if(light_id >= MAX_SHADOW_CASTERS)co_return;
+            // directional light
+            // TODO
+            projection_matrix = glm::ortho(-100.0f, 100.0f, -100.0f, 100.0f, 0.1f, 100.0f);
+        }
+        else if(light.direction.w == static_cast<float>(LightType::POINT))
+        {
+            // point light
+            // TODO
+            projection_matrix = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+        }
+        else if(light.direction.w == static_cast<float>(LightType::SPOT))
+        {
+            // spot light
+            float outer_cutoff_cos = light.cutoff.y;
+            outer_cutoff_cos = glm::clamp(outer_cutoff_cos, -1.0f, 1.0f);
+            float fov = glm::degrees(2.0f * acos(glm::clamp(outer_cutoff_cos, -0.999f, 0.999f)));
+            fov = glm::clamp(fov, 5.0f, 179.0f);
+            const float projection_near = 0.1f;
+            const float projection_far = 1024.0f;
+            projection_matrix = glm::perspective(glm::radians(fov), 1.0f, projection_near, projection_far);
+        }
+        else
+        {
+            // unknown light type
+            return std::nullopt;
+        }
 
-            if(!_strand.running_in_this_thread()){
-                co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        return projection_matrix * view_matrix;
+    }
+
+    float LightSystem::calculateShadowImportance(const GPULight & light, const glm::vec3 & camera_position) const
+    {
+        if(light.direction.w == static_cast<float>(LightType::DIRECTIONAL))return 2.0f;
+
+        // light without falloff reaches everywhere
+        const std::optional<float> reach = calculateLightReach(light);
+        if(!reach)return 1.0f;
+
+        // lit volume shrinks on screen roughly with distance from camera
+        const float distance = glm::length(glm::vec3(light.position) - camera_position);
+        if(distance <= *reach)return 1.0f;
+        return *reach / distance;
+    }
+
+    void LightSystem::allocateShadowTiles()
+    {
+        constexpr std::size_t ATLAS_AREA = (std::size_t)SHADOW_ATLAS_SIZE * SHADOW_ATLAS_SIZE;
+
+        std::size_t area = 0;
+        for(const ShadowPass & pass : _shadow_passes)
+        {
+            area += (std::size_t)pass.tile_size * pass.tile_size;
+        }
+
+        // halve tile of least important light until all tiles fit, smallest tiles of all lights always fit
+        while(area > ATLAS_AREA)
+        {
+            ShadowPass * least_important = nullptr;
+            for(ShadowPass & pass : _shadow_passes)
+            {
+                if(pass.tile_size <= MIN_SHADOW_TILE_SIZE)continue;
+                if(least_important == nullptr || pass.importance <= least_important->importance)least_important = &pass;
             }
+            assert(least_important != nullptr && "Smallest shadow tiles must fit into shadow atlas");
+            if(least_important == nullptr)break;
+
+            area -= (std::size_t)least_important->tile_size * least_important->tile_size * 3 / 4;
+            least_important->tile_size /= 2;
+        }
+
+        _shadow_tile_order.resize(_shadow_passes.size());
+        for(std::size_t p = 0; p < _shadow_passes.size(); ++p)_shadow_tile_order[p] = p;
 
+        // shadow casters are ordered the same way every frame, so unchanged lights keep their tiles
+        std::sort(_shadow_tile_order.begin(), _shadow_tile_order.end(),
+            [this](std::size_t lhs, std::size_t rhs)
+            {
+                const ShadowPass & l = _shadow_passes[lhs];
+                const ShadowPass & r = _shadow_passes[rhs];
+                if(l.tile_size != r.tile_size)return l.tile_size > r.tile_size;
+                return l.shadow_caster < r.shadow_caster;
+            });
+
+        // atlas is grid of smallest tiles walked in Morton order, tile of 4^k cells starts at multiple of 4^k
+        // so placing power of two tiles from largest keeps every tile square and aligned
+        uint32_t cell = 0;
+        for(const std::size_t p : _shadow_tile_order)
+        {
+            ShadowPass & pass = _shadow_passes[p];
+            const uint32_t side = pass.tile_size / MIN_SHADOW_TILE_SIZE;
+
+            pass.tile = RenderRegion{
+                .x = compactBits(cell) * MIN_SHADOW_TILE_SIZE,
+                .y = compactBits(cell >> 1) * MIN_SHADOW_TILE_SIZE,
+                .width = pass.tile_size,
+                .height = pass.tile_size
+            };
+            cell += side * side;
+        }
+    }
+
+    void LightSystem::invalidateOverlappingShadowMaps(uint32_t shadow_caster, const RenderRegion & tile, bool static_layer)
+    {
+        for(std::size_t s = 0; s < _shadow_map_caches.size(); ++s)
+        {
+            if(s == shadow_caster)continue;
+
+            ShadowMapCache & cache = _shadow_map_caches[s];
+            if(static_layer)
+            {
+                if(cache.static_layer_hash && cache.static_layer_tile.overlaps(tile))cache.static_layer_hash = std::nullopt;
+            }
+            else if(cache.valid && cache.tile.overlaps(tile))
+            {
+                cache.valid = false;
+            }
+        }
+    }
+
+    void LightSystem::appendShadowDraws(std::span<const ShadowPassCaster> casters, uint32_t shadow_caster, std::size_t fbo, const RenderRegion & tile,
+            const RenderSnapshot & snapshot, std::vector<DrawItem> & draw_list)
+    {
+        // handles and matrices resolved by visual system for the same snapshot
+        const std::vector<VisualHandles> & visual_handles = _visual_system.getVisualHandles();
+        const std::vector<glm::mat4> & model_matrices = _visual_system.getModelMatrices();
+
+        for(const ShadowPassCaster & caster : casters)
+        {
+            const MeshLODChain & lods = visual_handles[_shadow_culler_visuals[caster.caster]].lods;
+            _shadow_lod_stats.full_detail_triangles += lods.triangles[0];
+            _shadow_lod_stats.submitted_triangles += lods.triangles[caster.lod];
+            _shadow_lod_stats.instances[caster.lod]++;
+        }
+
+        if(_shadow_pass_instanced_shader)
+        {
+            // one draw per mesh, casters are already grouped by mesh
+            // draws of one caster share all inputs and are merged into single multi draw by renderer
+            uint32_t group_first = (uint32_t)_shadow_instances.size();
+            for(std::size_t c = 0; c < casters.size(); ++c)
+            {
+                const std::size_t i = _shadow_culler_visuals[casters[c].caster];
+                const std::size_t vb_id = casters[c].vertex_buffer;
+
+                _shadow_instances.emplace_back(GPUInstance{
+                    .model = model_matrices[i],
+                    .color = snapshot.visuals[i].color
+                });
+
+                const bool group_ends = c + 1 == casters.size() || casters[c + 1].vertex_buffer != vb_id;
+                if(group_ends == false)continue;
+
+                draw_list.emplace_back(DrawItem{
+                    .vertex_buffer = vb_id,
+                    .shader = *_shadow_pass_instanced_shader,
+                    .instance_count = (uint32_t)_shadow_instances.size() - group_first,
+                    .first_instance = group_first,
+                    .shader_inputs = ShaderInputs({
+                            {_SHADOW_CASTER, (int)shadow_caster}
+                        },
+                        {_shadow_instance_buffer_id}),
+                    .options = RenderOptions{
+                        .mode = RenderMode::Solid,
+                        .polygon_offset = PolygonOffset{.factor = 1.5f, .units = 4.0f},
+                        .region = tile
+                    },
+                    .fbo = fbo
+                });
+                group_first = (uint32_t)_shadow_instances.size();
+            }
+            return;
+        }
+
+        for(const ShadowPassCaster & caster : casters)
+        {
+            const std::size_t i = _shadow_culler_visuals[caster.caster];
+
+            // render depth information to tile of shadow atlas
+            // read interpolated matrix calculated by visual system
+            draw_list.emplace_back(DrawItem{
+                .vertex_buffer = caster.vertex_buffer,
+                .shader = _shadow_pass_shader,
+                .shader_inputs = ShaderInputs{
+                    {_MODEL, model_matrices[i]},
+                    {_SHADOW_CASTER, (int)shadow_caster}
+                },
+                .options = RenderOptions{
+                    .mode = RenderMode::Solid,
+                    .polygon_offset = PolygonOffset{.factor = 1.5f, .units = 4.0f},
+                    .region = tile
+                },
+                .fbo = fbo
+            });
+        }
+    }
+
+    asio::awaitable<void> LightSystem::renderShadows(const RenderSnapshot & snapshot, float alpha)
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        _shadow_cache_stats = ShadowCacheStats{};
+        _shadow_lod_stats = MeshLODStats{};
+        _frame++;
+
+        // shaders could be erased or reloaded since last frame
+        if(_renderer.getObjectGeneration() != _object_generation && resolveShadowShaders() == false)
+        {
+            _shadow_casters_count = 0;
+            _shadow_culling_stats = FrustumCuller::Stats{};
+            for(ShadowMapCache & cache : _shadow_map_caches)
+            {
+                cache.valid = false;
+                cache.static_layer_hash = std::nullopt;
+            }
+            co_await uploadLightSet(0);
+            co_return;
+        }
+
+        const glm::vec3 camera_position = interpolatePosition(snapshot.camera.transform, alpha);
+
+        const std::vector<glm::mat4> & model_matrices = _visual_system.getModelMatrices();
+        assert(model_matrices.size() == snapshot.visuals.size() && "Visual system must run with the same snapshot before light system");
+
+        collectShadowCasters(snapshot);
+        _shadow_culling_stats = FrustumCuller::Stats{};
+
+        // first pass, light space matrix, visible casters and tile size of every shadow map
+        _shadow_passes.clear();
+        _shadow_pass_casters.clear();
+
+        uint32_t light_id = 0;
+        for (std::size_t l = 0; l < _gpu_lights.size(); ++l)
+        {
+            if(light_id >= MAX_SHADOW_CASTERS)break;
+
+            GPULight & light = _gpu_lights[l];
             if(light.castShadows.x == 0)continue;
 
+            const std::optional<glm::mat4> light_space_matrix = calculateLightSpaceMatrix(light);
+            if(!light_space_matrix)break;
+
             // store shadow caster id 
             light.castShadows.y = static_cast<float>(light_id);
 
-            view_matrix = glm::lookAt(glm::vec3(light.position), glm::vec3(light.position) + glm::normalize(glm::vec3(light.direction)), BASE_UP_DIRECTION);
-            
-            if(light.direction.w == static_cast<float>(LightType::DIRECTIONAL))
+            const bool directional = light.direction.w == static_cast<float>(LightType::DIRECTIONAL);
+            ShadowPass pass{
+                .shadow_caster = light_id,
+                .light = snapshot.lights[l].entity,
+                .light_space_matrix = *light_space_matrix,
+                .distant = directional == false &&
+                    glm::length(glm::vec3(light.position) - camera_position) > _DISTANT_SHADOW_DISTANCE,
+                .importance = calculateShadowImportance(light, camera_position),
+                .casters_begin = _shadow_pass_casters.size()
+            };
+
+            // resolution follows share of screen light can affect, atlas may shrink it further
+            pass.tile_size = directional ? MAX_SHADOW_TILE_SIZE : std::clamp(
+                std::bit_ceil((uint32_t)(pass.importance * (float)MAX_LOCAL_SHADOW_TILE_SIZE)),
+                MIN_SHADOW_TILE_SIZE, MAX_LOCAL_SHADOW_TILE_SIZE);
+
+            // every entity inside of light frustum casts shadow, including entities outside of camera frustum
+            const FrustumCuller::Stats culling_stats = _shadow_culler.cull(Frustum::fromViewProjection(pass.light_space_matrix), _shadow_visible);
+            _shadow_culling_stats.visible += culling_stats.visible;
+            _shadow_culling_stats.culled += culling_stats.culled;
+
+            // stationary casters first, levels of detail are selected once tile size is known
+            for(const uint32_t visible : _shadow_visible)
+            {
+                const SnapshotVisual & visual = snapshot.visuals[_shadow_culler_visuals[visible]];
+                if(visual.has_transform == false || isStationary(visual.transform))_shadow_pass_casters.emplace_back(ShadowPassCaster{.caster = visible});
+            }
+            pass.static_casters_count = _shadow_pass_casters.size() - pass.casters_begin;
+            for(const uint32_t visible : _shadow_visible)
             {
-                // directional light
-                // TODO
-                projection_matrix = glm::ortho(-100.0f, 100.0f, -100.0f, 100.0f, 0.1f, 100.0f);
+                const SnapshotVisual & visual = snapshot.visuals[_shadow_culler_visuals[visible]];
+                if(visual.has_transform && isStationary(visual.transform) == false)_shadow_pass_casters.emplace_back(ShadowPassCaster{.caster = visible});
             }
-            else if(light.direction.w == static_cast<float>(LightType::POINT))
+            pass.casters_count = _shadow_pass_casters.size() - pass.casters_begin;
+
+            _shadow_passes.emplace_back(std::move(pass));
+            light_id++;
+        }
+
+        allocateShadowTiles();
+
+        const std::vector<VisualHandles> & visual_handles = _visual_system.getVisualHandles();
+        const std::vector<BoundingSphere> & world_bounds = _visual_system.getWorldBounds();
+
+        // content hash of every shadow map, moved tile needs map rendered again even when nothing else changed
+        for(ShadowPass & pass : _shadow_passes)
+        {
+            // casters smaller in tile draw coarser meshes, selected level is part of content hash
+            const auto casters_begin = _shadow_pass_casters.begin() + pass.casters_begin;
+            for(auto it = casters_begin; it != casters_begin + pass.casters_count; ++it)
             {
-                // point light
-                // TODO
-                projection_matrix = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+                const std::size_t i = _shadow_culler_visuals[it->caster];
+                const MeshLODChain & lods = visual_handles[i].lods;
+                it->lod = _shadow_lod_selector.select((uint64_t)pass.light << 32 | snapshot.visuals[i].entity,
+                    LODSelector::projectedDiameter(world_bounds[i], pass.light_space_matrix, (float)pass.tile.height), lods.count);
+                it->vertex_buffer = lods.count > 0 ? lods.vertex_buffers[it->lod] : *visual_handles[i].vertex_buffer;
             }
-            else if(light.direction.w == static_cast<float>(LightType::SPOT))
+
+            // both ranges sorted by selected mesh so draws of the same mesh stay consecutive
+            const auto by_mesh = [](const ShadowPassCaster & lhs, const ShadowPassCaster & rhs)
             {
-                // spot light
-                float outer_cutoff_cos = light.cutoff.y;
-                outer_cutoff_cos = glm::clamp(outer_cutoff_cos, -1.0f, 1.0f);
-                float fov = glm::degrees(2.0f * acos(glm::clamp(outer_cutoff_cos, -0.999f, 0.999f)));
-                fov = glm::clamp(fov, 5.0f, 179.0f);
-                const float projection_near = 0.1f;
-                const float projection_far = 1024.0f;
-                projection_matrix = glm::perspective(glm::radians(fov), shadow_map_aspect, projection_near, projection_far);
+                return lhs.vertex_buffer != rhs.vertex_buffer ? lhs.vertex_buffer < rhs.vertex_buffer : lhs.caster < rhs.caster;
+            };
+            std::sort(casters_begin, casters_begin + pass.static_casters_count, by_mesh);
+            std::sort(casters_begin + pass.static_casters_count, casters_begin + pass.casters_count, by_mesh);
+
+            // reloaded meshes or shaders change draws without changing any transform
+            uint64_t hash = hashValue(_SHADOW_HASH_SEED, _object_generation);
+            hash = hashValue(hash, pass.light);
+            hash = hashValue(hash, pass.light_space_matrix);
+            hash = hashValue(hash, pass.tile);
+            for(std::size_t c = pass.casters_begin; c < pass.casters_begin + pass.casters_count; ++c)
+            {
+                if(c == pass.casters_begin + pass.static_casters_count)pass.static_hash = hash;
+
+                const std::size_t i = _shadow_culler_visuals[_shadow_pass_casters[c].caster];
+                hash = hashValue(hash, snapshot.visuals[i].entity);
+                hash = hashValue(hash, _shadow_pass_casters[c].vertex_buffer);
+                hash = hashValue(hash, model_matrices[i]);
             }
-            else
+            if(pass.static_casters_count == pass.casters_count)pass.static_hash = hash;
+            pass.content_hash = hash;
+
+            const ShadowMapCache & cache = _shadow_map_caches[pass.shadow_caster];
+            pass.update = cache.valid == false || cache.content_hash != pass.content_hash;
+        }
+        _shadow_lod_selector.endFrame();
+
+        // out of date maps of distant lights share update budget, longest waiting first
+        // map of light seen for the first time in its slot or moved to another tile is always rendered
+        _distant_shadow_passes.clear();
+        for(std::size_t p = 0; p < _shadow_passes.size(); ++p)
+        {
+            const ShadowPass & pass = _shadow_passes[p];
+            const ShadowMapCache & cache = _shadow_map_caches[pass.shadow_caster];
+            if(pass.update && pass.distant && cache.valid && cache.light == pass.light && cache.tile == pass.tile)_distant_shadow_passes.emplace_back(p);
+        }
+        if(_distant_shadow_passes.size() > _DISTANT_SHADOW_UPDATES_PER_FRAME)
+        {
+            std::stable_sort(_distant_shadow_passes.begin(), _distant_shadow_passes.end(),
+                [this](std::size_t lhs, std::size_t rhs)
+                {
+                    return _shadow_map_caches[_shadow_passes[lhs].shadow_caster].updated_frame <
+                        _shadow_map_caches[_shadow_passes[rhs].shadow_caster].updated_frame;
+                });
+            for(std::size_t d = _DISTANT_SHADOW_UPDATES_PER_FRAME; d < _distant_shadow_passes.size(); ++d)
             {
-                // unknown light type
-                co_return;
+                _shadow_passes[_distant_shadow_passes[d]].update = false;
+                _shadow_cache_stats.deferred++;
             }
+        }
 
-            light_space_matrix = projection_matrix * view_matrix;
-            // store light space matrix
-            _shadow_map_light_space_matrices[light_id] = light_space_matrix;
+        // second pass, draws of shadow maps that changed
+        // draws of all shadow maps are submitted together after every tile is cleared
+        _shadow_draw_list.clear();
+        _shadow_static_draw_list.clear();
+        _shadow_instances.clear();
+        _shadow_static_clear_tiles.clear();
+        _shadow_clear_tiles.clear();
+        _shadow_copy_tiles.clear();
 
-            // clear shadow map fbo
-            co_await _renderer.clearScreen({0.0f, 0.0f, 0.0f, 1.0f}, _shadow_map_fbos.at(light_id));
+        for(ShadowPass & pass : _shadow_passes)
+        {
+            ShadowMapCache & cache = _shadow_map_caches[pass.shadow_caster];
 
-            // now for every light we need to render whole scene 
-            // so all entities with visual component
-            // using simplified shadow shader
-            for(const auto & [entity, mask] : entities.getAllEntities())
+            if(pass.update == false)
             {
+                // lighting pass samples kept map with matrix and tile it was rendered with
+                _shadow_map_light_space_matrices[pass.shadow_caster] = cache.light_space_matrix;
+                _shadow_map_tiles[pass.shadow_caster] = cache.tile;
+                if(cache.content_hash == pass.content_hash)_shadow_cache_stats.cached++;
+                continue;
+            }
+
+            // store light space matrix and tile, shadow and lighting passes read them from light set block
+            _shadow_map_light_space_matrices[pass.shadow_caster] = pass.light_space_matrix;
+            _shadow_map_tiles[pass.shadow_caster] = pass.tile;
+            _shadow_cache_stats.rendered++;
+
+            const std::span<const ShadowPassCaster> casters(_shadow_pass_casters.data() + pass.casters_begin, pass.casters_count);
+            const std::span<const ShadowPassCaster> static_casters = casters.first(pass.static_casters_count);
+            const std::span<const ShadowPassCaster> dynamic_casters = casters.subspan(pass.static_casters_count);
+
+            // static layer pays off once moving casters force map to be rendered while stationary ones stay
+            const bool static_layer_current = _shadow_static_atlas_fbo && cache.static_layer_hash == pass.static_hash;
+            pass.copy_static_layer = static_casters.empty() == false && (dynamic_casters.empty() == false || static_layer_current);
+
+            if(pass.copy_static_layer && !_shadow_static_atlas_fbo)
+            {
+                _shadow_static_atlas_fbo = co_await _renderer.constructFrameBufferObject(
+                    "LightSystem::fbo::shadow_atlas_static", Resolution{SHADOW_ATLAS_SIZE, SHADOW_ATLAS_SIZE},
+                    {{FBOAttachment::Type::Texture, FBOAttachment::Point::Depth, TextureFormat::Depth_32F}});
+
                 if(!_strand.running_in_this_thread()){
                     co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
                 }
 
-                if(mask.test(VisualSystem::MASK_POSITION_BIT) == false)continue;
+                if(!_shadow_static_atlas_fbo)
+                {
+                    spdlog::warn("Failed to create static shadow atlas, drawing every caster of shadow map {}", pass.shadow_caster);
+                    pass.copy_static_layer = false;
+                }
+            }
 
-                const VisualComponent * visual_component = components.getComponent<VisualComponent>(entity);
-                assert(visual_component != nullptr);
+            if(pass.copy_static_layer)
+            {
+                if(cache.static_layer_hash != pass.static_hash)
+                {
+                    invalidateOverlappingShadowMaps(pass.shadow_caster, pass.tile, true);
+                    _shadow_static_clear_tiles.emplace_back(pass.tile);
+                    appendShadowDraws(static_casters, pass.shadow_caster, *_shadow_static_atlas_fbo, pass.tile, snapshot, _shadow_static_draw_list);
+                    cache.static_layer_hash = pass.static_hash;
+                    cache.static_layer_tile = pass.tile;
+                    _shadow_cache_stats.static_layer_updates++;
+                }
+                else
+                {
+                    _shadow_cache_stats.static_layer_reuses++;
+                }
 
-                if(visual_component->visible() == false)continue;
+                // copy of static layer replaces clear of tile
+                _shadow_copy_tiles.emplace_back(pass.tile);
+                appendShadowDraws(dynamic_casters, pass.shadow_caster, _shadow_atlas_fbo, pass.tile, snapshot, _shadow_draw_list);
+            }
+            else
+            {
+                // clear only tile of shadow atlas, other tiles may hold cached maps
+                _shadow_clear_tiles.emplace_back(pass.tile);
+                appendShadowDraws(casters, pass.shadow_caster, _shadow_atlas_fbo, pass.tile, snapshot, _shadow_draw_list);
+            }
 
-                const auto vb_id = _renderer.getVertexBuffer(visual_component->vertex_buffer_name());
-                if(!vb_id)continue;
+            invalidateOverlappingShadowMaps(pass.shadow_caster, pass.tile, false);
+            cache.valid = true;
+            cache.light = pass.light;
+            cache.content_hash = pass.content_hash;
+            cache.light_space_matrix = pass.light_space_matrix;
+            cache.tile = pass.tile;
+            cache.updated_frame = _frame;
+        }
 
-                // read interpolated matrix from visual component
-                model_matrix = loadModelMatrixField(visual_component);
+        // light space matrices and tiles must be on GPU before shadow passes read them
+        co_await uploadLightSet(light_id);
 
-                // render depth information to shadow map fbo
-                co_await _renderer.render(*vb_id, _shadow_pass_shader, 
-                    ShaderInputs{
-                        .in_mat4 = {
-                            {"uModel", model_matrix},
-                            {"uLightSpaceMatrix", light_space_matrix}
-                        }
-                    },
-                    RenderOptions{
-                        .mode = RenderMode::Solid,
-                        .polygon_offset = PolygonOffset{.factor = 1.5f, .units = 4.0f}
-                    },
-                    _shadow_map_fbos.at(light_id)
-                );
+        if(_shadow_instances.empty() == false)
+        {
+            co_await _renderer.updateShaderStorageBuffer(_shadow_instance_buffer_id, sizeof(GPUInstance) * _shadow_instances.size(), _shadow_instances.data());
+
+            if(!_strand.running_in_this_thread()){
+                co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
             }
+        }
 
-            light_id++;
+        // static layers are complete before they are copied into shadow atlas
+        if(_shadow_static_clear_tiles.empty() == false)
+        {
+            co_await _renderer.clearScreenRegions({0.0f, 0.0f, 0.0f, 1.0f}, *_shadow_static_atlas_fbo, _shadow_static_clear_tiles);
+
+            if(!_strand.running_in_this_thread()){
+                co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+            }
+        }
+
+        if(_shadow_static_draw_list.empty() == false)
+        {
+            co_await _renderer.submit(_shadow_static_draw_list);
+
+            if(!_strand.running_in_this_thread()){
+                co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+            }
+        }
+
+        if(_shadow_copy_tiles.empty() == false)
+        {
+            co_await _renderer.copyFrameBufferObjectDepthRegions(*_shadow_static_atlas_fbo, _shadow_atlas_fbo, _shadow_copy_tiles);
+
+            if(!_strand.running_in_this_thread()){
+                co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+            }
+        }
+
+        if(_shadow_clear_tiles.empty() == false)
+        {
+            co_await _renderer.clearScreenRegions({0.0f, 0.0f, 0.0f, 1.0f}, _shadow_atlas_fbo, _shadow_clear_tiles);
+
+            if(!_strand.running_in_this_thread()){
+                co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+            }
         }
+
+        // all shadow passes with single hop onto render thread
+        co_await _renderer.submit(_shadow_draw_list);
+
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
         _shadow_casters_count = light_id;
     }
-}
\ No newline at end of file
+
+    asio::awaitable<void> LightSystem::uploadLightSet(uint32_t shadow_casters_count)
+    {
+        _gpu_light_set.light_count = static_cast<int32_t>(_gpu_lights.size());
+        _gpu_light_set.shadow_casters_count = static_cast<int32_t>(shadow_casters_count);
+        std::copy_n(_shadow_map_light_space_matrices.begin(), shadow_casters_count, _gpu_light_set.light_space_matrices);
+
+        // tiles in texture coordinates of shadow atlas
+        constexpr float atlas_size = (float)SHADOW_ATLAS_SIZE;
+        for(uint32_t i = 0; i < shadow_casters_count; ++i)
+        {
+            const RenderRegion & tile = _shadow_map_tiles[i];
+            _gpu_light_set.shadow_tiles[i] = glm::vec4(
+                (float)tile.x / atlas_size, (float)tile.y / atlas_size,
+                (float)tile.width / atlas_size, (float)tile.height / atlas_size);
+        }
+
+        co_await _renderer.updateUniformBuffer(_light_set_uniform_buffer_id, sizeof(GPULightSet), &_gpu_light_set);
+
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+    }
+}
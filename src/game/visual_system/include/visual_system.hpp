@@ -4,6 +4,9 @@
 #include <asio.hpp>
 #include <asio/experimental/awaitable_operators.hpp>
 using namespace asio::experimental::awaitable_operators;
+#include <spdlog/spdlog.h>
+
+#include <absl/container/flat_hash_map.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -12,14 +15,49 @@ using namespace asio::experimental::awaitable_operators;
 
 #include "ecs.hpp"
 #include "render.hpp"
+#include "render_queue.hpp"
 
 #include "camera_system.hpp"
 #include "transform_system.hpp"
+#include "render_snapshot.hpp"
 
 #include "visual_component.pb.h"
 
 namespace velora::game
 {
+    // std430 layout of Instance in instanced glsl shaders
+    #pragma pack(push, 1)
+    struct GPUInstance {
+        glm::mat4 model;
+        glm::vec4 color;
+    };
+    #pragma pack(pop)
+
+    /**
+     * @brief Consecutive range of instance buffer drawn with the same mesh and shader.
+     * Drawn with `DrawItem::first_instance` = `first`, instanced shaders read `instances[aInstance]`.
+     */
+    struct InstanceGroup
+    {
+        std::size_t vertex_buffer = 0;
+        std::size_t shader = 0;
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    /**
+     * @brief Renderer objects of visual, resolved from names of its component
+     */
+    struct VisualHandles
+    {
+        std::optional<std::size_t> vertex_buffer;
+        std::optional<std::size_t> shader;
+        // local space bounds of mesh, empty when vertex buffer is missing
+        MeshBounds bounds;
+        // levels of detail of mesh, first level is vertex_buffer, empty when vertex buffer is missing
+        MeshLODChain lods;
+    };
+
     class VisualSystem
     {
         public:
@@ -29,6 +67,12 @@ namespace velora::game
             constexpr static inline const char * getName() { return NAME; }
 
             constexpr static const std::initializer_list<const char *> DEPS = {"TransformSystem", "CameraSystem"};
+
+            // binding point of instance buffer in instanced shaders
+            constexpr static const unsigned int INSTANCE_BUFFER_BINDING = 3;
+
+            // suffix of instanced variant of shader, eg. deferred_shader_instanced
+            constexpr static const char * INSTANCED_SHADER_SUFFIX = "_instanced";
             constexpr static inline const std::initializer_list<const char *> & getDependencies() {return DEPS;}
 
             VisualSystem(const VisualSystem&) = delete;
@@ -43,19 +87,68 @@ namespace velora::game
                 Resolution resolution,
                 game::CameraSystem & camera_system);
 
-            // interpolated run
-            asio::awaitable<void> run(ComponentManager& components, EntityManager& entities, float alpha);
+            // interpolated run, reads visible entities from render snapshot
+            asio::awaitable<void> run(const RenderSnapshot & snapshot, float alpha);
 
             IRenderer & getRenderer() const;
 
             const std::vector<std::size_t> & getDeferredFBOTextures() const;
 
+            /**
+             * @brief Interpolated model matrices from last run.
+             * Indexed the same way as visuals of snapshot passed to run.
+             */
+            const std::vector<glm::mat4> & getModelMatrices() const;
+
+            /**
+             * @brief Instance groups of last run, in draw order.
+             * Every entity inside camera frustum with existing mesh and shader belongs to exactly one group.
+             */
+            const std::vector<InstanceGroup> & getInstanceGroups() const;
+
+            // shader storage buffer with GPUInstance of every instance group
+            std::size_t getInstanceBufferID() const;
+
+            /**
+             * @brief Renderer objects of visuals from last run.
+             * Indexed the same way as visuals of snapshot passed to run.
+             */
+            const std::vector<VisualHandles> & getVisualHandles() const;
+
+            /**
+             * @brief World space bounding spheres of visuals from last run.
+             * Indexed the same way as visuals of snapshot passed to run.
+             */
+            const std::vector<BoundingSphere> & getWorldBounds() const;
+
+            // visuals with mesh and shader tested against camera frustum in last run
+            FrustumCuller::Stats getCullingStats() const;
+
+            // triangles of G Buffer draws in last run, with and without level of detail selection
+            MeshLODStats getLODStats() const;
+
         protected:
             VisualSystem(asio::io_context & io_context,
                 IRenderer & renderer,
                 game::CameraSystem & camera_system,
+                std::size_t instance_buffer_id,
                 std::optional<std::size_t> fbo = std::nullopt);
 
+            // builds instance groups from sorted render queue and uploads instance buffer
+            asio::awaitable<void> buildInstanceGroups(const RenderSnapshot & snapshot);
+
+            // instanced variant of shader, looked up once per shader
+            std::optional<std::size_t> getInstancedShader(std::size_t shader, const std::string & shader_name);
+
+            // vertex buffers of lower levels of detail named by getMeshLODName, looked up once per mesh
+            const MeshLODChain & getLODChain(std::size_t vertex_buffer, const std::string & vertex_buffer_name);
+
+            /**
+             * @brief Handles of visual from cache, names are resolved only when
+             * entity is seen for the first time, its names changed or renderer objects changed.
+             */
+            const VisualHandles & resolveVisualHandles(const SnapshotVisual & visual);
+
         private:
             asio::strand<asio::io_context::executor_type> _strand;
 
@@ -64,5 +157,64 @@ namespace velora::game
 
             std::optional<std::size_t> _deferred_fbo;
             std::vector<std::size_t> _deferred_fbo_textures;
+
+            std::vector<glm::mat4> _model_matrices;
+            std::vector<VisualHandles> _visual_handles;
+            std::vector<BoundingSphere> _world_bounds;
+
+            // camera frustum culling, spheres of drawable visuals only
+            FrustumCuller _culler;
+            // index of snapshot visual of every culler sphere
+            std::vector<std::size_t> _culler_visuals;
+            // culler spheres inside camera frustum
+            std::vector<uint32_t> _visible;
+            FrustumCuller::Stats _culling_stats;
+
+            struct CachedVisualHandles
+            {
+                std::string vertex_buffer_name;
+                std::string shader_name;
+                VisualHandles handles;
+            };
+
+            // resolved handles per entity, valid for single renderer object generation
+            absl::flat_hash_map<Entity, CachedVisualHandles> _visual_handles_cache;
+            uint64_t _object_generation = 0;
+
+            // G Buffer draws of current frame, sorted by shader, mesh and front to back
+            RenderQueue _render_queue;
+            // index of snapshot visual of every pushed draw item
+            std::vector<std::size_t> _draw_visuals;
+            // draws submitted to renderer, reused between frames
+            std::vector<DrawItem> _draw_list;
+
+            std::size_t _instance_buffer_id;
+            std::vector<GPUInstance> _instances;
+            std::vector<InstanceGroup> _instance_groups;
+
+            // shader -> its instanced variant, nullopt when shader has none
+            absl::flat_hash_map<std::size_t, std::optional<std::size_t>> _instanced_shaders;
+
+            // full detail vertex buffer -> its levels of detail
+            absl::flat_hash_map<std::size_t, MeshLODChain> _lod_chains;
+            // level of every entity from its projected size on camera viewport
+            LODSelector _lod_selector{_LOD_THRESHOLDS, _LOD_HYSTERESIS};
+            MeshLODStats _lod_stats;
+
+            // order of G Buffer in frame for sort keys, shadow maps use lower targets
+            constexpr static const uint32_t _RENDER_TARGET = 1;
+
+            // handles cache is never pruned below this size
+            constexpr static const std::size_t _MIN_VISUAL_HANDLES_CACHE = 1024;
+
+            // projected diameters in pixels where meshes switch to coarser level
+            constexpr static const LODSelector::Thresholds _LOD_THRESHOLDS = {256.0f, 96.0f, 32.0f};
+            constexpr static const float _LOD_HYSTERESIS = 0.15f;
+
+            // G Buffer shader uniforms, interned once
+            // view and projection are read from frame uniform block uploaded by camera system
+            inline static const ShaderUniform _USE_TEXTURE{"useTexture"};
+            inline static const ShaderUniform _COLOR{"uColor"};
+            inline static const ShaderUniform _MODEL{"uModel"};
     };
 }
\ No newline at end of file
@@ -4,55 +4,6 @@ namespace velora::game
 {
     const uint32_t VisualSystem::MASK_POSITION_BIT = ComponentTypeManager::getTypeID<VisualComponent>();
 
-    void updateModelMatrixField(VisualComponent * visual_component, glm::mat4 model_matrix)
-    {
-        if(visual_component->has_model_matrix())
-        {
-            // save interpolated matrix in visual component
-            visual_component->mutable_model_matrix()->set_data(0, model_matrix[0][0]);
-            visual_component->mutable_model_matrix()->set_data(1, model_matrix[0][1]);
-            visual_component->mutable_model_matrix()->set_data(2, model_matrix[0][2]);
-            visual_component->mutable_model_matrix()->set_data(3, model_matrix[0][3]);
-
-            visual_component->mutable_model_matrix()->set_data(4, model_matrix[1][0]);
-            visual_component->mutable_model_matrix()->set_data(5, model_matrix[1][1]);
-            visual_component->mutable_model_matrix()->set_data(6, model_matrix[1][2]);
-            visual_component->mutable_model_matrix()->set_data(7, model_matrix[1][3]);     
-
-            visual_component->mutable_model_matrix()->set_data(8, model_matrix[2][0]);
-            visual_component->mutable_model_matrix()->set_data(9, model_matrix[2][1]);
-            visual_component->mutable_model_matrix()->set_data(10, model_matrix[2][2]);
-            visual_component->mutable_model_matrix()->set_data(11, model_matrix[2][3]);  
-
-            visual_component->mutable_model_matrix()->set_data(12, model_matrix[3][0]);
-            visual_component->mutable_model_matrix()->set_data(13, model_matrix[3][1]);
-            visual_component->mutable_model_matrix()->set_data(14, model_matrix[3][2]);
-            visual_component->mutable_model_matrix()->set_data(15, model_matrix[3][3]);
-        }
-        else
-        {
-            visual_component->mutable_model_matrix()->add_data( model_matrix[0][0]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[0][1]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[0][2]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[0][3]);
-
-            visual_component->mutable_model_matrix()->add_data(model_matrix[1][0]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[1][1]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[1][2]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[1][3]);     
-
-            visual_component->mutable_model_matrix()->add_data(model_matrix[2][0]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[2][1]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[2][2]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[2][3]);  
-
-            visual_component->mutable_model_matrix()->add_data(model_matrix[3][0]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[3][1]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[3][2]);
-            visual_component->mutable_model_matrix()->add_data(model_matrix[3][3]);  
-        }
-    }
-
     asio::awaitable<VisualSystem> VisualSystem::asyncConstructor(
                 asio::io_context & io_context,
                 IRenderer & renderer,
@@ -73,18 +24,30 @@ namespace velora::game
         {
             throw std::runtime_error("Failed to create visual system fbo");
         }
-        co_return VisualSystem(io_context, renderer, camera_system, *fbo);
+
+        // binding point 3 in instanced shaders
+        auto instance_buffer = co_await renderer.constructShaderStorageBuffer(
+                "VisualSystem::ssbo::instances", INSTANCE_BUFFER_BINDING, 0, nullptr);
+
+        if(!instance_buffer)
+        {
+            spdlog::error("Failed to create instance shader storage buffer");
+            throw std::runtime_error("Failed to create instance shader storage buffer");
+        }
+        co_return VisualSystem(io_context, renderer, camera_system, *instance_buffer, *fbo);
     }
 
     VisualSystem::VisualSystem(asio::io_context & io_context,
                     IRenderer & renderer,
                     game::CameraSystem & camera_system,
+                    std::size_t instance_buffer_id,
                     std::optional<std::size_t> fbo
         )
         :   _strand(asio::make_strand(io_context)),
             _renderer(renderer),
             _camera_system(camera_system),
-            _deferred_fbo(std::move(fbo))
+            _deferred_fbo(std::move(fbo)),
+            _instance_buffer_id(instance_buffer_id)
     {
         _deferred_fbo_textures = _renderer.getFrameBufferObjectTextures(*_deferred_fbo);
     }
@@ -99,7 +62,136 @@ namespace velora::game
         return _deferred_fbo_textures;
     }
 
-    asio::awaitable<void> VisualSystem::run(ComponentManager& components, EntityManager& entities, float alpha)
+    const std::vector<glm::mat4> & VisualSystem::getModelMatrices() const
+    {
+        return _model_matrices;
+    }
+
+    const std::vector<InstanceGroup> & VisualSystem::getInstanceGroups() const
+    {
+        return _instance_groups;
+    }
+
+    std::size_t VisualSystem::getInstanceBufferID() const
+    {
+        return _instance_buffer_id;
+    }
+
+    const std::vector<VisualHandles> & VisualSystem::getVisualHandles() const
+    {
+        return _visual_handles;
+    }
+
+    const std::vector<BoundingSphere> & VisualSystem::getWorldBounds() const
+    {
+        return _world_bounds;
+    }
+
+    FrustumCuller::Stats VisualSystem::getCullingStats() const
+    {
+        return _culling_stats;
+    }
+
+    MeshLODStats VisualSystem::getLODStats() const
+    {
+        return _lod_stats;
+    }
+
+    const VisualHandles & VisualSystem::resolveVisualHandles(const SnapshotVisual & visual)
+    {
+        auto [it, inserted] = _visual_handles_cache.try_emplace(visual.entity);
+        CachedVisualHandles & cached = it->second;
+
+        if(inserted == false &&
+            cached.vertex_buffer_name == visual.vertex_buffer_name &&
+            cached.shader_name == visual.shader_name)
+        {
+            return cached.handles;
+        }
+
+        // entity is new or its component changed, lookups warn about missing names only here
+        cached.vertex_buffer_name = visual.vertex_buffer_name;
+        cached.shader_name = visual.shader_name;
+        cached.handles = VisualHandles{
+            .vertex_buffer = _renderer.getVertexBuffer(visual.vertex_buffer_name),
+            .shader = _renderer.getShader(visual.shader_name)
+        };
+        if(cached.handles.vertex_buffer)
+        {
+            cached.handles.bounds = _renderer.getVertexBufferBounds(*cached.handles.vertex_buffer).value_or(MeshBounds{});
+            cached.handles.lods = getLODChain(*cached.handles.vertex_buffer, visual.vertex_buffer_name);
+        }
+        return cached.handles;
+    }
+
+    std::optional<std::size_t> VisualSystem::getInstancedShader(std::size_t shader, const std::string & shader_name)
+    {
+        auto it = _instanced_shaders.find(shader);
+        if(it != _instanced_shaders.end())return it->second;
+
+        const auto instanced_shader = _renderer.getShader(shader_name + INSTANCED_SHADER_SUFFIX);
+        _instanced_shaders.try_emplace(shader, instanced_shader);
+        return instanced_shader;
+    }
+
+    const MeshLODChain & VisualSystem::getLODChain(std::size_t vertex_buffer, const std::string & vertex_buffer_name)
+    {
+        auto [it, inserted] = _lod_chains.try_emplace(vertex_buffer);
+        MeshLODChain & chain = it->second;
+        if(inserted == false)return chain;
+
+        chain.vertex_buffers[0] = vertex_buffer;
+        chain.triangles[0] = (uint32_t)(_renderer.getVertexBufferElementCount(vertex_buffer).value_or(0) / 3);
+        chain.count = 1;
+
+        // levels are consecutive, first missing one ends chain
+        for(uint32_t level = 1; level < MAX_MESH_LODS; ++level)
+        {
+            const auto lod = _renderer.getVertexBuffer(getMeshLODName(vertex_buffer_name, level));
+            if(!lod)break;
+
+            chain.vertex_buffers[level] = *lod;
+            chain.triangles[level] = (uint32_t)(_renderer.getVertexBufferElementCount(*lod).value_or(0) / 3);
+            chain.count++;
+        }
+        return chain;
+    }
+
+    asio::awaitable<void> VisualSystem::buildInstanceGroups(const RenderSnapshot & snapshot)
+    {
+        _instances.clear();
+        _instance_groups.clear();
+        _instances.reserve(_render_queue.size());
+
+        // queue is sorted by shader and mesh first, so draws sharing both are already consecutive
+        for(std::size_t i = 0; i < _render_queue.size(); ++i)
+        {
+            const DrawItem & item = _render_queue[i];
+            const std::size_t visual_index = _draw_visuals[_render_queue.getPushIndex(i)];
+
+            _instances.emplace_back(GPUInstance{
+                .model = _model_matrices[visual_index],
+                .color = snapshot.visuals[visual_index].color
+            });
+
+            if(_instance_groups.empty() ||
+                _instance_groups.back().vertex_buffer != item.vertex_buffer ||
+                _instance_groups.back().shader != item.shader)
+            {
+                _instance_groups.emplace_back(InstanceGroup{
+                    .vertex_buffer = item.vertex_buffer,
+                    .shader = item.shader,
+                    .first = (uint32_t)i
+                });
+            }
+            _instance_groups.back().count++;
+        }
+
+        co_await _renderer.updateShaderStorageBuffer(_instance_buffer_id, sizeof(GPUInstance) * _instances.size(), _instances.data());
+        co_return;
+    }
+
+    asio::awaitable<void> VisualSystem::run(const RenderSnapshot & snapshot, float alpha)
     {
         if(_renderer.good() == false)co_return;
 
@@ -112,79 +204,151 @@ namespace velora::game
 
         // get camera system state
         const glm::vec3 & view_position = _camera_system.getPosition();
-        const glm::mat4 & view_matrix = _camera_system.getView();
-        const glm::mat4 & proj_matrix = _camera_system.getProjection();
-
-        VisualComponent * visual_component = nullptr;
-                
-        glm::mat4 model_matrix = glm::mat4(1.0f);
-        glm::vec4 color = glm::vec4(0.5, 0.5, 0.5, 1);
-        for (const auto& [entity, mask] : entities.getAllEntities())
+        const glm::mat4 view_projection = _camera_system.getProjection() * _camera_system.getView();
+        const Frustum frustum = Frustum::fromViewProjection(view_projection);
+        const float viewport_height = (float)_renderer.getViewport().getHeight();
+
+        // erased or reloaded renderer objects invalidate every resolved handle
+        const uint64_t object_generation = _renderer.getObjectGeneration();
+        if(object_generation != _object_generation)
         {
-            if(!_strand.running_in_this_thread()){
-                co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
-            }
+            _visual_handles_cache.clear();
+            _instanced_shaders.clear();
+            _lod_chains.clear();
+            _object_generation = object_generation;
+        }
+
+        // drop entities that are no longer visible once cache grows well past visible count
+        if(_visual_handles_cache.size() > 2 * snapshot.visuals.size() + _MIN_VISUAL_HANDLES_CACHE)
+        {
+            _visual_handles_cache.clear();
+        }
+
+        // snapshot contains only visible entities
+        _model_matrices.resize(snapshot.visuals.size());
+        _visual_handles.resize(snapshot.visuals.size());
+        _world_bounds.resize(snapshot.visuals.size());
 
-            if (mask.test(MASK_POSITION_BIT) == false) continue;
+        _culler.clear();
+        _culler.reserve(snapshot.visuals.size());
+        _culler_visuals.clear();
 
-            visual_component = components.getComponent<VisualComponent>(entity);
-            assert(visual_component != nullptr);
-                    
-            // if not visible, skip
-            if(visual_component->visible() == false) continue;
+        for (std::size_t i = 0; i < snapshot.visuals.size(); ++i)
+        {
+            const SnapshotVisual & visual = snapshot.visuals[i];
+
+            // if no transform component, use identity matrix
+            // otherwise interpolate between previous and current transform
+            _model_matrices[i] = visual.has_transform ? 
+                calculateInterpolatedTransformMatrix(visual.transform, alpha) : glm::mat4(1.0f);
             
-            const auto vb_id = _renderer.getVertexBuffer(visual_component->vertex_buffer_name());
-            const auto sh_id = _renderer.getShader(visual_component->shader_name());
+            _visual_handles[i] = resolveVisualHandles(visual);
+            _world_bounds[i] = transformBoundingSphere(_visual_handles[i].bounds.sphere, _model_matrices[i]);
 
-            if (!vb_id || !sh_id)
+            if (!_visual_handles[i].vertex_buffer || !_visual_handles[i].shader)
             {
                 // if cannot find vertex buffer or shader, skip
                 continue;
             }
 
-            // if also has a transform component
-            // update transform matrix
-            if(mask.test(TransformSystem::MASK_POSITION_BIT))
-            {
-                auto* transform_component = components.getComponent<TransformComponent>(entity);
-                assert(transform_component != nullptr);
+            _culler.add(_world_bounds[i]);
+            _culler_visuals.emplace_back(i);
+        }
 
-                // get model matrix from transform component
-                model_matrix = calculateInterpolatedTransformMatrix(*transform_component, alpha); 
-            }
-            else 
-            {
-                // if no transform component, use identity matrix
-                model_matrix = glm::mat4(1.0f);
-            }
+        // only visuals inside camera frustum are drawn into G Buffer
+        _culling_stats = _culler.cull(frustum, _visible);
+
+        _render_queue.clear();
+        _render_queue.reserve(_visible.size());
+        _draw_visuals.clear();
+        _lod_stats = MeshLODStats{};
+
+        for(const uint32_t visible : _visible)
+        {
+            const std::size_t i = _culler_visuals[visible];
+            const SnapshotVisual & visual = snapshot.visuals[i];
+            const std::size_t sh_id = *_visual_handles[i].shader;
+
+            // smaller on screen draws coarser mesh, instances of one level still group together
+            const MeshLODChain & lods = _visual_handles[i].lods;
+            const uint32_t lod = _lod_selector.select(visual.entity,
+                LODSelector::projectedDiameter(_world_bounds[i], view_projection, viewport_height), lods.count);
+            const std::size_t vb_id = lods.count > 0 ? lods.vertex_buffers[lod] : *_visual_handles[i].vertex_buffer;
+
+            _lod_stats.full_detail_triangles += lods.triangles[0];
+            _lod_stats.submitted_triangles += lods.triangles[lod];
+            _lod_stats.instances[lod]++;
 
-            updateModelMatrixField(visual_component, model_matrix);
+            const float view_distance = glm::length(glm::vec3(_model_matrices[i][3]) - view_position);
 
-            // get color from visual component
-            if(visual_component->has_color())
+            // instanced shaders read model and color from instance buffer,
+            // only draws without instanced variant need their own uniforms
+            const bool instanced = getInstancedShader(sh_id, visual.shader_name).has_value();
+
+            // render into deferred_fbo (G Buffer)
+            _render_queue.push(DrawItem{
+                .key = RenderSortKey::make(_RENDER_TARGET, RenderPass::Opaque, sh_id, 0, vb_id,
+                    RenderSortKey::quantizeDepth(view_distance, snapshot.camera.near_plane, snapshot.camera.far_plane, RenderPass::Opaque)),
+                .vertex_buffer = vb_id,
+                .shader = sh_id,
+                .shader_inputs = instanced ? ShaderInputs{} : ShaderInputs{
+                    {_USE_TEXTURE, false},
+                    {_COLOR, visual.color},
+                    {_MODEL, _model_matrices[i]}
+                },
+                .options = RenderOptions{
+                    .mode = RenderMode::Solid
+                },
+                .fbo = _deferred_fbo
+            });
+            _draw_visuals.emplace_back(i);
+        }
+
+        _lod_selector.endFrame();
+
+        // front to back within each shader and mesh group, so early depth test rejects hidden fragments
+        _render_queue.sort();
+
+        co_await buildInstanceGroups(snapshot);
+
+        // G Buffer pass as draw list, one draw per instance group or per entity without instanced shader
+        _draw_list.clear();
+        _draw_list.reserve(_instance_groups.size());
+        for(const InstanceGroup & group : _instance_groups)
+        {
+            const SnapshotVisual & visual = snapshot.visuals[_draw_visuals[_render_queue.getPushIndex(group.first)]];
+            const auto instanced_shader = getInstancedShader(group.shader, visual.shader_name);
+
+            if(!instanced_shader)
             {
-                color = glm::vec4(visual_component->color().x(), 
-                                  visual_component->color().y(), 
-                                  visual_component->color().z(), 
-                                  visual_component->color().w());
+                for(uint32_t i = group.first; i < group.first + group.count; ++i)
+                {
+                    _draw_list.emplace_back(_render_queue[i]);
+                }
+                continue;
             }
 
-            // render into deferred_fbo (G Buffer)
-            co_await _renderer.render(*vb_id, *sh_id, 
-                        ShaderInputs{
-                            .in_bool = {{"useTexture", false}},
-                            .in_vec4 = {{"uColor", color}},
-                            .in_mat4 = {
-                                {"uModel", model_matrix},
-                                {"uView", view_matrix},
-                                {"uProjection", proj_matrix}
-                            },
-                        },
-                        RenderOptions{
-                            .mode = RenderMode::Solid
-                        },
-                        _deferred_fbo);
+            // whole group in single draw call, per instance data is read from instance buffer
+            _draw_list.emplace_back(DrawItem{
+                .key = _render_queue[group.first].key,
+                .vertex_buffer = group.vertex_buffer,
+                .shader = *instanced_shader,
+                .instance_count = group.count,
+                .first_instance = group.first,
+                // same inputs for every group, renderer merges consecutive groups into single multi draw
+                .shader_inputs = ShaderInputs({
+                        {_USE_TEXTURE, false}
+                    },
+                    {_instance_buffer_id}),
+                .options = RenderOptions{
+                    .mode = RenderMode::Solid
+                },
+                .fbo = _deferred_fbo
+            });
         }
+
+        // whole pass with single hop onto render thread
+        co_await _renderer.submit(_draw_list);
         
         co_return;
     }
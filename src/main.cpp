@@ -2,20 +2,56 @@
 
 namespace velora
 {
+    asio::awaitable<Window> constructWindow(asio::io_context & io_context, IProcess & process, std::string name, Resolution resolution)
+    {
+        #ifndef VELORA_HEADLESS
+        if(isHeadless() == false)
+        {
+            co_return co_await Window::construct<winapi::WinapiWindow>(
+                asio::use_awaitable, io_context, process, std::move(name), std::move(resolution));
+        }
+        #endif
+        co_return co_await Window::construct<headless::HeadlessWindow>(
+            asio::use_awaitable, io_context, process, std::move(name), std::move(resolution));
+    }
+
+    // headless run without offscreen OpenGL context has nothing to present, only logic ticks
+    bool isDedicatedServer()
+    {
+        #ifdef VELORA_OPENGL_EGL
+        // headless process provides offscreen OpenGL context
+        return false;
+        #else
+        return isHeadless();
+        #endif
+    }
+
+    asio::awaitable<Renderer> constructRenderer(asio::io_context & io_context, IWindow & window)
+    {
+        #ifdef VELORA_OPENGL
+        if(isDedicatedServer() == false)
+        {
+            co_return co_await Renderer::construct<opengl::OpenGLRenderer>(asio::use_awaitable, window, 4, 0);
+        }
+        #endif
+        // dedicated server does not need command log, only object bookkeeping
+        co_return co_await Renderer::construct<null::NullRenderer>(
+            asio::use_awaitable, io_context, window.getResolution(), false);
+    }
+
     asio::awaitable<int> main(asio::io_context & io_context, IProcess & process)
     {
         spdlog::debug(std::format("[t:{}] Velora main started", std::this_thread::get_id()));
         
         // create system objects
-        Window window = co_await Window::construct<winapi::WinapiWindow>(
-            asio::use_awaitable, io_context, process, "Velora", Resolution{512, 256});
+        Window window = co_await constructWindow(io_context, process, "Velora", Resolution{512, 256});
         if (window->good() == false)
         {
             spdlog::error("Failed to create window");
             co_return -1;
         }
 
-        Renderer renderer = co_await Renderer::construct<opengl::OpenGLRenderer>(asio::use_awaitable, *window, 4, 0);
+        Renderer renderer = co_await constructRenderer(io_context, *window);
         if (renderer->good() == false)
         {
             spdlog::error("Failed to create renderer");
@@ -124,15 +160,27 @@ namespace velora
         
         game::TransformSystem transform_system(io_context);
 
-        // Create rendering systems
-        game::CameraSystem camera_system(io_context, *renderer);
+        // copies render relevant state into snapshot at the end of every logic tick
+        // rendering reads only from snapshots so it can run in parallel with logic
+        game::ExtractSystem extract_system(io_context);
+
+        // Create rendering systems, dedicated server does not render
+        const bool dedicated_server = isDedicatedServer();
+        std::optional<game::CameraSystem> camera_system;
+        std::optional<game::VisualSystem> visual_system;
+        std::optional<game::LightSystem> light_system;
+
+        if(dedicated_server == false)
+        {
+            camera_system.emplace(io_context, *renderer);
 
-        // async constructor because visual system must allocate fbo in renderer thread asynchronously
-        game::VisualSystem visual_system = co_await game::VisualSystem::asyncConstructor(
-                io_context, *renderer, {1280, 720}, camera_system);
+            // async constructor because visual system must allocate fbo in renderer thread asynchronously
+            visual_system.emplace(co_await game::VisualSystem::asyncConstructor(
+                    io_context, *renderer, {1280, 720}, *camera_system));
 
-        // async constructor because light system must allocate shader input buffer in renderer thread asynchronously
-        game::LightSystem light_system = co_await game::LightSystem::asyncConstructor(io_context, visual_system);
+            // async constructor because light system must allocate shader input buffer in renderer thread asynchronously
+            light_system.emplace(co_await game::LightSystem::asyncConstructor(io_context, *camera_system, *visual_system));
+        }
 
         // create scripts system
         game::ScriptSystem script_system(io_context);
@@ -164,26 +212,83 @@ namespace velora
 
         FpsCounter priority_fps_counter;
         FpsCounter logic_fps_counter;
-        std::chrono::high_resolution_clock::time_point last_log_time = std::chrono::high_resolution_clock::now();
 
-        auto NDC_quad_res = renderer->getVertexBuffer("NDC_quad_prefab");
-        if(!NDC_quad_res)
+        // priority loop to be executed as soon as possible
+        // stays empty on dedicated server, so loop runs only logic ticks
+        std::function<asio::awaitable<void>(float)> priority;
+        if(dedicated_server == false)
         {
-            spdlog::error("Failed to load NDC_quad_prefab");
-            co_return -1;
-        }
-        const std::size_t NDC_quad = NDC_quad_res.value();
+            auto NDC_quad_res = renderer->getVertexBuffer("NDC_quad_prefab");
+            if(!NDC_quad_res)
+            {
+                spdlog::error("Failed to load NDC_quad_prefab");
+                co_return -1;
+            }
+            const std::size_t NDC_quad = NDC_quad_res.value();
         
-        const auto deferred_lighting_pass_res = renderer->getShader("deferred_lighting_pass");
-        if(!deferred_lighting_pass_res)
-        {
-            spdlog::error("Failed to get deferred lighting pass shader");
-            co_return -1;
-        } 
-        const std::size_t deferred_lighting_pass = *deferred_lighting_pass_res;
+            const auto deferred_lighting_pass_res = renderer->getShader("deferred_lighting_pass");
+            if(!deferred_lighting_pass_res)
+            {
+                spdlog::error("Failed to get deferred lighting pass shader");
+                co_return -1;
+            } 
+            const std::size_t deferred_lighting_pass = *deferred_lighting_pass_res;
 
-        const auto & gbuffer_textures = visual_system.getDeferredFBOTextures();
+            const std::vector<std::size_t> gbuffer_textures = visual_system->getDeferredFBOTextures();
 
+            priority = [&renderer, &extract_system,
+                NDC_quad, deferred_lighting_pass, gbuffer_textures,
+                &camera_system, &light_system, &visual_system, &priority_fps_counter]
+            (float alpha) -> asio::awaitable<void> 
+            {
+                priority_fps_counter.frame();
+
+                // latest snapshot published by logic
+                const game::RenderSnapshot & snapshot = extract_system.acquireSnapshot();
+
+                // logic runs in parallel, alpha of loop may belong to newer or older tick than acquired snapshot
+                alpha = FixedStepLoop::getAlpha(snapshot.tick_time, snapshot.step);
+
+                co_await camera_system->run(snapshot, alpha);
+            
+                co_await renderer->clearScreen({0.8f, 0.8f, 0.8f, 1.0f});
+
+                // visual system will render entities with visual component into its GBuffer
+                // interpolate between current and previous transform using alpha
+                co_await visual_system->run(snapshot, alpha);
+                    
+                // light system will render shadows into its FBO
+                // and sends light to its shader storage buffer
+                // interpolate between current and previous light using alpha
+                co_await light_system->run(snapshot, alpha);
+
+                // deferred lighting uniforms, interned once
+                // camera, light count, light space matrices and shadow tiles are read from frame and light set uniform blocks
+                static const ShaderUniform g_position_uniform("gPosition");
+                static const ShaderUniform g_normal_uniform("gNormal");
+                static const ShaderUniform g_albedo_spec_uniform("gAlbedoSpec");
+                static const ShaderUniform shadow_atlas_uniform("shadowAtlas");
+
+                // render GBuffer to screen
+                co_await renderer->render(NDC_quad, deferred_lighting_pass,
+                    ShaderInputs({
+                            {g_position_uniform, ShaderInputs::Sampler{gbuffer_textures.at(0)}},
+                            {g_normal_uniform, ShaderInputs::Sampler{gbuffer_textures.at(1)}},
+                            {g_albedo_spec_uniform, ShaderInputs::Sampler{gbuffer_textures.at(2)}},
+                            {shadow_atlas_uniform, ShaderInputs::Sampler{light_system->getShadowAtlasTexture()}}
+                        },
+                        {light_system->getLightShaderBufferID(), light_system->getLightClusterBufferID()}),
+                    RenderOptions{
+                        .mode = RenderMode::Solid
+                    }
+                );
+
+                // swap buffers
+                co_await renderer->present();
+            
+                co_return;
+            };
+        }
 
         FixedStepLoop loop(io_context, 
             // fixed logic step 30 HZ update 
@@ -196,9 +301,9 @@ namespace velora
             },
 
             // logic loop to be executed at fixed time step 
-            [   &world,
-                &input_system, &transform_system, &script_system, &health_system,  &terrain_system, 
-                &last_log_time, &logic_fps_counter, &priority_fps_counter
+            [   &loop, &world,
+                &input_system, &transform_system, &script_system, &health_system,  &terrain_system, &extract_system,
+                &logic_fps_counter
             ]
             (std::chrono::duration<double> delta) -> asio::awaitable<void>  
             {
@@ -216,74 +321,63 @@ namespace velora
                 //         world.getCurrentLevel().runSystem(health_system, delta) &&
                 //         world.getCurrentLevel().runSystem(terrain_system, delta));
 
-                //track fps frames for profiling
-                if (std::chrono::high_resolution_clock::now() - last_log_time >= std::chrono::seconds(5)) 
-                {
-                        spdlog::info(std::format(
-                            "[t:{}]\n\tPriority FPS: {:.1f}\n\tLogic FPS:{:.1f}", 
-                                std::this_thread::get_id(),
-                                priority_fps_counter.getFPS(), 
-                                logic_fps_counter.getFPS()
-                            )
-                        );
-                    last_log_time = std::chrono::high_resolution_clock::now();
-                }
+                // publish render snapshot of this tick, stamped with time its state corresponds to
+                co_await world.getCurrentLevel().runSystem(extract_system, loop.getStepTime(FixedStepLoop::PRIMARY_RATE), delta);
 
                 co_return;
             },
 
-            // priority loop to be executed as soon as possible
-            [&renderer, &world,
-            &NDC_quad, &deferred_lighting_pass, &gbuffer_textures,
-            &camera_system, &light_system, &visual_system, &priority_fps_counter]
-            (float alpha) -> asio::awaitable<void> 
-            {
-                priority_fps_counter.frame();
+            // priority loop, empty on dedicated server
+            priority,
 
-                // execute camera calculation in parallel with light calculation
-                co_await (
-                    world.getCurrentLevel().runSystem(camera_system, alpha) 
-                );
-                
-                co_await renderer->clearScreen({0.8f, 0.8f, 0.8f, 1.0f});
+            // render runs on its own strand in parallel with logic
+            FixedStepLoop::Mode::Decoupled
+        );
 
-                // visual system will render entities with visual component into its GBuffer
-                // interpolate between current and previous transform using alpha
-                co_await world.getCurrentLevel().runSystem(visual_system, alpha);
-                        
-                // light system will render shadows into its FBO
-                // and sends light to its shader storage buffer
-                // interpolate between current and previous light using alpha
-                co_await world.getCurrentLevel().runSystem(light_system, alpha);                
+        // park loops between deadlines instead of spinning
+        // frame cap protects against unthrottled rendering when vsync is not honored (eg. minimized window)
+        // dedicated server has no priority step to cap, logic alone is parked until its next tick
+        if(dedicated_server == false)
+        {
+            loop.setPacing(FixedStepLoop::PacingConfig{
+                .enabled = true,
+                .target_frame_interval = 1s / 240.0
+            });
+        }
 
-                // render GBuffer to screen
-                co_await renderer->render(NDC_quad, deferred_lighting_pass,
-                    ShaderInputs{
-                        .in_int = {
-                            {"lightCount", (int)light_system.getLightsCount()},
-                            {"shadowCastersCount", (int)light_system.getShadowCastersCount()}},
-                        .in_mat4_array = {{"lightSpaceMatrices", light_system.getShadowMapLightSpaceMatrices()}},
-                        .in_samplers = {
-                            {"gPosition", gbuffer_textures.at(0)},
-                            {"gNormal", gbuffer_textures.at(1)},
-                            {"gAlbedoSpec", gbuffer_textures.at(2)}
-                        },
-                        .in_samplers_array = {
-                           {"shadowMaps", light_system.getShadowMapTextures()}
-                        },
-                        .storage_buffers = {light_system.getLightShaderBufferID()}
-                    },
-                    RenderOptions{
-                        .mode = RenderMode::Solid
-                    }
+        // track fps frames for profiling
+        // low rate update, never worth catching up
+        loop.addRate(FixedStepLoop::RateConfig{
+            .name = "stats",
+            .step = 5s,
+            .max_substeps = 1,
+            .policy = FixedStepLoop::CatchUpPolicy::Reset,
+            .update = [&loop, &logic_fps_counter, &priority_fps_counter](std::chrono::duration<double>) -> asio::awaitable<void>
+            {
+                const FramePacer::Jitter logic_jitter = loop.getLogicWakeUpJitter();
+                const FramePacer::Jitter priority_jitter = loop.getPriorityWakeUpJitter();
+
+                spdlog::info(std::format(
+                    "[t:{}]\n\tPriority FPS: {:.1f}\n\tLogic FPS:{:.1f}\n\tLogic ticks: {} (dropped {})"
+                    "\n\tLogic wake up jitter: mean {:.3f}ms max {:.3f}ms\n\tPriority wake up jitter: mean {:.3f}ms max {:.3f}ms", 
+                        std::this_thread::get_id(),
+                        priority_fps_counter.getFPS(), 
+                        logic_fps_counter.getFPS(),
+                        loop.getTick(FixedStepLoop::PRIMARY_RATE),
+                        loop.getDroppedTicks(FixedStepLoop::PRIMARY_RATE),
+                        logic_jitter.mean.count() * 1000.0, logic_jitter.max.count() * 1000.0,
+                        priority_jitter.mean.count() * 1000.0, priority_jitter.max.count() * 1000.0
+                    )
                 );
 
-                // swap buffers
-                co_await renderer->present();
-                
+                spdlog::info(std::format("\n\t{}\n\t{}\n\t{}\n\t{}",
+                    loop.getFrameRecorder().getSummary(),
+                    loop.getLogicRecorder().getSummary(),
+                    loop.getPriorityRecorder().getSummary(),
+                    loop.getRateRecorder(FixedStepLoop::PRIMARY_RATE).getSummary()));
                 co_return;
             }
-        );
+        });
 
         // start fixed step loop
         co_await loop.run();
@@ -294,6 +388,11 @@ namespace velora
 
         co_await saveWorldToDir(world, components_serializer_reg, getResourcesPath() / "saves", use_binary);
 
+        // dump frame timings of whole session for offline hitch analysis
+        loop.getFrameRecorder().dump(getResourcesPath() / "saves" / "frame_times.json");
+        loop.getLogicRecorder().dump(getResourcesPath() / "saves" / "logic_times.json");
+        loop.getPriorityRecorder().dump(getResourcesPath() / "saves" / "priority_times.json");
+
         spdlog::debug("Velora main finished with code {}", 0);
 
         co_return 0;
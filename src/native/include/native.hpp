@@ -1,7 +1,7 @@
 #if defined(WIN32)
 #include "windows/windows.hpp"
-#elif defined(UNIX)
-#include "unix/unix.h"
+#elif defined(__unix__)
+#include "unix/unix.hpp"
 #elif defined(__APPLE__)
 #include "mac/mac.h"
 #else
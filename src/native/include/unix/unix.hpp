@@ -0,0 +1,46 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <format>
+#include <sstream>
+#include <spdlog/spdlog.h>
+
+namespace velora::native
+{
+    // there is no windowing system or OpenGL context on unix yet,
+    // handles are opaque values handed out by headless process
+    struct unix_opengl_context;
+    struct unix_device_context;
+    struct unix_window;
+
+    using opengl_context_handle = unix_opengl_context *;
+    using device_context = unix_device_context *;
+    using console_handle = int;
+    using window_handle = unix_window *;
+    using process_handle = pid_t;
+}
+
+template <>
+struct std::formatter<velora::native::window_handle> : std::formatter<std::string> {
+  auto format(velora::native::window_handle handle, format_context& ctx) const {
+    return formatter<string>::format(
+      std::format("window_handle[{}]", (std::stringstream{} << handle).str()), ctx);
+  }
+};
+
+template <>
+struct std::formatter<velora::native::opengl_context_handle> : std::formatter<std::string> {
+  auto format(velora::native::opengl_context_handle handle, format_context& ctx) const {
+    return formatter<string>::format(
+      std::format("opengl_context[{}]", (std::stringstream{} << handle).str()), ctx);
+  }
+};
+
+template <>
+struct std::formatter<velora::native::device_context> : std::formatter<std::string> {
+  auto format(velora::native::device_context dc, format_context& ctx) const {
+    return formatter<string>::format(
+      std::format("device_context[{}]", (std::stringstream{} << dc).str()), ctx);
+  }
+};
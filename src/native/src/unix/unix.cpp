@@ -0,0 +1,25 @@
+#include "unix/unix.hpp"
+
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char ** environ;
+
+namespace velora::native{
+    void spawnProcess(const std::string& command)
+    {
+        const char * argv[] = {"/bin/sh", "-c", command.c_str(), nullptr};
+
+        pid_t pid;
+        const int result = posix_spawn(&pid, "/bin/sh", nullptr, nullptr, const_cast<char * const *>(argv), environ);
+        if(result != 0)
+        {
+            spdlog::error("posix_spawn failed: {}", result);
+            return;
+        }
+
+        // Wait until child process exits
+        int status = 0;
+        waitpid(pid, &status, 0);
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <variant>
+
+#include "native.hpp"
+#include "resolution.hpp"
+#include "process_window_callbacks.hpp"
+
+#include <asio.hpp>
+#include <spdlog/spdlog.h>
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
+#ifdef VELORA_OPENGL_EGL
+#include "opengl_context.hpp"
+#endif
+
+namespace velora::headless
+{
+    struct DestroyEvent {};
+    struct ResizeEvent { int width; int height; };
+    struct MoveEvent {};
+    struct FocusEvent {};
+    struct UnfocusEvent {};
+    struct KeyPressEvent { int key; };
+    struct KeyReleaseEvent { int key; };
+    struct MouseButtonDownEvent { int button; };
+    struct MouseButtonUpEvent { int button; };
+    struct MouseMoveEvent { int x; int y; float dx; float dy; };
+
+    /**
+     * @brief Window event delivered by `HeadlessProcess::injectEvent` instead of OS message loop
+     */
+    using HeadlessEvent = std::variant<
+        DestroyEvent,
+        ResizeEvent,
+        MoveEvent,
+        FocusEvent,
+        UnfocusEvent,
+        KeyPressEvent,
+        KeyReleaseEvent,
+        MouseButtonDownEvent,
+        MouseButtonUpEvent,
+        MouseMoveEvent>;
+
+    /**
+     * @brief Headless `IProcess` interface implementation for dedicated servers and tests.
+     * There is no message loop and no IO thread, windows are plain handles.
+     * OpenGL contexts are offscreen EGL contexts when built with VELORA_OPENGL_EGL, otherwise unavailable.
+     * Window callbacks run only for events injected with `injectEvent`.
+     * SIGINT and SIGTERM are translated into destroy event of every window.
+     */
+    class HeadlessProcess
+    {
+        public:
+            HeadlessProcess(asio::io_context & io_context);
+            HeadlessProcess(const HeadlessProcess &) = delete;
+            HeadlessProcess(HeadlessProcess &&) = delete;
+            HeadlessProcess & operator=(const HeadlessProcess &) = delete;
+            HeadlessProcess & operator=(HeadlessProcess &&) = delete;
+            ~HeadlessProcess();
+
+            asio::awaitable<void> close();
+            void join();
+
+            asio::awaitable<native::window_handle> registerWindow(std::string name, Resolution resolution);
+
+            asio::awaitable<bool> unregisterWindow(native::window_handle window);
+
+            asio::awaitable<bool> setWindowCallbacks(native::window_handle window, WindowCallbacks && callbacks);
+
+            // without VELORA_OPENGL_EGL there is no OpenGL in headless process, always returns nullptr
+            asio::awaitable<native::opengl_context_handle> registerOGLContext(native::window_handle window_handle, unsigned int major_version, unsigned int minor_version);
+
+            asio::awaitable<bool> unregisterOGLContext(native::opengl_context_handle oglctx);
+            
+            asio::awaitable<void> showCursor();
+
+            asio::awaitable<void> hideCursor();
+
+            /**
+             * @brief Delivers event to callbacks of window, callback is spawned on callbacks executor.
+             * @return false when window is not registered
+             */
+            asio::awaitable<bool> injectEvent(native::window_handle window, HeadlessEvent event);
+
+            bool isCursorVisible() const;
+
+            // current resolution of window, follows injected resize events
+            asio::awaitable<std::optional<Resolution>> getWindowResolution(native::window_handle window);
+
+        private:
+            void waitForSignal();
+
+            asio::strand<asio::io_context::executor_type> _strand;
+            asio::signal_set _signals;
+
+            absl::flat_hash_map<native::window_handle, std::optional<WindowCallbacks>> _window_handles;
+            // offscreen default framebuffer of OpenGL context has size of window
+            absl::flat_hash_map<native::window_handle, Resolution> _window_resolutions;
+            absl::flat_hash_set<native::opengl_context_handle> _oglctx_handles;
+
+            // 0 is never handed out so window handle is never nullptr
+            std::uintptr_t _next_window_id = 1;
+
+            bool _cursor_visible;
+            bool _closed;
+    };
+}
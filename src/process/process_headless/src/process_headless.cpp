@@ -0,0 +1,275 @@
+#include "process_headless.hpp"
+
+#include <algorithm>
+
+namespace velora::headless
+{
+    HeadlessProcess::HeadlessProcess(asio::io_context & io_context)
+    :   _strand(asio::make_strand(io_context)),
+        _signals(io_context, SIGINT, SIGTERM),
+        _cursor_visible(true),
+        _closed(false)
+    {
+        spdlog::debug(std::format("[headless] [t:{}] HeadlessProcess constructor called", std::this_thread::get_id()));
+
+        waitForSignal();
+    }
+
+    HeadlessProcess::~HeadlessProcess()
+    {
+        spdlog::debug(std::format("[headless] [t:{}] HeadlessProcess destructor called", std::this_thread::get_id()));
+
+        assert(_window_handles.empty() == true);
+        assert(_oglctx_handles.empty() == true);
+    }
+
+    void HeadlessProcess::waitForSignal()
+    {
+        _signals.async_wait(asio::bind_executor(_strand, [this](const asio::error_code & error, int signal)
+        {
+            if(error)return;
+
+            spdlog::info(std::format("[headless] [t:{}] Signal {} received, destroying windows", std::this_thread::get_id(), signal));
+
+            for(const auto & [window_handle, callbacks] : _window_handles)
+            {
+                asio::co_spawn(_strand, injectEvent(window_handle, DestroyEvent{}), asio::detached);
+            }
+
+            waitForSignal();
+        }));
+    }
+
+    void HeadlessProcess::join()
+    {
+        // nothing to join, all work runs on strand of io_context given in constructor
+        spdlog::debug(std::format("[headless] [t:{}] Headless process joined", std::this_thread::get_id()));
+    }
+
+    asio::awaitable<void> HeadlessProcess::close()
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        if(_closed)co_return;
+        _closed = true;
+
+        spdlog::debug(std::format("[headless] [t:{}] HeadlessProcess closing", std::this_thread::get_id()));
+
+        // pending signal wait would keep io_context running forever
+        asio::error_code error;
+        _signals.cancel(error);
+
+        while(_oglctx_handles.empty() == false){
+            co_await unregisterOGLContext(*(_oglctx_handles.begin()));
+        }
+
+        // same as closing OS windows, owners are notified and unregister windows themselves
+        for(const auto & [window_handle, callbacks] : _window_handles)
+        {
+            if(callbacks && callbacks->onDestroy != nullptr)
+            {
+                asio::co_spawn(callbacks->executor, callbacks->onDestroy(), asio::detached);
+            }
+        }
+
+        co_return;
+    }
+
+    asio::awaitable<native::window_handle> HeadlessProcess::registerWindow(std::string name, Resolution resolution)
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        if(_closed)
+        {
+            spdlog::error(std::format("[headless] cannot register window {}, process is closed", name));
+            co_return nullptr;
+        }
+
+        native::window_handle window_handle = reinterpret_cast<native::window_handle>(_next_window_id++);
+        _window_handles.try_emplace(window_handle, std::nullopt);
+        _window_resolutions.try_emplace(window_handle, resolution);
+
+        spdlog::info(std::format("[headless] [t:{}] Window {} {} {}x{} created", std::this_thread::get_id(),
+            name, window_handle, resolution.getWidth(), resolution.getHeight()));
+
+        co_return window_handle;
+    }
+
+    asio::awaitable<bool> HeadlessProcess::unregisterWindow(native::window_handle window)
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        if(_window_handles.erase(window) == 0){
+            spdlog::error(std::format("[headless] window {} not registered", window));
+            co_return false;
+        }
+        _window_resolutions.erase(window);
+
+        spdlog::info(std::format("[headless] window {} destroyed", window));
+        co_return true;
+    }
+
+    asio::awaitable<bool> HeadlessProcess::setWindowCallbacks(native::window_handle window, WindowCallbacks && callbacks)
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        auto it = _window_handles.find(window);
+        if(it == _window_handles.end()){
+            spdlog::error(std::format("[headless] window {} not registered", window));
+            co_return false;
+        }
+
+        it->second = std::move(callbacks);
+        co_return true;
+    }
+
+    asio::awaitable<native::opengl_context_handle> HeadlessProcess::registerOGLContext(native::window_handle window_handle, unsigned int major_version, unsigned int minor_version)
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        const auto window_it = _window_resolutions.find(window_handle);
+        if(window_it == _window_resolutions.end())
+        {
+            spdlog::error(std::format("[headless] cannot find window {} for constructing OGLContext ", window_handle));
+            co_return nullptr;
+        }
+
+#ifdef VELORA_OPENGL_EGL
+        native::opengl_context_handle oglctx = opengl::createEGLContext(
+            (unsigned int)window_it->second.getWidth(), (unsigned int)window_it->second.getHeight(),
+            major_version, minor_version);
+
+        if(oglctx == nullptr){
+            spdlog::error("[headless] Cannot create EGL context");
+            co_return nullptr;
+        }
+
+        _oglctx_handles.emplace(oglctx);
+
+        spdlog::info(std::format("[headless] created opengl context {}", oglctx));
+
+        co_return oglctx;
+#else
+        spdlog::warn(std::format("[headless] OpenGL {}.{} context is not available in headless process", major_version, minor_version));
+        co_return nullptr;
+#endif
+    }
+
+    asio::awaitable<bool> HeadlessProcess::unregisterOGLContext(native::opengl_context_handle oglctx)
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        if(_oglctx_handles.erase(oglctx) == 0)
+        {
+            spdlog::error(std::format("[headless] cannot find OGLContext {} for unregistering", oglctx));
+            co_return false;
+        }
+
+#ifdef VELORA_OPENGL_EGL
+        if(opengl::destroyEGLContext(oglctx) == false)
+        {
+            spdlog::error(std::format("[headless] cannot delete OGLContext {}", oglctx));
+            co_return false;
+        }
+#endif
+
+        spdlog::info(std::format("[headless] OGLContext {} destroyed", oglctx));
+
+        co_return true;
+    }
+
+    asio::awaitable<void> HeadlessProcess::showCursor()
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        _cursor_visible = true;
+    }
+
+    asio::awaitable<void> HeadlessProcess::hideCursor()
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        _cursor_visible = false;
+    }
+
+    bool HeadlessProcess::isCursorVisible() const
+    {
+        return _cursor_visible;
+    }
+
+    asio::awaitable<std::optional<Resolution>> HeadlessProcess::getWindowResolution(native::window_handle window)
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        const auto it = _window_resolutions.find(window);
+        if(it == _window_resolutions.end())co_return std::nullopt;
+
+        co_return it->second;
+    }
+
+    asio::awaitable<bool> HeadlessProcess::injectEvent(native::window_handle window, HeadlessEvent event)
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        auto it = _window_handles.find(window);
+        if(it == _window_handles.end()){
+            spdlog::error(std::format("[headless] window {} not registered", window));
+            co_return false;
+        }
+
+        // resolution follows injected resize even when nobody listens, so getters never go stale
+        if(const ResizeEvent * resize = std::get_if<ResizeEvent>(&event))
+        {
+            _window_resolutions.insert_or_assign(window, Resolution{(std::size_t)std::max(resize->width, 0), (std::size_t)std::max(resize->height, 0)});
+        }
+
+        // window without callbacks silently drops events, same as default window procedure
+        if(it->second.has_value() == false)co_return true;
+
+        const WindowCallbacks & callbacks = *it->second;
+
+        auto spawn = [&callbacks]<class Callback, class... Args>(const Callback & callback, Args... args)
+        {
+            if(callback == nullptr)return;
+            asio::co_spawn(callbacks.executor, callback(args...), asio::detached);
+        };
+
+        std::visit([&spawn, &callbacks](const auto & e)
+        {
+            using Event = std::decay_t<decltype(e)>;
+
+            if constexpr (std::is_same_v<Event, DestroyEvent>) spawn(callbacks.onDestroy);
+            else if constexpr (std::is_same_v<Event, ResizeEvent>) spawn(callbacks.onResize, e.width, e.height);
+            else if constexpr (std::is_same_v<Event, MoveEvent>) spawn(callbacks.onMove);
+            else if constexpr (std::is_same_v<Event, FocusEvent>) spawn(callbacks.onFocus);
+            else if constexpr (std::is_same_v<Event, UnfocusEvent>) spawn(callbacks.onUnfocus);
+            else if constexpr (std::is_same_v<Event, KeyPressEvent>) spawn(callbacks.onKeyPress, e.key);
+            else if constexpr (std::is_same_v<Event, KeyReleaseEvent>) spawn(callbacks.onKeyRelease, e.key);
+            else if constexpr (std::is_same_v<Event, MouseButtonDownEvent>) spawn(callbacks.onMouseButtonDown, e.button);
+            else if constexpr (std::is_same_v<Event, MouseButtonUpEvent>) spawn(callbacks.onMouseButtonUp, e.button);
+            else if constexpr (std::is_same_v<Event, MouseMoveEvent>) spawn(callbacks.onMouseMove, e.x, e.y, e.dx, e.dy);
+        }, event);
+
+        co_return true;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "vertex.hpp"
+
+namespace velora
+{
+    /**
+     * @brief Axis aligned bounding box
+     */
+    struct BoundingBox
+    {
+        glm::vec3 min = glm::vec3(0.0f);
+        glm::vec3 max = glm::vec3(0.0f);
+
+        glm::vec3 getCenter() const;
+        glm::vec3 getExtents() const;
+    };
+
+    /**
+     * @brief Bounding sphere
+     */
+    struct BoundingSphere
+    {
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+    };
+
+    /**
+     * @brief Local space bounds of mesh, computed once when vertex buffer is constructed.
+     * Sphere is centered in box center, so it is never larger than half diagonal of box.
+     */
+    struct MeshBounds
+    {
+        BoundingBox box;
+        BoundingSphere sphere;
+    };
+
+    /**
+     * @brief Computes box and sphere enclosing all vertices of mesh.
+     * Mesh without vertices has empty bounds at origin.
+     */
+    MeshBounds calculateMeshBounds(const std::vector<Vertex> & vertices);
+    MeshBounds calculateMeshBounds(const Mesh & mesh);
+
+    /**
+     * @brief World space box enclosing local box transformed by model matrix.
+     */
+    BoundingBox transformBoundingBox(const BoundingBox & box, const glm::mat4 & model);
+
+    /**
+     * @brief World space sphere enclosing local sphere transformed by model matrix.
+     * Radius is scaled by largest axis scale, so sphere stays conservative under non uniform scale.
+     */
+    BoundingSphere transformBoundingSphere(const BoundingSphere & sphere, const glm::mat4 & model);
+}
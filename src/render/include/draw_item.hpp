@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <cmath>
+
+#include "render_options.hpp"
+#include "shader.hpp"
+
+namespace velora
+{
+    /**
+     * @brief Order of draw items within one render target
+     */
+    enum class RenderPass : uint8_t
+    {
+        Shadow = 0,
+        Opaque = 1,
+        Transparent = 2,
+        Overlay = 3
+    };
+
+    /**
+     * @brief Packed 64-bit draw sort key.
+     *
+     * Bit layout, most significant first:
+     * | target 8 | pass 4 | shader 12 | material 12 | mesh 12 | depth 16 |
+     *
+     * Sorting by key groups draws by target, then pass, then shader, material and mesh, so that
+     * consecutive draws switch as little state as possible. Within same state opaque draws go
+     * front to back and transparent back to front.
+     * Resource IDs are truncated to field width, collision only weakens grouping, never correctness.
+     */
+    struct RenderSortKey
+    {
+        constexpr static const uint32_t TARGET_BITS = 8;
+        constexpr static const uint32_t PASS_BITS = 4;
+        constexpr static const uint32_t SHADER_BITS = 12;
+        constexpr static const uint32_t MATERIAL_BITS = 12;
+        constexpr static const uint32_t MESH_BITS = 12;
+        constexpr static const uint32_t DEPTH_BITS = 16;
+
+        constexpr static const uint32_t DEPTH_SHIFT = 0;
+        constexpr static const uint32_t MESH_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+        constexpr static const uint32_t MATERIAL_SHIFT = MESH_SHIFT + MESH_BITS;
+        constexpr static const uint32_t SHADER_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+        constexpr static const uint32_t PASS_SHIFT = SHADER_SHIFT + SHADER_BITS;
+        constexpr static const uint32_t TARGET_SHIFT = PASS_SHIFT + PASS_BITS;
+
+        static_assert(TARGET_SHIFT + TARGET_BITS == 64, "sort key fields must fill 64 bits");
+
+        /**
+         * @param target order of render target in frame, eg. shadow maps before G Buffer
+         * @param depth quantized view depth, see `quantizeDepth`
+         */
+        constexpr static uint64_t make(uint32_t target, RenderPass pass, std::size_t shader,
+            std::size_t material, std::size_t mesh, uint16_t depth)
+        {
+            return  (field(target, TARGET_BITS) << TARGET_SHIFT) |
+                    (field((uint64_t)pass, PASS_BITS) << PASS_SHIFT) |
+                    (field(shader, SHADER_BITS) << SHADER_SHIFT) |
+                    (field(material, MATERIAL_BITS) << MATERIAL_SHIFT) |
+                    (field(mesh, MESH_BITS) << MESH_SHIFT) |
+                    (field(depth, DEPTH_BITS) << DEPTH_SHIFT);
+        }
+
+        /**
+         * @brief Maps view space distance in [near, far] onto depth field.
+         * Opaque pass sorts ascending (front to back), transparent pass descending (back to front).
+         */
+        static uint16_t quantizeDepth(float distance, float near_plane, float far_plane, RenderPass pass)
+        {
+            const float range = std::max(far_plane - near_plane, 1e-6f);
+            const float normalized = std::clamp((distance - near_plane) / range, 0.0f, 1.0f);
+            const uint16_t depth = (uint16_t)std::lround(normalized * (float)((1u << DEPTH_BITS) - 1));
+            return pass == RenderPass::Transparent ? (uint16_t)~depth : depth;
+        }
+
+        constexpr static RenderPass getPass(uint64_t key)
+        {
+            return (RenderPass)((key >> PASS_SHIFT) & ((1ull << PASS_BITS) - 1));
+        }
+
+        private:
+            constexpr static uint64_t field(uint64_t value, uint32_t bits)
+            {
+                return value & ((1ull << bits) - 1);
+            }
+    };
+
+    /**
+     * @brief Single draw submitted to render queue or `IRenderer::submit`,
+     * arguments of `IRenderer::render` / `IRenderer::renderInstanced` with sort key
+     */
+    struct DrawItem
+    {
+        uint64_t key = 0;
+
+        std::size_t vertex_buffer = 0;
+        std::size_t shader = 0;
+        // more than 1 draws instances of instanced shader in single draw call, 0 draws nothing
+        std::size_t instance_count = 1;
+        // instance index of first instance, instanced shaders read instances[first_instance + gl_InstanceID]
+        uint32_t first_instance = 0;
+        ShaderInputs shader_inputs;
+        RenderOptions options;
+        std::optional<std::size_t> fbo;
+    };
+}
@@ -56,19 +56,6 @@ namespace velora
          */
         virtual bool good() const = 0;
 
-        /**
-         * @brief Enable the frame buffer object for rendering.
-         * 
-         * @return True if the frame buffer object was successfully enabled, false otherwise.
-         */
-        virtual bool enable() const = 0;
-
-        /**
-         * @brief Disable the frame buffer object.
-         * 
-         */
-        virtual void disable() const = 0;
-
         /**
          * @brief Get the textures attached to the frame buffer object.
          * 
@@ -97,8 +84,6 @@ namespace velora
 
             constexpr inline std::size_t ID() const override { return dispatch::getImpl().ID();}
             constexpr inline bool good() const override { return dispatch::getImpl().good();}
-            constexpr inline bool enable() const override { return dispatch::getImpl().enable();}
-            constexpr inline void disable() const override { return dispatch::getImpl().disable();}
             constexpr inline const std::vector<std::size_t> & getTextures() const override { return dispatch::getImpl().getTextures();}
             constexpr inline const Resolution & getResolution() const override { return dispatch::getImpl().getResolution();}
     };
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "bounds.hpp"
+
+namespace velora
+{
+    /**
+     * @brief Six planes of view frustum, normals point inside.
+     * Plane is (normal, distance), point p is inside when dot(normal, p) + distance >= 0.
+     */
+    struct Frustum
+    {
+        enum Plane : uint8_t
+        {
+            Left = 0,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            Count
+        };
+
+        std::array<glm::vec4, Plane::Count> planes;
+
+        /**
+         * @brief Extracts normalized planes of clip volume -w <= x, y, z <= w from view projection matrix.
+         * Works with any matrix mapping world into OpenGL clip space, eg. camera or light space matrix.
+         */
+        static Frustum fromViewProjection(const glm::mat4 & view_projection);
+
+        bool intersects(const BoundingSphere & sphere) const;
+        // conservative, box crossing frustum corner outside of all planes is still reported as intersecting
+        bool intersects(const BoundingBox & box) const;
+    };
+
+    /**
+     * @brief Culls batch of world space bounding spheres against frustum.
+     *
+     * Spheres are stored as structure of arrays, so four spheres are tested against a plane
+     * with single SSE instruction sequence. Scalar path is used where SSE is not available.
+     * Runs on CPU only and does not need renderer.
+     * Not thread safe, meant to be filled and culled from single strand.
+     */
+    class FrustumCuller
+    {
+        public:
+            struct Stats
+            {
+                uint32_t visible = 0;
+                uint32_t culled = 0;
+            };
+
+            FrustumCuller() = default;
+            FrustumCuller(const FrustumCuller&) = delete;
+            FrustumCuller(FrustumCuller&&) = default;
+            FrustumCuller& operator=(const FrustumCuller&) = delete;
+            FrustumCuller& operator=(FrustumCuller&&) = default;
+            ~FrustumCuller() = default;
+
+            void reserve(std::size_t size);
+
+            // removes all spheres, keeps allocated memory for next frame
+            void clear();
+
+            // @return index of sphere reported by cull
+            uint32_t add(const BoundingSphere & sphere);
+
+            std::size_t size() const;
+
+            /**
+             * @brief Collects spheres intersecting frustum.
+             * @param visible cleared and filled with indices of visible spheres in ascending order
+             * @return number of visible and culled spheres
+             */
+            Stats cull(const Frustum & frustum, std::vector<uint32_t> & visible) const;
+
+        private:
+            std::vector<float> _x;
+            std::vector<float> _y;
+            std::vector<float> _z;
+            std::vector<float> _radius;
+    };
+}
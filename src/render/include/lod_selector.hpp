@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "bounds.hpp"
+
+namespace velora
+{
+    // levels of detail of one mesh including full detail one
+    constexpr static const uint32_t MAX_MESH_LODS = 4;
+    // level N > 0 of vertex buffer "name" is vertex buffer "name_lodN"
+    constexpr static const char * MESH_LOD_SUFFIX = "_lod";
+
+    /**
+     * @brief Name of vertex buffer holding level of detail of mesh, level 0 is mesh itself.
+     */
+    std::string getMeshLODName(const std::string & name, uint32_t level);
+
+    /**
+     * @brief Vertex buffers of all levels of detail of one mesh, finest first.
+     * Mesh without lower levels has count 1.
+     */
+    struct MeshLODChain
+    {
+        std::array<std::size_t, MAX_MESH_LODS> vertex_buffers{};
+        // triangles of every level
+        std::array<uint32_t, MAX_MESH_LODS> triangles{};
+        uint32_t count = 0;
+    };
+
+    /**
+     * @brief Triangles of draws of last run, before and after level of detail selection
+     */
+    struct MeshLODStats
+    {
+        // triangles that would be submitted with full detail meshes only
+        uint64_t full_detail_triangles = 0;
+        uint64_t submitted_triangles = 0;
+        // drawn instances per level
+        std::array<uint32_t, MAX_MESH_LODS> instances{};
+    };
+
+    /**
+     * @brief Picks level of detail of every drawn object from its projected size in pixels.
+     *
+     * Level L is used while projected diameter stays under threshold L - 1 and above threshold L.
+     * Selected level of every key is remembered, object switches level only after crossing threshold
+     * by hysteresis share, so objects near threshold do not flicker between levels every frame.
+     * Runs on CPU only and does not need renderer.
+     * Not thread safe, meant to be used from single strand.
+     */
+    class LODSelector
+    {
+        public:
+            using Thresholds = std::array<float, MAX_MESH_LODS - 1>;
+
+            /**
+             * @param thresholds projected diameters in pixels under which next coarser level is used, descending
+             * @param hysteresis share of threshold projected size must cross before level changes
+             */
+            LODSelector(Thresholds thresholds, float hysteresis);
+            LODSelector(const LODSelector&) = delete;
+            LODSelector(LODSelector&&) = default;
+            LODSelector& operator=(const LODSelector&) = delete;
+            LODSelector& operator=(LODSelector&&) = default;
+            ~LODSelector() = default;
+
+            /**
+             * @brief Diameter of world space sphere projected on screen of viewport_height pixels.
+             * Works with perspective and orthographic matrices mapping world into OpenGL clip space.
+             * Infinite when sphere center is at or behind eye, those objects always get full detail.
+             */
+            static float projectedDiameter(const BoundingSphere & sphere, const glm::mat4 & view_projection, float viewport_height);
+
+            // @return level in [0, levels), 0 when levels is 0 or 1
+            uint32_t select(uint64_t key, float projected_diameter, uint32_t levels);
+
+            // forgets levels of keys not selected since last call, once they outnumber selected ones
+            void endFrame();
+
+        private:
+            struct Selection
+            {
+                uint32_t level = 0;
+                uint64_t frame = 0;
+            };
+
+            Thresholds _thresholds;
+            float _hysteresis;
+
+            absl::flat_hash_map<uint64_t, Selection> _selections;
+            uint64_t _frame = 0;
+            std::size_t _selected = 0;
+
+            // kept before pruning, so small scenes never rebuild the map
+            constexpr static const std::size_t _MIN_KEPT_SELECTIONS = 256;
+    };
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 #include "type.hpp"
 
 #include "resolution.hpp"
@@ -7,11 +9,16 @@
 #include "render_options.hpp"
 #include "vertex.hpp"
 #include "vertex_buffer.hpp"
+#include "bounds.hpp"
+#include "frustum_culler.hpp"
+#include "lod_selector.hpp"
 #include "shader_storage_buffer.hpp"
+#include "uniform_buffer.hpp"
 #include "frame_buffer_object.hpp"
 #include "texture.hpp"
 
 #include "shader.hpp"
+#include "draw_item.hpp"
 
 #include "fps_counter.hpp"
 
@@ -47,9 +54,44 @@ namespace velora
          * @brief Clear the screen with a color
          * 
          * @param color Color to clear the screen with
+         * @param fbo Frame buffer object to clear, default framebuffer when empty
+         * @param region Part of render target to clear, whole render target when empty
+         * @return asio::awaitable<void> 
+         */
+        virtual asio::awaitable<void> clearScreen(glm::vec4 color, std::optional<std::size_t> fbo = std::nullopt, std::optional<RenderRegion> region = std::nullopt) = 0;
+
+        /**
+         * @brief Copy depth attachment of one frame buffer object (FBO) into another.
+         * 
+         * Both FBOs must have depth attachment of the same resolution and format.
+         * 
+         * @param source ID of FBO to copy depth from.
+         * @param destination ID of FBO to copy depth into.
+         * @param region Part of depth copied into the same place of destination, whole depth when empty
          * @return asio::awaitable<void> 
          */
-        virtual asio::awaitable<void> clearScreen(glm::vec4 color, std::optional<std::size_t> fbo = std::nullopt) = 0;
+        virtual asio::awaitable<void> copyFrameBufferObjectDepth(std::size_t source, std::size_t destination, std::optional<RenderRegion> region = std::nullopt) = 0;
+
+        /**
+         * @brief Clear several regions of one render target with single hop onto render thread
+         * 
+         * @param color Color to clear the regions with
+         * @param fbo Frame buffer object to clear, default framebuffer when empty
+         * @param regions Parts of render target to clear, nothing is cleared when empty
+         * @return asio::awaitable<void> 
+         */
+        virtual asio::awaitable<void> clearScreenRegions(glm::vec4 color, std::optional<std::size_t> fbo, std::span<const RenderRegion> regions) = 0;
+
+        /**
+         * @brief Copy several regions of depth attachment of one frame buffer object (FBO) into another
+         * with single hop onto render thread.
+         * 
+         * @param source ID of FBO to copy depth from.
+         * @param destination ID of FBO to copy depth into.
+         * @param regions Parts of depth copied into the same places of destination, nothing is copied when empty
+         * @return asio::awaitable<void> 
+         */
+        virtual asio::awaitable<void> copyFrameBufferObjectDepthRegions(std::size_t source, std::size_t destination, std::span<const RenderRegion> regions) = 0;
 
         /**
          * @brief Render a vertex buffer using a specified shader.
@@ -72,6 +114,43 @@ namespace velora
                 ShaderInputs shader_inputs = ShaderInputs{},
                 RenderOptions options = RenderOptions{},
                 std::optional<std::size_t> fbo = std::nullopt) = 0;
+
+        /**
+         * @brief Render many instances of a vertex buffer with a single draw call.
+         * 
+         * Same as `render`, but the shader is executed `instance_count` times per vertex.
+         * Per instance data is read by the shader itself, usually from a shader storage buffer
+         * passed as storage buffer of `shader_inputs` and indexed with the instance ID.
+         * 
+         * @param vertex_buffer ID of the vertex buffer to render.
+         * @param shader ID of an instanced shader.
+         * @param instance_count Number of instances, nothing is rendered when 0.
+         * @param shader_inputs Inputs shared by all instances.
+         * @param options Options for rendering, including rendering mode and polygon offset.
+         * @param fbo Optional frame buffer object to render into. If not provided, rendering is done to the default framebuffer.
+         * 
+         * @return asio::awaitable<void> 
+         */
+        virtual asio::awaitable<void> renderInstanced(
+                std::size_t vertex_buffer,
+                std::size_t shader,
+                std::size_t instance_count,
+                ShaderInputs shader_inputs = ShaderInputs{},
+                RenderOptions options = RenderOptions{},
+                std::optional<std::size_t> fbo = std::nullopt) = 0;
+
+        /**
+         * @brief Render list of draws in given order.
+         * 
+         * Equivalent of calling `render` or `renderInstanced` for every item, but the whole list
+         * is executed with a single hop onto the render thread. Callers fill the list on their own
+         * strand and hand over the whole pass at once. Sort key of items is ignored.
+         * 
+         * @param draws Draws to execute, must stay alive until the returned awaitable completes.
+         * 
+         * @return asio::awaitable<void> 
+         */
+        virtual asio::awaitable<void> submit(std::span<const DrawItem> draws) = 0;
         
         /**
          * @brief Present the rendered frame
@@ -143,6 +222,26 @@ namespace velora
          */
         virtual std::optional<std::size_t> getVertexBuffer(std::string name) const = 0;
 
+        /**
+         * @brief Get the local space bounds of mesh of a vertex buffer object (VBO).
+         * 
+         * Bounds are computed once when VBO is constructed, callers cache them with the ID.
+         * 
+         * @param id ID of the VBO.
+         * 
+         * @return Bounds of the mesh, or std::nullopt if VBO does not exist.
+         */
+        virtual std::optional<MeshBounds> getVertexBufferBounds(std::size_t id) const = 0;
+
+        /**
+         * @brief Get the number of indices of a vertex buffer object (VBO), three per triangle.
+         * 
+         * @param id ID of the VBO.
+         * 
+         * @return Number of indices, or std::nullopt if VBO does not exist.
+         */
+        virtual std::optional<std::size_t> getVertexBufferElementCount(std::size_t id) const = 0;
+
         /**
          * @brief Construct a new shader object with the given name and vertex code
          * @param name Name of the shader
@@ -215,6 +314,50 @@ namespace velora
          */
         virtual std::optional<std::size_t> getShaderStorageBuffer(std::string name) const = 0;
 
+        /**
+         * @brief Construct a new uniform buffer
+         *
+         * Buffer is bound to its binding point for its whole lifetime,
+         * binding points of uniform buffers must be unique.
+         *
+         * @param name        The name of the uniform buffer
+         * @param binding_point The binding point of std140 uniform block in shaders
+         * @param size        The size of the uniform buffer in bytes
+         * @param data        The data to initialize the uniform buffer with, can be nullptr
+         *
+         * @return The id of the uniform buffer, or std::nullopt if an error occurred
+         */
+        virtual asio::awaitable<std::optional<std::size_t>> constructUniformBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data) = 0;
+
+        /**
+         * @brief Update a uniform buffer
+         *
+         * @param id          The id of the uniform buffer to update
+         * @param size        The size of the uniform buffer in bytes
+         * @param data        The data to update the uniform buffer with
+         *
+         * @return `true` if the uniform buffer was successfully updated, `false` otherwise
+         */
+        virtual asio::awaitable<bool> updateUniformBuffer(std::size_t id, const std::size_t size, const void * data) = 0;
+
+        /**
+         * @brief Erase a uniform buffer
+         *
+         * @param id The id of the uniform buffer to erase
+         *
+         * @return `true` if the uniform buffer was successfully erased, `false` otherwise
+         */
+        virtual asio::awaitable<bool> eraseUniformBuffer(std::size_t id) = 0;
+
+        /**
+         * @brief Get the id of a uniform buffer by name
+         *
+         * @param name The name of the uniform buffer
+         *
+         * @return The id of the uniform buffer, or std::nullopt if not found
+         */
+        virtual std::optional<std::size_t> getUniformBuffer(std::string name) const = 0;
+
         /**
          * @brief Construct a new Frame Buffer Object (FBO) object
          * 
@@ -259,6 +402,17 @@ namespace velora
          * @return A vector of size_t containing the IDs of the textures attached to the FBO object.
          */
         virtual std::vector<std::size_t> getFrameBufferObjectTextures(std::size_t id) const = 0;
+
+        /**
+         * @brief Get the generation of renderer objects
+         * 
+         * Generation changes whenever any object is constructed or erased, so IDs resolved by name
+         * can be cached by the caller and resolved again only when generation differs.
+         * IDs may be reused by new objects after erase, cached IDs must not outlive their generation.
+         * 
+         * @return Current generation, safe to call from any thread.
+         */
+        virtual uint64_t getObjectGeneration() const = 0;
     };
 
     template<class RendererImplType>
@@ -276,8 +430,20 @@ namespace velora
             inline asio::awaitable<void> close() override { co_return co_await dispatch::getImpl().close();}
             constexpr inline void join() override { return dispatch::getImpl().join();}
 
-            inline asio::awaitable<void> clearScreen(glm::vec4 color, std::optional<std::size_t> fbo) override { 
-                co_return co_await dispatch::getImpl().clearScreen(std::move(color), std::move(fbo));
+            inline asio::awaitable<void> clearScreen(glm::vec4 color, std::optional<std::size_t> fbo, std::optional<RenderRegion> region) override { 
+                co_return co_await dispatch::getImpl().clearScreen(std::move(color), std::move(fbo), std::move(region));
+            }
+
+            inline asio::awaitable<void> copyFrameBufferObjectDepth(std::size_t source, std::size_t destination, std::optional<RenderRegion> region) override { 
+                co_return co_await dispatch::getImpl().copyFrameBufferObjectDepth(std::move(source), std::move(destination), std::move(region));
+            }
+
+            inline asio::awaitable<void> clearScreenRegions(glm::vec4 color, std::optional<std::size_t> fbo, std::span<const RenderRegion> regions) override { 
+                co_return co_await dispatch::getImpl().clearScreenRegions(std::move(color), std::move(fbo), std::move(regions));
+            }
+
+            inline asio::awaitable<void> copyFrameBufferObjectDepthRegions(std::size_t source, std::size_t destination, std::span<const RenderRegion> regions) override { 
+                co_return co_await dispatch::getImpl().copyFrameBufferObjectDepthRegions(std::move(source), std::move(destination), std::move(regions));
             }
 
             inline asio::awaitable<void> render(std::size_t vertex_buffer, std::size_t shader, 
@@ -291,6 +457,23 @@ namespace velora
                 );
             }
 
+            inline asio::awaitable<void> renderInstanced(std::size_t vertex_buffer, std::size_t shader,
+                std::size_t instance_count,
+                ShaderInputs shader_inputs,
+                RenderOptions options,
+                std::optional<std::size_t> fbo) override { 
+                co_return co_await dispatch::getImpl().renderInstanced(std::move(vertex_buffer), std::move(shader),
+                    std::move(instance_count),
+                    std::move(shader_inputs),
+                    std::move(options),
+                    std::move(fbo)
+                );
+            }
+
+            inline asio::awaitable<void> submit(std::span<const DrawItem> draws) override { 
+                co_return co_await dispatch::getImpl().submit(std::move(draws));
+            }
+
             inline asio::awaitable<void> present() override { 
                 co_return co_await dispatch::getImpl().present();
             }
@@ -323,6 +506,14 @@ namespace velora
                 return dispatch::getImpl().getVertexBuffer(std::move(name));
             }
 
+            inline std::optional<MeshBounds> getVertexBufferBounds(std::size_t id) const override{
+                return dispatch::getImpl().getVertexBufferBounds(std::move(id));
+            }
+
+            inline std::optional<std::size_t> getVertexBufferElementCount(std::size_t id) const override{
+                return dispatch::getImpl().getVertexBufferElementCount(std::move(id));
+            }
+
             inline asio::awaitable<std::optional<std::size_t>> constructShader(std::string name, std::vector<std::string> vertex_code) override { 
                 co_return co_await dispatch::getImpl().constructShader(std::move(name), std::move(vertex_code));
             }
@@ -355,6 +546,22 @@ namespace velora
                 return dispatch::getImpl().getShaderStorageBuffer(std::move(name));
             }
 
+            inline asio::awaitable<std::optional<std::size_t>> constructUniformBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data) override{ 
+                co_return co_await dispatch::getImpl().constructUniformBuffer(std::move(name), binding_point, std::move(size), std::move(data));
+            }
+
+            inline asio::awaitable<bool> updateUniformBuffer(std::size_t id, const std::size_t size, const void * data) override {
+                co_return co_await dispatch::getImpl().updateUniformBuffer(std::move(id), std::move(size), std::move(data));
+            }
+
+            inline asio::awaitable<bool> eraseUniformBuffer(std::size_t id) override {
+                co_return co_await dispatch::getImpl().eraseUniformBuffer(std::move(id));
+            }
+
+            constexpr inline std::optional<std::size_t> getUniformBuffer(std::string name) const override{
+                return dispatch::getImpl().getUniformBuffer(std::move(name));
+            }
+
             inline asio::awaitable<std::optional<std::size_t>> constructFrameBufferObject(std::string name, Resolution resolution, std::initializer_list<FBOAttachment> attachments) override{ 
                 co_return co_await dispatch::getImpl().constructFrameBufferObject(std::move(name), std::move(resolution), std::move(attachments));
             }
@@ -370,6 +577,10 @@ namespace velora
             inline std::vector<std::size_t> getFrameBufferObjectTextures(std::size_t id) const override {
                 return dispatch::getImpl().getFrameBufferObjectTextures(std::move(id));
             }
+
+            inline uint64_t getObjectGeneration() const override {
+                return dispatch::getImpl().getObjectGeneration();
+            }
     };
 
     template<class RendererImplType>
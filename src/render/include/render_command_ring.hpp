@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+#include "native.hpp"
+#include <asio.hpp>
+
+namespace velora
+{
+    /**
+     * @brief Bounded lock-free command ring consumed by render thread.
+     *
+     * Engine strands push small commands (usually completion handler of coroutine waiting to continue
+     * on render thread), render thread pops and executes them in push order.
+     * Every slot has inline storage where command is constructed in place, so pushing never allocates
+     * and never locks. Slots are claimed with per slot sequence numbers, so several strands
+     * may push at the same time while render thread stays the only consumer.
+     *
+     * Render thread sleeps in `io_context` only when ring is empty,
+     * producers post wake up handler only when they find it sleeping.
+     */
+    class RenderCommandRing
+    {
+        public:
+            constexpr static const std::size_t CAPACITY = 1024;
+            constexpr static const std::size_t COMMAND_STORAGE_SIZE = 48;
+
+            static_assert((CAPACITY & (CAPACITY - 1)) == 0, "capacity must be power of two");
+
+            RenderCommandRing();
+            RenderCommandRing(const RenderCommandRing&) = delete;
+            RenderCommandRing(RenderCommandRing&&) = delete;
+            RenderCommandRing& operator=(const RenderCommandRing&) = delete;
+            RenderCommandRing& operator=(RenderCommandRing&&) = delete;
+            ~RenderCommandRing();
+
+            /**
+             * @brief Constructs command in free slot, safe to call from any thread.
+             * @return false when ring is full, command is left untouched
+             */
+            template<class F>
+            bool tryPush(F && command)
+            {
+                using Command = std::decay_t<F>;
+                static_assert(sizeof(Command) <= COMMAND_STORAGE_SIZE, "command does not fit into slot storage");
+                static_assert(alignof(Command) <= alignof(std::max_align_t), "command is over aligned");
+
+                std::size_t position = _enqueue_position.load(std::memory_order_relaxed);
+                Slot * slot = nullptr;
+                while(true)
+                {
+                    slot = &_slots[position & _MASK];
+                    const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                    const std::intptr_t difference = (std::intptr_t)sequence - (std::intptr_t)position;
+
+                    if(difference == 0)
+                    {
+                        // slot is free in this lap, claim it
+                        if(_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))break;
+                    }
+                    else if(difference < 0)
+                    {
+                        // slot still holds command of previous lap
+                        return false;
+                    }
+                    else
+                    {
+                        // other producer claimed slot first
+                        position = _enqueue_position.load(std::memory_order_relaxed);
+                    }
+                }
+
+                ::new(static_cast<void *>(slot->storage)) Command(std::forward<F>(command));
+                slot->consume = [](void * storage, bool execute)
+                {
+                    Command * stored = std::launder(reinterpret_cast<Command *>(storage));
+                    if(execute)(*stored)();
+                    stored->~Command();
+                };
+                slot->sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+
+            /**
+             * @brief Executes all commands pushed so far. Render thread only.
+             * @return number of executed commands
+             */
+            std::size_t drain();
+
+            // render thread only
+            bool empty() const;
+
+            /**
+             * @brief Render thread loop, executes commands and handlers of io_context until io_context runs out of work.
+             * Remaining commands are executed before return.
+             */
+            void run(asio::io_context & io_context);
+
+            /**
+             * @brief Wakes render thread if it sleeps in io_context, call after successful push
+             */
+            void wake(asio::io_context & io_context);
+
+            // true when called from thread executing `run`
+            bool isRenderThread() const;
+
+            /**
+             * @brief Continues awaiting coroutine on render thread.
+             * Handler of coroutine is pushed into ring, falls back to dispatch on strand when ring is full.
+             * Does nothing when already on render thread.
+             */
+            asio::awaitable<void> enter(asio::io_context & io_context, const asio::strand<asio::io_context::executor_type> & strand);
+
+            // number of times ring was full and strand was used instead
+            uint64_t getOverflowCount() const;
+
+        private:
+            constexpr static const std::size_t _MASK = CAPACITY - 1;
+            constexpr static const std::size_t _CACHE_LINE = 64;
+
+            struct alignas(_CACHE_LINE) Slot
+            {
+                std::atomic<std::size_t> sequence = 0;
+                // executes (when asked) and destroys command constructed in storage
+                void (*consume)(void * storage, bool execute) = nullptr;
+                alignas(std::max_align_t) std::byte storage[COMMAND_STORAGE_SIZE];
+            };
+
+            std::unique_ptr<Slot[]> _slots;
+
+            // producers and consumer write different cache lines
+            alignas(_CACHE_LINE) std::atomic<std::size_t> _enqueue_position = 0;
+            alignas(_CACHE_LINE) std::size_t _dequeue_position = 0;
+
+            alignas(_CACHE_LINE) std::atomic<bool> _sleeping = false;
+            std::atomic<std::thread::id> _render_thread_id;
+            std::atomic<uint64_t> _overflow_count = 0;
+    };
+}
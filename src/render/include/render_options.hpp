@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 
 namespace velora
@@ -26,6 +27,28 @@ namespace velora
     {
         float factor;
         float units;
+
+        constexpr bool operator==(const PolygonOffset &) const = default;
+    };
+
+    /**
+     * @brief Rectangle of render target in pixels, origin is bottom left corner like OpenGL window coordinates
+     * 
+     */
+    struct RenderRegion
+    {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        constexpr bool operator==(const RenderRegion &) const = default;
+
+        constexpr bool overlaps(const RenderRegion & other) const
+        {
+            return x < other.x + other.width && other.x < x + width &&
+                y < other.y + other.height && other.y < y + height;
+        }
     };
 
     /**
@@ -36,5 +59,9 @@ namespace velora
     {
         RenderMode mode = RenderMode::Solid;
         std::optional<PolygonOffset> polygon_offset;
+        // viewport inside of render target, whole render target when empty
+        std::optional<RenderRegion> region;
+
+        constexpr bool operator==(const RenderOptions &) const = default;
     };
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "native.hpp"
+#include <asio.hpp>
+
+#include "draw_item.hpp"
+#include "render.hpp"
+
+namespace velora
+{
+    /**
+     * @brief Per frame queue of draw items sorted by packed 64-bit key.
+     *
+     * Systems push draws in any order, queue sorts them once per frame with LSD radix sort
+     * and submits them in key order. Radix passes move only (key, index) pairs,
+     * draw items with their shader inputs are moved once at the end into sorted order,
+     * so whole queue can be handed to renderer as single contiguous list.
+     * Not thread safe, meant to be filled and submitted from single strand.
+     */
+    class RenderQueue
+    {
+        public:
+            RenderQueue() = default;
+            RenderQueue(const RenderQueue&) = delete;
+            RenderQueue(RenderQueue&&) = default;
+            RenderQueue& operator=(const RenderQueue&) = delete;
+            RenderQueue& operator=(RenderQueue&&) = default;
+            ~RenderQueue() = default;
+
+            void reserve(std::size_t size);
+
+            void push(DrawItem item);
+
+            // removes all items, keeps allocated memory for next frame
+            void clear();
+
+            std::size_t size() const;
+            bool empty() const;
+
+            /**
+             * @brief Stable radix sort of items by key, no-op when already sorted
+             */
+            void sort();
+
+            /**
+             * @brief Item at position in sorted order, `sort` must be called first
+             */
+            const DrawItem & operator[](std::size_t index) const;
+
+            /**
+             * @brief Push order of item at position in sorted order, `sort` must be called first
+             */
+            std::size_t getPushIndex(std::size_t index) const;
+
+            /**
+             * @brief All items in sorted order, `sort` must be called first
+             */
+            std::span<const DrawItem> getItems() const;
+
+            /**
+             * @brief Sorts queue if needed and renders all items in key order
+             * with single hop onto render thread
+             */
+            asio::awaitable<void> submit(IRenderer & renderer);
+
+        private:
+            constexpr static const uint32_t _RADIX_BITS = 8;
+            constexpr static const std::size_t _RADIX_SIZE = 1ull << _RADIX_BITS;
+            constexpr static const uint32_t _RADIX_PASSES = 64 / _RADIX_BITS;
+
+            // in push order until sorted, then in key order
+            std::vector<DrawItem> _items;
+            std::vector<DrawItem> _scratch_items;
+            // push order of every item in _items
+            std::vector<uint32_t> _push_indices;
+            std::vector<uint32_t> _scratch_push_indices;
+
+            // (key, index into _items)
+            std::vector<std::pair<uint64_t, uint32_t>> _order;
+            std::vector<std::pair<uint64_t, uint32_t>> _scratch;
+
+            bool _sorted = true;
+    };
+}
@@ -1,8 +1,15 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <span>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <variant>
 
 #include <glm/glm.hpp>
 #include <absl/container/flat_hash_map.h>
@@ -12,30 +19,111 @@
 
 namespace velora
 {
+    /**
+     * @brief Shader uniform name interned to small integer ID.
+     *
+     * Name is hashed only when uniform is created, create uniforms once (eg. static members)
+     * and reuse them for every draw. Same name always yields same ID,
+     * so shaders resolve uniforms to their locations by ID when program is linked.
+     */
+    class ShaderUniform
+    {
+        public:
+            constexpr static const uint32_t INVALID_ID = std::numeric_limits<uint32_t>::max();
+
+            ShaderUniform() = default;
+            explicit ShaderUniform(std::string_view name);
+
+            uint32_t ID() const { return _id; }
+
+            const std::string & getName() const;
+
+            // number of interned names, every ID is lower than this
+            static std::size_t getCount();
+
+        private:
+            uint32_t _id = INVALID_ID;
+    };
+
+    inline bool operator==(const ShaderUniform & lhs, const ShaderUniform & rhs){
+        return lhs.ID() == rhs.ID();
+    }
+
     /**
      * @brief Shader Inputs
-     * 
+     *
+     * Fixed layout block of uniform values and storage buffers of single draw,
+     * stored inline so building it never allocates.
+     * Array values are views, referenced data must outlive the draw.
      */
     struct ShaderInputs
     {
-        absl::flat_hash_map<std::string, bool> in_bool;
+        constexpr static const std::size_t MAX_UNIFORMS = 12;
+        constexpr static const std::size_t MAX_STORAGE_BUFFERS = 4;
+
+        // texture bound to sampler uniform
+        struct Sampler
+        {
+            std::size_t texture = 0;
+        };
+
+        // textures bound to sampler array uniform, consecutive texture units
+        struct SamplerArray
+        {
+            std::span<const std::size_t> textures;
+        };
+
+        using Value = std::variant<
+            bool,
+            int, float,
+            glm::vec2, glm::vec3, glm::vec4,
+            glm::mat2, glm::mat3, glm::mat4,
+            std::span<const glm::mat4>,
+            Sampler, SamplerArray>;
+
+        struct Input
+        {
+            ShaderUniform uniform;
+            Value value;
+        };
+
+        ShaderInputs() = default;
+        ShaderInputs(std::initializer_list<Input> inputs, std::initializer_list<std::size_t> storage_buffers = {});
 
-        absl::flat_hash_map<std::string, int> in_int;
-        absl::flat_hash_map<std::string, float> in_float;
-
-        absl::flat_hash_map<std::string, glm::vec2> in_vec2;
-        absl::flat_hash_map<std::string, glm::vec3> in_vec3;
-        absl::flat_hash_map<std::string, glm::vec4> in_vec4;
+        /**
+         * @brief Sets value of uniform, replaces value already set for it.
+         * @return false when block is full and value was dropped
+         */
+        bool set(ShaderUniform uniform, Value value);
+
+        // false when block is full and buffer was dropped
+        bool addStorageBuffer(std::size_t storage_buffer);
+
+        // nullptr when uniform is not set or holds value of other type
+        template<class T>
+        const T * find(ShaderUniform uniform) const
+        {
+            for(const Input & input : getInputs())
+            {
+                if(input.uniform == uniform)return std::get_if<T>(&input.value);
+            }
+            return nullptr;
+        }
 
-        absl::flat_hash_map<std::string, glm::mat2> in_mat2;
-        absl::flat_hash_map<std::string, glm::mat3> in_mat3;
-        absl::flat_hash_map<std::string, glm::mat4> in_mat4;
-        absl::flat_hash_map<std::string, std::vector<glm::mat4>> in_mat4_array;
+        /**
+         * @brief Same uniform values set in same order and same storage buffers.
+         * Array values are equal when they view the same memory, their content is not compared.
+         */
+        bool operator==(const ShaderInputs & other) const;
 
-        absl::flat_hash_map<std::string, std::size_t> in_samplers;
-        absl::flat_hash_map<std::string, std::vector<std::size_t>> in_samplers_array;
+        std::span<const Input> getInputs() const { return std::span<const Input>(_inputs.data(), _inputs_count); }
+        std::span<const std::size_t> getStorageBuffers() const { return std::span<const std::size_t>(_storage_buffers.data(), _storage_buffers_count); }
 
-        std::vector<std::size_t> storage_buffers;
+        private:
+            std::array<Input, MAX_UNIFORMS> _inputs;
+            std::array<std::size_t, MAX_STORAGE_BUFFERS> _storage_buffers{};
+            uint8_t _inputs_count = 0;
+            uint8_t _storage_buffers_count = 0;
     };
 
     /**
@@ -54,126 +142,113 @@ namespace velora
          */
         virtual std::size_t ID() const = 0;
 
-        /**
-         * @brief Check if the shader is valid.
-         * 
-         * @return True if the shader is valid, false otherwise.
-         */
-        virtual bool enable() = 0;
-
-        /**
-         * @brief Disable the shader.
-         * 
-         */
-        virtual bool disable() = 0;
-
         /**
          * @brief Set boolean uniform value in the shader.
          * 
-         * @param name The name of the uniform.
+         * @param uniform The uniform.
          * @param value Boolean value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, bool value) = 0;
+        virtual void setUniform(ShaderUniform uniform, bool value) = 0;
 
         /**
          * @brief Set the integer uniform value in the shader.
          * 
-         * @param name The name of the uniform.
+         * @param uniform The uniform.
          * @param value Integer value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, int value) = 0;
+        virtual void setUniform(ShaderUniform uniform, int value) = 0;
 
         /**
          * @brief Set the float uniform value in the shader.
          * 
-         * @param name The name of the uniform.
+         * @param uniform The uniform.
          * @param value Float value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, float value)= 0;
+        virtual void setUniform(ShaderUniform uniform, float value)= 0;
 
         /**
          * @brief Set the 2D float vector uniform value in the shader.
          * 
-         * @param name The name of the uniform.
+         * @param uniform The uniform.
          * @param value 2D float Vector value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, const glm::vec2 & value)= 0;
+        virtual void setUniform(ShaderUniform uniform, const glm::vec2 & value)= 0;
 
         /**
          * @brief Set the 3D float vector uniform value in the shader.
          * 
-         * @param name The name of the uniform.
+         * @param uniform The uniform.
          * @param value 3D float Vector value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, const glm::vec3 & value)= 0;
+        virtual void setUniform(ShaderUniform uniform, const glm::vec3 & value)= 0;
 
         /**
          * @brief Set the 4D float vector uniform value in the shader.
          * 
-         * @param name The name of the uniform.
+         * @param uniform The uniform.
          * @param value 4D float Vector value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, const glm::vec4 & value)= 0;
+        virtual void setUniform(ShaderUniform uniform, const glm::vec4 & value)= 0;
 
         /**
          * @brief Set the 2D float matrix uniform value in the shader.
          * 
-         * @param name The name of the uniform.
+         * @param uniform The uniform.
          * @param value 2D float Matrix value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, const glm::mat2 & value)= 0;
+        virtual void setUniform(ShaderUniform uniform, const glm::mat2 & value)= 0;
 
         /**
          * @brief Set the 3D float matrix uniform value in the shader.
          * 
-         * @param name The name of the uniform.
+         * @param uniform The uniform.
          * @param value 3D float Matrix value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, const glm::mat3 & value)= 0;
+        virtual void setUniform(ShaderUniform uniform, const glm::mat3 & value)= 0;
 
         /**
          * @brief Set the 4D float matrix uniform value in the shader.
          * 
-         * @param name The name of the uniform.
+         * @param uniform The uniform.
          * @param value 4D float Matrix value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, const glm::mat4 & value)= 0;
+        virtual void setUniform(ShaderUniform uniform, const glm::mat4 & value)= 0;
 
         /**
          * @brief Set the 4D float matrix array uniform value in the shader.
          * 
-         * @param name The name of the uniform.
-         * @param value 4D float Matrix array value of the uniform.
+         * @param uniform The uniform.
+         * @param values 4D float Matrix array value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, const std::vector<glm::mat4> & values)= 0;
+        virtual void setUniform(ShaderUniform uniform, std::span<const glm::mat4> values)= 0;
 
         /**
          * @brief Set the texture uniform value in the shader.
          * 
-         * @param name The name of the uniform.
+         * @param uniform The uniform.
          * @param value Texture value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, unsigned int unit, const ITexture & value)= 0;
+        virtual void setUniform(ShaderUniform uniform, unsigned int unit, const ITexture & value)= 0;
 
         /**
          * @brief Set the texture array uniform value in the shader.
          * 
-         * @param name The name of the uniform.
-         * @param value Texture array value of the uniform.
+         * @param uniform The uniform.
+         * @param values Texture array value of the uniform.
          * 
          */
-        virtual void setUniform(const std::string & name, unsigned int unit, const std::vector<ITexture*> & values)= 0;
+        virtual void setUniform(ShaderUniform uniform, unsigned int unit, std::span<ITexture * const> values)= 0;
 
     };
 
@@ -190,25 +265,23 @@ namespace velora
 
             constexpr inline std::size_t ID() const override { return dispatch::getImpl().ID();}
 
-            constexpr inline bool enable() override { return dispatch::getImpl().enable();}
-            constexpr inline bool disable() override { return dispatch::getImpl().disable();}
 
-            constexpr inline void setUniform(const std::string & name, bool value) override { return dispatch::getImpl().setUniform(name, value);}
+            constexpr inline void setUniform(ShaderUniform uniform, bool value) override { return dispatch::getImpl().setUniform(uniform, value);}
 
-            constexpr inline void setUniform(const std::string & name, int value) override { return dispatch::getImpl().setUniform(name, value);}
-            constexpr inline void setUniform(const std::string & name, float value) override { return dispatch::getImpl().setUniform(name, value);}
+            constexpr inline void setUniform(ShaderUniform uniform, int value) override { return dispatch::getImpl().setUniform(uniform, value);}
+            constexpr inline void setUniform(ShaderUniform uniform, float value) override { return dispatch::getImpl().setUniform(uniform, value);}
 
-            constexpr inline void setUniform(const std::string & name, const glm::vec2 & value) override { return dispatch::getImpl().setUniform(name, value);}
-            constexpr inline void setUniform(const std::string & name, const glm::vec3 & value) override { return dispatch::getImpl().setUniform(name, value);}
-            constexpr inline void setUniform(const std::string & name, const glm::vec4 & value) override { return dispatch::getImpl().setUniform(name, value);}
+            constexpr inline void setUniform(ShaderUniform uniform, const glm::vec2 & value) override { return dispatch::getImpl().setUniform(uniform, value);}
+            constexpr inline void setUniform(ShaderUniform uniform, const glm::vec3 & value) override { return dispatch::getImpl().setUniform(uniform, value);}
+            constexpr inline void setUniform(ShaderUniform uniform, const glm::vec4 & value) override { return dispatch::getImpl().setUniform(uniform, value);}
 
-            constexpr inline void setUniform(const std::string & name, const glm::mat2 & value) override { return dispatch::getImpl().setUniform(name, value);}
-            constexpr inline void setUniform(const std::string & name, const glm::mat3 & value) override { return dispatch::getImpl().setUniform(name, value);}
-            constexpr inline void setUniform(const std::string & name, const glm::mat4 & value) override { return dispatch::getImpl().setUniform(name, value);}
-            constexpr inline void setUniform(const std::string & name, const std::vector<glm::mat4> & values) override { return dispatch::getImpl().setUniform(name, values);}
+            constexpr inline void setUniform(ShaderUniform uniform, const glm::mat2 & value) override { return dispatch::getImpl().setUniform(uniform, value);}
+            constexpr inline void setUniform(ShaderUniform uniform, const glm::mat3 & value) override { return dispatch::getImpl().setUniform(uniform, value);}
+            constexpr inline void setUniform(ShaderUniform uniform, const glm::mat4 & value) override { return dispatch::getImpl().setUniform(uniform, value);}
+            constexpr inline void setUniform(ShaderUniform uniform, std::span<const glm::mat4> values) override { return dispatch::getImpl().setUniform(uniform, values);}
 
-            constexpr inline void setUniform(const std::string & name, unsigned int unit, const ITexture & value) override { return dispatch::getImpl().setUniform(name, unit, value);}
-            constexpr inline void setUniform(const std::string & name, unsigned int unit, const std::vector<ITexture*> & values) override { return dispatch::getImpl().setUniform(name, unit, values);}
+            constexpr inline void setUniform(ShaderUniform uniform, unsigned int unit, const ITexture & value) override { return dispatch::getImpl().setUniform(uniform, unit, value);}
+            constexpr inline void setUniform(ShaderUniform uniform, unsigned int unit, std::span<ITexture * const> values) override { return dispatch::getImpl().setUniform(uniform, unit, values);}
  
     };
 
@@ -37,20 +37,11 @@ namespace velora
         virtual bool good() const = 0;
 
         /**
-         * @brief Enable the shader storage buffer.
+         * @brief Get the binding point of the shader storage buffer.
          * 
-         * @return True if the shader storage buffer was successfully enabled, false otherwise.
-         * 
-         * @note This function must be called on the render thread strand.
-         */
-        virtual bool enable() const = 0;
-
-        /**
-         * @brief Disable the shader storage buffer.
-         * 
-         * @note This function must be called on the render thread strand.
+         * @return The binding point shaders read the buffer from.
          */
-        virtual void disable() const = 0;
+        virtual unsigned int getBindingPoint() const = 0;
 
         /**
          * @brief Update the data of the shader storage buffer.
@@ -76,8 +67,7 @@ namespace velora
 
             constexpr inline std::size_t ID() const override { return dispatch::getImpl().ID();}
             constexpr inline bool good() const override { return dispatch::getImpl().good();}
-            constexpr inline bool enable() const override { return dispatch::getImpl().enable();}
-            constexpr inline void disable() const override { return dispatch::getImpl().disable();}
+            constexpr inline unsigned int getBindingPoint() const override { return dispatch::getImpl().getBindingPoint();}
             constexpr inline void update(std::size_t size, const void * data) override { return dispatch::getImpl().update(std::move(size), std::move(data));}
     };
 
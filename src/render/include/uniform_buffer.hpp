@@ -0,0 +1,106 @@
+
+#pragma once
+
+#include "type.hpp"
+#include <string>
+#include <utility>
+
+namespace velora
+{
+    /**
+     * @brief Interface for Uniform Buffer Objects (UBO)
+     * 
+     * @note This interface is used to create and manage Uniform Buffer Objects (UBO).
+     * Buffer stays bound to its binding point, so draws never reference it,
+     * upload it once per frame or pass and every shader with matching uniform block reads it.
+     * 
+     */
+    class IUniformBuffer : public type::Interface
+    {
+        public:
+        virtual ~IUniformBuffer() = default;
+
+        /**
+         * @brief Get the ID of the uniform buffer.
+         * 
+         * @return The ID of the uniform buffer.
+         * 
+         * @note This function must be called on the render thread strand.
+         */
+        virtual std::size_t ID() const = 0;
+        
+        /**
+         * @brief Check if the uniform buffer is valid.
+         * 
+         * @return True if the uniform buffer is valid, false otherwise.
+         * 
+         * @note This function must be called on the render thread strand.
+         */
+        virtual bool good() const = 0;
+
+        /**
+         * @brief Get the binding point the uniform buffer is bound to.
+         * 
+         * @return Binding point of uniform block in shaders (std140 layout).
+         * 
+         * @note This function must be called on the render thread strand.
+         */
+        virtual unsigned int getBindingPoint() const = 0;
+
+        /**
+         * @brief Update the data of the uniform buffer.
+         * 
+         * @param size The size of the data to update.
+         * @param data The data to update.
+         * 
+         * @note This function must be called on the render thread strand.
+         */
+        virtual void update(std::size_t size, const void * data) = 0;
+    };
+
+    template<class UniformBufferImplType>
+    class UniformBufferDispatcher final : public type::Dispatcher<IUniformBuffer, UniformBufferImplType>
+    {
+        public:
+            using dispatch = type::Dispatcher<IUniformBuffer, UniformBufferImplType>;
+
+            inline UniformBufferDispatcher(UniformBufferImplType && obj) : dispatch(std::move(obj)){}
+            template<class... Args>                                                                             
+            inline UniformBufferDispatcher(Args && ... args) : dispatch(std::forward<Args>(args)...){} 
+            inline ~UniformBufferDispatcher() = default;
+
+            constexpr inline std::size_t ID() const override { return dispatch::getImpl().ID();}
+            constexpr inline bool good() const override { return dispatch::getImpl().good();}
+            constexpr inline unsigned int getBindingPoint() const override { return dispatch::getImpl().getBindingPoint();}
+            constexpr inline void update(std::size_t size, const void * data) override { return dispatch::getImpl().update(std::move(size), std::move(data));}
+    };
+
+    template<class UniformBufferImplType>
+    UniformBufferDispatcher(UniformBufferImplType && ) -> UniformBufferDispatcher<UniformBufferImplType>;
+
+    class UniformBuffer : public type::Implementation<IUniformBuffer, UniformBufferDispatcher> 
+    {                                                                   
+        public:
+            /* move ctor */
+            UniformBuffer(UniformBuffer && other) = default;
+            UniformBuffer & operator=(UniformBuffer && other) = default;
+
+            /* dtor */
+            virtual ~UniformBuffer() = default;
+        
+            /* ctor */
+            template<class UniformBufferImplType>
+            UniformBuffer(UniformBufferImplType && impl)
+            : Implementation(std::move(impl))
+            {}                                                          
+    };
+
+    template <typename H>
+    constexpr inline H AbslHashValue(H h, const UniformBuffer & vb) {
+        return H::combine(std::move(h), vb->ID());
+    }
+
+    constexpr inline bool operator==(const UniformBuffer & lhs, const UniformBuffer & rhs){
+        return lhs->ID() == rhs->ID();
+    }
+}
\ No newline at end of file
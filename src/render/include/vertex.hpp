@@ -3,6 +3,7 @@
 #include <vector>
 #include <algorithm>
 #include <array>
+#include <cstdint>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
@@ -25,6 +26,54 @@ namespace velora
     };
     #pragma pack(pop) // each vertex is now exactly 8 floats = 32 bytes, no extra padding
 
+    #pragma pack(push, 1)
+    /**
+     * @brief Vertex with half float position and uv and 10 bit signed normalized normal, 16 bytes.
+     * 
+     * GPU converts every attribute to float, shaders read it the same way as Vertex.
+     */
+    struct CompressedVertex
+    {
+        std::array<uint16_t, 3> position;
+        uint16_t padding;
+        // x in lowest 10 bits, then y and z, 2 highest bits unused
+        uint32_t normal;
+        std::array<uint16_t, 2> uv;
+    };
+    #pragma pack(pop)
+
+    /**
+     * @brief Layout of vertices of mesh on GPU
+     * 
+     */
+    enum class VertexFormat : uint8_t
+    {
+        Float = 0,      // Vertex
+        Compressed,     // CompressedVertex
+        Count
+    };
+
+    /**
+     * @brief Width of indices of mesh on GPU, indices are relative to first vertex of mesh
+     * 
+     */
+    enum class IndexFormat : uint8_t
+    {
+        UInt32 = 0,
+        UInt16,
+        Count
+    };
+
+    constexpr inline std::size_t getVertexFormatSize(VertexFormat format)
+    {
+        return format == VertexFormat::Compressed ? sizeof(CompressedVertex) : sizeof(Vertex);
+    }
+
+    constexpr inline std::size_t getIndexFormatSize(IndexFormat format)
+    {
+        return format == IndexFormat::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    }
+
     /**
      * @brief Mesh
      * 
@@ -90,4 +139,63 @@ namespace velora
      * @return The cylinder prefab object.
      */
     const Mesh& getCylinderPrefab(unsigned int segments = 32);
+
+    /**
+     * @brief Simplifies mesh by vertex clustering.
+     * 
+     * Bounds of mesh are split into grid_resolution cells along longest axis, vertices of one cell
+     * facing the same direction are merged into their average, collapsed and duplicate triangles are removed.
+     * 
+     * @param mesh The mesh to simplify.
+     * @param grid_resolution The number of cells along longest axis, lower is coarser.
+     * @return The simplified mesh, copy of mesh when it cannot be simplified.
+     */
+    Mesh simplifyMesh(const Mesh & mesh, unsigned int grid_resolution);
+
+    /**
+     * @brief Generates levels of detail of mesh by simplifying it on coarser and coarser grids.
+     * 
+     * Level is kept only when it removes enough triangles of previous level,
+     * so meshes that are already coarse get shorter chains.
+     * 
+     * @param mesh The mesh of full detail.
+     * @param max_levels The maximal number of levels including full detail one.
+     * @return The levels from finest to coarsest, first level is copy of mesh.
+     */
+    std::vector<Mesh> generateLODChain(const Mesh & mesh, unsigned int max_levels);
+
+    /**
+     * @brief Chooses most compact vertex format that keeps mesh precise enough.
+     * 
+     * Half float positions are used when their rounding error stays small against size of mesh,
+     * so only meshes far from their origin or larger than half float range keep float positions.
+     * 
+     * @param vertices The vertices of mesh.
+     * @return VertexFormat::Compressed when positions and uvs fit, VertexFormat::Float otherwise.
+     */
+    VertexFormat chooseVertexFormat(const std::vector<Vertex> & vertices);
+
+    /**
+     * @brief Chooses narrowest index format able to address every vertex of mesh.
+     * 
+     * @param vertex_count The number of vertices of mesh.
+     * @return The index format.
+     */
+    IndexFormat chooseIndexFormat(std::size_t vertex_count);
+
+    /**
+     * @brief Encodes vertices into CompressedVertex layout, normals are normalized before encoding.
+     * 
+     * @param vertices The vertices to encode.
+     * @return The encoded vertices.
+     */
+    std::vector<CompressedVertex> compressVertices(const std::vector<Vertex> & vertices);
+
+    /**
+     * @brief Narrows indices to 16 bits, every index must be below 65536.
+     * 
+     * @param indices The indices to narrow.
+     * @return The narrowed indices.
+     */
+    std::vector<uint16_t> narrowIndices(const std::vector<unsigned int> & indices);
 }
\ No newline at end of file
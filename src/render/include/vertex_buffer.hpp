@@ -5,6 +5,8 @@
 #include <string>
 #include <utility>
 
+#include "bounds.hpp"
+
 namespace velora
 {
     /**
@@ -38,17 +40,39 @@ namespace velora
         virtual std::size_t numberOfElements() const = 0;
 
         /**
-         * @brief Enable the vertex buffer for rendering.
+         * @brief Get the position of the first index of the mesh in the index buffer it may share with other meshes.
+         * 
+         * @return The first index, 0 when the mesh has index buffer of its own.
+         */
+        virtual std::size_t firstIndex() const = 0;
+
+        /**
+         * @brief Get the value added to every index of the mesh, position of its first vertex in shared vertex buffer.
+         * 
+         * @return The base vertex, 0 when the mesh has vertex buffer of its own.
+         */
+        virtual std::size_t baseVertex() const = 0;
+
+        /**
+         * @brief Get the layout vertices of the mesh are stored in.
+         * 
+         * @return The vertex format chosen for the mesh when the vertex buffer was constructed.
+         */
+        virtual VertexFormat vertexFormat() const = 0;
+
+        /**
+         * @brief Get the width of indices of the mesh.
          * 
-         * @return True if the vertex buffer was successfully enabled, false otherwise.
+         * @return The index format chosen for the mesh when the vertex buffer was constructed.
          */
-        virtual bool enable() const = 0;
+        virtual IndexFormat indexFormat() const = 0;
 
         /**
-         * @brief Disable the vertex buffer.
+         * @brief Get the local space bounds of mesh, computed when the vertex buffer is constructed.
          * 
+         * @return The bounds of the mesh.
          */
-        virtual void disable() const = 0;
+        virtual const MeshBounds & getBounds() const = 0;
     };
 
     template<class VertexBufferImplType>
@@ -65,8 +89,11 @@ namespace velora
             constexpr inline std::size_t ID() const override { return dispatch::getImpl().ID();}
             constexpr inline bool good() const override { return dispatch::getImpl().good();}
             constexpr inline std::size_t numberOfElements() const override { return dispatch::getImpl().numberOfElements();}
-            constexpr inline bool enable() const override { return dispatch::getImpl().enable();}
-            constexpr inline void disable() const override { return dispatch::getImpl().disable();}
+            constexpr inline std::size_t firstIndex() const override { return dispatch::getImpl().firstIndex();}
+            constexpr inline std::size_t baseVertex() const override { return dispatch::getImpl().baseVertex();}
+            constexpr inline VertexFormat vertexFormat() const override { return dispatch::getImpl().vertexFormat();}
+            constexpr inline IndexFormat indexFormat() const override { return dispatch::getImpl().indexFormat();}
+            constexpr inline const MeshBounds & getBounds() const override { return dispatch::getImpl().getBounds();}
     };
 
     template<class VertexBufferImplType>
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "native.hpp"
+#include <asio.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <glm/glm.hpp>
+
+#include "render.hpp"
+
+namespace velora::null
+{
+    /**
+     * @brief Single recorded renderer command
+     */
+    struct NullRenderCommand
+    {
+        enum class Type : uint8_t
+        {
+            Clear,
+            CopyDepth,
+            Draw,
+            Present,
+            UpdateViewport,
+            UpdateShaderStorageBuffer,
+            UpdateUniformBuffer,
+            SetVSync
+        };
+
+        Type type;
+        uint64_t frame = 0;
+
+        // target of clear, depth copy and draw, std::nullopt is default framebuffer
+        std::optional<std::size_t> fbo = std::nullopt;
+        // source of depth copy
+        std::optional<std::size_t> source_fbo = std::nullopt;
+        // part of target of clear, depth copy and draw, std::nullopt is whole target
+        std::optional<RenderRegion> region = std::nullopt;
+
+        // draw
+        std::size_t vertex_buffer = 0;
+        std::size_t shader = 0;
+        RenderMode mode = RenderMode::Solid;
+        bool polygon_offset = false;
+        uint32_t elements = 0;
+        uint32_t instances = 1;
+        uint32_t uniforms = 0;
+        uint32_t uniform_bytes = 0;
+        uint32_t samplers = 0;
+        uint32_t storage_buffers = 0;
+
+        // shader storage or uniform buffer update
+        std::size_t storage_buffer = 0;
+        std::size_t data_bytes = 0;
+    };
+
+    /**
+     * @brief Counters of one frame, frame ends with present
+     */
+    struct NullFrameStats
+    {
+        uint64_t frame = 0;
+
+        uint32_t clears = 0;
+        uint32_t depth_copies = 0;
+        uint32_t draw_calls = 0;
+        // batched draw lists, each is single hop onto strand
+        uint32_t submits = 0;
+        uint64_t instances = 0;
+        uint64_t triangles = 0;
+
+        uint32_t uniforms = 0;
+        uint64_t uniform_bytes = 0;
+        uint32_t samplers = 0;
+
+        // number of times bound object changed between consecutive draw calls
+        uint32_t vertex_buffer_switches = 0;
+        uint32_t shader_switches = 0;
+        uint32_t fbo_switches = 0;
+
+        uint32_t storage_buffer_updates = 0;
+        uint64_t storage_buffer_bytes = 0;
+
+        uint32_t uniform_buffer_updates = 0;
+        uint64_t uniform_buffer_bytes = 0;
+    };
+
+    /**
+     * @brief `IRenderer` implementation without GPU.
+     * Hands out fake resource IDs, records compact command log and per-frame counters.
+     * Used to profile and test CPU side of rendering without window or OpenGL context.
+     * Commands hop onto own strand like on render thread, so submission overhead stays comparable.
+     *
+     * To inspect log and counters keep `RendererDispatcher<NullRenderer>` and use `getImpl()`.
+     */
+    class NullRenderer
+    {
+        public:
+            NullRenderer(asio::io_context & io_context, Resolution viewport, bool record_commands = true);
+            NullRenderer(NullRenderer && other) = default;
+            NullRenderer & operator=(NullRenderer && other) = default;
+            NullRenderer(const NullRenderer &) = delete;
+            NullRenderer & operator=(const NullRenderer &) = delete;
+            ~NullRenderer() = default;
+
+            static asio::awaitable<NullRenderer> asyncConstructor(asio::io_context & io_context, Resolution viewport, bool record_commands = true);
+
+            bool good() const;
+
+            asio::awaitable<void> close();
+
+            asio::awaitable<void> clearScreen(glm::vec4 color, std::optional<std::size_t> fbo, std::optional<RenderRegion> region);
+            asio::awaitable<void> copyFrameBufferObjectDepth(std::size_t source, std::size_t destination, std::optional<RenderRegion> region);
+            asio::awaitable<void> clearScreenRegions(glm::vec4 color, std::optional<std::size_t> fbo, std::span<const RenderRegion> regions);
+            asio::awaitable<void> copyFrameBufferObjectDepthRegions(std::size_t source, std::size_t destination, std::span<const RenderRegion> regions);
+            asio::awaitable<void> render(std::size_t vertex_buffer,
+                std::size_t shader,
+                ShaderInputs shader_inputs,
+                RenderOptions options,
+                std::optional<std::size_t> fbo);
+            asio::awaitable<void> renderInstanced(std::size_t vertex_buffer,
+                std::size_t shader,
+                std::size_t instance_count,
+                ShaderInputs shader_inputs,
+                RenderOptions options,
+                std::optional<std::size_t> fbo);
+            asio::awaitable<void> submit(std::span<const DrawItem> draws);
+                
+            asio::awaitable<void> present();
+            asio::awaitable<void> updateViewport(Resolution resolution);
+            Resolution getViewport() const;
+            asio::awaitable<void> enableVSync();
+            asio::awaitable<void> disableVSync();
+
+            asio::awaitable<std::optional<std::size_t>> constructVertexBuffer(std::string name, const Mesh & mesh);
+            asio::awaitable<bool> eraseVertexBuffer(std::size_t id);
+            std::optional<std::size_t> getVertexBuffer(std::string name) const;
+            std::optional<MeshBounds> getVertexBufferBounds(std::size_t id) const;
+            std::optional<std::size_t> getVertexBufferElementCount(std::size_t id) const;
+
+            asio::awaitable<std::optional<std::size_t>> constructShader(std::string name, std::vector<std::string> vertex_code);
+            asio::awaitable<std::optional<std::size_t>> constructShader(std::string name, std::vector<std::string> vertex_code, std::vector<std::string> fragment_code);
+            asio::awaitable<bool> eraseShader(std::size_t id);
+            std::optional<std::size_t> getShader(std::string name) const;
+
+            asio::awaitable<std::optional<std::size_t>> constructShaderStorageBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data);
+            asio::awaitable<bool> eraseShaderStorageBuffer(std::size_t id);
+            std::optional<std::size_t> getShaderStorageBuffer(std::string name) const;
+            asio::awaitable<bool> updateShaderStorageBuffer(std::size_t id, const std::size_t size, const void * data);
+
+            asio::awaitable<std::optional<std::size_t>> constructUniformBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data);
+            asio::awaitable<bool> eraseUniformBuffer(std::size_t id);
+            std::optional<std::size_t> getUniformBuffer(std::string name) const;
+            asio::awaitable<bool> updateUniformBuffer(std::size_t id, const std::size_t size, const void * data);
+            
+            asio::awaitable<std::optional<std::size_t>> constructFrameBufferObject(std::string name, Resolution resolution, std::initializer_list<FBOAttachment> attachments);
+            asio::awaitable<bool> eraseFrameBufferObject(std::size_t id);
+            std::optional<std::size_t> getFrameBufferObject(std::string name) const;
+            std::vector<std::size_t> getFrameBufferObjectTextures(std::size_t id) const;
+
+            uint64_t getObjectGeneration() const;
+
+            void join();
+
+            const std::vector<NullRenderCommand> & getCommandLog() const;
+            void clearCommandLog();
+
+            // counters of last presented frame
+            const NullFrameStats & getFrameStats() const;
+            // counters of frame in progress
+            const NullFrameStats & getCurrentFrameStats() const;
+
+            bool isVSyncEnabled() const;
+
+        private:
+            struct NullVertexBuffer
+            {
+                std::string name;
+                uint32_t elements;
+                MeshBounds bounds;
+            };
+
+            struct NullShader
+            {
+                std::string name;
+            };
+
+            struct NullShaderStorageBuffer
+            {
+                std::string name;
+                unsigned int binding_point;
+                std::size_t size;
+            };
+
+            struct NullUniformBuffer
+            {
+                std::string name;
+                unsigned int binding_point;
+                std::size_t size;
+            };
+
+            struct NullFrameBufferObject
+            {
+                std::string name;
+                Resolution resolution;
+                std::vector<std::size_t> textures;
+            };
+
+            asio::awaitable<void> ensureOnStrand();
+
+            void recordDraw(std::size_t vertex_buffer,
+                std::size_t shader,
+                std::size_t instance_count,
+                const ShaderInputs & shader_inputs,
+                const RenderOptions & options,
+                std::optional<std::size_t> fbo);
+
+            template<class T>
+            std::optional<std::size_t> emplaceObject(
+                absl::flat_hash_map<std::size_t, T> & object_map,
+                absl::flat_hash_map<std::string, std::size_t> & name_map,
+                std::string name, T && object)
+            {
+                if(name_map.contains(name))
+                {
+                    spdlog::warn(std::format("[t:{}] renderer object {} already exists", std::this_thread::get_id(), name));
+                    return std::nullopt;
+                }
+
+                const std::size_t id = _next_id++;
+                object_map.try_emplace(id, std::move(object));
+                name_map.try_emplace(std::move(name), id);
+                _object_generation->fetch_add(1, std::memory_order_release);
+                return id;
+            }
+
+            template<class T>
+            std::optional<std::size_t> findObject(
+                const absl::flat_hash_map<std::size_t, T> & object_map,
+                const absl::flat_hash_map<std::string, std::size_t> & name_map,
+                const std::string & name) const
+            {
+                if(good() == false) return std::nullopt;
+
+                auto it = name_map.find(name);
+                if(it == name_map.end() || object_map.contains(it->second) == false)
+                {
+                    spdlog::warn(std::format("[t:{}] renderer object {} does not exist", std::this_thread::get_id(), name));
+                    return std::nullopt;
+                }
+                return it->second;
+            }
+
+            template<class T>
+            bool eraseObject(
+                absl::flat_hash_map<std::size_t, T> & object_map,
+                absl::flat_hash_map<std::string, std::size_t> & name_map,
+                std::size_t id)
+            {
+                auto it = object_map.find(id);
+                if(it == object_map.end())
+                {
+                    spdlog::warn(std::format("[t:{}] renderer object {} does not exist", std::this_thread::get_id(), id));
+                    return false;
+                }
+                name_map.erase(it->second.name);
+                object_map.erase(it);
+                _object_generation->fetch_add(1, std::memory_order_release);
+                return true;
+            }
+
+            void record(NullRenderCommand command);
+
+            asio::strand<asio::io_context::executor_type> _strand;
+
+            // read from any thread through good(), unique_ptr keeps renderer movable
+            std::unique_ptr<std::atomic<bool>> _good = std::make_unique<std::atomic<bool>>(true);
+            bool _record_commands;
+            bool _vsync = false;
+
+            Resolution _viewport_resolution;
+
+            // 0 is never handed out so it can be used as invalid id
+            std::size_t _next_id = 1;
+
+            // incremented on every construct and erase, unique_ptr keeps renderer movable
+            std::unique_ptr<std::atomic<uint64_t>> _object_generation = std::make_unique<std::atomic<uint64_t>>(0);
+
+            absl::flat_hash_map<std::size_t, NullVertexBuffer> _vertex_buffers;
+            absl::flat_hash_map<std::size_t, NullShader> _shaders;
+            absl::flat_hash_map<std::size_t, NullShaderStorageBuffer> _shader_storage_buffers;
+            absl::flat_hash_map<std::size_t, NullUniformBuffer> _uniform_buffers;
+            absl::flat_hash_map<std::size_t, NullFrameBufferObject> _frame_buffer_objects;
+
+            absl::flat_hash_map<std::string, std::size_t> _vertex_buffer_names;
+            absl::flat_hash_map<std::string, std::size_t> _shader_names;
+            absl::flat_hash_map<std::string, std::size_t> _shader_storage_buffer_names;
+            absl::flat_hash_map<std::string, std::size_t> _uniform_buffer_names;
+            absl::flat_hash_map<std::string, std::size_t> _frame_buffer_object_names;
+
+            std::vector<NullRenderCommand> _command_log;
+
+            NullFrameStats _frame_stats;
+            NullFrameStats _current_frame_stats;
+
+            // last bound objects, used to count switches
+            std::optional<std::size_t> _bound_vertex_buffer;
+            std::optional<std::size_t> _bound_shader;
+            std::optional<std::size_t> _bound_fbo;
+    };
+}
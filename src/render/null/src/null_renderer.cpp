@@ -0,0 +1,593 @@
+#include "null_renderer.hpp"
+
+namespace velora::null
+{
+    namespace
+    {
+        // bytes uploaded for uniform value, samplers are counted separately
+        template<class T>
+        void countUniform(const T &, uint32_t & count, uint32_t & bytes)
+        {
+            count += 1;
+            bytes += (uint32_t)std::max(sizeof(T), sizeof(int));
+        }
+
+        void countUniform(const std::span<const glm::mat4> & values, uint32_t & count, uint32_t & bytes)
+        {
+            count += (uint32_t)values.size();
+            bytes += (uint32_t)(values.size() * sizeof(glm::mat4));
+        }
+    }
+
+    asio::awaitable<NullRenderer> NullRenderer::asyncConstructor(asio::io_context & io_context, Resolution viewport, bool record_commands)
+    {
+        co_return NullRenderer(io_context, viewport, record_commands);
+    }
+
+    NullRenderer::NullRenderer(asio::io_context & io_context, Resolution viewport, bool record_commands)
+    :   _strand(asio::make_strand(io_context)),
+        _record_commands(record_commands),
+        _viewport_resolution(viewport)
+    {
+        spdlog::debug(std::format("[null] [t:{}] Null renderer created {}x{}", std::this_thread::get_id(),
+            _viewport_resolution.getWidth(), _viewport_resolution.getHeight()));
+    }
+
+    asio::awaitable<void> NullRenderer::ensureOnStrand()
+    {
+        if(!_strand.running_in_this_thread()) {
+            co_return co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        co_return;
+    }
+
+    void NullRenderer::record(NullRenderCommand command)
+    {
+        if(_record_commands == false)return;
+
+        command.frame = _current_frame_stats.frame;
+        _command_log.emplace_back(std::move(command));
+    }
+
+    bool NullRenderer::good() const
+    {
+        return _good != nullptr && _good->load(std::memory_order_acquire);
+    }
+
+    void NullRenderer::join()
+    {
+        // there is no render thread, commands run on strand of callers io_context
+        if(_good != nullptr)_good->store(false, std::memory_order_release);
+    }
+
+    uint64_t NullRenderer::getObjectGeneration() const
+    {
+        return _object_generation->load(std::memory_order_acquire);
+    }
+
+    asio::awaitable<void> NullRenderer::close()
+    {
+        if(good() == false)co_return;
+
+        co_await ensureOnStrand();
+
+        spdlog::debug(std::format("[null] [t:{}] close", std::this_thread::get_id()));
+
+        _good->store(false, std::memory_order_release);
+
+        _vertex_buffers.clear();
+        _shaders.clear();
+        _shader_storage_buffers.clear();
+        _uniform_buffers.clear();
+        _frame_buffer_objects.clear();
+
+        _vertex_buffer_names.clear();
+        _shader_names.clear();
+        _shader_storage_buffer_names.clear();
+        _uniform_buffer_names.clear();
+        _frame_buffer_object_names.clear();
+
+        co_return;
+    }
+
+    asio::awaitable<void> NullRenderer::clearScreen(glm::vec4 color, std::optional<std::size_t> fbo, std::optional<RenderRegion> region)
+    {
+        if(good() == false)co_return;
+
+        co_await ensureOnStrand();
+
+        if(fbo && _frame_buffer_objects.contains(*fbo) == false)
+        {
+            spdlog::error("Frame buffer object not found");
+            co_return;
+        }
+
+        _current_frame_stats.clears++;
+        record(NullRenderCommand{.type = NullRenderCommand::Type::Clear, .fbo = fbo, .region = region});
+
+        co_return;
+    }
+
+    asio::awaitable<void> NullRenderer::copyFrameBufferObjectDepth(std::size_t source, std::size_t destination, std::optional<RenderRegion> region)
+    {
+        if(good() == false)co_return;
+
+        co_await ensureOnStrand();
+
+        if(_frame_buffer_objects.contains(source) == false || _frame_buffer_objects.contains(destination) == false)
+        {
+            spdlog::error("Frame buffer object not found");
+            co_return;
+        }
+
+        _current_frame_stats.depth_copies++;
+        record(NullRenderCommand{.type = NullRenderCommand::Type::CopyDepth, .fbo = destination, .source_fbo = source, .region = region});
+
+        co_return;
+    }
+
+    asio::awaitable<void> NullRenderer::clearScreenRegions(glm::vec4 color, std::optional<std::size_t> fbo, std::span<const RenderRegion> regions)
+    {
+        if(good() == false || regions.empty())co_return;
+
+        co_await ensureOnStrand();
+
+        if(fbo && _frame_buffer_objects.contains(*fbo) == false)
+        {
+            spdlog::error("Frame buffer object not found");
+            co_return;
+        }
+
+        for(const RenderRegion & region : regions)
+        {
+            _current_frame_stats.clears++;
+            record(NullRenderCommand{.type = NullRenderCommand::Type::Clear, .fbo = fbo, .region = region});
+        }
+
+        co_return;
+    }
+
+    asio::awaitable<void> NullRenderer::copyFrameBufferObjectDepthRegions(std::size_t source, std::size_t destination, std::span<const RenderRegion> regions)
+    {
+        if(good() == false || regions.empty())co_return;
+
+        co_await ensureOnStrand();
+
+        if(_frame_buffer_objects.contains(source) == false || _frame_buffer_objects.contains(destination) == false)
+        {
+            spdlog::error("Frame buffer object not found");
+            co_return;
+        }
+
+        for(const RenderRegion & region : regions)
+        {
+            _current_frame_stats.depth_copies++;
+            record(NullRenderCommand{.type = NullRenderCommand::Type::CopyDepth, .fbo = destination, .source_fbo = source, .region = region});
+        }
+
+        co_return;
+    }
+
+    asio::awaitable<void> NullRenderer::render(
+            std::size_t vertex_buffer,
+            std::size_t shader,
+            ShaderInputs shader_inputs,
+            RenderOptions options,
+            std::optional<std::size_t> fbo)
+    {
+        if(good() == false)co_return;
+
+        co_await ensureOnStrand();
+
+        recordDraw(vertex_buffer, shader, 1, shader_inputs, options, fbo);
+
+        co_return;
+    }
+
+    asio::awaitable<void> NullRenderer::renderInstanced(
+            std::size_t vertex_buffer,
+            std::size_t shader,
+            std::size_t instance_count,
+            ShaderInputs shader_inputs,
+            RenderOptions options,
+            std::optional<std::size_t> fbo)
+    {
+        if(good() == false)co_return;
+        if(instance_count == 0)co_return;
+
+        co_await ensureOnStrand();
+
+        recordDraw(vertex_buffer, shader, instance_count, shader_inputs, options, fbo);
+
+        co_return;
+    }
+
+    asio::awaitable<void> NullRenderer::submit(std::span<const DrawItem> draws)
+    {
+        if(good() == false)co_return;
+
+        co_await ensureOnStrand();
+
+        _current_frame_stats.submits++;
+        for(const DrawItem & draw : draws)
+        {
+            if(draw.instance_count == 0)continue;
+            recordDraw(draw.vertex_buffer, draw.shader, draw.instance_count, draw.shader_inputs, draw.options, draw.fbo);
+        }
+
+        co_return;
+    }
+
+    void NullRenderer::recordDraw(
+            std::size_t vertex_buffer,
+            std::size_t shader,
+            std::size_t instance_count,
+            const ShaderInputs & shader_inputs,
+            const RenderOptions & options,
+            std::optional<std::size_t> fbo)
+    {
+        if(fbo && _frame_buffer_objects.contains(*fbo) == false)
+        {
+            spdlog::error("Frame buffer object not found");
+            return;
+        }
+
+        if(_shaders.contains(shader) == false){
+            spdlog::warn("Rendering: Shader not found");
+            return;
+        }
+
+        auto vertex_buffer_it = _vertex_buffers.find(vertex_buffer);
+        if(vertex_buffer_it == _vertex_buffers.end()){
+            spdlog::warn("Rendering: Vertex buffer not found");
+            return;
+        }
+
+        NullRenderCommand command{
+            .type = NullRenderCommand::Type::Draw,
+            .fbo = fbo,
+            .region = options.region,
+            .vertex_buffer = vertex_buffer,
+            .shader = shader,
+            .mode = options.mode,
+            .polygon_offset = options.polygon_offset.has_value(),
+            .elements = vertex_buffer_it->second.elements,
+            .instances = (uint32_t)instance_count
+        };
+
+        for(const ShaderInputs::Input & input : shader_inputs.getInputs())
+        {
+            std::visit([&command](const auto & value)
+            {
+                using T = std::decay_t<decltype(value)>;
+
+                if constexpr (std::is_same_v<T, ShaderInputs::Sampler>)
+                {
+                    command.samplers += 1;
+                }
+                else if constexpr (std::is_same_v<T, ShaderInputs::SamplerArray>)
+                {
+                    command.samplers += (uint32_t)value.textures.size();
+                }
+                else
+                {
+                    countUniform(value, command.uniforms, command.uniform_bytes);
+                }
+            }, input.value);
+        }
+        command.storage_buffers = (uint32_t)shader_inputs.getStorageBuffers().size();
+
+        if(_bound_vertex_buffer != vertex_buffer)_current_frame_stats.vertex_buffer_switches++;
+        if(_bound_shader != shader)_current_frame_stats.shader_switches++;
+        if(_bound_fbo.has_value() == false || *_bound_fbo != fbo)_current_frame_stats.fbo_switches++;
+
+        _bound_vertex_buffer = vertex_buffer;
+        _bound_shader = shader;
+        _bound_fbo = fbo;
+
+        _current_frame_stats.draw_calls++;
+        _current_frame_stats.instances += command.instances;
+        _current_frame_stats.triangles += (uint64_t)(command.elements / 3) * command.instances;
+        _current_frame_stats.uniforms += command.uniforms;
+        _current_frame_stats.uniform_bytes += command.uniform_bytes;
+        _current_frame_stats.samplers += command.samplers;
+
+        record(std::move(command));
+    }
+
+    asio::awaitable<void> NullRenderer::present()
+    {
+        if(good() == false)co_return;
+
+        co_await ensureOnStrand();
+
+        record(NullRenderCommand{.type = NullRenderCommand::Type::Present});
+
+        _frame_stats = _current_frame_stats;
+        _current_frame_stats = NullFrameStats{.frame = _frame_stats.frame + 1};
+
+        // real backend does not keep bindings across frames either
+        _bound_vertex_buffer.reset();
+        _bound_shader.reset();
+        _bound_fbo.reset();
+
+        co_return;
+    }
+
+    asio::awaitable<void> NullRenderer::updateViewport(Resolution resolution)
+    {
+        if(good() == false)co_return;
+
+        co_await ensureOnStrand();
+
+        _viewport_resolution = resolution;
+        record(NullRenderCommand{.type = NullRenderCommand::Type::UpdateViewport});
+
+        co_return;
+    }
+
+    Resolution NullRenderer::getViewport() const
+    {
+        return _viewport_resolution;
+    }
+
+    asio::awaitable<void> NullRenderer::enableVSync()
+    {
+        if(good() == false)co_return;
+
+        co_await ensureOnStrand();
+
+        _vsync = true;
+        record(NullRenderCommand{.type = NullRenderCommand::Type::SetVSync});
+        co_return;
+    }
+
+    asio::awaitable<void> NullRenderer::disableVSync()
+    {
+        if(good() == false)co_return;
+
+        co_await ensureOnStrand();
+
+        _vsync = false;
+        record(NullRenderCommand{.type = NullRenderCommand::Type::SetVSync});
+        co_return;
+    }
+
+    bool NullRenderer::isVSyncEnabled() const
+    {
+        return _vsync;
+    }
+
+    asio::awaitable<std::optional<std::size_t>> NullRenderer::constructVertexBuffer(std::string name, const Mesh & mesh)
+    {
+        if(good() == false)co_return std::nullopt;
+
+        co_await ensureOnStrand();
+
+        co_return emplaceObject(_vertex_buffers, _vertex_buffer_names, name,
+            NullVertexBuffer{.name = name, .elements = (uint32_t)mesh.indices.size(), .bounds = calculateMeshBounds(mesh)});
+    }
+
+    asio::awaitable<bool> NullRenderer::eraseVertexBuffer(std::size_t id)
+    {
+        if(good() == false)co_return false;
+
+        co_await ensureOnStrand();
+
+        co_return eraseObject(_vertex_buffers, _vertex_buffer_names, id);
+    }
+
+    std::optional<std::size_t> NullRenderer::getVertexBuffer(std::string name) const
+    {
+        return findObject(_vertex_buffers, _vertex_buffer_names, name);
+    }
+
+    std::optional<MeshBounds> NullRenderer::getVertexBufferBounds(std::size_t id) const
+    {
+        auto it = _vertex_buffers.find(id);
+        if(it == _vertex_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] Vertex buffer {} does not exist", std::this_thread::get_id(), id));
+            return std::nullopt;
+        }
+        return it->second.bounds;
+    }
+
+    std::optional<std::size_t> NullRenderer::getVertexBufferElementCount(std::size_t id) const
+    {
+        auto it = _vertex_buffers.find(id);
+        if(it == _vertex_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] Vertex buffer {} does not exist", std::this_thread::get_id(), id));
+            return std::nullopt;
+        }
+        return it->second.elements;
+    }
+
+    asio::awaitable<std::optional<std::size_t>> NullRenderer::constructShader(std::string name, std::vector<std::string> vertex_code)
+    {
+        if(good() == false)co_return std::nullopt;
+
+        co_await ensureOnStrand();
+
+        co_return emplaceObject(_shaders, _shader_names, name, NullShader{.name = name});
+    }
+
+    asio::awaitable<std::optional<std::size_t>> NullRenderer::constructShader(std::string name, std::vector<std::string> vertex_code, std::vector<std::string> fragment_code)
+    {
+        co_return co_await constructShader(std::move(name), std::move(vertex_code));
+    }
+
+    asio::awaitable<bool> NullRenderer::eraseShader(std::size_t id)
+    {
+        if(good() == false)co_return false;
+
+        co_await ensureOnStrand();
+
+        co_return eraseObject(_shaders, _shader_names, id);
+    }
+
+    std::optional<std::size_t> NullRenderer::getShader(std::string name) const
+    {
+        return findObject(_shaders, _shader_names, name);
+    }
+
+    asio::awaitable<std::optional<std::size_t>> NullRenderer::constructShaderStorageBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data)
+    {
+        if(good() == false)co_return std::nullopt;
+
+        co_await ensureOnStrand();
+
+        co_return emplaceObject(_shader_storage_buffers, _shader_storage_buffer_names, name,
+            NullShaderStorageBuffer{.name = name, .binding_point = binding_point, .size = size});
+    }
+
+    asio::awaitable<bool> NullRenderer::eraseShaderStorageBuffer(std::size_t id)
+    {
+        if(good() == false)co_return false;
+
+        co_await ensureOnStrand();
+
+        co_return eraseObject(_shader_storage_buffers, _shader_storage_buffer_names, id);
+    }
+
+    std::optional<std::size_t> NullRenderer::getShaderStorageBuffer(std::string name) const
+    {
+        return findObject(_shader_storage_buffers, _shader_storage_buffer_names, name);
+    }
+
+    asio::awaitable<bool> NullRenderer::updateShaderStorageBuffer(std::size_t id, const std::size_t size, const void * data)
+    {
+        if(good() == false)co_return false;
+
+        co_await ensureOnStrand();
+
+        auto it = _shader_storage_buffers.find(id);
+        if(it == _shader_storage_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] Shader storage buffer {} does not exist", std::this_thread::get_id(), id));
+            co_return false;
+        }
+        it->second.size = size;
+
+        _current_frame_stats.storage_buffer_updates++;
+        _current_frame_stats.storage_buffer_bytes += size;
+        record(NullRenderCommand{
+            .type = NullRenderCommand::Type::UpdateShaderStorageBuffer,
+            .storage_buffer = id,
+            .data_bytes = size});
+
+        co_return true;
+    }
+
+    asio::awaitable<std::optional<std::size_t>> NullRenderer::constructUniformBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data)
+    {
+        if(good() == false)co_return std::nullopt;
+
+        co_await ensureOnStrand();
+
+        co_return emplaceObject(_uniform_buffers, _uniform_buffer_names, name,
+            NullUniformBuffer{.name = name, .binding_point = binding_point, .size = size});
+    }
+
+    asio::awaitable<bool> NullRenderer::eraseUniformBuffer(std::size_t id)
+    {
+        if(good() == false)co_return false;
+
+        co_await ensureOnStrand();
+
+        co_return eraseObject(_uniform_buffers, _uniform_buffer_names, id);
+    }
+
+    std::optional<std::size_t> NullRenderer::getUniformBuffer(std::string name) const
+    {
+        return findObject(_uniform_buffers, _uniform_buffer_names, name);
+    }
+
+    asio::awaitable<bool> NullRenderer::updateUniformBuffer(std::size_t id, const std::size_t size, const void * data)
+    {
+        if(good() == false)co_return false;
+
+        co_await ensureOnStrand();
+
+        auto it = _uniform_buffers.find(id);
+        if(it == _uniform_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] Uniform buffer {} does not exist", std::this_thread::get_id(), id));
+            co_return false;
+        }
+        it->second.size = size;
+
+        _current_frame_stats.uniform_buffer_updates++;
+        _current_frame_stats.uniform_buffer_bytes += size;
+        record(NullRenderCommand{
+            .type = NullRenderCommand::Type::UpdateUniformBuffer,
+            .storage_buffer = id,
+            .data_bytes = size});
+
+        co_return true;
+    }
+
+    asio::awaitable<std::optional<std::size_t>> NullRenderer::constructFrameBufferObject(std::string name, Resolution resolution, std::initializer_list<FBOAttachment> attachments)
+    {
+        if(good() == false)co_return std::nullopt;
+
+        co_await ensureOnStrand();
+
+        NullFrameBufferObject fbo{.name = name, .resolution = resolution};
+        for(const auto & att : attachments)
+        {
+            // render buffers get id as well so texture ids stay unique, but only textures are exposed
+            const std::size_t id = _next_id++;
+            if(att.type == FBOAttachment::Type::Texture)fbo.textures.emplace_back(id);
+        }
+
+        co_return emplaceObject(_frame_buffer_objects, _frame_buffer_object_names, name, std::move(fbo));
+    }
+
+    asio::awaitable<bool> NullRenderer::eraseFrameBufferObject(std::size_t id)
+    {
+        if(good() == false)co_return false;
+
+        co_await ensureOnStrand();
+
+        co_return eraseObject(_frame_buffer_objects, _frame_buffer_object_names, id);
+    }
+
+    std::optional<std::size_t> NullRenderer::getFrameBufferObject(std::string name) const
+    {
+        return findObject(_frame_buffer_objects, _frame_buffer_object_names, name);
+    }
+
+    std::vector<std::size_t> NullRenderer::getFrameBufferObjectTextures(std::size_t id) const
+    {
+        auto it = _frame_buffer_objects.find(id);
+        if(it == _frame_buffer_objects.end())
+        {
+            spdlog::warn(std::format("[t:{}] Frame buffer object {} does not exist", std::this_thread::get_id(), id));
+            return {};
+        }
+        return it->second.textures;
+    }
+
+    const std::vector<NullRenderCommand> & NullRenderer::getCommandLog() const
+    {
+        return _command_log;
+    }
+
+    void NullRenderer::clearCommandLog()
+    {
+        _command_log.clear();
+    }
+
+    const NullFrameStats & NullRenderer::getFrameStats() const
+    {
+        return _frame_stats;
+    }
+
+    const NullFrameStats & NullRenderer::getCurrentFrameStats() const
+    {
+        return _current_frame_stats;
+    }
+}
@@ -1,14 +1,19 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 #include "native.hpp"
 #include <asio.hpp>
 
 #include <GL/glew.h>
-#ifdef WIN32
-    #include <GL/wglew.h>
-#endif
 
 #include <spdlog/spdlog.h>
 
@@ -26,14 +31,22 @@
 #include "vertex_buffer.hpp"
 #include "shader.hpp"
 #include "shader_storage_buffer.hpp"
+#include "uniform_buffer.hpp"
 #include "frame_buffer_object.hpp"
 #include "texture.hpp"
 #include "render_buffer.hpp"
+#include "draw_item.hpp"
+#include "render_command_ring.hpp"
 
 #include "opengl_debug.hpp"
+#include "opengl_context.hpp"
+#include "opengl_geometry_arena.hpp"
 #include "opengl_vertex_buffer.hpp"
 #include "opengl_shader.hpp"
 #include "opengl_shader_storage_buffer.hpp"
+#include "opengl_uniform_buffer.hpp"
+#include "opengl_state_cache.hpp"
+#include "opengl_upload_ring.hpp"
 #include "opengl_frame_buffer_object.hpp"
 #include "opengl_texture.hpp"
 #include "opengl_render_buffer_object.hpp"
@@ -55,12 +68,22 @@ namespace velora::opengl
 
             asio::awaitable<void> close();
 
-            asio::awaitable<void> clearScreen(glm::vec4 color, std::optional<std::size_t> fbo);
+            asio::awaitable<void> clearScreen(glm::vec4 color, std::optional<std::size_t> fbo, std::optional<RenderRegion> region);
+            asio::awaitable<void> copyFrameBufferObjectDepth(std::size_t source, std::size_t destination, std::optional<RenderRegion> region);
+            asio::awaitable<void> clearScreenRegions(glm::vec4 color, std::optional<std::size_t> fbo, std::span<const RenderRegion> regions);
+            asio::awaitable<void> copyFrameBufferObjectDepthRegions(std::size_t source, std::size_t destination, std::span<const RenderRegion> regions);
             asio::awaitable<void> render(std::size_t vertex_buffer,
                 std::size_t shader,
                 ShaderInputs shader_inputs,
                 RenderOptions options,
                 std::optional<std::size_t> fbo);
+            asio::awaitable<void> renderInstanced(std::size_t vertex_buffer,
+                std::size_t shader,
+                std::size_t instance_count,
+                ShaderInputs shader_inputs,
+                RenderOptions options,
+                std::optional<std::size_t> fbo);
+            asio::awaitable<void> submit(std::span<const DrawItem> draws);
                 
             asio::awaitable<void> present();
             asio::awaitable<void> updateViewport(Resolution resolution);
@@ -71,6 +94,8 @@ namespace velora::opengl
             asio::awaitable<std::optional<std::size_t>> constructVertexBuffer(std::string name, const Mesh & mesh);
             asio::awaitable<bool> eraseVertexBuffer(std::size_t id);
             std::optional<std::size_t> getVertexBuffer(std::string name) const;
+            std::optional<MeshBounds> getVertexBufferBounds(std::size_t id) const;
+            std::optional<std::size_t> getVertexBufferElementCount(std::size_t id) const;
 
             asio::awaitable<std::optional<std::size_t>> constructShader(std::string name, std::vector<std::string> vertex_code);
             asio::awaitable<std::optional<std::size_t>> constructShader(std::string name, std::vector<std::string> vertex_code, std::vector<std::string> fragment_code);
@@ -81,6 +106,11 @@ namespace velora::opengl
             asio::awaitable<bool> eraseShaderStorageBuffer(std::size_t id);
             std::optional<std::size_t> getShaderStorageBuffer(std::string name) const;
             asio::awaitable<bool> updateShaderStorageBuffer(std::size_t id, const std::size_t size, const void * data);
+
+            asio::awaitable<std::optional<std::size_t>> constructUniformBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data);
+            asio::awaitable<bool> eraseUniformBuffer(std::size_t id);
+            std::optional<std::size_t> getUniformBuffer(std::string name) const;
+            asio::awaitable<bool> updateUniformBuffer(std::size_t id, const std::size_t size, const void * data);
             
             asio::awaitable<std::optional<std::size_t>> constructFrameBufferObject(std::string name, Resolution resolution, std::initializer_list<FBOAttachment> attachments);
             asio::awaitable<bool> eraseFrameBufferObject(std::size_t id);
@@ -102,6 +132,23 @@ namespace velora::opengl
 
             void join();
 
+            uint64_t getObjectGeneration() const;
+
+            // calls passed to and skipped by GL state cache since renderer was created, safe to call from any thread
+            OpenGLStateCache::Stats getStateCacheStats() const;
+
+            /**
+             * @brief Cross-check every skipped GL call against real GL state with glGet*, mismatches are logged.
+             * Enabled by default in debug builds. Safe to call from any thread.
+             */
+            void setStateCacheValidation(bool enabled);
+
+            // bytes streamed through upload ring and time spent waiting for its fences, safe to call from any thread
+            OpenGLUploadRing::Stats getUploadStats() const;
+
+            // occupancy of vertex and index buffers shared by all meshes, safe to call from any thread
+            OpenGLGeometryArena::Stats getGeometryArenaStats() const;
+
         protected:
             OpenGLRenderer(IWindow & window, native::opengl_context_handle oglctx_handle);
 
@@ -126,12 +173,16 @@ namespace velora::opengl
 
                 T obj = T::template construct<ImplType>(std::forward<Args>(args)...);
 
+                // constructors bind and unbind objects on their own
+                invalidateStateCache();
+
                 const std::size_t id = obj->ID();
 
                 if(object_map.contains(id))co_return std::nullopt;
 
                 object_map.try_emplace(id, std::move(obj));
                 name_map.try_emplace(std::move(name), id);
+                _object_generation->fetch_add(1, std::memory_order_release);
 
                 co_return id;
             }
@@ -159,7 +210,9 @@ namespace velora::opengl
             }
 
             template<class T>
-            asio::awaitable<bool> eraseInternalObject(absl::flat_hash_map<std::size_t, T> & object_map, std::size_t id) const
+            asio::awaitable<bool> eraseInternalObject(absl::flat_hash_map<std::size_t, T> & object_map,
+                absl::flat_hash_map<std::string, std::size_t> & name_map,
+                std::size_t id)
             {
                 if(good() == false)co_return false;
 
@@ -172,6 +225,10 @@ namespace velora::opengl
                 }
 
                 object_map.erase(id);
+                // GL may hand out the same ID again, so name must not keep pointing at it
+                absl::erase_if(name_map, [id](const auto & entry){ return entry.second == id; });
+                invalidateStateCache();
+                _object_generation->fetch_add(1, std::memory_order_release);
 
                 spdlog::info(std::format("[t:{}] renderer object {} erased", std::this_thread::get_id(), id));
 
@@ -179,7 +236,51 @@ namespace velora::opengl
             }
 
 
-            void assignShaderInputs(const std::size_t & shader_ID, const ShaderInputs & shader_inputs);
+            // uniforms are set through handles resolved at link time, no allocation and no name hashing
+            void assignShaderInputs(Shader & shader, const ShaderInputs & shader_inputs);
+
+            /**
+             * @brief Binds frame buffer object or default framebuffer and sets viewport to region or its whole size.
+             * Binds and viewport already set by previous draw are skipped by state cache.
+             */
+            bool bindFrameBuffer(std::optional<std::size_t> fbo, std::optional<RenderRegion> region = std::nullopt);
+
+            void invalidateStateCache();
+
+            /**
+             * @brief Checks on render thread that context supports features every draw relies on.
+             * Base instance (OpenGL 4.2 or ARB_base_instance) offsets instance attribute of geometry arena.
+             */
+            asio::awaitable<bool> checkRequiredFeatures();
+
+            // clears color and depth of frame buffer or of its region only, on render thread
+            bool clearFrameBuffer(const glm::vec4 & color, std::optional<std::size_t> fbo, std::optional<RenderRegion> region);
+            // blits depth of region or whole frame buffer into the same place of destination, on render thread
+            bool copyDepth(std::size_t source, std::size_t destination, std::optional<RenderRegion> region);
+
+            // binds frame buffer, program, vertex array of geometry arena pool and shader inputs and sets raster state of draw call
+            bool bindDrawState(GLuint vertex_array,
+                std::size_t shader,
+                const ShaderInputs & shader_inputs,
+                const RenderOptions & options,
+                std::optional<std::size_t> fbo);
+
+            // single draw call on render thread, shared by render, renderInstanced and submit
+            bool drawElements(std::size_t vertex_buffer,
+                std::size_t shader,
+                std::size_t instance_count,
+                uint32_t first_instance,
+                const ShaderInputs & shader_inputs,
+                const RenderOptions & options,
+                std::optional<std::size_t> fbo);
+
+            /**
+             * @brief Draws items sharing all state but mesh and instances with single glMultiDrawElementsIndirect.
+             * Meshes of all items must be stored in the same vertex and index formats.
+             * Command buffer is written into upload ring.
+             * @return false when nothing was drawn, items are then drawn one by one
+             */
+            bool multiDrawElements(std::span<const DrawItem> draws);
 
         private:
             struct RenderThreadContext
@@ -208,6 +309,8 @@ namespace velora::opengl
                     asio::io_context _io_context;
                     asio::executor_work_guard<asio::io_context::executor_type> _work_guard;
                     asio::strand<asio::io_context::executor_type> _strand;
+                    // coroutines hop onto render thread through ring, strand is fallback when it is full
+                    RenderCommandRing _command_ring;
 
                     IWindow & _window;
                     native::device_context * _device_context;
@@ -216,6 +319,8 @@ namespace velora::opengl
                     std::thread _worker_thread;
             };
 
+            constexpr static const std::size_t _MAX_SAMPLER_ARRAY_SIZE = 32;
+
             IWindow & _window;
 
             std::unique_ptr<native::opengl_context_handle> _oglctx_handle;
@@ -223,20 +328,69 @@ namespace velora::opengl
 
             Resolution _viewport_resolution;
 
+            // vertex buffers are ranges of it, unique_ptr keeps renderer movable and arena outlives vertex buffers
+            std::unique_ptr<OpenGLGeometryArena> _geometry_arena = std::make_unique<OpenGLGeometryArena>();
+
             absl::flat_hash_map<std::size_t, VertexBuffer> _vertex_buffers;
             absl::flat_hash_map<std::size_t, Shader> _shaders;
             absl::flat_hash_map<std::size_t, ShaderStorageBuffer> _shader_storage_buffers;
+            absl::flat_hash_map<std::size_t, UniformBuffer> _uniform_buffers;
             absl::flat_hash_map<std::size_t, FrameBufferObject> _frame_buffer_objects;
             absl::flat_hash_map<std::size_t, Texture> _textures;
             absl::flat_hash_map<std::size_t, RenderBuffer> _rbos;
 
+            // buffer whose current data lives in upload ring, bound as ring range instead of its own storage
+            struct StreamedBuffer
+            {
+                OpenGLUploadRing::Range range;
+                uint64_t frame = 0;
+            };
+
+            // layout of glMultiDrawElementsIndirect command
+            #pragma pack(push, 1)
+            struct DrawElementsIndirectCommand
+            {
+                GLuint count;
+                GLuint instance_count;
+                GLuint first_index;
+                GLint base_vertex;
+                GLuint base_instance;
+            };
+            #pragma pack(pop)
+
+            // command buffer of last multi draw, reused between draws
+            std::vector<DrawElementsIndirectCommand> _indirect_commands;
+
+            // writes data into upload ring and into copy, std::nullopt when ring cannot take it
+            std::optional<StreamedBuffer> streamBuffer(const std::size_t size, const void * data, std::vector<std::byte> & copy);
+            // data not updated for OpenGLUploadRing::FRAMES frames is moved back into own storage before its region is reused
+            void releaseStaleStreamedBuffers();
+
+            absl::flat_hash_map<std::size_t, StreamedBuffer> _streamed_shader_storage_buffers;
+            absl::flat_hash_map<std::size_t, StreamedBuffer> _streamed_uniform_buffers;
+            // ring memory is write only, own storage of streamed buffer is restored from its copy
+            // copies live as long as their buffer, so updates reuse their memory
+            absl::flat_hash_map<std::size_t, std::vector<std::byte>> _shader_storage_buffer_copies;
+            absl::flat_hash_map<std::size_t, std::vector<std::byte>> _uniform_buffer_copies;
+
             absl::flat_hash_map<std::string, std::size_t> _vertex_buffer_names;
             absl::flat_hash_map<std::string, std::size_t> _shader_names;
             absl::flat_hash_map<std::string, std::size_t> _shader_storage_buffer_names;
+            absl::flat_hash_map<std::string, std::size_t> _uniform_buffer_names;
             absl::flat_hash_map<std::string, std::size_t> _frame_buffer_object_names;
             absl::flat_hash_map<std::string, std::size_t> _textures_names;
             absl::flat_hash_map<std::string, std::size_t> _rbos_names;
 
+            // GL state set by draws, consecutive draws sharing it skip binds and state queries
+            // used only from render thread, unique_ptr keeps renderer movable
+            std::unique_ptr<OpenGLStateCache> _state_cache = std::make_unique<OpenGLStateCache>();
+
+            // persistently mapped memory written by buffer updates, used only from render thread
+            std::unique_ptr<OpenGLUploadRing> _upload_ring = std::make_unique<OpenGLUploadRing>();
+
+            // incremented on every construct and erase, unique_ptr keeps renderer movable
+            std::unique_ptr<std::atomic<uint64_t>> _object_generation = std::make_unique<std::atomic<uint64_t>>(0);
+
             // Render thread initialized at the end of the constructor
             std::unique_ptr<RenderThreadContext> _render_context; // dedicated single thread
     };
@@ -23,7 +23,7 @@ namespace velora::opengl
      * @brief OpenGL Frame Buffer Object
      * 
      * This class is used to create and manage an OpenGL Frame Buffer Object (FBO).
-     * It provides methods to enable, disable, and check the status of the FBO.
+     * It is bound for rendering by renderer through OpenGLStateCache.
      * 
      * @note This class is not thread-safe. Must be used in renderer thread.
      */
@@ -58,24 +58,6 @@ namespace velora::opengl
              */
             bool good() const;
 
-            /**
-             * @brief Enable the OpenGL Frame Buffer Object for rendering.
-             * 
-             * Bind the frame buffer object to the current OpenGL context for rendering.
-             * 
-             * @return True if the frame buffer object is valid and was successfully enabled, otherwise false.
-             */
-            bool enable() const;
-            
-            /**
-             * @brief Disable the OpenGL Frame Buffer Object for rendering.
-             * 
-             * Unbind the frame buffer object from the current OpenGL context for rendering.
-             * 
-             * @return None
-             */
-            void disable() const;
-            
             /**
              * @brief Get the textures attached to the frame buffer object.
              * 
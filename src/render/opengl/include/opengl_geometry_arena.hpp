@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+#include <GL/glew.h>
+
+#include "opengl_debug.hpp"
+#include "vertex.hpp"
+
+namespace velora::opengl
+{
+    /**
+     * @brief Vertex and index buffers shared by all meshes of renderer.
+     *
+     * Meshes are sub-allocated ranges of both buffers, drawn with base vertex and first index,
+     * so meshes of one pool use one vertex array object and consecutive draws never switch it.
+     * Every mesh is encoded at allocation into most compact vertex and index format that keeps it precise,
+     * every combination of formats is separate pool with its own buffers and vertex array.
+     * Compressed attributes are converted to float by GPU, so shaders read every pool the same way.
+     *
+     * Free ranges are kept in first-fit free list per buffer and merged with their neighbours,
+     * when no free range is large enough buffer is reallocated with doubled capacity
+     * and its content copied on GPU, offsets of existing meshes stay valid.
+     *
+     * Vertex arrays also hold per instance attribute INSTANCE_ATTRIBUTE = first instance + gl_InstanceID,
+     * instanced shaders index instance data with it, so draws differing only in first instance share state.
+     *
+     * @note Not thread-safe, must be used on render thread. Stats may be read from any thread.
+     */
+    class OpenGLGeometryArena
+    {
+        public:
+            constexpr static const GLuint INSTANCE_ATTRIBUTE = 3;
+            // first instance + instance count of every draw must stay below
+            constexpr static const std::size_t MAX_INSTANCES = 1 << 18;
+
+            // mesh inside of shared buffers of its pool, offsets and counts in vertices and indices
+            struct Range
+            {
+                VertexFormat vertex_format = VertexFormat::Float;
+                IndexFormat index_format = IndexFormat::UInt32;
+                std::size_t first_vertex = 0;
+                std::size_t vertex_count = 0;
+                std::size_t first_index = 0;
+                std::size_t index_count = 0;
+            };
+
+            struct Stats
+            {
+                std::size_t vertex_capacity = 0;
+                std::size_t used_vertices = 0;
+                std::size_t index_capacity = 0;
+                std::size_t used_indices = 0;
+                std::size_t meshes = 0;
+                // meshes stored with compressed vertices and with 16 bit indices
+                std::size_t compressed_meshes = 0;
+                std::size_t narrow_index_meshes = 0;
+                // size of allocated meshes as stored and as they would be with float vertices and 32 bit indices
+                std::size_t used_bytes = 0;
+                std::size_t uncompressed_bytes = 0;
+                // buffer reallocations caused by growth
+                uint64_t reallocations = 0;
+            };
+
+            OpenGLGeometryArena();
+            OpenGLGeometryArena(const OpenGLGeometryArena&) = delete;
+            OpenGLGeometryArena(OpenGLGeometryArena&&) = delete;
+            OpenGLGeometryArena& operator=(const OpenGLGeometryArena&) = delete;
+            OpenGLGeometryArena& operator=(OpenGLGeometryArena&&) = delete;
+            ~OpenGLGeometryArena();
+
+            /**
+             * @brief Encodes mesh and copies it into free ranges of buffers of its pool,
+             * buffers are created on first mesh of pool and grown when full.
+             * Changes vertex array binding.
+             * @return std::nullopt when mesh is empty or buffers cannot be created
+             */
+            std::optional<Range> allocate(const std::vector<Vertex> & vertices, const std::vector<unsigned int> & indices);
+
+            // returns ranges of mesh into free lists of its pool, data is left in place until overwritten
+            void free(const Range & range);
+
+            // 0 until first mesh of formats is allocated
+            GLuint getVertexArray(VertexFormat vertex_format, IndexFormat index_format) const;
+
+            // deletes buffers and vertex arrays, context must be current
+            void release();
+
+            Stats getStats() const;
+
+            static GLenum getIndexType(IndexFormat format);
+
+        private:
+            // first fit free list of one buffer, offsets and sizes in elements
+            struct FreeList
+            {
+                // offset -> size of free ranges, adjacent ranges are always merged
+                std::map<std::size_t, std::size_t> ranges;
+                std::size_t capacity = 0;
+
+                std::optional<std::size_t> allocate(std::size_t size);
+                void free(std::size_t offset, std::size_t size);
+                // adds [capacity, new_capacity) as free range
+                void grow(std::size_t new_capacity);
+            };
+
+            // buffers and vertex array of meshes with the same formats
+            struct Pool
+            {
+                VertexFormat vertex_format = VertexFormat::Float;
+                IndexFormat index_format = IndexFormat::UInt32;
+
+                GLuint VAO = 0;
+                GLuint VBO = 0;
+                GLuint EBO = 0;
+                bool unsupported = false;
+
+                FreeList vertices;
+                FreeList indices;
+            };
+
+            constexpr static const std::size_t _POOLS = (std::size_t)VertexFormat::Count * (std::size_t)IndexFormat::Count;
+
+            static std::size_t getPoolIndex(VertexFormat vertex_format, IndexFormat index_format);
+
+            bool createInstanceBuffer();
+            bool create(Pool & pool);
+            // deletes buffers and vertex array of pool, pool can be created again
+            void destroy(Pool & pool);
+            // grows list and its buffer so that size elements fit, old content is copied to new buffer
+            bool grow(FreeList & list, GLuint & buffer, std::size_t element_size, std::size_t size);
+            // points vertex array of pool at its current buffers
+            void attachBuffers(const Pool & pool);
+
+            std::array<Pool, _POOLS> _pools;
+            // 0, 1, 2, ... MAX_INSTANCES - 1, read with divisor 1 and offset by first instance of draw, shared by all pools
+            GLuint _instance_buffer = 0;
+
+            std::atomic<std::size_t> _vertex_capacity = 0;
+            std::atomic<std::size_t> _used_vertices = 0;
+            std::atomic<std::size_t> _index_capacity = 0;
+            std::atomic<std::size_t> _used_indices = 0;
+            std::atomic<std::size_t> _meshes = 0;
+            std::atomic<std::size_t> _compressed_meshes = 0;
+            std::atomic<std::size_t> _narrow_index_meshes = 0;
+            std::atomic<std::size_t> _used_bytes = 0;
+            std::atomic<std::size_t> _uncompressed_bytes = 0;
+            std::atomic<uint64_t> _reallocations = 0;
+
+            // sized for prefab meshes, larger meshes grow buffers on first allocation
+            constexpr static const std::size_t _INITIAL_VERTICES = 64 * 1024;
+            constexpr static const std::size_t _INITIAL_INDICES = 256 * 1024;
+    };
+}
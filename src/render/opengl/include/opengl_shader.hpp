@@ -1,8 +1,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <optional>
+#include <span>
 #include <utility>
+#include <vector>
 
 #include <absl/container/flat_hash_map.h>
 #include <glm/gtc/type_ptr.hpp>
@@ -14,6 +17,7 @@
 #include "opengl_core.hpp"
 #include "glsl_variable.hpp"
 #include "texture.hpp"
+#include "shader.hpp"
 
 namespace velora::opengl
 {
@@ -28,25 +32,22 @@ namespace velora::opengl
 
         std::size_t ID() const;
 
-        bool enable();
-        bool disable();
+        void setUniform(ShaderUniform uniform, bool value);
 
-        void setUniform(const std::string & name, bool value);
+        void setUniform(ShaderUniform uniform, int value);
+        void setUniform(ShaderUniform uniform, float value);
 
-        void setUniform(const std::string & name, int value);
-        void setUniform(const std::string & name, float value);
+        void setUniform(ShaderUniform uniform, const glm::vec2 & value);
+        void setUniform(ShaderUniform uniform, const glm::vec3 & value);
+        void setUniform(ShaderUniform uniform, const glm::vec4 & value);
 
-        void setUniform(const std::string & name, const glm::vec2 & value);
-        void setUniform(const std::string & name, const glm::vec3 & value);
-        void setUniform(const std::string & name, const glm::vec4 & value);
+        void setUniform(ShaderUniform uniform, const glm::mat2 & value);
+        void setUniform(ShaderUniform uniform, const glm::mat3 & value);
+        void setUniform(ShaderUniform uniform, const glm::mat4 & value);
+        void setUniform(ShaderUniform uniform, std::span<const glm::mat4> values);
 
-        void setUniform(const std::string & name, const glm::mat2 & value);
-        void setUniform(const std::string & name, const glm::mat3 & value);
-        void setUniform(const std::string & name, const glm::mat4 & value);
-        void setUniform(const std::string & name, const std::vector<glm::mat4> & values);
-
-        void setUniform(const std::string & name, unsigned int unit, const ITexture & value);
-        void setUniform(const std::string & name, unsigned int unit, const std::vector<ITexture*> & values);
+        void setUniform(ShaderUniform uniform, unsigned int unit, const ITexture & value);
+        void setUniform(ShaderUniform uniform, unsigned int unit, std::span<ITexture * const> values);
 
 
     protected:
@@ -81,13 +82,26 @@ namespace velora::opengl
 
     private:
         constexpr static const unsigned int _MAX_LOG_LENGTH = 4096;
+        constexpr static const unsigned int _MAX_TEXTURE_ARRAY_SIZE = 32;
+
+        // uniform resolved at link time, array uniforms are stored under name without [0]
+        struct UniformSlot
+        {
+            GLint location = -1;
+            GLint size = 0;
+            GLenum type = GL_NONE;
+        };
+
+        // nullptr when shader has no such active uniform, logs error
+        const UniformSlot * findUniform(ShaderUniform uniform) const;
 
         GLuint _shader_program_ID;
 
         std::optional<Stage> _vertex_stage;
         std::optional<Stage> _fragment_stage;
         
-        absl::flat_hash_map<std::string, std::pair<GLint, GLSLVariable>> _uniforms;
+        // indexed by ShaderUniform ID, resolving uniform never hashes its name
+        std::vector<UniformSlot> _uniforms;
         absl::flat_hash_map<std::string, std::pair<GLint, GLSLVariable>> _attributes;
     };
 }
\ No newline at end of file
@@ -20,10 +20,8 @@ namespace velora::opengl
             std::size_t ID() const;
 
             bool good() const;
-            //
-            bool enable() const;
-            //
-            void disable() const;
+
+            unsigned int getBindingPoint() const;
 
             void update(std::size_t size, const void * data);
 
@@ -35,6 +33,7 @@ namespace velora::opengl
 
         private:
             GLuint _SSBO;
+            GLuint _binding_point;
 
             GLsizeiptr _size;
             const void * _data;
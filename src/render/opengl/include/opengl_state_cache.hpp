@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include <spdlog/spdlog.h>
+#include <GL/glew.h>
+
+#include "opengl_debug.hpp"
+
+namespace velora::opengl
+{
+    /**
+     * @brief Shadow copy of OpenGL state touched by draw calls.
+     *
+     * Renderer changes bound program, vertex array, frame buffer, indexed buffer bindings, viewport,
+     * polygon mode and polygon offset only through this cache, so calls that would not change anything are skipped
+     * and no glGet* query is needed to find out what is bound.
+     * Unknown state (after invalidate) is always set.
+     *
+     * With validation enabled every skipped call is cross-checked against real OpenGL state,
+     * mismatch is logged and call is issued anyway.
+     *
+     * @note Not thread-safe, must be used on render thread. Stats and validation flag may be accessed from any thread.
+     */
+    class OpenGLStateCache
+    {
+        public:
+            constexpr static const GLuint MAX_INDEXED_BUFFER_BINDINGS = 16;
+
+            struct Stats
+            {
+                // state changing calls passed to OpenGL
+                uint64_t issued_calls = 0;
+                // calls skipped because state was already set
+                uint64_t avoided_calls = 0;
+                // skipped calls whose cached state did not match OpenGL, validation only
+                uint64_t validation_mismatches = 0;
+            };
+
+            OpenGLStateCache();
+
+            // forget all cached state, next call of every kind is issued
+            void invalidate();
+
+            void useProgram(GLuint program);
+            void bindVertexArray(GLuint vertex_array);
+            // binds both draw and read frame buffer, 0 is default framebuffer
+            void bindFramebuffer(GLuint frame_buffer);
+            // binds separate read and draw frame buffer for blits, next bindFramebuffer is always issued
+            void bindBlitFramebuffers(GLuint read_frame_buffer, GLuint draw_frame_buffer);
+            // GL_SHADER_STORAGE_BUFFER or GL_UNIFORM_BUFFER, indexes from MAX_INDEXED_BUFFER_BINDINGS up are not cached
+            void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+            // binds size bytes of buffer from offset, same targets and caching as bindBufferBase
+            void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+            void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+            // GL_FILL or GL_LINE for front and back faces
+            void polygonMode(GLenum mode);
+            // enables GL_POLYGON_OFFSET_FILL with factor and units
+            void polygonOffset(GLfloat factor, GLfloat units);
+            // disables GL_POLYGON_OFFSET_FILL
+            void disablePolygonOffset();
+
+            Stats getStats() const;
+
+            void setValidation(bool enabled);
+            bool getValidation() const;
+
+        private:
+            // true when call can be skipped, cross-checks cached value when validation is enabled
+            // cached value is forgotten on mismatch
+            template<class T, class Query>
+            bool skip(std::optional<T> & cached, const T & value, const char * name, Query && query)
+            {
+                if(cached != value)
+                {
+                    _issued_calls.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                if(_validation.load(std::memory_order_relaxed))
+                {
+                    const T real = query();
+                    if(real != value)
+                    {
+                        _validation_mismatches.fetch_add(1, std::memory_order_relaxed);
+                        cached = std::nullopt;
+                        _issued_calls.fetch_add(1, std::memory_order_relaxed);
+                        spdlog::error("[opengl] state cache mismatch of {}", name);
+                        return false;
+                    }
+                }
+
+                _avoided_calls.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            struct PolygonOffsetState
+            {
+                bool enabled = false;
+                GLfloat factor = 0.0f;
+                GLfloat units = 0.0f;
+
+                bool operator==(const PolygonOffsetState &) const = default;
+            };
+
+            void setPolygonOffset(PolygonOffsetState offset);
+
+            // whole buffer binding has offset and size 0, as reported by OpenGL
+            struct IndexedBinding
+            {
+                GLuint buffer = 0;
+                GLintptr offset = 0;
+                GLsizeiptr size = 0;
+
+                bool operator==(const IndexedBinding &) const = default;
+            };
+
+            // indexed binding array of target, nullptr when target is not cached
+            std::optional<IndexedBinding> * findIndexedBinding(GLenum target, GLuint index);
+            void setIndexedBinding(GLenum target, GLuint index, IndexedBinding binding);
+
+            std::optional<GLuint> _program;
+            std::optional<GLuint> _vertex_array;
+            std::optional<GLuint> _frame_buffer;
+            std::array<std::optional<IndexedBinding>, MAX_INDEXED_BUFFER_BINDINGS> _shader_storage_buffers;
+            std::array<std::optional<IndexedBinding>, MAX_INDEXED_BUFFER_BINDINGS> _uniform_buffers;
+            std::optional<std::array<GLint, 4>> _viewport;
+            std::optional<GLenum> _polygon_mode;
+            std::optional<PolygonOffsetState> _polygon_offset;
+
+            std::atomic<bool> _validation;
+
+            std::atomic<uint64_t> _issued_calls = 0;
+            std::atomic<uint64_t> _avoided_calls = 0;
+            std::atomic<uint64_t> _validation_mismatches = 0;
+    };
+}
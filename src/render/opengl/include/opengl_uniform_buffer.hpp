@@ -0,0 +1,44 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+#include <GL/glew.h>
+#include <utility>
+
+#include "opengl_debug.hpp"
+
+namespace velora::opengl
+{
+    /**
+     * @brief Uniform buffer object with std140 layout.
+     * Bound to its binding point with glBindBufferBase once, updates only replace data.
+     */
+    class OpenGLUniformBuffer
+    {
+        public:
+            OpenGLUniformBuffer(unsigned int binding_point, std::size_t size, const void * data);
+            
+            ~OpenGLUniformBuffer();
+
+            OpenGLUniformBuffer(OpenGLUniformBuffer && other);
+
+            std::size_t ID() const;
+
+            bool good() const;
+
+            unsigned int getBindingPoint() const;
+
+            void update(std::size_t size, const void * data);
+
+        protected:
+            bool generateBuffer();
+            bool removeBuffer();
+            // reallocates storage when size changes, otherwise updates it in place
+            bool copyDataToGPU(std::size_t size, const void * data);
+
+        private:
+            GLuint _UBO;
+
+            unsigned int _binding_point;
+            GLsizeiptr _size;
+    };
+}
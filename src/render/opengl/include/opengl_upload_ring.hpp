@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <spdlog/spdlog.h>
+#include <GL/glew.h>
+
+#include "opengl_debug.hpp"
+
+namespace velora::opengl
+{
+    /**
+     * @brief Persistently mapped, coherent buffer for per frame uploads.
+     *
+     * Buffer is split into FRAMES regions, every frame sub-allocates linearly from its own region,
+     * so dynamic data is written straight into mapped memory without any driver allocation.
+     * Fence is placed at the end of every frame, region is reused only after its fence signals,
+     * so CPU never overwrites data GPU may still read.
+     *
+     * Allocations fail when GL 4.4 or ARB_buffer_storage is missing or region of current frame is full,
+     * callers fall back to their own storage then.
+     *
+     * @note Not thread-safe, must be used on render thread. Stats may be read from any thread.
+     */
+    class OpenGLUploadRing
+    {
+        public:
+            // frames in flight, data uploaded in frame N stays valid until frame N + FRAMES begins
+            constexpr static const std::size_t FRAMES = 3;
+            constexpr static const std::size_t REGION_SIZE = 4 * 1024 * 1024;
+
+            // range of ring bound to indexed buffer binding instead of whole buffer of object
+            struct Range
+            {
+                GLuint buffer = 0;
+                GLintptr offset = 0;
+                GLsizeiptr size = 0;
+
+                bool operator==(const Range &) const = default;
+            };
+
+            struct Allocation
+            {
+                GLuint buffer = 0;
+                GLintptr offset = 0;
+                // mapped memory of allocation, write only
+                std::byte * data = nullptr;
+            };
+
+            struct Stats
+            {
+                // bytes written into ring by last finished frame
+                uint64_t frame_uploaded_bytes = 0;
+                // time render thread waited for fence of reused region in last finished frame
+                std::chrono::microseconds frame_fence_wait_time{0};
+                uint64_t total_uploaded_bytes = 0;
+                std::chrono::microseconds total_fence_wait_time{0};
+                // uploads that did not fit into region of their frame
+                uint64_t overflows = 0;
+                uint64_t frames = 0;
+            };
+
+            OpenGLUploadRing() = default;
+            OpenGLUploadRing(const OpenGLUploadRing&) = delete;
+            OpenGLUploadRing(OpenGLUploadRing&&) = delete;
+            OpenGLUploadRing& operator=(const OpenGLUploadRing&) = delete;
+            OpenGLUploadRing& operator=(OpenGLUploadRing&&) = delete;
+            ~OpenGLUploadRing();
+
+            /**
+             * @brief Reserves size bytes in region of current frame, aligned for uniform and shader storage buffer ranges.
+             * Buffer is created on first call, first allocation of frame waits until its region is free.
+             * @return std::nullopt when ring is not supported, size is 0 or region is full
+             */
+            std::optional<Allocation> allocate(std::size_t size);
+
+            // fences region of finished frame and moves to region of next frame, called once per presented frame
+            void endFrame();
+
+            // index of frame being recorded, increments with every endFrame
+            uint64_t getFrame() const;
+
+            // deletes buffer and fences, context must be current
+            void release();
+
+            Stats getStats() const;
+
+        private:
+            bool create();
+            // blocks until GPU finished reading region, measures wait time
+            void waitForRegion(std::size_t region);
+
+            GLuint _buffer = 0;
+            std::byte * _mapped = nullptr;
+            bool _unsupported = false;
+            GLintptr _alignment = 256;
+
+            std::array<GLsync, FRAMES> _fences{};
+            std::size_t _region = 0;
+            std::size_t _cursor = 0;
+            // region of current frame was already waited for
+            bool _region_ready = false;
+            uint64_t _frame = 0;
+
+            uint64_t _frame_uploaded_bytes = 0;
+            std::chrono::microseconds _frame_fence_wait_time{0};
+
+            std::atomic<uint64_t> _last_frame_uploaded_bytes = 0;
+            std::atomic<int64_t> _last_frame_fence_wait_us = 0;
+            std::atomic<uint64_t> _total_uploaded_bytes = 0;
+            std::atomic<int64_t> _total_fence_wait_us = 0;
+            std::atomic<uint64_t> _overflows = 0;
+            std::atomic<uint64_t> _frames = 0;
+
+            // single wait on fence, render thread keeps waiting until it signals
+            constexpr static const GLuint64 _FENCE_WAIT_TIMEOUT_NS = 1'000'000'000;
+    };
+}
@@ -2,17 +2,24 @@
 
 #include <spdlog/spdlog.h>
 #include <GL/glew.h>
+#include <optional>
 #include <utility>
 
 #include "opengl_debug.hpp"
+#include "opengl_geometry_arena.hpp"
 #include "vertex.hpp"
+#include "bounds.hpp"
 
 namespace velora::opengl
 {
+    /**
+     * @brief Mesh stored in range of geometry arena shared by all vertex buffers of renderer.
+     * ID is unique for lifetime of process, range is returned to arena on destruction.
+     */
     class OpenGLVertexBuffer
     {
         public:
-            OpenGLVertexBuffer(std::vector<unsigned int> indices, std::vector<Vertex> vertices);
+            OpenGLVertexBuffer(OpenGLGeometryArena & arena, std::vector<unsigned int> indices, std::vector<Vertex> vertices);
             
             ~OpenGLVertexBuffer();
 
@@ -23,23 +30,22 @@ namespace velora::opengl
             bool good() const;
 
             std::size_t numberOfElements() const;
-            //
-            bool enable() const;
-            //
-            void disable() const;
 
-        protected:
-            bool setGPUAttributes();
-            bool generateBuffers();
-            bool removeBuffers();
-            bool copyDataToGPU() const;
+            std::size_t firstIndex() const;
+
+            std::size_t baseVertex() const;
+
+            VertexFormat vertexFormat() const;
+
+            IndexFormat indexFormat() const;
+
+            const MeshBounds & getBounds() const;
 
         private:
-            GLuint _VAO;
-            GLuint _VBO;
-            GLuint _EBO;
+            OpenGLGeometryArena * _arena;
+            std::size_t _ID;
+            std::optional<OpenGLGeometryArena::Range> _range;
 
-            std::vector<GLuint> _indices;
-            std::vector<Vertex> _vertices;
+            MeshBounds _bounds;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "native.hpp"
+
+#include <GL/glew.h>
+#include <spdlog/spdlog.h>
+
+namespace velora::opengl
+{
+    /**
+     * @brief Binds OpenGL context to calling thread.
+     * Device context is ignored by offscreen backends, where drawable surface is part of context.
+     */
+    bool makeContextCurrent(native::device_context device_context, native::opengl_context_handle oglctx);
+
+    /**
+     * @brief Unbinds any OpenGL context from calling thread
+     */
+    void releaseCurrentContext();
+
+    bool swapBuffers(native::device_context device_context, native::opengl_context_handle oglctx);
+
+    bool setSwapInterval(native::opengl_context_handle oglctx, int interval);
+
+#ifdef VELORA_OPENGL_EGL
+    /**
+     * @brief Creates offscreen EGL context with pbuffer of given size as default framebuffer.
+     * Prefers Mesa surfaceless platform, so neither display server nor GPU is required (eg. llvmpipe).
+     * Initializes GLEW on first context.
+     * @return nullptr on failure
+     */
+    native::opengl_context_handle createEGLContext(unsigned int width, unsigned int height, unsigned int major_version, unsigned int minor_version);
+
+    bool destroyEGLContext(native::opengl_context_handle oglctx);
+#endif
+}
@@ -0,0 +1,192 @@
+#ifdef VELORA_OPENGL_EGL
+
+#include "opengl_context.hpp"
+
+#include <algorithm>
+#include <format>
+#include <string_view>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace velora::native
+{
+    struct unix_opengl_context
+    {
+        EGLDisplay display = EGL_NO_DISPLAY;
+        EGLContext context = EGL_NO_CONTEXT;
+        // EGL_NO_SURFACE when pbuffer is not supported, then only FBOs can be rendered into
+        EGLSurface surface = EGL_NO_SURFACE;
+    };
+}
+
+namespace velora::opengl
+{
+    static EGLDisplay getEGLDisplay()
+    {
+        // initialized once for whole process, EGL terminates it at exit
+        static const EGLDisplay display = []() -> EGLDisplay
+        {
+            EGLDisplay display = EGL_NO_DISPLAY;
+
+            const char * client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+            auto get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+            if(client_extensions != nullptr && get_platform_display != nullptr &&
+                std::string_view(client_extensions).contains("EGL_MESA_platform_surfaceless"))
+            {
+                display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            }
+
+            if(display == EGL_NO_DISPLAY)
+            {
+                display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+            }
+
+            EGLint major = 0;
+            EGLint minor = 0;
+            if(display == EGL_NO_DISPLAY || eglInitialize(display, &major, &minor) == EGL_FALSE)
+            {
+                spdlog::error(std::format("[egl] Cannot initialize EGL display, err: {:#x}", eglGetError()));
+                return EGL_NO_DISPLAY;
+            }
+
+            spdlog::info(std::format("[egl] EGL {}.{} initialized, vendor: {}", major, minor, eglQueryString(display, EGL_VENDOR)));
+            return display;
+        }();
+
+        return display;
+    }
+
+    native::opengl_context_handle createEGLContext(unsigned int width, unsigned int height, unsigned int major_version, unsigned int minor_version)
+    {
+        const EGLDisplay display = getEGLDisplay();
+        if(display == EGL_NO_DISPLAY)return nullptr;
+
+        if(eglBindAPI(EGL_OPENGL_API) == EGL_FALSE)
+        {
+            spdlog::error(std::format("[egl] Desktop OpenGL API not supported, err: {:#x}", eglGetError()));
+            return nullptr;
+        }
+
+        static const EGLint CONFIG_ATTRIBUTES[] =
+        {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_ALPHA_SIZE, 8,
+            EGL_DEPTH_SIZE, 24,
+            EGL_STENCIL_SIZE, 8,
+            EGL_NONE
+        };
+
+        EGLConfig config = nullptr;
+        EGLint configs_count = 0;
+        if(eglChooseConfig(display, CONFIG_ATTRIBUTES, &config, 1, &configs_count) == EGL_FALSE || configs_count == 0)
+        {
+            spdlog::error(std::format("[egl] No matching EGL config, err: {:#x}", eglGetError()));
+            return nullptr;
+        }
+
+        const EGLint CONTEXT_ATTRIBUTES[] =
+        {
+            EGL_CONTEXT_MAJOR_VERSION, (EGLint)major_version,
+            EGL_CONTEXT_MINOR_VERSION, (EGLint)minor_version,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+
+        const EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, CONTEXT_ATTRIBUTES);
+        if(context == EGL_NO_CONTEXT)
+        {
+            spdlog::error(std::format("[egl] Cannot create OpenGL {}.{} context, err: {:#x}", major_version, minor_version, eglGetError()));
+            return nullptr;
+        }
+
+        const EGLint PBUFFER_ATTRIBUTES[] =
+        {
+            EGL_WIDTH, (EGLint)std::max(width, 1u),
+            EGL_HEIGHT, (EGLint)std::max(height, 1u),
+            EGL_NONE
+        };
+
+        EGLSurface surface = eglCreatePbufferSurface(display, config, PBUFFER_ATTRIBUTES);
+        if(surface == EGL_NO_SURFACE)
+        {
+            spdlog::warn(std::format("[egl] Cannot create pbuffer, default framebuffer unavailable, err: {:#x}", eglGetError()));
+        }
+
+        if(eglMakeCurrent(display, surface, surface, context) == EGL_FALSE)
+        {
+            spdlog::error(std::format("[egl] Cannot activate OpenGL context, err: {:#x}", eglGetError()));
+            if(surface != EGL_NO_SURFACE)eglDestroySurface(display, surface);
+            eglDestroyContext(display, context);
+            return nullptr;
+        }
+
+        // glewInit would query GLX, context init loads only OpenGL entry points
+        glewExperimental = true;
+        if(glewContextInit() != GLEW_OK){
+            spdlog::error("[egl] Cannot initialize GLEW");
+        }else{
+            spdlog::info("[egl] GLEW initialized properly");
+        }
+
+        spdlog::info(std::format("\nOpenGL\n  vendor: {}\n  renderer: {}\n  version: {}\n  shading language version: {}", 
+            (const char *)glGetString(GL_VENDOR), 
+            (const char *)glGetString(GL_RENDERER), 
+            (const char *)glGetString(GL_VERSION),
+            (const char *)glGetString(GL_SHADING_LANGUAGE_VERSION)));
+
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+        return new native::unix_opengl_context{
+            .display = display,
+            .context = context,
+            .surface = surface
+        };
+    }
+
+    bool destroyEGLContext(native::opengl_context_handle oglctx)
+    {
+        if(oglctx == nullptr)return false;
+
+        if(oglctx->surface != EGL_NO_SURFACE)eglDestroySurface(oglctx->display, oglctx->surface);
+        const bool destroyed = eglDestroyContext(oglctx->display, oglctx->context) == EGL_TRUE;
+
+        delete oglctx;
+        return destroyed;
+    }
+
+    bool makeContextCurrent(native::device_context, native::opengl_context_handle oglctx)
+    {
+        if(oglctx == nullptr)return false;
+        return eglMakeCurrent(oglctx->display, oglctx->surface, oglctx->surface, oglctx->context) == EGL_TRUE;
+    }
+
+    void releaseCurrentContext()
+    {
+        const EGLDisplay display = eglGetCurrentDisplay();
+        if(display == EGL_NO_DISPLAY)return;
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+    bool swapBuffers(native::device_context, native::opengl_context_handle oglctx)
+    {
+        if(oglctx == nullptr)return false;
+
+        // swapping pbuffer is a no-op, wait for GPU instead so frame boundaries are real for timing
+        glFinish();
+        return true;
+    }
+
+    bool setSwapInterval(native::opengl_context_handle oglctx, int interval)
+    {
+        if(oglctx == nullptr)return false;
+        return eglSwapInterval(oglctx->display, interval) == EGL_TRUE;
+    }
+}
+
+#endif
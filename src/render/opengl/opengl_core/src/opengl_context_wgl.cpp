@@ -0,0 +1,30 @@
+#ifdef WIN32
+
+#include "opengl_context.hpp"
+
+#include <GL/wglew.h>
+
+namespace velora::opengl
+{
+    bool makeContextCurrent(native::device_context device_context, native::opengl_context_handle oglctx)
+    {
+        return wglMakeCurrent(device_context, oglctx) != FALSE;
+    }
+
+    void releaseCurrentContext()
+    {
+        wglMakeCurrent(0, 0);
+    }
+
+    bool swapBuffers(native::device_context device_context, native::opengl_context_handle)
+    {
+        return SwapBuffers(device_context) != FALSE;
+    }
+
+    bool setSwapInterval(native::opengl_context_handle, int interval)
+    {
+        return wglSwapIntervalEXT(interval) != FALSE;
+    }
+}
+
+#endif
@@ -36,11 +36,7 @@ namespace velora::opengl
 
     asio::awaitable<void> OpenGLRenderer::RenderThreadContext::ensureOnStrand()
     {
-        if(!_strand.running_in_this_thread()) {
-            co_return co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
-        }
-
-        co_return;
+        co_return co_await _command_ring.enter(_io_context, _strand);
     }
 
     void OpenGLRenderer::RenderThreadContext::signalClose()
@@ -69,7 +65,7 @@ namespace velora::opengl
         *(_device_context) = _window.acquireDeviceContext();
                 
         // bind context
-        if(wglMakeCurrent(*(_device_context), *(_oglctx_handle)) == FALSE)
+        if(makeContextCurrent(*(_device_context), *(_oglctx_handle)) == false)
         {
             spdlog::error(std::format("[t:{}] Cannot activate OpenGL context", std::this_thread::get_id()));
             return;
@@ -85,7 +81,7 @@ namespace velora::opengl
 
         try
         {
-            _io_context.run();
+            _command_ring.run(_io_context);
         }
         catch(const std::exception & e)
         {
@@ -93,7 +89,7 @@ namespace velora::opengl
         }
     
         // unbind context
-        wglMakeCurrent(0, 0);
+        releaseCurrentContext();
         _window.releaseDeviceContext(*(_device_context));
 
         spdlog::debug(std::format("[opengl] [t:{}] Render thread ended", std::this_thread::get_id()));
@@ -105,7 +101,22 @@ namespace velora::opengl
         auto window_handle = window.getHandle();
         native::opengl_context_handle oglctx_handle = co_await window.getProcess().registerOGLContext(window_handle, major_version, minor_version);
 
-        co_return OpenGLRenderer(window, oglctx_handle);
+        // check resumes on render thread, renderer must not be returned or destroyed there,
+        // destructor joins render thread
+        auto executor = co_await asio::this_coro::executor;
+
+        OpenGLRenderer renderer(window, oglctx_handle);
+        const bool supported = co_await renderer.checkRequiredFeatures();
+
+        co_await asio::dispatch(executor, asio::use_awaitable);
+
+        if(supported == false)
+        {
+            // destructor closes render thread and unregisters context
+            throw std::runtime_error("OpenGL context does not support features required by renderer");
+        }
+
+        co_return renderer;
     }
 
     OpenGLRenderer::OpenGLRenderer(IWindow & window, native::opengl_context_handle oglctx_handle)
@@ -131,10 +142,14 @@ namespace velora::opengl
         _oglctx_handle(std::move(other._oglctx_handle)),
         _device_context(std::move(other._device_context)),
 
+        _geometry_arena(std::move(other._geometry_arena)),
         _vertex_buffers(std::move(other._vertex_buffers)),
         _shaders(std::move(other._shaders)),
 
-        _viewport_resolution(std::move(other._viewport_resolution))
+        _viewport_resolution(std::move(other._viewport_resolution)),
+
+        _state_cache(std::move(other._state_cache)),
+        _upload_ring(std::move(other._upload_ring))
     {
         other._oglctx_handle = nullptr;
     }
@@ -171,6 +186,11 @@ namespace velora::opengl
         _device_context.reset();
     }
 
+    uint64_t OpenGLRenderer::getObjectGeneration() const
+    {
+        return _object_generation->load(std::memory_order_acquire);
+    }
+
     asio::awaitable<void> OpenGLRenderer::close()
     {
         if(good() == false)co_return;
@@ -186,12 +206,20 @@ namespace velora::opengl
         _vertex_buffers.clear();
         _shaders.clear();
         _shader_storage_buffers.clear();
+        _uniform_buffers.clear();
         _frame_buffer_objects.clear();
         _textures.clear();
         _rbos.clear();
-
-        // unbind context before unregistering in winapi process
-        wglMakeCurrent(0, 0);
+        _streamed_shader_storage_buffers.clear();
+        _streamed_uniform_buffers.clear();
+        _shader_storage_buffer_copies.clear();
+        _uniform_buffer_copies.clear();
+        _upload_ring->release();
+        _geometry_arena->release();
+        invalidateStateCache();
+
+        // unbind context before unregistering in process
+        releaseCurrentContext();
         _window.releaseDeviceContext(*_device_context);
 
         // save handle value to be sent to winapi process for unregistration
@@ -212,13 +240,29 @@ namespace velora::opengl
                 _render_context != nullptr && _render_context->running();
     }
 
+    asio::awaitable<bool> OpenGLRenderer::checkRequiredFeatures()
+    {
+        if(good() == false)co_return false;
+
+        co_await _render_context->ensureOnStrand();
+
+        if(!GLEW_VERSION_4_2 && !GLEW_ARB_base_instance)
+        {
+            spdlog::error(std::format("[opengl] Base instance drawing is not supported, OpenGL 4.2 or ARB_base_instance is required, context version: {}",
+                (const char *)glGetString(GL_VERSION)));
+            co_return false;
+        }
+
+        co_return true;
+    }
+
     asio::awaitable<void> OpenGLRenderer::enableVSync()
     {
         if(good() == false)co_return;
 
         co_await _render_context->ensureOnStrand();
 
-        wglSwapIntervalEXT(1);
+        setSwapInterval(*_oglctx_handle, 1);
         co_return;
     }
 
@@ -228,7 +272,7 @@ namespace velora::opengl
 
         co_await _render_context->ensureOnStrand();
 
-        wglSwapIntervalEXT(0);
+        setSwapInterval(*_oglctx_handle, 0);
         co_return;
     }
 
@@ -237,12 +281,12 @@ namespace velora::opengl
     {
         co_return co_await (constructInternalObject<OpenGLVertexBuffer>(
             _vertex_buffers, _vertex_buffer_names, std::move(name),
-            mesh.indices, mesh.vertices));
+            *_geometry_arena, mesh.indices, mesh.vertices));
     }
 
     asio::awaitable<bool> OpenGLRenderer::eraseVertexBuffer(std::size_t id)
     {
-        co_return co_await eraseInternalObject(_vertex_buffers, std::move(id));
+        co_return co_await eraseInternalObject(_vertex_buffers, _vertex_buffer_names, std::move(id));
     }
 
     std::optional<std::size_t> OpenGLRenderer::getVertexBuffer(std::string name) const
@@ -250,6 +294,32 @@ namespace velora::opengl
         return getInternalObjectID(_vertex_buffers, _vertex_buffer_names, std::move(name));
     }
 
+    std::optional<MeshBounds> OpenGLRenderer::getVertexBufferBounds(std::size_t id) const
+    {
+        if(good() == false)return std::nullopt;
+
+        auto it = _vertex_buffers.find(id);
+        if(it == _vertex_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] renderer object {} does not exist", std::this_thread::get_id(), id));
+            return std::nullopt;
+        }
+        return it->second->getBounds();
+    }
+
+    std::optional<std::size_t> OpenGLRenderer::getVertexBufferElementCount(std::size_t id) const
+    {
+        if(good() == false)return std::nullopt;
+
+        auto it = _vertex_buffers.find(id);
+        if(it == _vertex_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] renderer object {} does not exist", std::this_thread::get_id(), id));
+            return std::nullopt;
+        }
+        return it->second->numberOfElements();
+    }
+
 
     asio::awaitable<std::optional<std::size_t>> OpenGLRenderer::constructShader(std::string name, std::vector<std::string> vertex_code)
     {
@@ -266,7 +336,7 @@ namespace velora::opengl
 
     asio::awaitable<bool> OpenGLRenderer::eraseShader(std::size_t id)
     {
-        co_return co_await eraseInternalObject(_shaders, std::move(id));
+        co_return co_await eraseInternalObject(_shaders, _shader_names, std::move(id));
     }
 
     std::optional<std::size_t> OpenGLRenderer::getShader(std::string name) const
@@ -288,7 +358,13 @@ namespace velora::opengl
 
     asio::awaitable<bool> OpenGLRenderer::eraseShaderStorageBuffer(std::size_t id)
     {
-        co_return co_await eraseInternalObject(_shader_storage_buffers, std::move(id));
+        const bool erased = co_await eraseInternalObject(_shader_storage_buffers, _shader_storage_buffer_names, id);
+        if(erased)
+        {
+            _streamed_shader_storage_buffers.erase(id);
+            _shader_storage_buffer_copies.erase(id);
+        }
+        co_return erased;
     }
 
     std::optional<std::size_t> OpenGLRenderer::getShaderStorageBuffer(std::string name) const
@@ -308,10 +384,78 @@ namespace velora::opengl
             co_return false;
         }
 
+        // ring range is bound by draws reading the buffer
+        auto streamed = streamBuffer(size, data, _shader_storage_buffer_copies[id]);
+        if(streamed)
+        {
+            _streamed_shader_storage_buffers.insert_or_assign(id, std::move(*streamed));
+            co_return true;
+        }
+
+        _streamed_shader_storage_buffers.erase(id);
         _shader_storage_buffers.at(id)->update(std::move(size), std::move(data));
         co_return true;
     }
 
+    asio::awaitable<std::optional<std::size_t>> OpenGLRenderer::constructUniformBuffer(
+                std::string name,
+                unsigned int binding_point,
+                const std::size_t size,
+                const void * data)
+    {
+        co_return co_await (constructInternalObject<OpenGLUniformBuffer>(
+            _uniform_buffers, _uniform_buffer_names, std::move(name),
+            binding_point, std::move(size), std::move(data)));
+    }
+
+    asio::awaitable<bool> OpenGLRenderer::eraseUniformBuffer(std::size_t id)
+    {
+        const bool erased = co_await eraseInternalObject(_uniform_buffers, _uniform_buffer_names, id);
+        if(erased)
+        {
+            _streamed_uniform_buffers.erase(id);
+            _uniform_buffer_copies.erase(id);
+        }
+        co_return erased;
+    }
+
+    std::optional<std::size_t> OpenGLRenderer::getUniformBuffer(std::string name) const
+    {
+        return getInternalObjectID(_uniform_buffers, _uniform_buffer_names, std::move(name));
+    }
+    
+    asio::awaitable<bool> OpenGLRenderer::updateUniformBuffer(std::size_t id, const std::size_t size, const void * data)
+    {
+        if(good() == false)co_return false;
+        
+        co_await _render_context->ensureOnStrand();
+        
+        auto uniform_buffer_it = _uniform_buffers.find(id);
+        if(uniform_buffer_it == _uniform_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] Uniform buffer {} does not exist", std::this_thread::get_id(), id));
+            co_return false;
+        }
+
+        const GLuint binding_point = (GLuint)uniform_buffer_it->second->getBindingPoint();
+
+        // uniform blocks are bound globally, draws issued from now on read new range
+        auto streamed = streamBuffer(size, data, _uniform_buffer_copies[id]);
+        if(streamed)
+        {
+            _state_cache->bindBufferRange(GL_UNIFORM_BUFFER, binding_point, streamed->range.buffer, streamed->range.offset, streamed->range.size);
+            _streamed_uniform_buffers.insert_or_assign(id, std::move(*streamed));
+            co_return true;
+        }
+
+        uniform_buffer_it->second->update(std::move(size), std::move(data));
+        if(_streamed_uniform_buffers.erase(id) > 0)
+        {
+            _state_cache->bindBufferBase(GL_UNIFORM_BUFFER, binding_point, (GLuint)uniform_buffer_it->second->ID());
+        }
+        co_return true;
+    }
+
 
     asio::awaitable<std::optional<std::size_t>> OpenGLRenderer::constructFrameBufferObject(std::string name, Resolution resolution, std::initializer_list<FBOAttachment> attachments)
     {
@@ -367,7 +511,7 @@ namespace velora::opengl
 
     asio::awaitable<bool> OpenGLRenderer::eraseFrameBufferObject(std::size_t id)
     {
-        co_return co_await eraseInternalObject(_frame_buffer_objects, std::move(id));
+        co_return co_await eraseInternalObject(_frame_buffer_objects, _frame_buffer_object_names, std::move(id));
     }
 
     std::optional<std::size_t> OpenGLRenderer::getFrameBufferObject(std::string name) const
@@ -386,7 +530,7 @@ namespace velora::opengl
 
     asio::awaitable<bool> OpenGLRenderer::eraseTexture(std::size_t id)
     {
-        co_return co_await eraseInternalObject(_textures, std::move(id));
+        co_return co_await eraseInternalObject(_textures, _textures_names, std::move(id));
     }
 
     std::optional<std::size_t> OpenGLRenderer::getTexture(std::string name) const
@@ -395,142 +539,298 @@ namespace velora::opengl
     }
 
 
-    void OpenGLRenderer::assignShaderInputs(const std::size_t & shader_ID, const ShaderInputs & shader_inputs)
+    void OpenGLRenderer::assignShaderInputs(Shader & shader, const ShaderInputs & shader_inputs)
     {
-        for(const auto & [name, val] : shader_inputs.in_bool)
-        {
-            _shaders.at(shader_ID)->setUniform(name, val);
-        }
-
-        for(const auto & [name, val] : shader_inputs.in_int)
-        {
-            _shaders.at(shader_ID)->setUniform(name, val);
-        }
-        for(const auto & [name, val] : shader_inputs.in_float)
-        {
-            _shaders.at(shader_ID)->setUniform(name, val);
-        }
+        // Samplers take consecutive texture units in order of inputs
+        unsigned int sampler_unit = 0;
 
-        for(const auto & [name, val] : shader_inputs.in_vec2)
+        for(const ShaderInputs::Input & input : shader_inputs.getInputs())
         {
-            _shaders.at(shader_ID)->setUniform(name, val);
-        }
-        for(const auto & [name, val] : shader_inputs.in_vec3)
-        {
-            _shaders.at(shader_ID)->setUniform(name, val);
-        }
-        for(const auto & [name, val] : shader_inputs.in_vec4)
-        {
-            _shaders.at(shader_ID)->setUniform(name, val);
-        }
+            std::visit([&](const auto & value)
+            {
+                using T = std::decay_t<decltype(value)>;
 
-        for(const auto & [name, val] : shader_inputs.in_mat2)
-        {
-            _shaders.at(shader_ID)->setUniform(name, val);
-        }
-        for(const auto & [name, val] : shader_inputs.in_mat3)
-        {
-            _shaders.at(shader_ID)->setUniform(name, val);
-        }
-        for(const auto & [name, val] : shader_inputs.in_mat4)
-        {
-            _shaders.at(shader_ID)->setUniform(name, val);
-        }
-        for(const auto & [name, val] : shader_inputs.in_mat4_array)
-        {
-            _shaders.at(shader_ID)->setUniform(name, val);
+                if constexpr (std::is_same_v<T, ShaderInputs::Sampler>)
+                {
+                    auto texture_it = _textures.find(value.texture);
+                    if(texture_it == _textures.end())
+                    {
+                        spdlog::warn(std::format("[t:{}] Texture {} does not exist", std::this_thread::get_id(), input.uniform.getName()));
+                        return;
+                    }
+
+                    shader->setUniform(input.uniform, sampler_unit++, *texture_it->second);
+                }
+                else if constexpr (std::is_same_v<T, ShaderInputs::SamplerArray>)
+                {
+                    if(value.textures.size() > _MAX_SAMPLER_ARRAY_SIZE)
+                    {
+                        spdlog::error("Sampler array {} has more than {} textures", input.uniform.getName(), _MAX_SAMPLER_ARRAY_SIZE);
+                        return;
+                    }
+
+                    std::array<ITexture*, _MAX_SAMPLER_ARRAY_SIZE> in_textures;
+                    for(std::size_t i = 0; i < value.textures.size(); ++i)
+                    {
+                        auto texture_it = _textures.find(value.textures[i]);
+                        if(texture_it == _textures.end())
+                        {
+                            spdlog::warn(std::format("[t:{}] Texture {} does not exist", std::this_thread::get_id(), input.uniform.getName()));
+                            return;
+                        }
+                        in_textures[i] = texture_it->second.get();
+                    }
+
+                    shader->setUniform(input.uniform, sampler_unit, std::span<ITexture * const>(in_textures.data(), value.textures.size()));
+                    sampler_unit += (unsigned int)value.textures.size();
+                }
+                else
+                {
+                    shader->setUniform(input.uniform, value);
+                }
+            }, input.value);
         }
         
         // SSBO
-        for(const auto & storage_buffer : shader_inputs.storage_buffers)
+        for(const auto & storage_buffer : shader_inputs.getStorageBuffers())
         {
             auto shader_storage_buffer_it = _shader_storage_buffers.find(storage_buffer);
             if(shader_storage_buffer_it == _shader_storage_buffers.end()){
                 spdlog::warn("Rendering: Shader storage buffer not found");
                 continue;
             }
-            if(shader_storage_buffer_it->second->enable() == false)
+            // binding point may be shared by several buffers, cache skips rebinding the same one
+            auto streamed_it = _streamed_shader_storage_buffers.find(storage_buffer);
+            if(streamed_it != _streamed_shader_storage_buffers.end())
             {
-                spdlog::error("Cannot enable shader storage buffer");
-                continue;
+                const OpenGLUploadRing::Range & range = streamed_it->second.range;
+                _state_cache->bindBufferRange(GL_SHADER_STORAGE_BUFFER,
+                    shader_storage_buffer_it->second->getBindingPoint(), range.buffer, range.offset, range.size);
+            }
+            else
+            {
+                _state_cache->bindBufferBase(GL_SHADER_STORAGE_BUFFER,
+                    shader_storage_buffer_it->second->getBindingPoint(), (GLuint)shader_storage_buffer_it->second->ID());
             }
         }
+    }
 
-        // Samplers
-        unsigned int sampler_unit = 0;
+    void OpenGLRenderer::invalidateStateCache()
+    {
+        _state_cache->invalidate();
+    }
 
-        for(const auto & [name, sampler] : shader_inputs.in_samplers )
+    OpenGLStateCache::Stats OpenGLRenderer::getStateCacheStats() const
+    {
+        if(_state_cache == nullptr)return {};
+        return _state_cache->getStats();
+    }
+
+    void OpenGLRenderer::setStateCacheValidation(bool enabled)
+    {
+        if(_state_cache == nullptr)return;
+        _state_cache->setValidation(enabled);
+    }
+
+    OpenGLUploadRing::Stats OpenGLRenderer::getUploadStats() const
+    {
+        if(_upload_ring == nullptr)return {};
+        return _upload_ring->getStats();
+    }
+
+    OpenGLGeometryArena::Stats OpenGLRenderer::getGeometryArenaStats() const
+    {
+        if(_geometry_arena == nullptr)return {};
+        return _geometry_arena->getStats();
+    }
+
+    std::optional<OpenGLRenderer::StreamedBuffer> OpenGLRenderer::streamBuffer(const std::size_t size, const void * data, std::vector<std::byte> & copy)
+    {
+        if(data == nullptr)return std::nullopt;
+
+        const std::optional<OpenGLUploadRing::Allocation> allocation = _upload_ring->allocate(size);
+        if(!allocation)return std::nullopt;
+
+        std::memcpy(allocation->data, data, size);
+
+        // keeps capacity of previous updates, allocates only when buffer grows
+        const std::byte * bytes = static_cast<const std::byte *>(data);
+        copy.assign(bytes, bytes + size);
+
+        return StreamedBuffer{
+            .range = OpenGLUploadRing::Range{.buffer = allocation->buffer, .offset = allocation->offset, .size = (GLsizeiptr)size},
+            .frame = _upload_ring->getFrame()
+        };
+    }
+
+    void OpenGLRenderer::releaseStaleStreamedBuffers()
+    {
+        const auto stale = [this](const StreamedBuffer & streamed)
+        {
+            return _upload_ring->getFrame() >= streamed.frame + OpenGLUploadRing::FRAMES;
+        };
+
+        for(auto it = _streamed_shader_storage_buffers.begin(); it != _streamed_shader_storage_buffers.end();)
         {
-            if(_textures.contains(sampler) == false)
+            auto shader_storage_buffer_it = _shader_storage_buffers.find(it->first);
+            if(stale(it->second) && shader_storage_buffer_it != _shader_storage_buffers.end())
             {
-                spdlog::warn(std::format("[t:{}] Texture {} does not exist", std::this_thread::get_id(), name));
+                const std::vector<std::byte> & copy = _shader_storage_buffer_copies.at(it->first);
+                shader_storage_buffer_it->second->update(copy.size(), copy.data());
+                _streamed_shader_storage_buffers.erase(it++);
                 continue;
             }
-
-            _shaders.at(shader_ID)->setUniform(name, sampler_unit++, *_textures.at(sampler));
+            ++it;
         }
 
-        bool success = true;
-        std::vector<ITexture*> in_textures;
-        for(const auto & [name, samplers] : shader_inputs.in_samplers_array)
+        for(auto it = _streamed_uniform_buffers.begin(); it != _streamed_uniform_buffers.end();)
         {
-            for(unsigned int i = 0; i < samplers.size(); ++i)
+            auto uniform_buffer_it = _uniform_buffers.find(it->first);
+            if(stale(it->second) && uniform_buffer_it != _uniform_buffers.end())
             {
-                if(_textures.contains(samplers[i]) == false)
-                {
-                    spdlog::warn(std::format("[t:{}] Texture {} does not exist", std::this_thread::get_id(), name));
-                    success = false;
-                    continue;
-                }
-                else
-                {
-                    in_textures.emplace_back(_textures.at(samplers[i]).get());
-                }
+                const std::vector<std::byte> & copy = _uniform_buffer_copies.at(it->first);
+                uniform_buffer_it->second->update(copy.size(), copy.data());
+                _state_cache->bindBufferBase(GL_UNIFORM_BUFFER, (GLuint)uniform_buffer_it->second->getBindingPoint(), (GLuint)uniform_buffer_it->second->ID());
+                _streamed_uniform_buffers.erase(it++);
+                continue;
             }
-            if(!success)continue;
-
-            _shaders.at(shader_ID)->setUniform(name, sampler_unit, in_textures);
-            sampler_unit += in_textures.size();
+            ++it;
         }
     }
 
-    asio::awaitable<void> OpenGLRenderer::clearScreen(glm::vec4 color, std::optional<std::size_t> fbo)
+    bool OpenGLRenderer::bindFrameBuffer(std::optional<std::size_t> fbo, std::optional<RenderRegion> region)
     {
-        if(good() == false)co_return;
-
-        co_await _render_context->ensureOnStrand();
-
         if(fbo)
         {
-            if(_frame_buffer_objects.contains(*fbo) == false)
+            auto fbo_it = _frame_buffer_objects.find(*fbo);
+            if(fbo_it == _frame_buffer_objects.end())
             {
                 spdlog::error("Frame buffer object not found");
-                co_return;
+                return false;
             }
-            if(_frame_buffer_objects.at(*fbo)->enable() == false)
+            _state_cache->bindFramebuffer((GLuint)fbo_it->second->ID());
+            if(!region)
             {
-                spdlog::error("Cannot enable frame buffer object");
-                co_return;
+                _state_cache->viewport(0, 0, (GLsizei)fbo_it->second->getResolution().getWidth(),
+                    (GLsizei)fbo_it->second->getResolution().getHeight());
             }
-            const auto & fbo_obj_ref = _frame_buffer_objects.at(*fbo);
-            glViewport(0, 0, (GLsizei)fbo_obj_ref->getResolution().getWidth(),
-                 (GLsizei)fbo_obj_ref->getResolution().getHeight());
         }
         else
         {
-            glViewport(0, 0, (GLsizei)_viewport_resolution.getWidth(), 
-                (GLsizei)_viewport_resolution.getHeight());
+            _state_cache->bindFramebuffer(0);
+            if(!region)
+            {
+                _state_cache->viewport(0, 0, (GLsizei)_viewport_resolution.getWidth(), 
+                    (GLsizei)_viewport_resolution.getHeight());
+            }
+        }
+
+        if(region)
+        {
+            _state_cache->viewport((GLint)region->x, (GLint)region->y, (GLsizei)region->width, (GLsizei)region->height);
+        }
+
+        return true;
+    }
+
+    asio::awaitable<void> OpenGLRenderer::clearScreen(glm::vec4 color, std::optional<std::size_t> fbo, std::optional<RenderRegion> region)
+    {
+        if(good() == false)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        clearFrameBuffer(color, fbo, region);
+
+        co_return;
+    }
+
+    asio::awaitable<void> OpenGLRenderer::copyFrameBufferObjectDepth(std::size_t source, std::size_t destination, std::optional<RenderRegion> region)
+    {
+        if(good() == false)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        copyDepth(source, destination, region);
+
+        co_return;
+    }
+
+    asio::awaitable<void> OpenGLRenderer::clearScreenRegions(glm::vec4 color, std::optional<std::size_t> fbo, std::span<const RenderRegion> regions)
+    {
+        if(good() == false || regions.empty())co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        for(const RenderRegion & region : regions)
+        {
+            if(clearFrameBuffer(color, fbo, region) == false)break;
         }
 
+        co_return;
+    }
+
+    asio::awaitable<void> OpenGLRenderer::copyFrameBufferObjectDepthRegions(std::size_t source, std::size_t destination, std::span<const RenderRegion> regions)
+    {
+        if(good() == false || regions.empty())co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        for(const RenderRegion & region : regions)
+        {
+            if(copyDepth(source, destination, region) == false)break;
+        }
+
+        co_return;
+    }
+
+    bool OpenGLRenderer::clearFrameBuffer(const glm::vec4 & color, std::optional<std::size_t> fbo, std::optional<RenderRegion> region)
+    {
+        if(bindFrameBuffer(fbo) == false)return false;
+
         glClearColor(color.r, color.g, color.b, color.a);
+
+        // clear ignores viewport, only scissor limits it
+        if(region)
+        {
+            glEnable(GL_SCISSOR_TEST);
+            glScissor((GLint)region->x, (GLint)region->y, (GLsizei)region->width, (GLsizei)region->height);
+        }
+
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        if(fbo)
+        if(region)glDisable(GL_SCISSOR_TEST);
+
+        return true;
+    }
+
+    bool OpenGLRenderer::copyDepth(std::size_t source, std::size_t destination, std::optional<RenderRegion> region)
+    {
+        auto source_it = _frame_buffer_objects.find(source);
+        auto destination_it = _frame_buffer_objects.find(destination);
+        if(source_it == _frame_buffer_objects.end() || destination_it == _frame_buffer_objects.end())
         {
-            _frame_buffer_objects.at(*fbo)->disable();
+            spdlog::error("Frame buffer object not found");
+            return false;
         }
 
-        co_return;
+        const Resolution & resolution = destination_it->second->getResolution();
+        if(source_it->second->getResolution().getWidth() != resolution.getWidth() ||
+            source_it->second->getResolution().getHeight() != resolution.getHeight())
+        {
+            spdlog::error("Frame buffer objects resolution mismatch");
+            return false;
+        }
+
+        const RenderRegion copy_region = region.value_or(RenderRegion{
+            .width = (uint32_t)resolution.getWidth(),
+            .height = (uint32_t)resolution.getHeight()});
+        const GLint x0 = (GLint)copy_region.x, y0 = (GLint)copy_region.y;
+        const GLint x1 = x0 + (GLint)copy_region.width, y1 = y0 + (GLint)copy_region.height;
+
+        _state_cache->bindBlitFramebuffers((GLuint)source_it->second->ID(), (GLuint)destination_it->second->ID());
+        glBlitFramebuffer(x0, y0, x1, y1, x0, y0, x1, y1, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+        return true;
     }
 
     asio::awaitable<void> OpenGLRenderer::render(
@@ -544,77 +844,198 @@ namespace velora::opengl
 
         co_await _render_context->ensureOnStrand();
 
-        if(fbo)
+        drawElements(vertex_buffer, shader, 1, 0, shader_inputs, options, fbo);
+
+        co_return;
+    }
+
+    asio::awaitable<void> OpenGLRenderer::renderInstanced(
+            std::size_t vertex_buffer,
+            std::size_t shader,
+            std::size_t instance_count,
+            ShaderInputs shader_inputs,
+            RenderOptions options,
+            std::optional<std::size_t> fbo)
+    {
+        if(good() == false)co_return;
+        if(instance_count == 0)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        drawElements(vertex_buffer, shader, instance_count, 0, shader_inputs, options, fbo);
+
+        co_return;
+    }
+
+    asio::awaitable<void> OpenGLRenderer::submit(std::span<const DrawItem> draws)
+    {
+        if(good() == false)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        // meshes of different formats live in different pools of geometry arena and cannot share multi draw
+        const auto formatsOf = [this](std::size_t vertex_buffer)
+        {
+            auto vertex_buffer_it = _vertex_buffers.find(vertex_buffer);
+            if(vertex_buffer_it == _vertex_buffers.end())return std::pair{VertexFormat::Count, IndexFormat::Count};
+            return std::pair{vertex_buffer_it->second->vertexFormat(), vertex_buffer_it->second->indexFormat()};
+        };
+
+        // consecutive draws differing only in mesh and instances become single multi draw,
+        // render queue order keeps them together
+        const auto sharesState = [&formatsOf](const DrawItem & lhs, const DrawItem & rhs)
         {
-            if(_frame_buffer_objects.contains(*fbo) == false)
+            return rhs.instance_count > 0 && lhs.shader == rhs.shader && lhs.fbo == rhs.fbo &&
+                lhs.options == rhs.options && lhs.shader_inputs == rhs.shader_inputs &&
+                formatsOf(lhs.vertex_buffer) == formatsOf(rhs.vertex_buffer);
+        };
+
+        std::size_t first = 0;
+        while(first < draws.size())
+        {
+            if(draws[first].instance_count == 0)
             {
-                spdlog::error("Frame buffer object not found");
-                co_return;
+                first++;
+                continue;
             }
-            if(_frame_buffer_objects.at(*fbo)->enable() == false)
+
+            std::size_t last = first + 1;
+            while(last < draws.size() && sharesState(draws[first], draws[last]))last++;
+
+            const std::span<const DrawItem> batch = draws.subspan(first, last - first);
+            if(batch.size() == 1 || multiDrawElements(batch) == false)
             {
-                spdlog::error("Cannot enable frame buffer object");
-                co_return;
+                for(const DrawItem & draw : batch)
+                {
+                    drawElements(draw.vertex_buffer, draw.shader, draw.instance_count, draw.first_instance,
+                        draw.shader_inputs, draw.options, draw.fbo);
+                }
             }
-            const auto & fbo_obj_ref = _frame_buffer_objects.at(*fbo);
-            glViewport(0, 0, (GLsizei)fbo_obj_ref->getResolution().getWidth(),
-                 (GLsizei)fbo_obj_ref->getResolution().getHeight());
-        }
-        else
-        {
-            glViewport(0, 0, (GLsizei)_viewport_resolution.getWidth(), 
-                (GLsizei)_viewport_resolution.getHeight());
+            first = last;
         }
 
+        co_return;
+    }
+
+    bool OpenGLRenderer::bindDrawState(
+            GLuint vertex_array,
+            std::size_t shader,
+            const ShaderInputs & shader_inputs,
+            const RenderOptions & options,
+            std::optional<std::size_t> fbo)
+    {
+        if(bindFrameBuffer(fbo, options.region) == false)return false;
+
         auto shader_it = _shaders.find(shader);
         if(shader_it == _shaders.end()){
             spdlog::warn("Rendering: Shader not found");
-            co_return;
+            return false;
         }
 
-        auto vertex_buffer_it = _vertex_buffers.find(vertex_buffer);
-        if(vertex_buffer_it == _vertex_buffers.end()){
-            spdlog::warn("Rendering: Vertex buffer not found");
-            co_return;
-        }
+        // draws sorted by render queue share shader with previous draw most of the time
+        // all meshes live in geometry arena, vertex array of their pool holds vertex and element buffer bindings of draw
+        // most meshes share one pool, so vertex array rarely changes between draws
+        _state_cache->useProgram((GLuint)shader_it->second->ID());
+        _state_cache->bindVertexArray(vertex_array);
 
+        assignShaderInputs(shader_it->second, shader_inputs);
 
-        if(shader_it->second->enable() == false){
-            spdlog::error("Cannot enable shader program");
-            co_return;
-        }
+        // raster state is set for every draw and never restored, cache skips it when it matches previous draw
+        _state_cache->polygonMode(options.mode == RenderMode::Wireframe ? GL_LINE : GL_FILL);
 
-        if(vertex_buffer_it->second->enable() == false){
-            spdlog::error("Cannot enable vertex buffer");
-            co_return;
+        if(options.polygon_offset)
+        {
+            _state_cache->polygonOffset(options.polygon_offset->factor, options.polygon_offset->units);
+        }
+        else
+        {
+            _state_cache->disablePolygonOffset();
         }
 
-        assignShaderInputs(shader, shader_inputs);
+        return true;
+    }
 
-        if(options.mode == RenderMode::Wireframe)glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        
-        if(options.polygon_offset)
-        {
-            glEnable(GL_POLYGON_OFFSET_FILL);
-            glPolygonOffset(options.polygon_offset->factor, options.polygon_offset->units);
+    bool OpenGLRenderer::drawElements(
+            std::size_t vertex_buffer,
+            std::size_t shader,
+            std::size_t instance_count,
+            uint32_t first_instance,
+            const ShaderInputs & shader_inputs,
+            const RenderOptions & options,
+            std::optional<std::size_t> fbo)
+    {
+        auto vertex_buffer_it = _vertex_buffers.find(vertex_buffer);
+        if(vertex_buffer_it == _vertex_buffers.end()){
+            spdlog::warn("Rendering: Vertex buffer not found");
+            return false;
         }
 
-        glDrawElements(GL_TRIANGLES, (GLsizei)vertex_buffer_it->second->numberOfElements(), GL_UNSIGNED_INT, nullptr);
-        
-        if(options.polygon_offset)
+        if(first_instance + instance_count > OpenGLGeometryArena::MAX_INSTANCES)
         {
-            glDisable(GL_POLYGON_OFFSET_FILL);
+            spdlog::warn(std::format("Rendering: instances [{}, {}) exceed instance attribute range", first_instance, first_instance + instance_count));
+            return false;
         }
 
-        if(options.mode == RenderMode::Wireframe)glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); // restore default
+        const VertexFormat vertex_format = vertex_buffer_it->second->vertexFormat();
+        const IndexFormat index_format = vertex_buffer_it->second->indexFormat();
+        if(bindDrawState(_geometry_arena->getVertexArray(vertex_format, index_format), shader, shader_inputs, options, fbo) == false)return false;
 
+        // base instance offsets instance attribute, gl_InstanceID still starts at 0
+        glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES,
+            (GLsizei)vertex_buffer_it->second->numberOfElements(), OpenGLGeometryArena::getIndexType(index_format),
+            (const void *)(vertex_buffer_it->second->firstIndex() * getIndexFormatSize(index_format)),
+            (GLsizei)instance_count, (GLint)vertex_buffer_it->second->baseVertex(), (GLuint)first_instance);
 
-        if(fbo)
+        // frame buffer object stays bound for next draw, bindFrameBuffer switches it when needed
+
+        return true;
+    }
+
+    bool OpenGLRenderer::multiDrawElements(std::span<const DrawItem> draws)
+    {
+        if(!GLEW_VERSION_4_3 && !GLEW_ARB_multi_draw_indirect)return false;
+
+        if(draws.empty())return false;
+
+        auto first_vertex_buffer_it = _vertex_buffers.find(draws.front().vertex_buffer);
+        if(first_vertex_buffer_it == _vertex_buffers.end())return false;
+        const VertexFormat vertex_format = first_vertex_buffer_it->second->vertexFormat();
+        const IndexFormat index_format = first_vertex_buffer_it->second->indexFormat();
+
+        _indirect_commands.clear();
+        for(const DrawItem & draw : draws)
         {
-            _frame_buffer_objects.at(*fbo)->disable();
+            auto vertex_buffer_it = _vertex_buffers.find(draw.vertex_buffer);
+            if(vertex_buffer_it == _vertex_buffers.end())return false;
+            if(draw.first_instance + draw.instance_count > OpenGLGeometryArena::MAX_INSTANCES)return false;
+            // first index is counted in indices, so it stays valid for any index width
+            if(vertex_buffer_it->second->vertexFormat() != vertex_format || vertex_buffer_it->second->indexFormat() != index_format)return false;
+
+            _indirect_commands.emplace_back(DrawElementsIndirectCommand{
+                .count = (GLuint)vertex_buffer_it->second->numberOfElements(),
+                .instance_count = (GLuint)draw.instance_count,
+                .first_index = (GLuint)vertex_buffer_it->second->firstIndex(),
+                .base_vertex = (GLint)vertex_buffer_it->second->baseVertex(),
+                .base_instance = draw.first_instance
+            });
         }
 
-        co_return;
+        const std::size_t size = sizeof(DrawElementsIndirectCommand) * _indirect_commands.size();
+        const std::optional<OpenGLUploadRing::Allocation> allocation = _upload_ring->allocate(size);
+        if(!allocation)return false;
+
+        std::memcpy(allocation->data, _indirect_commands.data(), size);
+
+        const DrawItem & draw = draws.front();
+        if(bindDrawState(_geometry_arena->getVertexArray(vertex_format, index_format), draw.shader, draw.shader_inputs, draw.options, draw.fbo) == false)return false;
+
+        // indirect buffer binding is not vertex array state and used only here
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, allocation->buffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, OpenGLGeometryArena::getIndexType(index_format), (const void *)allocation->offset,
+            (GLsizei)_indirect_commands.size(), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        return true;
     }
 
     asio::awaitable<void> OpenGLRenderer::present()
@@ -623,8 +1044,11 @@ namespace velora::opengl
 
         co_await _render_context->ensureOnStrand();
 
+        _upload_ring->endFrame();
+        releaseStaleStreamedBuffers();
+
         glFlush();
-        SwapBuffers(*_device_context);
+        swapBuffers(*_device_context, *_oglctx_handle);
 
         co_return;
     }
@@ -637,20 +1061,23 @@ namespace velora::opengl
         
         _viewport_resolution = resolution;
 
+        // context is made current again below, do not trust cached state
+        invalidateStateCache();
+
         // if the OpenGL context depends on a HDC that may change
         // (e.g. due to window resize, DPI change, or re-creation), 
         // then you must re-acquire the HDC (_device_context) from the HWND before calling glViewport()
         // or any other GL function that implicitly touches the current drawable surface
         
         // release old context
-        wglMakeCurrent(0, 0);
+        releaseCurrentContext();
         _window.releaseDeviceContext(*_device_context);
 
         // acquire new context
         *_device_context = _window.acquireDeviceContext();
                 
         // bind context
-        if(wglMakeCurrent(*_device_context, *_oglctx_handle) == FALSE)
+        if(makeContextCurrent(*_device_context, *_oglctx_handle) == false)
         {
             spdlog::error(std::format("[t:{}] Cannot activate OpenGL context", std::this_thread::get_id()));
             co_return;
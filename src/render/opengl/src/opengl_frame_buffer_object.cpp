@@ -11,17 +11,19 @@ namespace velora::opengl
             return;
         }
 
-        enable();
+        // attachments need frame buffer bound, renderer invalidates state cache after construction
+        glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
 
         processAttachments(attachments);
 
         if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
         {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
             spdlog::error("FBO validation failed");
             throw std::runtime_error("FBO validation failed");
         }
 
-        disable();
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
         const auto check = checkOpenGLState();
         if(!check)
@@ -40,7 +42,7 @@ namespace velora::opengl
     {
         if(good() == false)return;
 
-        disable();
+        // deleting bound frame buffer reverts binding to default framebuffer
         removeBuffer();
 
         spdlog::info("OpenGL frame buffer object destroyed");
@@ -89,54 +91,6 @@ namespace velora::opengl
         return good();
     }
 
-    void OpenGLFrameBufferObject::disable() const
-    {
-        if(_FBO == 0)return;
-
-        GLint currently_bound_FBO = 0;
-        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &currently_bound_FBO);
-        
-        if(currently_bound_FBO != (GLint)_FBO)
-        {
-            spdlog::warn("Disable OpenGL frame buffer object which is not currently bound");
-            return;
-        }
-        
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    }
-
-    bool OpenGLFrameBufferObject::enable() const
-    {
-        if(_FBO == 0)
-        {
-            spdlog::error("Use of uninitialized OpenGL frame buffer object");
-            return false;
-        }
-
-        // check if need of bind SSBO
-        GLint currently_bound_FBO = 0;
-        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &currently_bound_FBO);
-
-        // already binded
-        if(currently_bound_FBO == (GLint)_FBO) return true;
-        
-        // try to bind
-        glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
-
-        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &currently_bound_FBO);
-
-        if(currently_bound_FBO != (GLint)_FBO)
-        { 
-            spdlog::error(std::format("FBO binding failed, currently bound: {}, should be {} ", 
-                    currently_bound_FBO, _FBO));
-                
-            disable();
-            return false;
-        }
-        
-        return true;
-    }
-
     const std::vector<std::size_t> & OpenGLFrameBufferObject::getTextures() const
     {
         return _attached_textures;
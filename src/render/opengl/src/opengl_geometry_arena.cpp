@@ -0,0 +1,390 @@
+#include "opengl_geometry_arena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <vector>
+
+namespace velora::opengl
+{
+    std::optional<std::size_t> OpenGLGeometryArena::FreeList::allocate(std::size_t size)
+    {
+        for(auto it = ranges.begin(); it != ranges.end(); ++it)
+        {
+            if(it->second < size)continue;
+
+            const std::size_t offset = it->first;
+            const std::size_t remaining = it->second - size;
+            ranges.erase(it);
+            if(remaining > 0)ranges.emplace(offset + size, remaining);
+            return offset;
+        }
+        return std::nullopt;
+    }
+
+    void OpenGLGeometryArena::FreeList::free(std::size_t offset, std::size_t size)
+    {
+        if(size == 0)return;
+
+        auto next = ranges.lower_bound(offset);
+
+        // merge with range ending at offset
+        if(next != ranges.begin())
+        {
+            auto previous = std::prev(next);
+            if(previous->first + previous->second == offset)
+            {
+                offset = previous->first;
+                size += previous->second;
+                ranges.erase(previous);
+            }
+        }
+
+        // merge with range starting right after
+        if(next != ranges.end() && offset + size == next->first)
+        {
+            size += next->second;
+            ranges.erase(next);
+        }
+
+        ranges.emplace(offset, size);
+    }
+
+    void OpenGLGeometryArena::FreeList::grow(std::size_t new_capacity)
+    {
+        if(new_capacity <= capacity)return;
+
+        const std::size_t old_capacity = capacity;
+        capacity = new_capacity;
+        free(old_capacity, new_capacity - old_capacity);
+    }
+
+    OpenGLGeometryArena::OpenGLGeometryArena()
+    {
+        for(std::size_t v = 0; v < (std::size_t)VertexFormat::Count; ++v)
+        {
+            for(std::size_t i = 0; i < (std::size_t)IndexFormat::Count; ++i)
+            {
+                Pool & pool = _pools[getPoolIndex((VertexFormat)v, (IndexFormat)i)];
+                pool.vertex_format = (VertexFormat)v;
+                pool.index_format = (IndexFormat)i;
+            }
+        }
+    }
+
+    OpenGLGeometryArena::~OpenGLGeometryArena()
+    {
+        assert(_instance_buffer == 0 && "Geometry arena should be released on render thread before destruction");
+    }
+
+    std::size_t OpenGLGeometryArena::getPoolIndex(VertexFormat vertex_format, IndexFormat index_format)
+    {
+        return (std::size_t)vertex_format * (std::size_t)IndexFormat::Count + (std::size_t)index_format;
+    }
+
+    GLenum OpenGLGeometryArena::getIndexType(IndexFormat format)
+    {
+        return format == IndexFormat::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
+    bool OpenGLGeometryArena::createInstanceBuffer()
+    {
+        // instance attribute source never changes, filled once
+        std::vector<GLuint> instance_indices(MAX_INSTANCES);
+        std::iota(instance_indices.begin(), instance_indices.end(), 0u);
+
+        glGenBuffers(1, &_instance_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, _instance_buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(sizeof(GLuint) * instance_indices.size()), instance_indices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Geometry arena instance buffer creation failed, OpenGL error : {}", check.error());
+            glDeleteBuffers(1, &_instance_buffer);
+            _instance_buffer = 0;
+            return false;
+        }
+        return true;
+    }
+
+    bool OpenGLGeometryArena::create(Pool & pool)
+    {
+        if(_instance_buffer == 0 && createInstanceBuffer() == false)return false;
+
+        glGenVertexArrays(1, &pool.VAO);
+
+        if(grow(pool.vertices, pool.VBO, getVertexFormatSize(pool.vertex_format), _INITIAL_VERTICES) == false ||
+            grow(pool.indices, pool.EBO, getIndexFormatSize(pool.index_format), _INITIAL_INDICES) == false)
+        {
+            destroy(pool);
+            return false;
+        }
+        // first buffers are not a reallocation
+        _reallocations.fetch_sub(2, std::memory_order_relaxed);
+
+        attachBuffers(pool);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Geometry arena creation failed, OpenGL error : {}", check.error());
+            destroy(pool);
+            return false;
+        }
+
+        spdlog::debug(std::format("[opengl] Geometry arena pool {} vertex bytes, {} index bytes, VAO {}, VBO {}, EBO {}",
+            getVertexFormatSize(pool.vertex_format), getIndexFormatSize(pool.index_format), pool.VAO, pool.VBO, pool.EBO));
+        return true;
+    }
+
+    void OpenGLGeometryArena::destroy(Pool & pool)
+    {
+        for(GLuint * buffer : {&pool.VBO, &pool.EBO})
+        {
+            if(*buffer != 0)glDeleteBuffers(1, buffer);
+            *buffer = 0;
+        }
+
+        if(pool.VAO != 0)
+        {
+            glDeleteVertexArrays(1, &pool.VAO);
+            pool.VAO = 0;
+        }
+
+        pool.vertices = FreeList{};
+        pool.indices = FreeList{};
+    }
+
+    bool OpenGLGeometryArena::grow(FreeList & list, GLuint & buffer, std::size_t element_size, std::size_t size)
+    {
+        const std::size_t new_capacity = std::max(list.capacity * 2, list.capacity + size);
+
+        GLuint new_buffer = 0;
+        glGenBuffers(1, &new_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, new_buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(new_capacity * element_size), nullptr, GL_STATIC_DRAW);
+
+        // copy target bindings are not vertex array state, draw bindings stay untouched
+        if(buffer != 0)
+        {
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)(list.capacity * element_size));
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        // old buffer and meshes in it stay valid when growth fails
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Geometry arena buffer growth failed, OpenGL error : {}", check.error());
+            glDeleteBuffers(1, &new_buffer);
+            return false;
+        }
+
+        spdlog::debug(std::format("[opengl] Geometry arena buffer {} grown from {} to {} elements", new_buffer, list.capacity, new_capacity));
+
+        if(buffer != 0)glDeleteBuffers(1, &buffer);
+        buffer = new_buffer;
+        list.grow(new_capacity);
+        _reallocations.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void OpenGLGeometryArena::attachBuffers(const Pool & pool)
+    {
+        glBindVertexArray(pool.VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, pool.VBO);
+        if(pool.vertex_format == VertexFormat::Compressed)
+        {
+            // converted to float by GPU, shaders declare the same vec3, vec3 and vec2 inputs as for float vertices
+            glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, sizeof(CompressedVertex), (void*)offsetof(CompressedVertex, position));
+            glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(CompressedVertex), (void*)offsetof(CompressedVertex, normal));
+            glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CompressedVertex), (void*)offsetof(CompressedVertex, uv));
+        }
+        else
+        {
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+        }
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+
+        // advances once per instance and starts at base instance of draw
+        glBindBuffer(GL_ARRAY_BUFFER, _instance_buffer);
+        glVertexAttribIPointer(INSTANCE_ATTRIBUTE, 1, GL_UNSIGNED_INT, sizeof(GLuint), nullptr);
+        glVertexAttribDivisor(INSTANCE_ATTRIBUTE, 1);
+        glEnableVertexAttribArray(INSTANCE_ATTRIBUTE);
+
+        // element buffer binding is vertex array state
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.EBO);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    std::optional<OpenGLGeometryArena::Range> OpenGLGeometryArena::allocate(const std::vector<Vertex> & vertices, const std::vector<unsigned int> & indices)
+    {
+        if(vertices.empty() || indices.empty())return std::nullopt;
+
+        // encoders are chosen per mesh, meshes too large or too far from origin for compact formats keep full precision
+        Pool * pool = &_pools[getPoolIndex(chooseVertexFormat(vertices), chooseIndexFormat(vertices.size()))];
+        for(Pool * candidate : {pool, &_pools[getPoolIndex(VertexFormat::Float, IndexFormat::UInt32)]})
+        {
+            pool = candidate;
+            if(pool->unsupported)continue;
+            if(pool->VAO != 0)break;
+            if(create(*pool))break;
+
+            spdlog::warn(std::format("[opengl] Geometry arena pool with {} byte vertices and {} byte indices is not supported",
+                getVertexFormatSize(pool->vertex_format), getIndexFormatSize(pool->index_format)));
+            pool->unsupported = true;
+        }
+        if(pool->unsupported || pool->VAO == 0)return std::nullopt;
+
+        const std::size_t vertex_size = getVertexFormatSize(pool->vertex_format);
+        const std::size_t index_size = getIndexFormatSize(pool->index_format);
+
+        std::optional<std::size_t> first_vertex = pool->vertices.allocate(vertices.size());
+        if(!first_vertex && grow(pool->vertices, pool->VBO, vertex_size, vertices.size()))
+        {
+            attachBuffers(*pool);
+            first_vertex = pool->vertices.allocate(vertices.size());
+        }
+        if(!first_vertex)return std::nullopt;
+
+        std::optional<std::size_t> first_index = pool->indices.allocate(indices.size());
+        if(!first_index && grow(pool->indices, pool->EBO, index_size, indices.size()))
+        {
+            attachBuffers(*pool);
+            first_index = pool->indices.allocate(indices.size());
+        }
+        if(!first_index)
+        {
+            pool->vertices.free(*first_vertex, vertices.size());
+            return std::nullopt;
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, pool->VBO);
+        if(pool->vertex_format == VertexFormat::Compressed)
+        {
+            const std::vector<CompressedVertex> compressed = compressVertices(vertices);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(*first_vertex * vertex_size), (GLsizeiptr)(compressed.size() * vertex_size), compressed.data());
+        }
+        else
+        {
+            glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(*first_vertex * vertex_size), (GLsizeiptr)(vertices.size() * vertex_size), vertices.data());
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, pool->EBO);
+        if(pool->index_format == IndexFormat::UInt16)
+        {
+            const std::vector<uint16_t> narrowed = narrowIndices(indices);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(*first_index * index_size), (GLsizeiptr)(narrowed.size() * index_size), narrowed.data());
+        }
+        else
+        {
+            glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(*first_index * index_size), (GLsizeiptr)(indices.size() * index_size), indices.data());
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Geometry arena upload failed, OpenGL error : {}", check.error());
+        }
+
+        const Range range{
+            .vertex_format = pool->vertex_format,
+            .index_format = pool->index_format,
+            .first_vertex = *first_vertex,
+            .vertex_count = vertices.size(),
+            .first_index = *first_index,
+            .index_count = indices.size()
+        };
+
+        std::size_t vertex_capacity = 0;
+        std::size_t index_capacity = 0;
+        for(const Pool & p : _pools)
+        {
+            vertex_capacity += p.vertices.capacity;
+            index_capacity += p.indices.capacity;
+        }
+        _vertex_capacity.store(vertex_capacity, std::memory_order_relaxed);
+        _index_capacity.store(index_capacity, std::memory_order_relaxed);
+        _used_vertices.fetch_add(range.vertex_count, std::memory_order_relaxed);
+        _used_indices.fetch_add(range.index_count, std::memory_order_relaxed);
+        _meshes.fetch_add(1, std::memory_order_relaxed);
+        if(range.vertex_format == VertexFormat::Compressed)_compressed_meshes.fetch_add(1, std::memory_order_relaxed);
+        if(range.index_format == IndexFormat::UInt16)_narrow_index_meshes.fetch_add(1, std::memory_order_relaxed);
+        _used_bytes.fetch_add(range.vertex_count * vertex_size + range.index_count * index_size, std::memory_order_relaxed);
+        _uncompressed_bytes.fetch_add(range.vertex_count * sizeof(Vertex) + range.index_count * sizeof(GLuint), std::memory_order_relaxed);
+
+        return range;
+    }
+
+    void OpenGLGeometryArena::free(const Range & range)
+    {
+        Pool & pool = _pools[getPoolIndex(range.vertex_format, range.index_format)];
+        if(pool.VAO == 0)return;
+
+        pool.vertices.free(range.first_vertex, range.vertex_count);
+        pool.indices.free(range.first_index, range.index_count);
+
+        _used_vertices.fetch_sub(range.vertex_count, std::memory_order_relaxed);
+        _used_indices.fetch_sub(range.index_count, std::memory_order_relaxed);
+        _meshes.fetch_sub(1, std::memory_order_relaxed);
+        if(range.vertex_format == VertexFormat::Compressed)_compressed_meshes.fetch_sub(1, std::memory_order_relaxed);
+        if(range.index_format == IndexFormat::UInt16)_narrow_index_meshes.fetch_sub(1, std::memory_order_relaxed);
+        _used_bytes.fetch_sub(range.vertex_count * getVertexFormatSize(range.vertex_format) +
+            range.index_count * getIndexFormatSize(range.index_format), std::memory_order_relaxed);
+        _uncompressed_bytes.fetch_sub(range.vertex_count * sizeof(Vertex) + range.index_count * sizeof(GLuint), std::memory_order_relaxed);
+    }
+
+    GLuint OpenGLGeometryArena::getVertexArray(VertexFormat vertex_format, IndexFormat index_format) const
+    {
+        return _pools[getPoolIndex(vertex_format, index_format)].VAO;
+    }
+
+    void OpenGLGeometryArena::release()
+    {
+        for(Pool & pool : _pools)
+        {
+            destroy(pool);
+        }
+
+        if(_instance_buffer != 0)glDeleteBuffers(1, &_instance_buffer);
+        _instance_buffer = 0;
+
+        _vertex_capacity.store(0, std::memory_order_relaxed);
+        _index_capacity.store(0, std::memory_order_relaxed);
+        _used_vertices.store(0, std::memory_order_relaxed);
+        _used_indices.store(0, std::memory_order_relaxed);
+        _meshes.store(0, std::memory_order_relaxed);
+        _compressed_meshes.store(0, std::memory_order_relaxed);
+        _narrow_index_meshes.store(0, std::memory_order_relaxed);
+        _used_bytes.store(0, std::memory_order_relaxed);
+        _uncompressed_bytes.store(0, std::memory_order_relaxed);
+    }
+
+    OpenGLGeometryArena::Stats OpenGLGeometryArena::getStats() const
+    {
+        return Stats{
+            .vertex_capacity = _vertex_capacity.load(std::memory_order_relaxed),
+            .used_vertices = _used_vertices.load(std::memory_order_relaxed),
+            .index_capacity = _index_capacity.load(std::memory_order_relaxed),
+            .used_indices = _used_indices.load(std::memory_order_relaxed),
+            .meshes = _meshes.load(std::memory_order_relaxed),
+            .compressed_meshes = _compressed_meshes.load(std::memory_order_relaxed),
+            .narrow_index_meshes = _narrow_index_meshes.load(std::memory_order_relaxed),
+            .used_bytes = _used_bytes.load(std::memory_order_relaxed),
+            .uncompressed_bytes = _uncompressed_bytes.load(std::memory_order_relaxed),
+            .reallocations = _reallocations.load(std::memory_order_relaxed)
+        };
+    }
+}
@@ -1,5 +1,7 @@
 #include "opengl_shader.hpp"
 
+#include <array>
+
 namespace velora::opengl
 {
     OpenGLShader::Stage::Stage(GLuint linked_shader_ID, GLenum stage_type, std::vector<std::string> code)
@@ -170,7 +172,9 @@ namespace velora::opengl
     OpenGLShader::OpenGLShader(OpenGLShader && other)
     :   _shader_program_ID{std::move(other._shader_program_ID)},
         _vertex_stage{std::move(other._vertex_stage)},
-        _fragment_stage{std::move(other._fragment_stage)}
+        _fragment_stage{std::move(other._fragment_stage)},
+        _uniforms{std::move(other._uniforms)},
+        _attributes{std::move(other._attributes)}
     {
         other._shader_program_ID = 0;
     }
@@ -179,12 +183,11 @@ namespace velora::opengl
     {
         if(_shader_program_ID == 0)return;
 
-        disable();
-
         // clearing stages data
         if(_vertex_stage.has_value())_vertex_stage.reset();
         if(_fragment_stage.has_value())_fragment_stage.reset();
 
+        // program still in use is deleted once it is not current anymore, renderer invalidates state cache on erase
         glDeleteProgram(_shader_program_ID);
         spdlog::info(std::format("OpenGL shader[{}] destroyed", _shader_program_ID));
 
@@ -214,39 +217,6 @@ namespace velora::opengl
         return _shader_program_ID;
     }
 
-    bool OpenGLShader::enable()
-    {
-        // already binded
-        GLint currently_used_shader = 0;
-        glGetIntegerv(GL_CURRENT_PROGRAM, &currently_used_shader);
-        if(currently_used_shader == (GLint)_shader_program_ID){
-            return true;
-        }
-        
-        glUseProgram(_shader_program_ID);
-
-        glGetIntegerv(GL_CURRENT_PROGRAM, &currently_used_shader);
-        if(currently_used_shader != (GLint)_shader_program_ID){
-            spdlog::error(std::format("Cannot bind OpenGL shader[{}], currently binded {}", _shader_program_ID, currently_used_shader));
-            return false;
-        }
-        return true;
-    }
-
-    bool OpenGLShader::disable()
-    {
-        // only unbind if this is currently used
-        GLint currently_used_shader = 0;
-        glGetIntegerv(GL_CURRENT_PROGRAM, &currently_used_shader);
-        if(currently_used_shader != (GLint)_shader_program_ID)
-        {
-            spdlog::debug(std::format("OpenGL shader[{}] is not currently used by opengl rendering state", _shader_program_ID));
-            return false;
-        }
-        glUseProgram(0);
-        return true;
-    }
-
     bool OpenGLShader::linkProgram()
     {
         GLint result = GL_FALSE;
@@ -342,170 +312,141 @@ namespace velora::opengl
             );
             GLint location = glGetUniformLocation(_shader_program_ID, var.name);
 
-            _uniforms[var.name] = std::make_pair(std::move(location), std::move(var));
+            // arrays are reported as name[0], set by uniform of plain name
+            std::string_view name(var.name, var.length);
+            if(name.ends_with("[0]"))name.remove_suffix(3);
+
+            const ShaderUniform uniform(name);
+            if(uniform.ID() >= _uniforms.size())_uniforms.resize(uniform.ID() + 1);
+            _uniforms[uniform.ID()] = UniformSlot{.location = location, .size = var.size, .type = var.type};
 
             spdlog::debug("Uniform [{}]: name={}, type=0x{:X}, size={}", i, var.name, var.type, var.size);
         }
     }
 
-    void OpenGLShader::setUniform(const std::string & name, bool value)
+    const OpenGLShader::UniformSlot * OpenGLShader::findUniform(ShaderUniform uniform) const
     {
-        if(_uniforms.contains(name) == false)
+        if(uniform.ID() >= _uniforms.size() || _uniforms[uniform.ID()].location == -1)
         {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
+            spdlog::error("Uniform {} not found in shader program {}", uniform.getName(), _shader_program_ID);
+            return nullptr;
         }
-        glUniform1i(_uniforms.at(name).first, value);
+        return &_uniforms[uniform.ID()];
     }
 
-    void OpenGLShader::setUniform(const std::string & name, int value)
+    void OpenGLShader::setUniform(ShaderUniform uniform, bool value)
     {
-        if(_uniforms.contains(name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
-        glUniform1i(_uniforms.at(name).first, value);
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
+        glUniform1i(slot->location, value);
     }
 
-    void OpenGLShader::setUniform(const std::string & name, float value)
+    void OpenGLShader::setUniform(ShaderUniform uniform, int value)
     {
-        if(_uniforms.contains(name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
-        glUniform1f(_uniforms.at(name).first, value);
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
+        glUniform1i(slot->location, value);
     }
 
-    void OpenGLShader::setUniform(const std::string & name, const glm::vec2 & value)
+    void OpenGLShader::setUniform(ShaderUniform uniform, float value)
     {
-        if(_uniforms.contains(name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
-        glUniform2fv(_uniforms.at(name).first, 1, glm::value_ptr(value));
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
+        glUniform1f(slot->location, value);
     }
 
-    void OpenGLShader::setUniform(const std::string & name, const glm::vec3 & value)
+    void OpenGLShader::setUniform(ShaderUniform uniform, const glm::vec2 & value)
     {
-        if(_uniforms.contains(name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
-        glUniform3fv(_uniforms.at(name).first, 1, glm::value_ptr(value));
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
+        glUniform2fv(slot->location, 1, glm::value_ptr(value));
     }
 
-    void OpenGLShader::setUniform(const std::string & name, const glm::vec4 & value)
+    void OpenGLShader::setUniform(ShaderUniform uniform, const glm::vec3 & value)
     {
-        if(_uniforms.contains(name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
-        glUniform4fv(_uniforms.at(name).first, 1, glm::value_ptr(value));
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
+        glUniform3fv(slot->location, 1, glm::value_ptr(value));
     }
 
-    void OpenGLShader::setUniform(const std::string & name, const glm::mat2 & value)
+    void OpenGLShader::setUniform(ShaderUniform uniform, const glm::vec4 & value)
     {
-        if(_uniforms.contains(name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
-        glUniformMatrix2fv(_uniforms.at(name).first, 1, GL_FALSE, glm::value_ptr(value));
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
+        glUniform4fv(slot->location, 1, glm::value_ptr(value));
+    }
+
+    void OpenGLShader::setUniform(ShaderUniform uniform, const glm::mat2 & value)
+    {
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
+        glUniformMatrix2fv(slot->location, 1, GL_FALSE, glm::value_ptr(value));
     }
         
-    void OpenGLShader::setUniform(const std::string & name, const glm::mat3 & value)
+    void OpenGLShader::setUniform(ShaderUniform uniform, const glm::mat3 & value)
     {
-        if(_uniforms.contains(name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
-        glUniformMatrix3fv(_uniforms.at(name).first, 1, GL_FALSE, glm::value_ptr(value));
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
+        glUniformMatrix3fv(slot->location, 1, GL_FALSE, glm::value_ptr(value));
     }
 
-    void OpenGLShader::setUniform(const std::string & name, const glm::mat4 & value)
+    void OpenGLShader::setUniform(ShaderUniform uniform, const glm::mat4 & value)
     {
-        if(_uniforms.contains(name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
-        glUniformMatrix4fv(_uniforms.at(name).first, 1, GL_FALSE, glm::value_ptr(value));
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
+        glUniformMatrix4fv(slot->location, 1, GL_FALSE, glm::value_ptr(value));
     }
 
-    void OpenGLShader::setUniform(const std::string & name, const std::vector<glm::mat4> & values)
+    void OpenGLShader::setUniform(ShaderUniform uniform, std::span<const glm::mat4> values)
     {
-        const std::string array_name = name + "[0]";
-        if(_uniforms.contains(array_name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
+        if(values.empty())return;
+
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
 
-        const auto & glsl_var = _uniforms.at(array_name).second;
-        if(values.size() >= glsl_var.size)
+        if(values.size() > (std::size_t)slot->size)
         {
-            spdlog::error("Uniform {} size {} is greater than the shader uniform array size {}", name, values.size(), glsl_var.size);
+            spdlog::error("Uniform {} size {} is greater than the shader uniform array size {}", uniform.getName(), values.size(), slot->size);
             return;
         }
 
-        glUniformMatrix4fv(_uniforms.at(array_name).first, values.size(), GL_FALSE, glm::value_ptr(values[0]));
+        glUniformMatrix4fv(slot->location, (GLsizei)values.size(), GL_FALSE, glm::value_ptr(values[0]));
     }
 
-    void OpenGLShader::setUniform(const std::string & name, unsigned int unit, const ITexture & value)
+    void OpenGLShader::setUniform(ShaderUniform uniform, unsigned int unit, const ITexture & value)
     {
-        if(_uniforms.contains(name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
 
         glActiveTexture(GL_TEXTURE0 + unit);
 
         value.enable();
 
-        glUniform1i(_uniforms.at(name).first, unit);
+        glUniform1i(slot->location, unit);
     }
 
-    void OpenGLShader::setUniform(const std::string & name, unsigned int unit, const std::vector<ITexture*> & values)
+    void OpenGLShader::setUniform(ShaderUniform uniform, unsigned int unit, std::span<ITexture * const> values)
     {
-        const std::string array_name = name + "[0]";
+        if(values.empty())return;
 
-        if(_uniforms.contains(array_name) == false)
-        {
-            spdlog::error("Uniform {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
+        const UniformSlot * slot = findUniform(uniform);
+        if(slot == nullptr)return;
 
-        const auto & glsl_var = _uniforms.at(array_name).second;
-        if(values.size() >= glsl_var.size)
+        if(values.size() > (std::size_t)slot->size || values.size() > _MAX_TEXTURE_ARRAY_SIZE)
         {
-            spdlog::error("Uniform {} size {} is greater than the shader uniform array size {}", name, values.size(), glsl_var.size);
+            spdlog::error("Uniform {} size {} is greater than the shader uniform array size {}", uniform.getName(), values.size(), slot->size);
             return;
         }
 
-        std::vector<int> texture_units(values.size());
+        std::array<GLint, _MAX_TEXTURE_ARRAY_SIZE> texture_units;
         for (unsigned int i = 0; i < values.size(); ++i)
         {
             texture_units[i] = unit + i;
-            glActiveTexture(GL_TEXTURE0 + texture_units.at(i));
-            values.at(i)->enable();
+            glActiveTexture(GL_TEXTURE0 + texture_units[i]);
+            values[i]->enable();
         }
 
-        GLint base_location = glGetUniformLocation(_shader_program_ID, name.c_str());
-        if (base_location == -1) {
-            spdlog::error("Uniform base {} not found in shader program {}", name, _shader_program_ID);
-            return;
-        }
-
-        glUniform1iv(base_location, static_cast<GLsizei>(values.size()), texture_units.data());
+        glUniform1iv(slot->location, static_cast<GLsizei>(values.size()), texture_units.data());
     }
 
 }
-
-
@@ -5,7 +5,8 @@ namespace velora::opengl
     OpenGLShaderStorageBuffer::OpenGLShaderStorageBuffer(unsigned int binding_point, std::size_t size, const void * data)
     :   _size(std::move(size)),
         _data(std::move(data)),
-        _SSBO(0)
+        _SSBO(0),
+        _binding_point(binding_point)
     {
         if(generateBuffer() == false) 
         { 
@@ -13,12 +14,10 @@ namespace velora::opengl
             return;
         }
 
-        enable();
+        // binds buffer to its indexed and generic binding point, renderer invalidates state cache after construction
         setGPUAttributes(binding_point);
         copyDataToGPU();
 
-        disable();
-
         const auto check = checkOpenGLState();
         if(!check)
         {
@@ -28,6 +27,7 @@ namespace velora::opengl
     
     OpenGLShaderStorageBuffer::OpenGLShaderStorageBuffer(OpenGLShaderStorageBuffer && other)
     :   _SSBO(other._SSBO),
+        _binding_point(other._binding_point),
         _size(std::move(other._size)),
         _data(std::move(other._data))
     {
@@ -40,7 +40,6 @@ namespace velora::opengl
     {
         if(good() == false)return;
 
-        disable();
         removeBuffer();
 
         spdlog::info("OpenGL shader storage buffer destroyed");
@@ -56,6 +55,11 @@ namespace velora::opengl
         return _SSBO != 0;
     }
 
+    unsigned int OpenGLShaderStorageBuffer::getBindingPoint() const
+    {
+        return _binding_point;
+    }
+
     void OpenGLShaderStorageBuffer::update(std::size_t size, const void * data)
     {
         _size = (GLsizeiptr)size;
@@ -96,54 +100,6 @@ namespace velora::opengl
         return good();
     }
 
-    void OpenGLShaderStorageBuffer::disable() const
-    {
-        if(_SSBO == 0)return;
-
-        GLint currently_bound_SSBO = 0;
-        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_BINDING, &currently_bound_SSBO);
-        
-        if(currently_bound_SSBO != (GLint)_SSBO)
-        {
-            spdlog::warn("Disable OpenGL shader storage buffer which is not currently bound");
-            return;
-        }
-        
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-    }
-
-    bool OpenGLShaderStorageBuffer::enable() const
-    {
-        if(_SSBO == 0)
-        {
-            spdlog::error("Use of uninitialized OpenGL shader storage buffer");
-            return false;
-        }
-
-        // check if need of bind SSBO
-        GLint currently_bound_SSBO = 0;
-        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_BINDING, &currently_bound_SSBO);
-
-        // already binded
-        if(currently_bound_SSBO == (GLint)_SSBO) return true;
-        
-        // try to bind
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, _SSBO);
-
-        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_BINDING, &currently_bound_SSBO);
-
-        if(currently_bound_SSBO != (GLint)_SSBO)
-        { 
-            spdlog::error(std::format("SSBO binding failed, currently bound: {}, should be {} ", 
-                    currently_bound_SSBO, _SSBO));
-                
-            disable();
-            return false;
-        }
-        
-        return true;
-    }
-
     bool OpenGLShaderStorageBuffer::setGPUAttributes(GLuint binding_point)
     {
         spdlog::debug(std::format("Setting shader storage buffer {} to be bound at {} binding point", _SSBO, binding_point));
@@ -154,12 +110,15 @@ namespace velora::opengl
 
     bool OpenGLShaderStorageBuffer::copyDataToGPU() const
     {
-        if(enable() == false)
+        if(_SSBO == 0)
         {
-            spdlog::error("Cannot enable OpenGL shader storage buffer");
+            spdlog::error("Use of uninitialized OpenGL shader storage buffer");
             return false;
         }
 
+        // updated every frame, generic binding point is set without querying it first
+        // indexed binding used by shaders is not touched
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, _SSBO);
         glBufferData(GL_SHADER_STORAGE_BUFFER, _size, _data, GL_DYNAMIC_DRAW);
         
         return true;
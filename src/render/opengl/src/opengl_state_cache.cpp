@@ -0,0 +1,232 @@
+#include "opengl_state_cache.hpp"
+
+namespace velora::opengl
+{
+    namespace
+    {
+        #ifdef NDEBUG
+        constexpr bool VALIDATION_DEFAULT = false;
+        #else
+        constexpr bool VALIDATION_DEFAULT = true;
+        #endif
+
+        GLuint queryBinding(GLenum pname)
+        {
+            GLint value = 0;
+            glGetIntegerv(pname, &value);
+            return (GLuint)value;
+        }
+
+        GLuint queryIndexedBinding(GLenum pname, GLuint index)
+        {
+            GLint value = 0;
+            glGetIntegeri_v(pname, index, &value);
+            return (GLuint)value;
+        }
+
+        GLint64 queryIndexedBinding64(GLenum pname, GLuint index)
+        {
+            GLint64 value = 0;
+            glGetInteger64i_v(pname, index, &value);
+            return value;
+        }
+    }
+
+    OpenGLStateCache::OpenGLStateCache()
+    :   _validation(VALIDATION_DEFAULT)
+    {}
+
+    void OpenGLStateCache::invalidate()
+    {
+        _program = std::nullopt;
+        _vertex_array = std::nullopt;
+        _frame_buffer = std::nullopt;
+        _shader_storage_buffers.fill(std::nullopt);
+        _uniform_buffers.fill(std::nullopt);
+        _viewport = std::nullopt;
+        _polygon_mode = std::nullopt;
+        _polygon_offset = std::nullopt;
+    }
+
+    void OpenGLStateCache::useProgram(GLuint program)
+    {
+        if(skip(_program, program, "program", [](){ return queryBinding(GL_CURRENT_PROGRAM); }))return;
+
+        glUseProgram(program);
+        _program = program;
+    }
+
+    void OpenGLStateCache::bindVertexArray(GLuint vertex_array)
+    {
+        if(skip(_vertex_array, vertex_array, "vertex array", [](){ return queryBinding(GL_VERTEX_ARRAY_BINDING); }))return;
+
+        glBindVertexArray(vertex_array);
+        _vertex_array = vertex_array;
+    }
+
+    void OpenGLStateCache::bindFramebuffer(GLuint frame_buffer)
+    {
+        if(skip(_frame_buffer, frame_buffer, "frame buffer", [](){ return queryBinding(GL_DRAW_FRAMEBUFFER_BINDING); }))return;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+        _frame_buffer = frame_buffer;
+    }
+
+    void OpenGLStateCache::bindBlitFramebuffers(GLuint read_frame_buffer, GLuint draw_frame_buffer)
+    {
+        _issued_calls.fetch_add(2, std::memory_order_relaxed);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, read_frame_buffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_frame_buffer);
+
+        // cached binding means both read and draw frame buffer
+        _frame_buffer = std::nullopt;
+    }
+
+    std::optional<OpenGLStateCache::IndexedBinding> * OpenGLStateCache::findIndexedBinding(GLenum target, GLuint index)
+    {
+        if(index >= MAX_INDEXED_BUFFER_BINDINGS)return nullptr;
+
+        switch(target)
+        {
+            case GL_SHADER_STORAGE_BUFFER: return &_shader_storage_buffers[index];
+            case GL_UNIFORM_BUFFER: return &_uniform_buffers[index];
+            default: return nullptr;
+        }
+    }
+
+    void OpenGLStateCache::setIndexedBinding(GLenum target, GLuint index, IndexedBinding binding)
+    {
+        const auto bind = [&]()
+        {
+            if(binding.size == 0)glBindBufferBase(target, index, binding.buffer);
+            else glBindBufferRange(target, index, binding.buffer, binding.offset, binding.size);
+        };
+
+        std::optional<IndexedBinding> * cached = findIndexedBinding(target, index);
+        if(cached == nullptr)
+        {
+            _issued_calls.fetch_add(1, std::memory_order_relaxed);
+            bind();
+            return;
+        }
+
+        const bool storage = target == GL_SHADER_STORAGE_BUFFER;
+        const auto query = [storage, index]()
+        {
+            return IndexedBinding{
+                .buffer = queryIndexedBinding(storage ? GL_SHADER_STORAGE_BUFFER_BINDING : GL_UNIFORM_BUFFER_BINDING, index),
+                .offset = (GLintptr)queryIndexedBinding64(storage ? GL_SHADER_STORAGE_BUFFER_START : GL_UNIFORM_BUFFER_START, index),
+                .size = (GLsizeiptr)queryIndexedBinding64(storage ? GL_SHADER_STORAGE_BUFFER_SIZE : GL_UNIFORM_BUFFER_SIZE, index)
+            };
+        };
+        if(skip(*cached, binding, "indexed buffer binding", query))return;
+
+        bind();
+        *cached = binding;
+    }
+
+    void OpenGLStateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        setIndexedBinding(target, index, IndexedBinding{.buffer = buffer});
+    }
+
+    void OpenGLStateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+    {
+        setIndexedBinding(target, index, IndexedBinding{.buffer = buffer, .offset = offset, .size = size});
+    }
+
+    void OpenGLStateCache::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        const std::array<GLint, 4> value{x, y, (GLint)width, (GLint)height};
+        if(skip(_viewport, value, "viewport", []()
+            {
+                std::array<GLint, 4> real{};
+                glGetIntegerv(GL_VIEWPORT, real.data());
+                return real;
+            }))return;
+
+        glViewport(x, y, width, height);
+        _viewport = value;
+    }
+
+    void OpenGLStateCache::polygonMode(GLenum mode)
+    {
+        if(skip(_polygon_mode, mode, "polygon mode", []()
+            {
+                // front and back mode on compatibility profiles, single value on core
+                std::array<GLint, 2> real{};
+                glGetIntegerv(GL_POLYGON_MODE, real.data());
+                return (GLenum)real[0];
+            }))return;
+
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+        _polygon_mode = mode;
+    }
+
+    void OpenGLStateCache::polygonOffset(GLfloat factor, GLfloat units)
+    {
+        setPolygonOffset(PolygonOffsetState{.enabled = true, .factor = factor, .units = units});
+    }
+
+    void OpenGLStateCache::disablePolygonOffset()
+    {
+        // factor and units are left as they are, only enable flag is compared when disabled
+        const PolygonOffsetState disabled{
+            .enabled = false,
+            .factor = _polygon_offset ? _polygon_offset->factor : 0.0f,
+            .units = _polygon_offset ? _polygon_offset->units : 0.0f};
+        setPolygonOffset(disabled);
+    }
+
+    void OpenGLStateCache::setPolygonOffset(PolygonOffsetState offset)
+    {
+        if(skip(_polygon_offset, offset, "polygon offset", [&offset]()
+            {
+                PolygonOffsetState real{.enabled = glIsEnabled(GL_POLYGON_OFFSET_FILL) == GL_TRUE};
+                if(offset.enabled == false)
+                {
+                    // values of disabled offset do not matter
+                    real.factor = offset.factor;
+                    real.units = offset.units;
+                    return real;
+                }
+                glGetFloatv(GL_POLYGON_OFFSET_FACTOR, &real.factor);
+                glGetFloatv(GL_POLYGON_OFFSET_UNITS, &real.units);
+                return real;
+            }))return;
+
+        const bool was_enabled = _polygon_offset && _polygon_offset->enabled;
+        const bool values_known = _polygon_offset && _polygon_offset->factor == offset.factor && _polygon_offset->units == offset.units;
+
+        if(offset.enabled)
+        {
+            if(was_enabled == false)glEnable(GL_POLYGON_OFFSET_FILL);
+            if(values_known == false)glPolygonOffset(offset.factor, offset.units);
+        }
+        else
+        {
+            glDisable(GL_POLYGON_OFFSET_FILL);
+        }
+
+        _polygon_offset = offset;
+    }
+
+    OpenGLStateCache::Stats OpenGLStateCache::getStats() const
+    {
+        return Stats{
+            .issued_calls = _issued_calls.load(std::memory_order_relaxed),
+            .avoided_calls = _avoided_calls.load(std::memory_order_relaxed),
+            .validation_mismatches = _validation_mismatches.load(std::memory_order_relaxed)
+        };
+    }
+
+    void OpenGLStateCache::setValidation(bool enabled)
+    {
+        _validation.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool OpenGLStateCache::getValidation() const
+    {
+        return _validation.load(std::memory_order_relaxed);
+    }
+}
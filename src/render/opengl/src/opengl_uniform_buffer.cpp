@@ -0,0 +1,123 @@
+#include "opengl_uniform_buffer.hpp"
+
+namespace velora::opengl
+{
+    OpenGLUniformBuffer::OpenGLUniformBuffer(unsigned int binding_point, std::size_t size, const void * data)
+    :   _UBO(0),
+        _binding_point(binding_point),
+        _size(0)
+    {
+        if(generateBuffer() == false) 
+        { 
+            spdlog::error("OpenGL uniform buffer creation failed");
+            return;
+        }
+
+        copyDataToGPU(size, data);
+
+        spdlog::debug(std::format("Setting uniform buffer {} to be bound at {} binding point", _UBO, _binding_point));
+        glBindBufferBase(GL_UNIFORM_BUFFER, _binding_point, _UBO);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] UBO validation buffer failed, OpenGL error : {}", check.error());
+        }
+    }
+    
+    OpenGLUniformBuffer::OpenGLUniformBuffer(OpenGLUniformBuffer && other)
+    :   _UBO(other._UBO),
+        _binding_point(other._binding_point),
+        _size(other._size)
+    {
+        other._UBO = 0;
+        other._size = 0;
+    }
+
+    OpenGLUniformBuffer::~OpenGLUniformBuffer()
+    {
+        if(good() == false)return;
+
+        removeBuffer();
+
+        spdlog::info("OpenGL uniform buffer destroyed");
+    }
+
+    std::size_t OpenGLUniformBuffer::ID() const
+    {
+        return _UBO;
+    }
+
+    bool OpenGLUniformBuffer::good() const 
+    {
+        return _UBO != 0;
+    }
+
+    unsigned int OpenGLUniformBuffer::getBindingPoint() const
+    {
+        return _binding_point;
+    }
+
+    void OpenGLUniformBuffer::update(std::size_t size, const void * data)
+    {
+        copyDataToGPU(size, data);
+    }
+
+    bool OpenGLUniformBuffer::removeBuffer()
+    {
+        if(_UBO != 0)
+        {
+            spdlog::debug(std::format("OpenGL uniform buffer destroy UBO {}" , _UBO));
+            glDeleteBuffers(1, &_UBO);
+            _UBO = 0;
+            return true;
+        }
+        else 
+        {
+            spdlog::error(std::format("OpenGL uniform buffer destroy UBO {} failed", _UBO) );
+            return false;
+        }
+    }
+
+    bool OpenGLUniformBuffer::generateBuffer()
+    {        
+        spdlog::debug("Generating new OpenGL uniform buffer ... ");
+
+        glGenBuffers(1, &_UBO);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] UBO generate buffer failed, OpenGL error : {}", check.error());
+        }
+
+        spdlog::debug(std::format("OpenGL uniform buffer UBO {}", _UBO));
+        
+        return good();
+    }
+
+    bool OpenGLUniformBuffer::copyDataToGPU(std::size_t size, const void * data)
+    {
+        if(_UBO == 0)
+        {
+            spdlog::error("Use of uninitialized OpenGL uniform buffer");
+            return false;
+        }
+
+        // generic binding point only, indexed binding of buffer is not touched
+        glBindBuffer(GL_UNIFORM_BUFFER, _UBO);
+
+        if((GLsizeiptr)size != _size)
+        {
+            _size = (GLsizeiptr)size;
+            glBufferData(GL_UNIFORM_BUFFER, _size, data, GL_DYNAMIC_DRAW);
+        }
+        else if(data != nullptr && _size > 0)
+        {
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, _size, data);
+        }
+
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        return true;
+    }
+}
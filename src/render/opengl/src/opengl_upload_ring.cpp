@@ -0,0 +1,164 @@
+#include "opengl_upload_ring.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace velora::opengl
+{
+    OpenGLUploadRing::~OpenGLUploadRing()
+    {
+        assert(_buffer == 0 && "Upload ring should be released on render thread before destruction");
+    }
+
+    bool OpenGLUploadRing::create()
+    {
+        if(!GLEW_VERSION_4_4 && !GLEW_ARB_buffer_storage)
+        {
+            spdlog::warn("[opengl] Persistent buffer mapping is not supported, dynamic buffers are reallocated on every update");
+            return false;
+        }
+
+        GLint uniform_alignment = 0;
+        GLint storage_alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_alignment);
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storage_alignment);
+        _alignment = std::max<GLintptr>({(GLintptr)uniform_alignment, (GLintptr)storage_alignment, 16});
+
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        // copy write target is not used by renderer, buffer bindings of draws stay untouched
+        glGenBuffers(1, &_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, _buffer);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(REGION_SIZE * FRAMES), nullptr, flags);
+        _mapped = static_cast<std::byte *>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)(REGION_SIZE * FRAMES), flags));
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Upload ring creation failed, OpenGL error : {}", check.error());
+        }
+        if(!check || _mapped == nullptr)
+        {
+            release();
+            return false;
+        }
+
+        spdlog::debug(std::format("[opengl] Upload ring buffer {} with {} regions of {} bytes", _buffer, FRAMES, REGION_SIZE));
+        return true;
+    }
+
+    void OpenGLUploadRing::waitForRegion(std::size_t region)
+    {
+        GLsync & fence = _fences[region];
+        if(fence == nullptr)return;
+
+        const auto start = std::chrono::steady_clock::now();
+        for(;;)
+        {
+            const GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, _FENCE_WAIT_TIMEOUT_NS);
+            if(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)break;
+            if(result == GL_WAIT_FAILED)
+            {
+                spdlog::error("[opengl] Upload ring fence wait failed");
+                break;
+            }
+        }
+        _frame_fence_wait_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    std::optional<OpenGLUploadRing::Allocation> OpenGLUploadRing::allocate(std::size_t size)
+    {
+        if(_unsupported || size == 0)return std::nullopt;
+
+        if(_buffer == 0 && create() == false)
+        {
+            _unsupported = true;
+            return std::nullopt;
+        }
+
+        if(_region_ready == false)
+        {
+            waitForRegion(_region);
+            _region_ready = true;
+        }
+
+        const std::size_t offset = (_cursor + (std::size_t)_alignment - 1) / (std::size_t)_alignment * (std::size_t)_alignment;
+        if(offset + size > REGION_SIZE)
+        {
+            _overflows.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        _cursor = offset + size;
+        _frame_uploaded_bytes += size;
+
+        const std::size_t ring_offset = _region * REGION_SIZE + offset;
+        return Allocation{
+            .buffer = _buffer,
+            .offset = (GLintptr)ring_offset,
+            .data = _mapped + ring_offset
+        };
+    }
+
+    void OpenGLUploadRing::endFrame()
+    {
+        // region untouched this frame keeps fence of its last use
+        if(_buffer != 0 && _region_ready)
+        {
+            _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        _region = (_region + 1) % FRAMES;
+        _cursor = 0;
+        _region_ready = false;
+        _frame++;
+
+        _last_frame_uploaded_bytes.store(_frame_uploaded_bytes, std::memory_order_relaxed);
+        _last_frame_fence_wait_us.store(_frame_fence_wait_time.count(), std::memory_order_relaxed);
+        _total_uploaded_bytes.fetch_add(_frame_uploaded_bytes, std::memory_order_relaxed);
+        _total_fence_wait_us.fetch_add(_frame_fence_wait_time.count(), std::memory_order_relaxed);
+        _frames.fetch_add(1, std::memory_order_relaxed);
+
+        _frame_uploaded_bytes = 0;
+        _frame_fence_wait_time = std::chrono::microseconds{0};
+    }
+
+    uint64_t OpenGLUploadRing::getFrame() const
+    {
+        return _frame;
+    }
+
+    void OpenGLUploadRing::release()
+    {
+        for(GLsync & fence : _fences)
+        {
+            if(fence != nullptr)glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        if(_buffer != 0)
+        {
+            // persistent mapping is released together with buffer
+            glDeleteBuffers(1, &_buffer);
+            _buffer = 0;
+        }
+        _mapped = nullptr;
+        _region_ready = false;
+        _cursor = 0;
+    }
+
+    OpenGLUploadRing::Stats OpenGLUploadRing::getStats() const
+    {
+        return Stats{
+            .frame_uploaded_bytes = _last_frame_uploaded_bytes.load(std::memory_order_relaxed),
+            .frame_fence_wait_time = std::chrono::microseconds{_last_frame_fence_wait_us.load(std::memory_order_relaxed)},
+            .total_uploaded_bytes = _total_uploaded_bytes.load(std::memory_order_relaxed),
+            .total_fence_wait_time = std::chrono::microseconds{_total_fence_wait_us.load(std::memory_order_relaxed)},
+            .overflows = _overflows.load(std::memory_order_relaxed),
+            .frames = _frames.load(std::memory_order_relaxed)
+        };
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "native.hpp"
+#include <asio.hpp>
+
+#include <glm/glm.hpp>
+
+#include "render_options.hpp"
+#include "vertex.hpp"
+
+#include "software_shader.hpp"
+#include "software_texture.hpp"
+
+namespace velora::software
+{
+    /**
+     * @brief Attachments rasterizer writes into, all must have the same resolution
+     */
+    struct SoftwareRenderTarget
+    {
+        std::size_t width = 0;
+        std::size_t height = 0;
+
+        std::array<SoftwareTexture *, MAX_SOFTWARE_COLOR_OUTPUTS> colors = {};
+        std::size_t colors_count = 0;
+
+        // depth test and write are skipped without depth attachment
+        SoftwareTexture * depth = nullptr;
+    };
+
+    struct SoftwareRasterStats
+    {
+        uint64_t triangles_submitted = 0;
+        uint64_t triangles_rasterized = 0;
+        uint64_t fragments_shaded = 0;
+    };
+
+    /**
+     * @brief Tiled multithreaded triangle rasterizer.
+     *
+     * Draw runs vertex stage in parallel chunks, clips triangles against near plane, culls back faces,
+     * bins triangles into screen tiles and then shades tiles in parallel.
+     * Each tile is owned by exactly one thread and keeps submission order of triangles,
+     * so no synchronization is needed on attachments and results are deterministic.
+     * Coverage is evaluated with edge functions four pixels at once.
+     */
+    class SoftwareRasterizer
+    {
+        public:
+            constexpr static const std::size_t TILE_SIZE = 64;
+
+            /**
+             * @param threads number of threads rasterizing tiles, caller thread included
+             */
+            SoftwareRasterizer(unsigned int threads);
+            SoftwareRasterizer(const SoftwareRasterizer &) = delete;
+            SoftwareRasterizer(SoftwareRasterizer &&) = delete;
+            SoftwareRasterizer & operator=(const SoftwareRasterizer &) = delete;
+            SoftwareRasterizer & operator=(SoftwareRasterizer &&) = delete;
+            ~SoftwareRasterizer();
+
+            SoftwareRasterStats draw(const SoftwareRenderTarget & target, const Mesh & mesh, const SoftwareProgram & program, const RenderOptions & options);
+
+            unsigned int getThreadsCount() const;
+
+        private:
+            struct ClipVertex
+            {
+                glm::vec4 position;
+                SoftwareVaryings varyings;
+            };
+
+            struct ScreenTriangle
+            {
+                // edge functions w_i(x, y) = a_i * x + b_i * y + c_i, already divided by area
+                glm::vec3 a;
+                glm::vec3 b;
+                glm::vec3 c;
+                // top left fill rule, edge is inclusive when true
+                std::array<bool, 3> inclusive;
+
+                // inverse length of edges in pixels scaled by area, used by wireframe
+                glm::vec3 edge_scale;
+
+                glm::vec3 depth;
+                glm::vec3 inv_w;
+                std::array<SoftwareVaryings, 3> varyings;
+
+                float depth_offset;
+
+                int min_x, min_y, max_x, max_y;
+            };
+
+            void runParallel(std::size_t count, const std::function<void(std::size_t)> & job);
+
+            void setupTriangle(const ClipVertex & v0, const ClipVertex & v1, const ClipVertex & v2,
+                const SoftwareRenderTarget & target, const RenderOptions & options);
+
+            uint64_t rasterizeTile(std::size_t tile, const SoftwareRenderTarget & target, const SoftwareProgram & program, const RenderOptions & options) const;
+
+            const unsigned int _threads;
+            asio::thread_pool _pool;
+
+            // scratch buffers reused between draw calls
+            std::vector<ClipVertex> _vertices;
+            std::vector<ScreenTriangle> _triangles;
+            std::vector<std::vector<uint32_t>> _bins;
+            std::vector<std::size_t> _active_tiles;
+
+            std::size_t _tiles_x = 0;
+            std::size_t _tiles_y = 0;
+    };
+}
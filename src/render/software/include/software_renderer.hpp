@@ -0,0 +1,282 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "native.hpp"
+#include <asio.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <glm/glm.hpp>
+
+#include "render.hpp"
+#include "render_command_ring.hpp"
+
+#include "software_texture.hpp"
+#include "software_shader.hpp"
+#include "software_rasterizer.hpp"
+
+namespace velora::software
+{
+    /**
+     * @brief Counters and CPU cost of one frame, frame ends with present
+     */
+    struct SoftwareFrameStats
+    {
+        uint64_t frame = 0;
+
+        uint32_t clears = 0;
+        uint32_t depth_copies = 0;
+        uint32_t draw_calls = 0;
+        uint64_t triangles_submitted = 0;
+        uint64_t triangles_rasterized = 0;
+        uint64_t fragments_shaded = 0;
+
+        // time spent executing commands on render thread
+        std::chrono::duration<double> render_time = std::chrono::duration<double>::zero();
+    };
+
+    /**
+     * @brief `IRenderer` implementation rasterizing on CPU.
+     * Runs the same passes as OpenGL backend on machines without GPU,
+     * shaders are C++ functors registered under names of GLSL shaders (see `registerSoftwareShader`).
+     * Commands are executed on own render thread, triangles are rasterized by `SoftwareRasterizer` thread pool.
+     *
+     * To read frames keep `RendererDispatcher<SoftwareRenderer>` and use `getImpl()`.
+     */
+    class SoftwareRenderer
+    {
+        public:
+            SoftwareRenderer(Resolution viewport, unsigned int threads = std::thread::hardware_concurrency());
+            SoftwareRenderer(SoftwareRenderer && other) = default;
+            SoftwareRenderer & operator=(SoftwareRenderer && other) = default;
+            SoftwareRenderer(const SoftwareRenderer &) = delete;
+            SoftwareRenderer & operator=(const SoftwareRenderer &) = delete;
+            ~SoftwareRenderer();
+
+            static asio::awaitable<SoftwareRenderer> asyncConstructor(Resolution viewport, unsigned int threads = std::thread::hardware_concurrency());
+
+            bool good() const;
+
+            asio::awaitable<void> close();
+
+            asio::awaitable<void> clearScreen(glm::vec4 color, std::optional<std::size_t> fbo, std::optional<RenderRegion> region);
+            asio::awaitable<void> copyFrameBufferObjectDepth(std::size_t source, std::size_t destination, std::optional<RenderRegion> region);
+            asio::awaitable<void> clearScreenRegions(glm::vec4 color, std::optional<std::size_t> fbo, std::span<const RenderRegion> regions);
+            asio::awaitable<void> copyFrameBufferObjectDepthRegions(std::size_t source, std::size_t destination, std::span<const RenderRegion> regions);
+            asio::awaitable<void> render(std::size_t vertex_buffer,
+                std::size_t shader,
+                ShaderInputs shader_inputs,
+                RenderOptions options,
+                std::optional<std::size_t> fbo);
+            asio::awaitable<void> renderInstanced(std::size_t vertex_buffer,
+                std::size_t shader,
+                std::size_t instance_count,
+                ShaderInputs shader_inputs,
+                RenderOptions options,
+                std::optional<std::size_t> fbo);
+            asio::awaitable<void> submit(std::span<const DrawItem> draws);
+                
+            asio::awaitable<void> present();
+            asio::awaitable<void> updateViewport(Resolution resolution);
+            Resolution getViewport() const;
+            asio::awaitable<void> enableVSync();
+            asio::awaitable<void> disableVSync();
+
+            asio::awaitable<std::optional<std::size_t>> constructVertexBuffer(std::string name, const Mesh & mesh);
+            asio::awaitable<bool> eraseVertexBuffer(std::size_t id);
+            std::optional<std::size_t> getVertexBuffer(std::string name) const;
+            std::optional<MeshBounds> getVertexBufferBounds(std::size_t id) const;
+            std::optional<std::size_t> getVertexBufferElementCount(std::size_t id) const;
+
+            asio::awaitable<std::optional<std::size_t>> constructShader(std::string name, std::vector<std::string> vertex_code);
+            asio::awaitable<std::optional<std::size_t>> constructShader(std::string name, std::vector<std::string> vertex_code, std::vector<std::string> fragment_code);
+            asio::awaitable<bool> eraseShader(std::size_t id);
+            std::optional<std::size_t> getShader(std::string name) const;
+
+            asio::awaitable<std::optional<std::size_t>> constructShaderStorageBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data);
+            asio::awaitable<bool> eraseShaderStorageBuffer(std::size_t id);
+            std::optional<std::size_t> getShaderStorageBuffer(std::string name) const;
+            asio::awaitable<bool> updateShaderStorageBuffer(std::size_t id, const std::size_t size, const void * data);
+
+            asio::awaitable<std::optional<std::size_t>> constructUniformBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data);
+            asio::awaitable<bool> eraseUniformBuffer(std::size_t id);
+            std::optional<std::size_t> getUniformBuffer(std::string name) const;
+            asio::awaitable<bool> updateUniformBuffer(std::size_t id, const std::size_t size, const void * data);
+            
+            asio::awaitable<std::optional<std::size_t>> constructFrameBufferObject(std::string name, Resolution resolution, std::initializer_list<FBOAttachment> attachments);
+            asio::awaitable<bool> eraseFrameBufferObject(std::size_t id);
+            std::optional<std::size_t> getFrameBufferObject(std::string name) const;
+            std::vector<std::size_t> getFrameBufferObjectTextures(std::size_t id) const;
+
+            uint64_t getObjectGeneration() const;
+
+            void join();
+
+            // last presented frame, read only after join or from render strand
+            const SoftwareTexture & getFrontBuffer() const;
+
+            // attachment texture by ID, nullptr when it does not exist
+            const SoftwareTexture * getTexture(std::size_t id) const;
+
+            // counters of last presented frame
+            const SoftwareFrameStats & getFrameStats() const;
+
+        private:
+            class RenderThreadContext
+            {
+                public:
+                    RenderThreadContext();
+                    ~RenderThreadContext();
+
+                    void join();
+                    const asio::strand<asio::io_context::executor_type> & getStrand() const;
+                    asio::awaitable<void> ensureOnStrand();
+                    void signalClose();
+                    bool running() const;
+
+                private:
+                    void workerThread();
+
+                    asio::io_context _io_context;
+                    asio::executor_work_guard<asio::io_context::executor_type> _work_guard;
+                    asio::strand<asio::io_context::executor_type> _strand;
+                    // coroutines hop onto render thread through ring, strand is fallback when it is full
+                    RenderCommandRing _command_ring;
+                    std::thread _worker_thread;
+            };
+
+            struct SoftwareVertexBuffer
+            {
+                std::string name;
+                Mesh mesh;
+                MeshBounds bounds;
+            };
+
+            struct SoftwareShaderProgram
+            {
+                std::string name;
+                SoftwareShader shader;
+            };
+
+            struct SoftwareFrameBufferObject
+            {
+                std::string name;
+                Resolution resolution;
+
+                // every attachment texture including render buffers, owned by fbo
+                std::vector<std::size_t> attachments;
+                std::vector<std::size_t> color_attachments;
+                std::optional<std::size_t> depth_attachment;
+
+                // texture attachments visible to samplers
+                std::vector<std::size_t> textures;
+            };
+
+            std::optional<SoftwareRenderTarget> getRenderTarget(std::optional<std::size_t> fbo);
+
+            // draw call on render thread, shared by render, renderInstanced and submit
+            void drawInstances(std::size_t vertex_buffer,
+                std::size_t shader,
+                std::size_t instance_count,
+                uint32_t first_instance,
+                const ShaderInputs & shader_inputs,
+                const RenderOptions & options,
+                std::optional<std::size_t> fbo);
+
+            template<class T>
+            std::optional<std::size_t> emplaceObject(
+                absl::flat_hash_map<std::size_t, T> & object_map,
+                absl::flat_hash_map<std::string, std::size_t> & name_map,
+                std::string name, T && object)
+            {
+                if(name_map.contains(name))
+                {
+                    spdlog::warn(std::format("[t:{}] renderer object {} already exists", std::this_thread::get_id(), name));
+                    return std::nullopt;
+                }
+
+                const std::size_t id = _next_id++;
+                object_map.try_emplace(id, std::move(object));
+                name_map.try_emplace(std::move(name), id);
+                _object_generation->fetch_add(1, std::memory_order_release);
+                return id;
+            }
+
+            template<class T>
+            std::optional<std::size_t> findObject(
+                const absl::flat_hash_map<std::size_t, T> & object_map,
+                const absl::flat_hash_map<std::string, std::size_t> & name_map,
+                const std::string & name) const
+            {
+                if(good() == false) return std::nullopt;
+
+                auto it = name_map.find(name);
+                if(it == name_map.end() || object_map.contains(it->second) == false)
+                {
+                    spdlog::warn(std::format("[t:{}] renderer object {} does not exist", std::this_thread::get_id(), name));
+                    return std::nullopt;
+                }
+                return it->second;
+            }
+
+            template<class T>
+            bool eraseObject(
+                absl::flat_hash_map<std::size_t, T> & object_map,
+                absl::flat_hash_map<std::string, std::size_t> & name_map,
+                std::size_t id)
+            {
+                auto it = object_map.find(id);
+                if(it == object_map.end())
+                {
+                    spdlog::warn(std::format("[t:{}] renderer object {} does not exist", std::this_thread::get_id(), id));
+                    return false;
+                }
+                name_map.erase(it->second.name);
+                object_map.erase(it);
+                _object_generation->fetch_add(1, std::memory_order_release);
+                return true;
+            }
+
+            std::unique_ptr<RenderThreadContext> _render_context;
+            std::unique_ptr<SoftwareRasterizer> _rasterizer;
+
+            Resolution _viewport_resolution;
+
+            // default framebuffer, back buffer is swapped with front buffer on present
+            std::unique_ptr<SoftwareTexture> _back_buffer;
+            std::unique_ptr<SoftwareTexture> _front_buffer;
+            std::unique_ptr<SoftwareTexture> _depth_buffer;
+
+            // 0 is never handed out so it can be used as invalid id
+            std::size_t _next_id = 1;
+
+            // incremented on every construct and erase, unique_ptr keeps renderer movable
+            std::unique_ptr<std::atomic<uint64_t>> _object_generation = std::make_unique<std::atomic<uint64_t>>(0);
+
+            absl::flat_hash_map<std::size_t, SoftwareVertexBuffer> _vertex_buffers;
+            absl::flat_hash_map<std::size_t, SoftwareShaderProgram> _shaders;
+            absl::flat_hash_map<std::size_t, SoftwareShaderStorageBuffer> _shader_storage_buffers;
+            absl::flat_hash_map<std::size_t, SoftwareUniformBuffer> _uniform_buffers;
+            absl::flat_hash_map<std::size_t, SoftwareFrameBufferObject> _frame_buffer_objects;
+            absl::flat_hash_map<std::size_t, SoftwareTexture> _textures;
+
+            absl::flat_hash_map<std::string, std::size_t> _vertex_buffer_names;
+            absl::flat_hash_map<std::string, std::size_t> _shader_names;
+            absl::flat_hash_map<std::string, std::size_t> _shader_storage_buffer_names;
+            absl::flat_hash_map<std::string, std::size_t> _uniform_buffer_names;
+            absl::flat_hash_map<std::string, std::size_t> _frame_buffer_object_names;
+
+            SoftwareFrameStats _frame_stats;
+            SoftwareFrameStats _current_frame_stats;
+    };
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <glm/glm.hpp>
+
+#include "shader.hpp"
+#include "vertex.hpp"
+
+#include "software_texture.hpp"
+
+namespace velora::software
+{
+    constexpr std::size_t MAX_SOFTWARE_VARYINGS = 4;
+    constexpr std::size_t MAX_SOFTWARE_COLOR_OUTPUTS = 4;
+
+    /**
+     * @brief Values passed from vertex to fragment stage, interpolated perspective correct.
+     * Equivalent of GLSL `out` / `in` variables, each slot holds up to vec4.
+     */
+    using SoftwareVaryings = std::array<glm::vec4, MAX_SOFTWARE_VARYINGS>;
+
+    /**
+     * @brief Fragment stage outputs, one per color attachment in attachment order
+     */
+    using SoftwareFragmentOutput = std::array<glm::vec4, MAX_SOFTWARE_COLOR_OUTPUTS>;
+
+    /**
+     * @brief Vertex stage, returns clip space position (gl_Position)
+     */
+    using SoftwareVertexShader = std::function<glm::vec4(const Vertex & vertex, SoftwareVaryings & varyings)>;
+
+    /**
+     * @brief Fragment stage, returns false to discard fragment.
+     * Called concurrently from rasterizer threads, must not modify captured state.
+     */
+    using SoftwareFragmentShader = std::function<bool(const SoftwareVaryings & varyings, SoftwareFragmentOutput & output)>;
+
+    /**
+     * @brief Shader program of single draw call, uniforms are already resolved and captured.
+     * Missing fragment stage means depth only pass.
+     */
+    struct SoftwareProgram
+    {
+        SoftwareVertexShader vertex;
+        SoftwareFragmentShader fragment;
+    };
+
+    struct SoftwareShaderStorageBuffer
+    {
+        std::string name;
+        unsigned int binding_point;
+        std::vector<std::byte> data;
+    };
+
+    struct SoftwareUniformBuffer
+    {
+        std::string name;
+        unsigned int binding_point;
+        std::vector<std::byte> data;
+    };
+
+    /**
+     * @brief Read only view of draw call inputs given to shader when program is built.
+     * Lookups are done once per draw call, never per vertex or fragment.
+     */
+    class SoftwareShaderResources
+    {
+        public:
+            SoftwareShaderResources(const ShaderInputs & inputs,
+                const absl::flat_hash_map<std::size_t, SoftwareTexture> & textures,
+                const absl::flat_hash_map<std::size_t, SoftwareShaderStorageBuffer> & storage_buffers,
+                const absl::flat_hash_map<std::size_t, SoftwareUniformBuffer> & uniform_buffers,
+                int instance_id = 0);
+
+            // first instance of draw call + gl_InstanceID, aInstance attribute of instanced glsl shaders, 0 for regular draw calls
+            int getInstanceID() const;
+
+            bool getBool(ShaderUniform uniform, bool fallback = false) const;
+            int getInt(ShaderUniform uniform, int fallback = 0) const;
+            float getFloat(ShaderUniform uniform, float fallback = 0.0f) const;
+            glm::vec2 getVec2(ShaderUniform uniform, glm::vec2 fallback = glm::vec2(0.0f)) const;
+            glm::vec3 getVec3(ShaderUniform uniform, glm::vec3 fallback = glm::vec3(0.0f)) const;
+            glm::vec4 getVec4(ShaderUniform uniform, glm::vec4 fallback = glm::vec4(0.0f)) const;
+            glm::mat4 getMat4(ShaderUniform uniform, glm::mat4 fallback = glm::mat4(1.0f)) const;
+            std::span<const glm::mat4> getMat4Array(ShaderUniform uniform) const;
+
+            // nullptr when sampler is not set or texture does not exist
+            const SoftwareTexture * getSampler(ShaderUniform uniform) const;
+            std::vector<const SoftwareTexture *> getSamplerArray(ShaderUniform uniform) const;
+
+            // buffer from shader inputs bound at binding point, empty when none is bound
+            std::span<const std::byte> getStorageBuffer(unsigned int binding_point) const;
+
+            template<class T>
+            std::span<const T> getStorageBuffer(unsigned int binding_point) const
+            {
+                const std::span<const std::byte> data = getStorageBuffer(binding_point);
+                return std::span<const T>(reinterpret_cast<const T *>(data.data()), data.size() / sizeof(T));
+            }
+
+            // uniform buffer bound at binding point, uniform buffers are bound globally and not part of shader inputs
+            std::span<const std::byte> getUniformBuffer(unsigned int binding_point) const;
+
+            // nullptr when no buffer is bound or it is smaller than block
+            template<class T>
+            const T * getUniformBuffer(unsigned int binding_point) const
+            {
+                const std::span<const std::byte> data = getUniformBuffer(binding_point);
+                if(data.size() < sizeof(T))return nullptr;
+                return reinterpret_cast<const T *>(data.data());
+            }
+
+        private:
+            template<class T>
+            T findOr(ShaderUniform uniform, T fallback) const
+            {
+                const T * value = _inputs.find<T>(uniform);
+                if(value == nullptr)return fallback;
+                return *value;
+            }
+
+            const ShaderInputs & _inputs;
+            const absl::flat_hash_map<std::size_t, SoftwareTexture> & _textures;
+            const absl::flat_hash_map<std::size_t, SoftwareShaderStorageBuffer> & _storage_buffers;
+            const absl::flat_hash_map<std::size_t, SoftwareUniformBuffer> & _uniform_buffers;
+            const int _instance_id;
+    };
+
+    /**
+     * @brief C++ counterpart of GLSL shader, builds program of one draw call from its resources
+     */
+    using SoftwareShader = std::function<SoftwareProgram(const SoftwareShaderResources & resources)>;
+
+    /**
+     * @brief Registers shader under name, `constructShader` of software renderer picks shader by this name.
+     * Built-in shaders are registered under the names of `resources/shaders/glsl/*` directories.
+     * Safe to call from any thread, replaces already registered shader.
+     */
+    void registerSoftwareShader(std::string name, SoftwareShader shader);
+
+    std::optional<SoftwareShader> findSoftwareShader(const std::string & name);
+
+    /**
+     * @brief C++ ports of shaders in `resources/shaders/glsl`, registered automatically
+     */
+    absl::flat_hash_map<std::string, SoftwareShader> getBuiltinSoftwareShaders();
+}
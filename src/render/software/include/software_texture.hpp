@@ -0,0 +1,104 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "resolution.hpp"
+#include "texture.hpp"
+#include "render_options.hpp"
+
+namespace velora::software
+{
+    /**
+     * @brief CPU side texture used as framebuffer attachment and sampler.
+     * Texels are stored as floats but every write is quantized to precision of texture format,
+     * so passes reading previous pass outputs see the same values as on GPU.
+     * Row 0 is bottom row, same as OpenGL window and texture coordinates.
+     */
+    class SoftwareTexture
+    {
+        public:
+            SoftwareTexture(Resolution resolution, TextureFormat format);
+            SoftwareTexture(SoftwareTexture && other) = default;
+            SoftwareTexture & operator=(SoftwareTexture && other) = default;
+            SoftwareTexture(const SoftwareTexture &) = delete;
+            SoftwareTexture & operator=(const SoftwareTexture &) = delete;
+            ~SoftwareTexture() = default;
+
+            Resolution getResolution() const;
+            TextureFormat getFormat() const;
+            
+            std::size_t getWidth() const;
+            std::size_t getHeight() const;
+
+            bool isDepth() const;
+
+            void clear(glm::vec4 value);
+            // clears texels inside of region only, region is clamped to texture
+            void clear(glm::vec4 value, const RenderRegion & region);
+            // copies texels inside of region from texture of the same resolution and format
+            void copy(const SoftwareTexture & source, const RenderRegion & region);
+
+            inline void write(std::size_t x, std::size_t y, glm::vec4 value)
+            {
+                float * texel = &_texels[(y * _width + x) * _channels];
+                for(uint8_t c = 0; c < _channels; ++c)
+                {
+                    texel[c] = quantize(value[c]);
+                }
+            }
+
+            inline glm::vec4 read(std::size_t x, std::size_t y) const
+            {
+                const float * texel = &_texels[(y * _width + x) * _channels];
+                glm::vec4 value(0.0f, 0.0f, 0.0f, 1.0f);
+                for(uint8_t c = 0; c < _channels; ++c)
+                {
+                    value[c] = texel[c];
+                }
+                return value;
+            }
+
+            inline float readDepth(std::size_t x, std::size_t y) const
+            {
+                return _texels[(y * _width + x) * _channels];
+            }
+
+            inline void writeDepth(std::size_t x, std::size_t y, float depth)
+            {
+                _texels[(y * _width + x) * _channels] = quantize(depth);
+            }
+
+            /**
+             * @brief Nearest texel lookup with repeat wrapping, matches filtering of OpenGL textures
+             */
+            glm::vec4 sample(glm::vec2 uv) const;
+
+            /**
+             * @brief Depth comparison lookup like sampler2DShadow with GL_LESS compare func
+             * @return 1 when reference depth is less than stored depth (lit), 0 otherwise
+             */
+            float sampleCompare(glm::vec3 coords) const;
+
+            /**
+             * @brief Saves color channels as binary PPM, used to compare frames in regression tests
+             */
+            bool savePPM(const std::filesystem::path & path) const;
+
+        private:
+            static uint8_t getChannelsCount(TextureFormat format);
+
+            float quantize(float value) const;
+
+            Resolution _resolution;
+            TextureFormat _format;
+
+            std::size_t _width;
+            std::size_t _height;
+            uint8_t _channels;
+
+            std::vector<float> _texels;
+    };
+}
@@ -0,0 +1,433 @@
+#include "software_shader.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace velora::software
+{
+    namespace
+    {
+        // varying slots shared by built-in shaders
+        constexpr std::size_t FRAG_POS = 0;
+        constexpr std::size_t NORMAL = 1;
+        constexpr std::size_t TEX_COORD = 2;
+
+        constexpr int LIGHT_TYPE_DIRECTIONAL = 1;
+        constexpr int LIGHT_TYPE_SPOT = 3;
+
+        constexpr unsigned int FRAME_UNIFORM_BINDING = 0;
+        constexpr unsigned int LIGHT_SET_UNIFORM_BINDING = 1;
+        constexpr unsigned int LIGHT_BUFFER_BINDING = 2;
+        constexpr unsigned int INSTANCE_BUFFER_BINDING = 3;
+        constexpr unsigned int LIGHT_CLUSTER_BUFFER_BINDING = 4;
+
+        // uniforms of built-in shaders, interned once
+        const ShaderUniform UNIFORM_TEXTURE{"uTexture"};
+        const ShaderUniform UNIFORM_USE_TEXTURE{"useTexture"};
+        const ShaderUniform UNIFORM_MODEL{"uModel"};
+        const ShaderUniform UNIFORM_COLOR{"uColor"};
+        const ShaderUniform UNIFORM_SHADOW_CASTER{"uShadowCaster"};
+        const ShaderUniform UNIFORM_G_POSITION{"gPosition"};
+        const ShaderUniform UNIFORM_G_NORMAL{"gNormal"};
+        const ShaderUniform UNIFORM_G_ALBEDO_SPEC{"gAlbedoSpec"};
+        const ShaderUniform UNIFORM_SHADOW_ATLAS{"shadowAtlas"};
+        const ShaderUniform UNIFORM_DEBUG_MODE{"debugMode"};
+
+        constexpr std::size_t MAX_SHADOW_CASTERS = 32;
+
+        // light cluster grid of deferred lighting pass
+        constexpr int CLUSTER_GRID_X = 16;
+        constexpr int CLUSTER_GRID_Y = 9;
+        constexpr int CLUSTER_GRID_Z = 24;
+        constexpr std::size_t CLUSTERS_COUNT = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+
+        // std140 layout of FrameBlock in glsl shaders
+        #pragma pack(push, 1)
+        struct GPUFrame {
+            glm::mat4 view;
+            glm::mat4 projection;
+            glm::vec4 camera_position;  // w unused
+            float time;
+            float padding[3];
+        };
+        #pragma pack(pop)
+
+        // std140 layout of LightSetBlock in glsl shaders
+        #pragma pack(push, 1)
+        struct GPULightSet {
+            glm::mat4 light_space_matrices[MAX_SHADOW_CASTERS];
+            glm::vec4 shadow_tiles[MAX_SHADOW_CASTERS];    // xy = uv offset, zw = uv scale of tile in shadow atlas
+            glm::vec4 cluster_depth_slicing;    // x = near, y = far, slice = floor(log(depth) * z + w)
+            int32_t light_count;
+            int32_t shadow_casters_count;
+            int32_t global_lights_count;
+            int32_t padding;
+        };
+        #pragma pack(pop)
+
+        // std430 layout of GPULight in glsl shaders
+        #pragma pack(push, 1)
+        struct GPULight {
+            glm::vec4 position;     // w unused
+            glm::vec4 direction;    // w = type
+            glm::vec4 color;        // w = intensity
+            glm::vec4 attenuation;  // x=constant, y=linear, z=quadratic, w=unused
+            glm::vec2 cutoff;       // x=inner, y=outer
+            glm::vec2 castShadows;  // x=enabled, y=shadowMapIndex
+        };
+        #pragma pack(pop)
+
+        // std430 layout of Instance in instanced glsl shaders
+        #pragma pack(push, 1)
+        struct GPUInstance {
+            glm::mat4 model;
+            glm::vec4 color;
+        };
+        #pragma pack(pop)
+
+        // instance of instanced draw call, instances[aInstance]
+        std::optional<GPUInstance> findInstance(const SoftwareShaderResources & resources)
+        {
+            const std::span<const GPUInstance> buffer = resources.getStorageBuffer<GPUInstance>(INSTANCE_BUFFER_BINDING);
+            const int index = resources.getInstanceID();
+            if(index < 0 || (std::size_t)index >= buffer.size())return std::nullopt;
+            return buffer[index];
+        }
+
+        glm::vec3 calculateLight(const GPULight & light, glm::vec3 normal, glm::vec3 frag_pos)
+        {
+            glm::vec3 light_dir;
+            float attenuation = 1.0f;
+
+            const int type = (int)light.direction.w;
+            if(type == LIGHT_TYPE_DIRECTIONAL)
+            {
+                light_dir = glm::normalize(-glm::vec3(light.direction));
+            }
+            else
+            {
+                const glm::vec3 delta = glm::vec3(light.position) - frag_pos;
+                light_dir = glm::normalize(delta);
+                const float dist = glm::length(delta);
+                attenuation = 1.0f / (light.attenuation.x + light.attenuation.y * dist + light.attenuation.z * dist * dist);
+
+                if(type == LIGHT_TYPE_SPOT)
+                {
+                    const float theta = glm::dot(light_dir, glm::normalize(-glm::vec3(light.direction)));
+                    const float epsilon = light.cutoff.x - light.cutoff.y;
+                    attenuation *= std::clamp((theta - light.cutoff.y) / epsilon, 0.0f, 1.0f);
+                }
+            }
+
+            const float diff = std::max(glm::dot(normal, light_dir), 0.0f);
+            return glm::vec3(light.color) * light.color.w * diff * attenuation;
+        }
+
+        // lights of light buffer counted by light set block
+        std::span<const GPULight> findLights(const SoftwareShaderResources & resources)
+        {
+            const std::span<const GPULight> buffer = resources.getStorageBuffer<GPULight>(LIGHT_BUFFER_BINDING);
+            const GPULightSet * light_set = resources.getUniformBuffer<GPULightSet>(LIGHT_SET_UNIFORM_BINDING);
+            if(light_set == nullptr)return {};
+            return buffer.first(std::min<std::size_t>(std::max(light_set->light_count, 0), buffer.size()));
+        }
+
+        // light space matrix of shadow map being rendered, uShadowCaster indexes light set block
+        glm::mat4 findLightSpaceMatrix(const SoftwareShaderResources & resources)
+        {
+            const GPULightSet * light_set = resources.getUniformBuffer<GPULightSet>(LIGHT_SET_UNIFORM_BINDING);
+            const int shadow_caster = resources.getInt(UNIFORM_SHADOW_CASTER);
+            if(light_set == nullptr || shadow_caster < 0 || (std::size_t)shadow_caster >= MAX_SHADOW_CASTERS)return glm::mat4(1.0f);
+            return light_set->light_space_matrices[shadow_caster];
+        }
+
+        // vertex stage of basic_shader, light_shader and deferred_shader
+        SoftwareVertexShader makeModelViewProjectionVertex(const SoftwareShaderResources & resources, const glm::mat4 & model)
+        {
+            const glm::mat3 normal_matrix = glm::mat3(glm::transpose(glm::inverse(model)));
+            const GPUFrame * frame = resources.getUniformBuffer<GPUFrame>(FRAME_UNIFORM_BINDING);
+            const glm::mat4 view_projection = frame == nullptr ? glm::mat4(1.0f) : frame->projection * frame->view;
+
+            return [model, normal_matrix, view_projection](const Vertex & vertex, SoftwareVaryings & varyings)
+            {
+                const glm::vec4 world_pos = model * glm::vec4(vertex.position, 1.0f);
+                varyings[FRAG_POS] = world_pos;
+                varyings[NORMAL] = glm::vec4(normal_matrix * vertex.normal, 0.0f);
+                varyings[TEX_COORD] = glm::vec4(vertex.uv, 0.0f, 0.0f);
+                return view_projection * world_pos;
+            };
+        }
+
+        // vertex stage of full screen passes
+        glm::vec4 screenQuadVertex(const Vertex & vertex, SoftwareVaryings & varyings)
+        {
+            varyings[TEX_COORD] = glm::vec4(vertex.uv, 0.0f, 0.0f);
+            return glm::vec4(vertex.position.x, vertex.position.y, 0.0f, 1.0f);
+        }
+
+        // base color of basic_shader, light_shader and deferred_shader
+        std::function<glm::vec4(glm::vec2)> makeBaseColor(const SoftwareShaderResources & resources, const glm::vec4 & color)
+        {
+            const SoftwareTexture * texture = resources.getSampler(UNIFORM_TEXTURE);
+
+            if(resources.getBool(UNIFORM_USE_TEXTURE) && texture != nullptr)
+            {
+                return [texture](glm::vec2 uv){ return texture->sample(uv); };
+            }
+            return [color](glm::vec2){ return color; };
+        }
+
+        SoftwareProgram basicShader(const SoftwareShaderResources & resources)
+        {
+            return SoftwareProgram{
+                .vertex = makeModelViewProjectionVertex(resources, resources.getMat4(UNIFORM_MODEL)),
+                .fragment = [base_color = makeBaseColor(resources, resources.getVec4(UNIFORM_COLOR))](const SoftwareVaryings & varyings, SoftwareFragmentOutput & output)
+                {
+                    output[0] = base_color(glm::vec2(varyings[TEX_COORD]));
+                    return true;
+                }
+            };
+        }
+
+        SoftwareProgram lightShader(const SoftwareShaderResources & resources)
+        {
+            return SoftwareProgram{
+                .vertex = makeModelViewProjectionVertex(resources, resources.getMat4(UNIFORM_MODEL)),
+                .fragment = [base_color = makeBaseColor(resources, resources.getVec4(UNIFORM_COLOR)), lights = findLights(resources)]
+                    (const SoftwareVaryings & varyings, SoftwareFragmentOutput & output)
+                {
+                    const glm::vec3 frag_pos = glm::vec3(varyings[FRAG_POS]);
+                    const glm::vec3 normal = glm::normalize(glm::vec3(varyings[NORMAL]));
+                    const glm::vec4 color = base_color(glm::vec2(varyings[TEX_COORD]));
+
+                    glm::vec3 lighting(0.0f);
+                    for(const GPULight & light : lights)
+                    {
+                        lighting += calculateLight(light, normal, frag_pos);
+                    }
+
+                    output[0] = glm::vec4(glm::vec3(color) * lighting, color.a);
+                    return true;
+                }
+            };
+        }
+
+        SoftwareProgram deferredShader(const SoftwareShaderResources & resources)
+        {
+            return SoftwareProgram{
+                .vertex = makeModelViewProjectionVertex(resources, resources.getMat4(UNIFORM_MODEL)),
+                .fragment = [base_color = makeBaseColor(resources, resources.getVec4(UNIFORM_COLOR))](const SoftwareVaryings & varyings, SoftwareFragmentOutput & output)
+                {
+                    output[0] = varyings[FRAG_POS];                                         // gPosition
+                    output[1] = glm::vec4(glm::normalize(glm::vec3(varyings[NORMAL])), 0.0f); // gNormal
+                    output[2] = base_color(glm::vec2(varyings[TEX_COORD]));                 // gAlbedoSpec
+                    return true;
+                }
+            };
+        }
+
+        SoftwareProgram shadowDepth(const SoftwareShaderResources & resources)
+        {
+            const glm::mat4 light_space_model = findLightSpaceMatrix(resources) * resources.getMat4(UNIFORM_MODEL);
+
+            return SoftwareProgram{
+                .vertex = [light_space_model](const Vertex & vertex, SoftwareVaryings &)
+                {
+                    return light_space_model * glm::vec4(vertex.position, 1.0f);
+                },
+                // no output, depth is written by rasterizer
+                .fragment = nullptr
+            };
+        }
+
+        SoftwareProgram deferredShaderInstanced(const SoftwareShaderResources & resources)
+        {
+            const std::optional<GPUInstance> instance = findInstance(resources);
+            if(!instance)return SoftwareProgram{};
+
+            return SoftwareProgram{
+                .vertex = makeModelViewProjectionVertex(resources, instance->model),
+                .fragment = [base_color = makeBaseColor(resources, instance->color)](const SoftwareVaryings & varyings, SoftwareFragmentOutput & output)
+                {
+                    output[0] = varyings[FRAG_POS];                                         // gPosition
+                    output[1] = glm::vec4(glm::normalize(glm::vec3(varyings[NORMAL])), 0.0f); // gNormal
+                    output[2] = base_color(glm::vec2(varyings[TEX_COORD]));                 // gAlbedoSpec
+                    return true;
+                }
+            };
+        }
+
+        SoftwareProgram shadowDepthInstanced(const SoftwareShaderResources & resources)
+        {
+            const std::optional<GPUInstance> instance = findInstance(resources);
+            if(!instance)return SoftwareProgram{};
+
+            const glm::mat4 light_space_model = findLightSpaceMatrix(resources) * instance->model;
+
+            return SoftwareProgram{
+                .vertex = [light_space_model](const Vertex & vertex, SoftwareVaryings &)
+                {
+                    return light_space_model * glm::vec4(vertex.position, 1.0f);
+                },
+                // no output, depth is written by rasterizer
+                .fragment = nullptr
+            };
+        }
+
+        SoftwareProgram deferredLightingPass(const SoftwareShaderResources & resources)
+        {
+            const SoftwareTexture * g_position = resources.getSampler(UNIFORM_G_POSITION);
+            const SoftwareTexture * g_normal = resources.getSampler(UNIFORM_G_NORMAL);
+            const SoftwareTexture * g_albedo_spec = resources.getSampler(UNIFORM_G_ALBEDO_SPEC);
+
+            if(g_position == nullptr || g_normal == nullptr || g_albedo_spec == nullptr)
+            {
+                return SoftwareProgram{ .vertex = screenQuadVertex, .fragment = [](const SoftwareVaryings &, SoftwareFragmentOutput & output)
+                {
+                    output[0] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+                    return true;
+                }};
+            }
+
+            const GPULightSet * light_set = resources.getUniformBuffer<GPULightSet>(LIGHT_SET_UNIFORM_BINDING);
+            const std::span<const glm::mat4> light_space_matrices = light_set == nullptr ?
+                std::span<const glm::mat4>() : std::span<const glm::mat4>(light_set->light_space_matrices);
+            const std::span<const glm::vec4> shadow_tiles = light_set == nullptr ?
+                std::span<const glm::vec4>() : std::span<const glm::vec4>(light_set->shadow_tiles);
+            const SoftwareTexture * shadow_atlas = resources.getSampler(UNIFORM_SHADOW_ATLAS);
+            const int shadow_casters_count = light_set == nullptr || shadow_atlas == nullptr ? 0 : std::min(
+                (int)light_set->shadow_casters_count,
+                (int)light_space_matrices.size());
+
+            // light indices of clusters, every light is shaded by every pixel when cluster buffer is missing
+            const std::span<const uint32_t> light_clusters = resources.getStorageBuffer<uint32_t>(LIGHT_CLUSTER_BUFFER_BINDING);
+            const bool clustered = light_set != nullptr && light_clusters.size() >= CLUSTERS_COUNT * 2;
+            const GPUFrame * frame = resources.getUniformBuffer<GPUFrame>(FRAME_UNIFORM_BINDING);
+            const glm::mat4 view = frame == nullptr ? glm::mat4(1.0f) : frame->view;
+            const glm::vec4 depth_slicing = light_set == nullptr ? glm::vec4(1.0f, 1.0f, 0.0f, 0.0f) : light_set->cluster_depth_slicing;
+            const std::size_t global_lights_count = light_set == nullptr ? 0 : std::clamp<std::size_t>(
+                std::max(light_set->global_lights_count, 0), 0, light_clusters.size() - std::min(light_clusters.size(), CLUSTERS_COUNT * 2));
+
+            return SoftwareProgram{
+                .vertex = screenQuadVertex,
+                .fragment = [g_position, g_normal, g_albedo_spec, lights = findLights(resources),
+                    light_space_matrices, shadow_tiles, shadow_atlas, shadow_casters_count,
+                    light_clusters, clustered, view, depth_slicing, global_lights_count]
+                    (const SoftwareVaryings & varyings, SoftwareFragmentOutput & output)
+                {
+                    const glm::vec2 uv = glm::vec2(varyings[TEX_COORD]);
+                    const glm::vec3 frag_pos = glm::vec3(g_position->sample(uv));
+                    const glm::vec3 normal = glm::normalize(glm::vec3(g_normal->sample(uv)));
+                    const glm::vec4 albedo = g_albedo_spec->sample(uv);
+
+                    const auto shade = [&](const GPULight & light)
+                    {
+                        float shadow = 1.0f;
+                        const int shadow_index = (int)light.castShadows.y;
+                        if(light.castShadows.x > 0.0f && shadow_index >= 0 && shadow_index < shadow_casters_count)
+                        {
+                            const glm::vec4 light_space = light_space_matrices[shadow_index] * glm::vec4(frag_pos, 1.0f);
+                            glm::vec3 coords = glm::vec3(light_space) / light_space.w * 0.5f + 0.5f;
+                            coords.z -= 0.005f;
+
+                            // outside of light frustum stays lit, neighbouring texels of atlas belong to other lights
+                            if(coords.x >= 0.0f && coords.x <= 1.0f && coords.y >= 0.0f && coords.y <= 1.0f)
+                            {
+                                const glm::vec4 & tile = shadow_tiles[shadow_index];
+                                const glm::vec2 half_texel = 0.5f / glm::vec2((float)shadow_atlas->getWidth(), (float)shadow_atlas->getHeight());
+                                const glm::vec2 tile_uv = glm::clamp(glm::vec2(tile) + glm::vec2(coords) * glm::vec2(tile.z, tile.w),
+                                    glm::vec2(tile) + half_texel, glm::vec2(tile) + glm::vec2(tile.z, tile.w) - half_texel);
+
+                                // 0.2 = minimum ambient in shadow
+                                shadow = glm::mix(0.2f, 1.0f, shadow_atlas->sampleCompare(glm::vec3(tile_uv, coords.z)));
+                            }
+                        }
+
+                        return calculateLight(light, normal, frag_pos) * shadow;
+                    };
+
+                    glm::vec3 lighting(0.0f);
+                    if(clustered == false)
+                    {
+                        for(const GPULight & light : lights)lighting += shade(light);
+                    }
+                    else
+                    {
+                        const std::span<const uint32_t> light_indices = light_clusters.subspan(CLUSTERS_COUNT * 2);
+
+                        // global lights reach every pixel
+                        for(std::size_t i = 0; i < global_lights_count; ++i)
+                        {
+                            if(light_indices[i] < lights.size())lighting += shade(lights[light_indices[i]]);
+                        }
+
+                        // only lights whose bounds touch cluster of this pixel
+                        const float depth = std::max(-(view * glm::vec4(frag_pos, 1.0f)).z, depth_slicing.x);
+                        const int x = std::clamp((int)(uv.x * (float)CLUSTER_GRID_X), 0, CLUSTER_GRID_X - 1);
+                        const int y = std::clamp((int)(uv.y * (float)CLUSTER_GRID_Y), 0, CLUSTER_GRID_Y - 1);
+                        const int z = std::clamp((int)std::floor(std::log(depth) * depth_slicing.z + depth_slicing.w), 0, CLUSTER_GRID_Z - 1);
+                        const std::size_t cluster = (std::size_t)(x + CLUSTER_GRID_X * (y + CLUSTER_GRID_Y * z));
+
+                        const std::size_t offset = light_clusters[cluster * 2];
+                        const std::size_t count = light_clusters[cluster * 2 + 1];
+                        for(std::size_t i = offset; i < std::min(offset + count, light_indices.size()); ++i)
+                        {
+                            if(light_indices[i] < lights.size())lighting += shade(lights[light_indices[i]]);
+                        }
+                    }
+
+                    output[0] = glm::vec4(lighting * glm::vec3(albedo), albedo.a);
+                    return true;
+                }
+            };
+        }
+
+        SoftwareProgram debugGBuffer(const SoftwareShaderResources & resources)
+        {
+            const SoftwareTexture * g_position = resources.getSampler(UNIFORM_G_POSITION);
+            const SoftwareTexture * g_normal = resources.getSampler(UNIFORM_G_NORMAL);
+            const SoftwareTexture * g_albedo_spec = resources.getSampler(UNIFORM_G_ALBEDO_SPEC);
+            const int debug_mode = resources.getInt(UNIFORM_DEBUG_MODE);
+
+            return SoftwareProgram{
+                .vertex = screenQuadVertex,
+                .fragment = [g_position, g_normal, g_albedo_spec, debug_mode](const SoftwareVaryings & varyings, SoftwareFragmentOutput & output)
+                {
+                    const glm::vec2 uv = glm::vec2(varyings[TEX_COORD]);
+
+                    if(debug_mode == 0 && g_position != nullptr)
+                    {
+                        output[0] = glm::vec4(glm::vec3(g_position->sample(uv)) * 0.1f, 1.0f);
+                    }
+                    else if(debug_mode == 1 && g_normal != nullptr)
+                    {
+                        output[0] = glm::vec4(glm::normalize(glm::vec3(g_normal->sample(uv))) * 0.5f + 0.5f, 1.0f);
+                    }
+                    else if(debug_mode == 2 && g_albedo_spec != nullptr)
+                    {
+                        output[0] = g_albedo_spec->sample(uv);
+                    }
+                    else
+                    {
+                        output[0] = glm::vec4(1.0f, 0.0f, 1.0f, 1.0f); // magenta for invalid mode
+                    }
+                    return true;
+                }
+            };
+        }
+    }
+
+    absl::flat_hash_map<std::string, SoftwareShader> getBuiltinSoftwareShaders()
+    {
+        return {
+            {"basic_shader", basicShader},
+            {"light_shader", lightShader},
+            {"deferred_shader", deferredShader},
+            {"shadow_depth", shadowDepth},
+            {"deferred_shader_instanced", deferredShaderInstanced},
+            {"shadow_depth_instanced", shadowDepthInstanced},
+            {"deferred_lighting_pass", deferredLightingPass},
+            {"debug_gbuffer", debugGBuffer}
+        };
+    }
+}
@@ -0,0 +1,327 @@
+#include "software_rasterizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <latch>
+
+namespace velora::software
+{
+    namespace
+    {
+        // vertices shaded by one job of vertex stage
+        constexpr std::size_t VERTEX_CHUNK = 1024;
+
+        // smallest resolvable difference of 24 bit depth buffer, unit of polygon offset
+        constexpr float DEPTH_UNIT = 1.0f / 16777216.0f;
+    }
+
+    SoftwareRasterizer::SoftwareRasterizer(unsigned int threads)
+    :   _threads(std::max(threads, 1u)),
+        _pool(std::max(_threads - 1, 1u))
+    {}
+
+    SoftwareRasterizer::~SoftwareRasterizer()
+    {
+        _pool.join();
+    }
+
+    unsigned int SoftwareRasterizer::getThreadsCount() const
+    {
+        return _threads;
+    }
+
+    void SoftwareRasterizer::runParallel(std::size_t count, const std::function<void(std::size_t)> & job)
+    {
+        if(count == 0)return;
+
+        std::atomic<std::size_t> next = 0;
+        auto worker = [&next, &job, count]()
+        {
+            for(std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed))
+            {
+                job(i);
+            }
+        };
+
+        // caller thread works as well, pool only helps
+        const std::size_t helpers = std::min<std::size_t>(_threads - 1, count - 1);
+        std::latch done((std::ptrdiff_t)helpers);
+        for(std::size_t i = 0; i < helpers; ++i)
+        {
+            asio::post(_pool, [&worker, &done]()
+            {
+                worker();
+                done.count_down();
+            });
+        }
+
+        worker();
+        done.wait();
+    }
+
+    SoftwareRasterStats SoftwareRasterizer::draw(const SoftwareRenderTarget & target, const Mesh & mesh, const SoftwareProgram & program, const RenderOptions & options)
+    {
+        SoftwareRasterStats stats;
+        stats.triangles_submitted = mesh.indices.size() / 3;
+
+        if(target.width == 0 || target.height == 0 || !program.vertex)return stats;
+
+        // vertex stage
+        _vertices.resize(mesh.vertices.size());
+        runParallel((mesh.vertices.size() + VERTEX_CHUNK - 1) / VERTEX_CHUNK, [this, &mesh, &program](std::size_t chunk)
+        {
+            const std::size_t end = std::min((chunk + 1) * VERTEX_CHUNK, mesh.vertices.size());
+            for(std::size_t i = chunk * VERTEX_CHUNK; i < end; ++i)
+            {
+                ClipVertex & vertex = _vertices[i];
+                vertex.varyings.fill(glm::vec4(0.0f));
+                vertex.position = program.vertex(mesh.vertices[i], vertex.varyings);
+            }
+        });
+
+        // primitive assembly, near plane clipping and triangle setup
+        _triangles.clear();
+        for(std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            const uint32_t i0 = mesh.indices[i], i1 = mesh.indices[i + 1], i2 = mesh.indices[i + 2];
+            if(i0 >= _vertices.size() || i1 >= _vertices.size() || i2 >= _vertices.size())continue;
+
+            const std::array<const ClipVertex *, 3> input = {&_vertices[i0], &_vertices[i1], &_vertices[i2]};
+
+            // distance to near plane z = -w
+            std::array<float, 3> distance;
+            for(std::size_t v = 0; v < 3; ++v) distance[v] = input[v]->position.z + input[v]->position.w;
+
+            if(distance[0] >= 0.0f && distance[1] >= 0.0f && distance[2] >= 0.0f)
+            {
+                setupTriangle(*input[0], *input[1], *input[2], target, options);
+                continue;
+            }
+            if(distance[0] < 0.0f && distance[1] < 0.0f && distance[2] < 0.0f)continue;
+
+            // single plane clip of triangle yields at most quad
+            std::array<ClipVertex, 4> clipped;
+            std::size_t clipped_count = 0;
+            for(std::size_t v = 0; v < 3; ++v)
+            {
+                const std::size_t n = (v + 1) % 3;
+                if(distance[v] >= 0.0f) clipped[clipped_count++] = *input[v];
+                if((distance[v] >= 0.0f) != (distance[n] >= 0.0f))
+                {
+                    const float t = distance[v] / (distance[v] - distance[n]);
+                    ClipVertex & out = clipped[clipped_count++];
+                    out.position = glm::mix(input[v]->position, input[n]->position, t);
+                    for(std::size_t j = 0; j < MAX_SOFTWARE_VARYINGS; ++j)
+                    {
+                        out.varyings[j] = glm::mix(input[v]->varyings[j], input[n]->varyings[j], t);
+                    }
+                }
+            }
+
+            for(std::size_t v = 1; v + 1 < clipped_count; ++v)
+            {
+                setupTriangle(clipped[0], clipped[v], clipped[v + 1], target, options);
+            }
+        }
+        stats.triangles_rasterized = _triangles.size();
+
+        // binning, triangles keep submission order inside every tile
+        _tiles_x = (target.width + TILE_SIZE - 1) / TILE_SIZE;
+        _tiles_y = (target.height + TILE_SIZE - 1) / TILE_SIZE;
+        _bins.resize(_tiles_x * _tiles_y);
+        for(auto & bin : _bins) bin.clear();
+
+        for(uint32_t t = 0; t < (uint32_t)_triangles.size(); ++t)
+        {
+            const ScreenTriangle & triangle = _triangles[t];
+            for(std::size_t ty = triangle.min_y / TILE_SIZE; ty <= triangle.max_y / TILE_SIZE; ++ty)
+            {
+                for(std::size_t tx = triangle.min_x / TILE_SIZE; tx <= triangle.max_x / TILE_SIZE; ++tx)
+                {
+                    _bins[ty * _tiles_x + tx].emplace_back(t);
+                }
+            }
+        }
+
+        _active_tiles.clear();
+        for(std::size_t tile = 0; tile < _bins.size(); ++tile)
+        {
+            if(_bins[tile].empty() == false) _active_tiles.emplace_back(tile);
+        }
+
+        // fragment stage
+        std::atomic<uint64_t> fragments = 0;
+        runParallel(_active_tiles.size(), [this, &fragments, &target, &program, &options](std::size_t i)
+        {
+            fragments.fetch_add(rasterizeTile(_active_tiles[i], target, program, options), std::memory_order_relaxed);
+        });
+        stats.fragments_shaded = fragments.load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    void SoftwareRasterizer::setupTriangle(const ClipVertex & v0, const ClipVertex & v1, const ClipVertex & v2,
+        const SoftwareRenderTarget & target, const RenderOptions & options)
+    {
+        const std::array<const ClipVertex *, 3> vertices = {&v0, &v1, &v2};
+
+        // region limits coverage too, triangles are not clipped against side planes of clip volume
+        const RenderRegion region = options.region.value_or(RenderRegion{.width = (uint32_t)target.width, .height = (uint32_t)target.height});
+        const float viewport_x = (float)region.x, viewport_y = (float)region.y;
+        const float viewport_width = (float)region.width, viewport_height = (float)region.height;
+
+        ScreenTriangle triangle;
+        std::array<glm::vec2, 3> screen;
+        for(std::size_t v = 0; v < 3; ++v)
+        {
+            const glm::vec4 & position = vertices[v]->position;
+            if(position.w <= 0.0f)return;
+
+            const float inv_w = 1.0f / position.w;
+            const glm::vec3 ndc = glm::vec3(position) * inv_w;
+
+            // viewport transform, y axis points up like OpenGL window coordinates
+            screen[v] = glm::vec2(
+                viewport_x + (ndc.x * 0.5f + 0.5f) * viewport_width,
+                viewport_y + (ndc.y * 0.5f + 0.5f) * viewport_height);
+            triangle.depth[(glm::length_t)v] = ndc.z * 0.5f + 0.5f;
+            triangle.inv_w[(glm::length_t)v] = inv_w;
+
+            for(std::size_t j = 0; j < MAX_SOFTWARE_VARYINGS; ++j)
+            {
+                triangle.varyings[v][j] = vertices[v]->varyings[j];
+            }
+        }
+
+        // counter clockwise triangles have positive area, back faces and degenerate triangles are culled
+        const float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) - (screen[1].y - screen[0].y) * (screen[2].x - screen[0].x);
+        if(area <= 0.0f)return;
+
+        const float min_x = std::min({screen[0].x, screen[1].x, screen[2].x});
+        const float min_y = std::min({screen[0].y, screen[1].y, screen[2].y});
+        const float max_x = std::max({screen[0].x, screen[1].x, screen[2].x});
+        const float max_y = std::max({screen[0].y, screen[1].y, screen[2].y});
+
+        triangle.min_x = std::max((int)std::floor(min_x), (int)region.x);
+        triangle.min_y = std::max((int)std::floor(min_y), (int)region.y);
+        triangle.max_x = std::min({(int)std::ceil(max_x), (int)(region.x + region.width) - 1, (int)target.width - 1});
+        triangle.max_y = std::min({(int)std::ceil(max_y), (int)(region.y + region.height) - 1, (int)target.height - 1});
+        if(triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y)return;
+
+        // edge opposite to vertex i goes from vertex i+1 to vertex i+2
+        for(std::size_t i = 0; i < 3; ++i)
+        {
+            const glm::vec2 & from = screen[(i + 1) % 3];
+            const glm::vec2 & to = screen[(i + 2) % 3];
+
+            const glm::length_t e = (glm::length_t)i;
+            triangle.a[e] = (from.y - to.y) / area;
+            triangle.b[e] = (to.x - from.x) / area;
+            triangle.c[e] = (from.x * to.y - to.x * from.y) / area;
+
+            // interior lies left of every edge, top edges go left and left edges go down
+            triangle.inclusive[i] = (from.y == to.y && to.x < from.x) || (to.y < from.y);
+
+            triangle.edge_scale[e] = area / std::max(glm::length(to - from), 1e-6f);
+        }
+
+        triangle.depth_offset = 0.0f;
+        if(options.polygon_offset)
+        {
+            const float dzdx = glm::dot(triangle.a, triangle.depth);
+            const float dzdy = glm::dot(triangle.b, triangle.depth);
+            triangle.depth_offset = options.polygon_offset->factor * std::max(std::abs(dzdx), std::abs(dzdy)) +
+                options.polygon_offset->units * DEPTH_UNIT;
+        }
+
+        _triangles.emplace_back(std::move(triangle));
+    }
+
+    uint64_t SoftwareRasterizer::rasterizeTile(std::size_t tile, const SoftwareRenderTarget & target, const SoftwareProgram & program, const RenderOptions & options) const
+    {
+        const int tile_min_x = (int)((tile % _tiles_x) * TILE_SIZE);
+        const int tile_min_y = (int)((tile / _tiles_x) * TILE_SIZE);
+        const int tile_max_x = std::min(tile_min_x + (int)TILE_SIZE, (int)target.width) - 1;
+        const int tile_max_y = std::min(tile_min_y + (int)TILE_SIZE, (int)target.height) - 1;
+
+        const bool wireframe = options.mode == RenderMode::Wireframe;
+        const glm::vec4 lane_offset(0.5f, 1.5f, 2.5f, 3.5f);
+
+        uint64_t fragments = 0;
+        SoftwareVaryings varyings;
+        SoftwareFragmentOutput output;
+
+        for(const uint32_t t : _bins[tile])
+        {
+            const ScreenTriangle & triangle = _triangles[t];
+
+            const int min_x = std::max(tile_min_x, triangle.min_x);
+            const int min_y = std::max(tile_min_y, triangle.min_y);
+            const int max_x = std::min(tile_max_x, triangle.max_x);
+            const int max_y = std::min(tile_max_y, triangle.max_y);
+
+            for(int y = min_y; y <= max_y; ++y)
+            {
+                const glm::vec3 row = triangle.b * ((float)y + 0.5f) + triangle.c;
+
+                for(int x = min_x; x <= max_x; x += 4)
+                {
+                    // four pixels of span at once
+                    const glm::vec4 px = glm::vec4((float)x) + lane_offset;
+                    const glm::vec4 w0 = triangle.a.x * px + row.x;
+                    const glm::vec4 w1 = triangle.a.y * px + row.y;
+                    const glm::vec4 w2 = triangle.a.z * px + row.z;
+
+                    const glm::bvec4 in0 = triangle.inclusive[0] ? glm::greaterThanEqual(w0, glm::vec4(0.0f)) : glm::greaterThan(w0, glm::vec4(0.0f));
+                    const glm::bvec4 in1 = triangle.inclusive[1] ? glm::greaterThanEqual(w1, glm::vec4(0.0f)) : glm::greaterThan(w1, glm::vec4(0.0f));
+                    const glm::bvec4 in2 = triangle.inclusive[2] ? glm::greaterThanEqual(w2, glm::vec4(0.0f)) : glm::greaterThan(w2, glm::vec4(0.0f));
+
+                    const int lanes = std::min(4, max_x - x + 1);
+                    for(int lane = 0; lane < lanes; ++lane)
+                    {
+                        if(!(in0[lane] && in1[lane] && in2[lane]))continue;
+
+                        const glm::vec3 barycentric(w0[lane], w1[lane], w2[lane]);
+
+                        // keep only pixels closer than one pixel to any edge
+                        if(wireframe && glm::min(glm::min(barycentric.x * triangle.edge_scale.x, barycentric.y * triangle.edge_scale.y),
+                            barycentric.z * triangle.edge_scale.z) >= 1.0f)continue;
+
+                        const std::size_t sx = (std::size_t)(x + lane);
+                        const std::size_t sy = (std::size_t)y;
+
+                        const float depth = glm::dot(barycentric, triangle.depth) + triangle.depth_offset;
+                        if(depth < 0.0f || depth > 1.0f)continue;
+                        if(target.depth != nullptr && !(depth < target.depth->readDepth(sx, sy)))continue;
+
+                        if(program.fragment)
+                        {
+                            // perspective correct interpolation, barycentric weights divided by w and renormalized
+                            const glm::vec3 weights = barycentric * triangle.inv_w / glm::dot(barycentric, triangle.inv_w);
+                            for(std::size_t j = 0; j < MAX_SOFTWARE_VARYINGS; ++j)
+                            {
+                                varyings[j] = weights.x * triangle.varyings[0][j] + weights.y * triangle.varyings[1][j] + weights.z * triangle.varyings[2][j];
+                            }
+
+                            output.fill(glm::vec4(0.0f));
+                            if(program.fragment(varyings, output) == false)continue;
+                        }
+
+                        if(target.depth != nullptr) target.depth->writeDepth(sx, sy, depth);
+                        if(program.fragment)
+                        {
+                            for(std::size_t c = 0; c < target.colors_count; ++c)
+                            {
+                                target.colors[c]->write(sx, sy, output[c]);
+                            }
+                        }
+
+                        ++fragments;
+                    }
+                }
+            }
+        }
+
+        return fragments;
+    }
+}
@@ -0,0 +1,713 @@
+#include "software_renderer.hpp"
+
+#include <cstring>
+
+namespace velora::software
+{
+    SoftwareRenderer::RenderThreadContext::RenderThreadContext()
+    :   _io_context(1),
+        _work_guard(asio::make_work_guard(_io_context.get_executor())),
+        _strand(asio::make_strand(_io_context)),
+        _worker_thread(&SoftwareRenderer::RenderThreadContext::workerThread, this)
+    {}
+
+    SoftwareRenderer::RenderThreadContext::~RenderThreadContext()
+    {
+        join();
+    }
+
+    void SoftwareRenderer::RenderThreadContext::join()
+    {
+        if(_worker_thread.joinable() == false)return;
+
+        spdlog::debug(std::format("[software] [t:{}] Render thread waiting to finish ... ", std::this_thread::get_id()));
+
+        signalClose();
+        _worker_thread.join();
+
+        spdlog::debug(std::format("[software] [t:{}] Render thread finished", std::this_thread::get_id()));
+    }
+
+    const asio::strand<asio::io_context::executor_type> & SoftwareRenderer::RenderThreadContext::getStrand() const
+    {
+        return _strand;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::RenderThreadContext::ensureOnStrand()
+    {
+        co_return co_await _command_ring.enter(_io_context, _strand);
+    }
+
+    void SoftwareRenderer::RenderThreadContext::signalClose()
+    {
+        if(_work_guard.owns_work() == false)return;
+        spdlog::debug(std::format("[software] [t:{}] Render thread signaled to close", std::this_thread::get_id()));
+        _work_guard.reset();
+    }
+
+    bool SoftwareRenderer::RenderThreadContext::running() const
+    {
+        if(_work_guard.owns_work() == false)return false;
+        if(_worker_thread.joinable() == false)return false;
+        return true;
+    }
+
+    void SoftwareRenderer::RenderThreadContext::workerThread()
+    {
+        spdlog::debug(std::format("[software] [t:{}] Render thread started", std::this_thread::get_id()));
+
+        try
+        {
+            _command_ring.run(_io_context);
+        }
+        catch(const std::exception & e)
+        {
+            spdlog::error("[render] Software render thread exception: {}", e.what());
+        }
+
+        spdlog::debug(std::format("[software] [t:{}] Render thread ended", std::this_thread::get_id()));
+    }
+
+
+    asio::awaitable<SoftwareRenderer> SoftwareRenderer::asyncConstructor(Resolution viewport, unsigned int threads)
+    {
+        co_return SoftwareRenderer(viewport, threads);
+    }
+
+    SoftwareRenderer::SoftwareRenderer(Resolution viewport, unsigned int threads)
+    :   _render_context(std::make_unique<RenderThreadContext>()),
+        _rasterizer(std::make_unique<SoftwareRasterizer>(threads)),
+        _viewport_resolution(viewport),
+        _back_buffer(std::make_unique<SoftwareTexture>(viewport, TextureFormat::RGBA_32F)),
+        _front_buffer(std::make_unique<SoftwareTexture>(viewport, TextureFormat::RGBA_32F)),
+        _depth_buffer(std::make_unique<SoftwareTexture>(viewport, TextureFormat::Depth_32F))
+    {
+        _depth_buffer->clear(glm::vec4(1.0f));
+
+        spdlog::debug(std::format("[software] [t:{}] Software renderer created {}x{} with {} rasterizer threads", std::this_thread::get_id(),
+            _viewport_resolution.getWidth(), _viewport_resolution.getHeight(), _rasterizer->getThreadsCount()));
+    }
+
+    SoftwareRenderer::~SoftwareRenderer()
+    {
+        join();
+    }
+
+    void SoftwareRenderer::join()
+    {
+        if(_render_context == nullptr) return;
+
+        spdlog::debug(std::format("[software] [t:{}] Software renderer join", std::this_thread::get_id()));
+
+        asio::co_spawn(_render_context->getStrand(), close(), asio::detached);
+
+        // wait for render thread to finish
+        _render_context->join();
+    }
+
+    asio::awaitable<void> SoftwareRenderer::close()
+    {
+        if(good() == false)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        spdlog::debug(std::format("[software] [t:{}] close", std::this_thread::get_id()));
+
+        // stop accepting new rendering tasks
+        _render_context->signalClose();
+
+        _vertex_buffers.clear();
+        _shaders.clear();
+        _shader_storage_buffers.clear();
+        _uniform_buffers.clear();
+        _frame_buffer_objects.clear();
+        _textures.clear();
+
+        _vertex_buffer_names.clear();
+        _shader_names.clear();
+        _shader_storage_buffer_names.clear();
+        _uniform_buffer_names.clear();
+        _frame_buffer_object_names.clear();
+
+        co_return;
+    }
+
+    bool SoftwareRenderer::good() const
+    {
+        return _render_context != nullptr && _rasterizer != nullptr && _render_context->running();
+    }
+
+    std::optional<SoftwareRenderTarget> SoftwareRenderer::getRenderTarget(std::optional<std::size_t> fbo)
+    {
+        SoftwareRenderTarget target;
+
+        if(fbo.has_value() == false)
+        {
+            target.width = _back_buffer->getWidth();
+            target.height = _back_buffer->getHeight();
+            target.colors[0] = _back_buffer.get();
+            target.colors_count = 1;
+            target.depth = _depth_buffer.get();
+            return target;
+        }
+
+        auto fbo_it = _frame_buffer_objects.find(*fbo);
+        if(fbo_it == _frame_buffer_objects.end())
+        {
+            spdlog::error("Frame buffer object not found");
+            return std::nullopt;
+        }
+
+        const SoftwareFrameBufferObject & fbo_obj_ref = fbo_it->second;
+        target.width = fbo_obj_ref.resolution.getWidth();
+        target.height = fbo_obj_ref.resolution.getHeight();
+
+        for(const std::size_t attachment : fbo_obj_ref.color_attachments)
+        {
+            if(target.colors_count == MAX_SOFTWARE_COLOR_OUTPUTS)break;
+            target.colors[target.colors_count++] = &_textures.at(attachment);
+        }
+
+        if(fbo_obj_ref.depth_attachment)
+        {
+            target.depth = &_textures.at(*fbo_obj_ref.depth_attachment);
+        }
+
+        return target;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::clearScreen(glm::vec4 color, std::optional<std::size_t> fbo, std::optional<RenderRegion> region)
+    {
+        if(good() == false)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        const std::optional<SoftwareRenderTarget> target = getRenderTarget(fbo);
+        if(!target)co_return;
+
+        for(std::size_t c = 0; c < target->colors_count; ++c)
+        {
+            if(region)target->colors[c]->clear(color, *region);
+            else target->colors[c]->clear(color);
+        }
+        if(target->depth != nullptr)
+        {
+            if(region)target->depth->clear(glm::vec4(1.0f), *region);
+            else target->depth->clear(glm::vec4(1.0f));
+        }
+
+        _current_frame_stats.clears++;
+        _current_frame_stats.render_time += std::chrono::high_resolution_clock::now() - start;
+
+        co_return;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::copyFrameBufferObjectDepth(std::size_t source, std::size_t destination, std::optional<RenderRegion> region)
+    {
+        if(good() == false)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        const std::optional<SoftwareRenderTarget> source_target = getRenderTarget(source);
+        const std::optional<SoftwareRenderTarget> destination_target = getRenderTarget(destination);
+        if(!source_target || !destination_target)co_return;
+
+        if(source_target->depth == nullptr || destination_target->depth == nullptr ||
+            source_target->depth->getWidth() != destination_target->depth->getWidth() ||
+            source_target->depth->getHeight() != destination_target->depth->getHeight())
+        {
+            spdlog::error("Frame buffer objects depth attachments mismatch");
+            co_return;
+        }
+
+        destination_target->depth->copy(*source_target->depth, region.value_or(RenderRegion{
+            .width = (uint32_t)destination_target->depth->getWidth(),
+            .height = (uint32_t)destination_target->depth->getHeight()}));
+
+        _current_frame_stats.depth_copies++;
+        _current_frame_stats.render_time += std::chrono::high_resolution_clock::now() - start;
+
+        co_return;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::clearScreenRegions(glm::vec4 color, std::optional<std::size_t> fbo, std::span<const RenderRegion> regions)
+    {
+        if(good() == false || regions.empty())co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        const std::optional<SoftwareRenderTarget> target = getRenderTarget(fbo);
+        if(!target)co_return;
+
+        for(const RenderRegion & region : regions)
+        {
+            for(std::size_t c = 0; c < target->colors_count; ++c)
+            {
+                target->colors[c]->clear(color, region);
+            }
+            if(target->depth != nullptr)target->depth->clear(glm::vec4(1.0f), region);
+        }
+
+        _current_frame_stats.clears += (uint32_t)regions.size();
+        _current_frame_stats.render_time += std::chrono::high_resolution_clock::now() - start;
+
+        co_return;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::copyFrameBufferObjectDepthRegions(std::size_t source, std::size_t destination, std::span<const RenderRegion> regions)
+    {
+        if(good() == false || regions.empty())co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        const std::optional<SoftwareRenderTarget> source_target = getRenderTarget(source);
+        const std::optional<SoftwareRenderTarget> destination_target = getRenderTarget(destination);
+        if(!source_target || !destination_target)co_return;
+
+        if(source_target->depth == nullptr || destination_target->depth == nullptr ||
+            source_target->depth->getWidth() != destination_target->depth->getWidth() ||
+            source_target->depth->getHeight() != destination_target->depth->getHeight())
+        {
+            spdlog::error("Frame buffer objects depth attachments mismatch");
+            co_return;
+        }
+
+        for(const RenderRegion & region : regions)
+        {
+            destination_target->depth->copy(*source_target->depth, region);
+        }
+
+        _current_frame_stats.depth_copies += (uint32_t)regions.size();
+        _current_frame_stats.render_time += std::chrono::high_resolution_clock::now() - start;
+
+        co_return;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::render(
+            std::size_t vertex_buffer,
+            std::size_t shader,
+            ShaderInputs shader_inputs,
+            RenderOptions options,
+            std::optional<std::size_t> fbo)
+    {
+        co_await renderInstanced(vertex_buffer, shader, 1, std::move(shader_inputs), std::move(options), fbo);
+        co_return;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::renderInstanced(
+            std::size_t vertex_buffer,
+            std::size_t shader,
+            std::size_t instance_count,
+            ShaderInputs shader_inputs,
+            RenderOptions options,
+            std::optional<std::size_t> fbo)
+    {
+        if(good() == false)co_return;
+        if(instance_count == 0)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        drawInstances(vertex_buffer, shader, instance_count, 0, shader_inputs, options, fbo);
+
+        co_return;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::submit(std::span<const DrawItem> draws)
+    {
+        if(good() == false)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        for(const DrawItem & draw : draws)
+        {
+            if(draw.instance_count == 0)continue;
+            drawInstances(draw.vertex_buffer, draw.shader, draw.instance_count, draw.first_instance, draw.shader_inputs, draw.options, draw.fbo);
+        }
+
+        co_return;
+    }
+
+    void SoftwareRenderer::drawInstances(
+            std::size_t vertex_buffer,
+            std::size_t shader,
+            std::size_t instance_count,
+            uint32_t first_instance,
+            const ShaderInputs & shader_inputs,
+            const RenderOptions & options,
+            std::optional<std::size_t> fbo)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        const std::optional<SoftwareRenderTarget> target = getRenderTarget(fbo);
+        if(!target)return;
+
+        auto shader_it = _shaders.find(shader);
+        if(shader_it == _shaders.end()){
+            spdlog::warn("Rendering: Shader not found");
+            return;
+        }
+
+        auto vertex_buffer_it = _vertex_buffers.find(vertex_buffer);
+        if(vertex_buffer_it == _vertex_buffers.end()){
+            spdlog::warn("Rendering: Vertex buffer not found");
+            return;
+        }
+
+        // there is no instanced rasterization on CPU, every instance is drawn with its own program
+        // but command is still dispatched to render thread only once
+        for(std::size_t instance = 0; instance < instance_count; ++instance)
+        {
+            // resolve uniforms once per instance
+            const SoftwareProgram program = shader_it->second.shader(
+                SoftwareShaderResources(shader_inputs, _textures, _shader_storage_buffers, _uniform_buffers, (int)(first_instance + instance)));
+
+            const SoftwareRasterStats stats = _rasterizer->draw(*target, vertex_buffer_it->second.mesh, program, options);
+
+            _current_frame_stats.triangles_submitted += stats.triangles_submitted;
+            _current_frame_stats.triangles_rasterized += stats.triangles_rasterized;
+            _current_frame_stats.fragments_shaded += stats.fragments_shaded;
+        }
+
+        _current_frame_stats.draw_calls++;
+        _current_frame_stats.render_time += std::chrono::high_resolution_clock::now() - start;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::present()
+    {
+        if(good() == false)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        std::swap(_back_buffer, _front_buffer);
+
+        _frame_stats = _current_frame_stats;
+        _current_frame_stats = SoftwareFrameStats{.frame = _frame_stats.frame + 1};
+
+        co_return;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::updateViewport(Resolution resolution)
+    {
+        if(good() == false)co_return;
+
+        co_await _render_context->ensureOnStrand();
+
+        _viewport_resolution = resolution;
+
+        _back_buffer = std::make_unique<SoftwareTexture>(resolution, TextureFormat::RGBA_32F);
+        _front_buffer = std::make_unique<SoftwareTexture>(resolution, TextureFormat::RGBA_32F);
+        _depth_buffer = std::make_unique<SoftwareTexture>(resolution, TextureFormat::Depth_32F);
+        _depth_buffer->clear(glm::vec4(1.0f));
+
+        co_return;
+    }
+
+    Resolution SoftwareRenderer::getViewport() const
+    {
+        return _viewport_resolution;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::enableVSync()
+    {
+        // there is no display to synchronize with
+        co_return;
+    }
+
+    asio::awaitable<void> SoftwareRenderer::disableVSync()
+    {
+        co_return;
+    }
+
+    asio::awaitable<std::optional<std::size_t>> SoftwareRenderer::constructVertexBuffer(std::string name, const Mesh & mesh)
+    {
+        if(good() == false)co_return std::nullopt;
+
+        co_await _render_context->ensureOnStrand();
+
+        co_return emplaceObject(_vertex_buffers, _vertex_buffer_names, name,
+            SoftwareVertexBuffer{.name = name, .mesh = mesh, .bounds = calculateMeshBounds(mesh)});
+    }
+
+    asio::awaitable<bool> SoftwareRenderer::eraseVertexBuffer(std::size_t id)
+    {
+        if(good() == false)co_return false;
+
+        co_await _render_context->ensureOnStrand();
+
+        co_return eraseObject(_vertex_buffers, _vertex_buffer_names, id);
+    }
+
+    std::optional<std::size_t> SoftwareRenderer::getVertexBuffer(std::string name) const
+    {
+        return findObject(_vertex_buffers, _vertex_buffer_names, name);
+    }
+
+    std::optional<MeshBounds> SoftwareRenderer::getVertexBufferBounds(std::size_t id) const
+    {
+        auto it = _vertex_buffers.find(id);
+        if(it == _vertex_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] Vertex buffer {} does not exist", std::this_thread::get_id(), id));
+            return std::nullopt;
+        }
+        return it->second.bounds;
+    }
+
+    std::optional<std::size_t> SoftwareRenderer::getVertexBufferElementCount(std::size_t id) const
+    {
+        auto it = _vertex_buffers.find(id);
+        if(it == _vertex_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] Vertex buffer {} does not exist", std::this_thread::get_id(), id));
+            return std::nullopt;
+        }
+        return it->second.mesh.indices.size();
+    }
+
+    asio::awaitable<std::optional<std::size_t>> SoftwareRenderer::constructShader(std::string name, std::vector<std::string> vertex_code)
+    {
+        if(good() == false)co_return std::nullopt;
+
+        co_await _render_context->ensureOnStrand();
+
+        // GLSL code is not compiled, shader is picked by name
+        std::optional<SoftwareShader> shader = findSoftwareShader(name);
+        if(!shader)
+        {
+            spdlog::warn(std::format("[software] [t:{}] No software shader registered for {}", std::this_thread::get_id(), name));
+            co_return std::nullopt;
+        }
+
+        co_return emplaceObject(_shaders, _shader_names, name,
+            SoftwareShaderProgram{.name = name, .shader = std::move(*shader)});
+    }
+
+    asio::awaitable<std::optional<std::size_t>> SoftwareRenderer::constructShader(std::string name, std::vector<std::string> vertex_code, std::vector<std::string> fragment_code)
+    {
+        co_return co_await constructShader(std::move(name), std::move(vertex_code));
+    }
+
+    asio::awaitable<bool> SoftwareRenderer::eraseShader(std::size_t id)
+    {
+        if(good() == false)co_return false;
+
+        co_await _render_context->ensureOnStrand();
+
+        co_return eraseObject(_shaders, _shader_names, id);
+    }
+
+    std::optional<std::size_t> SoftwareRenderer::getShader(std::string name) const
+    {
+        return findObject(_shaders, _shader_names, name);
+    }
+
+    asio::awaitable<std::optional<std::size_t>> SoftwareRenderer::constructShaderStorageBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data)
+    {
+        if(good() == false)co_return std::nullopt;
+
+        co_await _render_context->ensureOnStrand();
+
+        SoftwareShaderStorageBuffer buffer{.name = name, .binding_point = binding_point, .data = std::vector<std::byte>(size)};
+        if(data != nullptr && size > 0)
+        {
+            std::memcpy(buffer.data.data(), data, size);
+        }
+
+        co_return emplaceObject(_shader_storage_buffers, _shader_storage_buffer_names, name, std::move(buffer));
+    }
+
+    asio::awaitable<bool> SoftwareRenderer::eraseShaderStorageBuffer(std::size_t id)
+    {
+        if(good() == false)co_return false;
+
+        co_await _render_context->ensureOnStrand();
+
+        co_return eraseObject(_shader_storage_buffers, _shader_storage_buffer_names, id);
+    }
+
+    std::optional<std::size_t> SoftwareRenderer::getShaderStorageBuffer(std::string name) const
+    {
+        return findObject(_shader_storage_buffers, _shader_storage_buffer_names, name);
+    }
+
+    asio::awaitable<bool> SoftwareRenderer::updateShaderStorageBuffer(std::size_t id, const std::size_t size, const void * data)
+    {
+        if(good() == false)co_return false;
+
+        co_await _render_context->ensureOnStrand();
+
+        auto it = _shader_storage_buffers.find(id);
+        if(it == _shader_storage_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] Shader storage buffer {} does not exist", std::this_thread::get_id(), id));
+            co_return false;
+        }
+
+        it->second.data.resize(size);
+        if(data != nullptr && size > 0)
+        {
+            std::memcpy(it->second.data.data(), data, size);
+        }
+
+        co_return true;
+    }
+
+    asio::awaitable<std::optional<std::size_t>> SoftwareRenderer::constructUniformBuffer(std::string name, unsigned int binding_point, const std::size_t size, const void * data)
+    {
+        if(good() == false)co_return std::nullopt;
+
+        co_await _render_context->ensureOnStrand();
+
+        SoftwareUniformBuffer buffer{.name = name, .binding_point = binding_point, .data = std::vector<std::byte>(size)};
+        if(data != nullptr && size > 0)
+        {
+            std::memcpy(buffer.data.data(), data, size);
+        }
+
+        co_return emplaceObject(_uniform_buffers, _uniform_buffer_names, name, std::move(buffer));
+    }
+
+    asio::awaitable<bool> SoftwareRenderer::eraseUniformBuffer(std::size_t id)
+    {
+        if(good() == false)co_return false;
+
+        co_await _render_context->ensureOnStrand();
+
+        co_return eraseObject(_uniform_buffers, _uniform_buffer_names, id);
+    }
+
+    std::optional<std::size_t> SoftwareRenderer::getUniformBuffer(std::string name) const
+    {
+        return findObject(_uniform_buffers, _uniform_buffer_names, name);
+    }
+
+    asio::awaitable<bool> SoftwareRenderer::updateUniformBuffer(std::size_t id, const std::size_t size, const void * data)
+    {
+        if(good() == false)co_return false;
+
+        co_await _render_context->ensureOnStrand();
+
+        auto it = _uniform_buffers.find(id);
+        if(it == _uniform_buffers.end())
+        {
+            spdlog::warn(std::format("[t:{}] Uniform buffer {} does not exist", std::this_thread::get_id(), id));
+            co_return false;
+        }
+
+        it->second.data.resize(size);
+        if(data != nullptr && size > 0)
+        {
+            std::memcpy(it->second.data.data(), data, size);
+        }
+
+        co_return true;
+    }
+
+    asio::awaitable<std::optional<std::size_t>> SoftwareRenderer::constructFrameBufferObject(std::string name, Resolution resolution, std::initializer_list<FBOAttachment> attachments)
+    {
+        if(good() == false)co_return std::nullopt;
+
+        co_await _render_context->ensureOnStrand();
+
+        SoftwareFrameBufferObject fbo{.name = name, .resolution = resolution};
+
+        for(const auto & att : attachments)
+        {
+            const std::size_t id = _next_id++;
+            SoftwareTexture & texture = _textures.try_emplace(id, resolution, att.format).first->second;
+            fbo.attachments.emplace_back(id);
+
+            if(att.point == FBOAttachment::Point::Color)
+            {
+                fbo.color_attachments.emplace_back(id);
+            }
+            else if(att.point == FBOAttachment::Point::Depth)
+            {
+                texture.clear(glm::vec4(1.0f));
+                fbo.depth_attachment = id;
+            }
+
+            // render buffers cannot be sampled
+            if(att.type == FBOAttachment::Type::Texture)
+            {
+                fbo.textures.emplace_back(id);
+            }
+        }
+
+        if(fbo.color_attachments.size() > MAX_SOFTWARE_COLOR_OUTPUTS)
+        {
+            spdlog::warn(std::format("[software] [t:{}] Frame buffer object {} has more than {} color attachments, rest is ignored",
+                std::this_thread::get_id(), name, MAX_SOFTWARE_COLOR_OUTPUTS));
+        }
+
+        std::vector<std::size_t> attachment_ids = fbo.attachments;
+        auto result = emplaceObject(_frame_buffer_objects, _frame_buffer_object_names, name, std::move(fbo));
+        if(!result)
+        {
+            for(const std::size_t id : attachment_ids) _textures.erase(id);
+        }
+
+        co_return result;
+    }
+
+    asio::awaitable<bool> SoftwareRenderer::eraseFrameBufferObject(std::size_t id)
+    {
+        if(good() == false)co_return false;
+
+        co_await _render_context->ensureOnStrand();
+
+        auto it = _frame_buffer_objects.find(id);
+        if(it != _frame_buffer_objects.end())
+        {
+            for(const std::size_t attachment : it->second.attachments) _textures.erase(attachment);
+        }
+
+        co_return eraseObject(_frame_buffer_objects, _frame_buffer_object_names, id);
+    }
+
+    std::optional<std::size_t> SoftwareRenderer::getFrameBufferObject(std::string name) const
+    {
+        return findObject(_frame_buffer_objects, _frame_buffer_object_names, name);
+    }
+
+    std::vector<std::size_t> SoftwareRenderer::getFrameBufferObjectTextures(std::size_t id) const
+    {
+        auto it = _frame_buffer_objects.find(id);
+        if(it == _frame_buffer_objects.end())
+        {
+            spdlog::warn(std::format("[t:{}] Frame buffer object {} does not exist", std::this_thread::get_id(), id));
+            return {};
+        }
+        return it->second.textures;
+    }
+
+    uint64_t SoftwareRenderer::getObjectGeneration() const
+    {
+        return _object_generation->load(std::memory_order_acquire);
+    }
+
+    const SoftwareTexture & SoftwareRenderer::getFrontBuffer() const
+    {
+        return *_front_buffer;
+    }
+
+    const SoftwareTexture * SoftwareRenderer::getTexture(std::size_t id) const
+    {
+        auto it = _textures.find(id);
+        if(it == _textures.end())return nullptr;
+        return &it->second;
+    }
+
+    const SoftwareFrameStats & SoftwareRenderer::getFrameStats() const
+    {
+        return _frame_stats;
+    }
+}
@@ -0,0 +1,143 @@
+#include "software_shader.hpp"
+
+#include <mutex>
+
+namespace velora::software
+{
+    namespace
+    {
+        struct SoftwareShaderRegistry
+        {
+            std::mutex mutex;
+            absl::flat_hash_map<std::string, SoftwareShader> shaders = getBuiltinSoftwareShaders();
+        };
+
+        SoftwareShaderRegistry & getRegistry()
+        {
+            static SoftwareShaderRegistry registry;
+            return registry;
+        }
+    }
+
+    void registerSoftwareShader(std::string name, SoftwareShader shader)
+    {
+        SoftwareShaderRegistry & registry = getRegistry();
+        std::scoped_lock lock(registry.mutex);
+        registry.shaders.insert_or_assign(std::move(name), std::move(shader));
+    }
+
+    std::optional<SoftwareShader> findSoftwareShader(const std::string & name)
+    {
+        SoftwareShaderRegistry & registry = getRegistry();
+        std::scoped_lock lock(registry.mutex);
+
+        auto it = registry.shaders.find(name);
+        if(it == registry.shaders.end())return std::nullopt;
+        return it->second;
+    }
+
+    SoftwareShaderResources::SoftwareShaderResources(const ShaderInputs & inputs,
+            const absl::flat_hash_map<std::size_t, SoftwareTexture> & textures,
+            const absl::flat_hash_map<std::size_t, SoftwareShaderStorageBuffer> & storage_buffers,
+            const absl::flat_hash_map<std::size_t, SoftwareUniformBuffer> & uniform_buffers,
+            int instance_id)
+    :   _inputs(inputs),
+        _textures(textures),
+        _storage_buffers(storage_buffers),
+        _uniform_buffers(uniform_buffers),
+        _instance_id(instance_id)
+    {}
+
+    int SoftwareShaderResources::getInstanceID() const
+    {
+        return _instance_id;
+    }
+
+    bool SoftwareShaderResources::getBool(ShaderUniform uniform, bool fallback) const
+    {
+        return findOr(uniform, fallback);
+    }
+
+    int SoftwareShaderResources::getInt(ShaderUniform uniform, int fallback) const
+    {
+        return findOr(uniform, fallback);
+    }
+
+    float SoftwareShaderResources::getFloat(ShaderUniform uniform, float fallback) const
+    {
+        return findOr(uniform, fallback);
+    }
+
+    glm::vec2 SoftwareShaderResources::getVec2(ShaderUniform uniform, glm::vec2 fallback) const
+    {
+        return findOr(uniform, fallback);
+    }
+
+    glm::vec3 SoftwareShaderResources::getVec3(ShaderUniform uniform, glm::vec3 fallback) const
+    {
+        return findOr(uniform, fallback);
+    }
+
+    glm::vec4 SoftwareShaderResources::getVec4(ShaderUniform uniform, glm::vec4 fallback) const
+    {
+        return findOr(uniform, fallback);
+    }
+
+    glm::mat4 SoftwareShaderResources::getMat4(ShaderUniform uniform, glm::mat4 fallback) const
+    {
+        return findOr(uniform, fallback);
+    }
+
+    std::span<const glm::mat4> SoftwareShaderResources::getMat4Array(ShaderUniform uniform) const
+    {
+        return findOr(uniform, std::span<const glm::mat4>());
+    }
+
+    const SoftwareTexture * SoftwareShaderResources::getSampler(ShaderUniform uniform) const
+    {
+        const ShaderInputs::Sampler * sampler = _inputs.find<ShaderInputs::Sampler>(uniform);
+        if(sampler == nullptr)return nullptr;
+
+        auto texture_it = _textures.find(sampler->texture);
+        if(texture_it == _textures.end())return nullptr;
+        return &texture_it->second;
+    }
+
+    std::vector<const SoftwareTexture *> SoftwareShaderResources::getSamplerArray(ShaderUniform uniform) const
+    {
+        std::vector<const SoftwareTexture *> samplers;
+
+        const ShaderInputs::SamplerArray * sampler_array = _inputs.find<ShaderInputs::SamplerArray>(uniform);
+        if(sampler_array == nullptr)return samplers;
+
+        samplers.reserve(sampler_array->textures.size());
+        for(const std::size_t id : sampler_array->textures)
+        {
+            auto texture_it = _textures.find(id);
+            samplers.emplace_back(texture_it == _textures.end() ? nullptr : &texture_it->second);
+        }
+        return samplers;
+    }
+
+    std::span<const std::byte> SoftwareShaderResources::getStorageBuffer(unsigned int binding_point) const
+    {
+        for(const std::size_t id : _inputs.getStorageBuffers())
+        {
+            auto it = _storage_buffers.find(id);
+            if(it != _storage_buffers.end() && it->second.binding_point == binding_point)
+            {
+                return it->second.data;
+            }
+        }
+        return {};
+    }
+
+    std::span<const std::byte> SoftwareShaderResources::getUniformBuffer(unsigned int binding_point) const
+    {
+        for(const auto & [id, buffer] : _uniform_buffers)
+        {
+            if(buffer.binding_point == binding_point)return buffer.data;
+        }
+        return {};
+    }
+}
@@ -0,0 +1,234 @@
+#include "software_texture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <fstream>
+
+#include <spdlog/spdlog.h>
+
+namespace velora::software
+{
+    namespace
+    {
+        inline float quantizeUnsigned(float value, float max_value)
+        {
+            return std::round(std::clamp(value, 0.0f, max_value));
+        }
+
+        // rounds mantissa to 10 bits like half float storage, range is not clamped
+        inline float quantizeHalf(float value)
+        {
+            uint32_t bits = std::bit_cast<uint32_t>(value);
+            bits = (bits + 0x0000'0FFFu + ((bits >> 13) & 1u)) & 0xFFFF'E000u;
+            return std::bit_cast<float>(bits);
+        }
+
+        inline int wrapRepeat(float coord, std::size_t size)
+        {
+            const int texel = (int)std::floor(coord * (float)size);
+            const int wrapped = texel % (int)size;
+            return wrapped < 0 ? wrapped + (int)size : wrapped;
+        }
+    }
+
+    SoftwareTexture::SoftwareTexture(Resolution resolution, TextureFormat format)
+    :   _resolution(resolution),
+        _format(format),
+        _width(resolution.getWidth()),
+        _height(resolution.getHeight()),
+        _channels(getChannelsCount(format)),
+        _texels(resolution.getWidth() * resolution.getHeight() * getChannelsCount(format), 0.0f)
+    {}
+
+    uint8_t SoftwareTexture::getChannelsCount(TextureFormat format)
+    {
+        switch(format)
+        {
+            case TextureFormat::RGB_8 :
+            case TextureFormat::RGB_16 :
+            case TextureFormat::RGB_32 :
+            case TextureFormat::RGB_16F :
+            case TextureFormat::RGB_32F :
+                return 3;
+
+            case TextureFormat::RGBA_8 :
+            case TextureFormat::RGBA_16 :
+            case TextureFormat::RGBA_32 :
+            case TextureFormat::RGBA_16F :
+            case TextureFormat::RGBA_32F :
+                return 4;
+
+            case TextureFormat::Depth :
+            case TextureFormat::Depth_32F :
+            case TextureFormat::Stencil :
+                return 1;
+
+            default :
+                spdlog::warn("[software] Unknown texture format");
+                return 4;
+        }
+    }
+
+    float SoftwareTexture::quantize(float value) const
+    {
+        switch(_format)
+        {
+            // integer formats, same as GL_*UI used by OpenGL backend
+            case TextureFormat::RGB_8 :
+            case TextureFormat::RGBA_8 :
+            case TextureFormat::Stencil :
+                return quantizeUnsigned(value, 255.0f);
+            case TextureFormat::RGB_16 :
+            case TextureFormat::RGBA_16 :
+                return quantizeUnsigned(value, 65535.0f);
+            case TextureFormat::RGB_32 :
+            case TextureFormat::RGBA_32 :
+                return quantizeUnsigned(value, 4294967295.0f);
+
+            case TextureFormat::RGB_16F :
+            case TextureFormat::RGBA_16F :
+                return quantizeHalf(value);
+
+            // 24 bit normalized depth
+            case TextureFormat::Depth :
+                return std::round(std::clamp(value, 0.0f, 1.0f) * 16777215.0f) / 16777215.0f;
+            case TextureFormat::Depth_32F :
+                return std::clamp(value, 0.0f, 1.0f);
+
+            default :
+                return value;
+        }
+    }
+
+    Resolution SoftwareTexture::getResolution() const
+    {
+        return _resolution;
+    }
+
+    TextureFormat SoftwareTexture::getFormat() const
+    {
+        return _format;
+    }
+
+    std::size_t SoftwareTexture::getWidth() const
+    {
+        return _width;
+    }
+
+    std::size_t SoftwareTexture::getHeight() const
+    {
+        return _height;
+    }
+
+    bool SoftwareTexture::isDepth() const
+    {
+        return _format == TextureFormat::Depth || _format == TextureFormat::Depth_32F;
+    }
+
+    void SoftwareTexture::clear(glm::vec4 value)
+    {
+        if(_texels.empty())return;
+
+        for(uint8_t c = 0; c < _channels; ++c)
+        {
+            _texels[c] = quantize(value[c]);
+        }
+
+        for(std::size_t i = _channels; i < _texels.size(); i += _channels)
+        {
+            std::copy_n(_texels.begin(), _channels, _texels.begin() + i);
+        }
+    }
+
+    void SoftwareTexture::clear(glm::vec4 value, const RenderRegion & region)
+    {
+        const std::size_t min_x = std::min<std::size_t>(region.x, _width);
+        const std::size_t min_y = std::min<std::size_t>(region.y, _height);
+        const std::size_t max_x = std::min<std::size_t>((std::size_t)region.x + region.width, _width);
+        const std::size_t max_y = std::min<std::size_t>((std::size_t)region.y + region.height, _height);
+        if(min_x >= max_x || min_y >= max_y)return;
+
+        std::array<float, 4> texel{};
+        for(uint8_t c = 0; c < _channels; ++c)
+        {
+            texel[c] = quantize(value[c]);
+        }
+
+        for(std::size_t y = min_y; y < max_y; ++y)
+        {
+            for(std::size_t x = min_x; x < max_x; ++x)
+            {
+                std::copy_n(texel.begin(), _channels, _texels.begin() + (y * _width + x) * _channels);
+            }
+        }
+    }
+
+    void SoftwareTexture::copy(const SoftwareTexture & source, const RenderRegion & region)
+    {
+        if(source._width != _width || source._height != _height || source.getFormat() != getFormat())return;
+
+        const std::size_t min_x = std::min<std::size_t>(region.x, _width);
+        const std::size_t min_y = std::min<std::size_t>(region.y, _height);
+        const std::size_t max_x = std::min<std::size_t>((std::size_t)region.x + region.width, _width);
+        const std::size_t max_y = std::min<std::size_t>((std::size_t)region.y + region.height, _height);
+        if(min_x >= max_x || min_y >= max_y)return;
+
+        // rows are contiguous, texels are already quantized to the same format
+        for(std::size_t y = min_y; y < max_y; ++y)
+        {
+            const std::size_t begin = (y * _width + min_x) * _channels;
+            std::copy_n(source._texels.begin() + begin, (max_x - min_x) * _channels, _texels.begin() + begin);
+        }
+    }
+
+    glm::vec4 SoftwareTexture::sample(glm::vec2 uv) const
+    {
+        if(_texels.empty())return glm::vec4(0.0f);
+
+        return read(wrapRepeat(uv.x, _width), wrapRepeat(uv.y, _height));
+    }
+
+    float SoftwareTexture::sampleCompare(glm::vec3 coords) const
+    {
+        if(_texels.empty())return 1.0f;
+
+        const float depth = readDepth(wrapRepeat(coords.x, _width), wrapRepeat(coords.y, _height));
+        return coords.z < depth ? 1.0f : 0.0f;
+    }
+
+    bool SoftwareTexture::savePPM(const std::filesystem::path & path) const
+    {
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!out.is_open())
+        {
+            spdlog::error("Failed to open software texture dump file: {}", path.string());
+            return false;
+        }
+
+        // integer formats already hold 0-255 range, everything else is normalized
+        const bool normalized = _format != TextureFormat::RGB_8 && _format != TextureFormat::RGBA_8;
+
+        out << "P6\n" << _width << " " << _height << "\n255\n";
+
+        std::vector<uint8_t> row(_width * 3);
+        for(std::size_t y = _height; y-- > 0;)
+        {
+            for(std::size_t x = 0; x < _width; ++x)
+            {
+                glm::vec4 texel = read(x, y);
+                if(_channels == 1) texel = glm::vec4(texel.r, texel.r, texel.r, 1.0f);
+                if(normalized) texel *= 255.0f;
+
+                for(std::size_t c = 0; c < 3; ++c)
+                {
+                    row[x * 3 + c] = (uint8_t)std::clamp(texel[(glm::length_t)c], 0.0f, 255.0f);
+                }
+            }
+            out.write((const char *)row.data(), (std::streamsize)row.size());
+        }
+
+        return true;
+    }
+}
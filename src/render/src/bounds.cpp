@@ -0,0 +1,76 @@
+#include "bounds.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace velora
+{
+    glm::vec3 BoundingBox::getCenter() const
+    {
+        return (min + max) * 0.5f;
+    }
+
+    glm::vec3 BoundingBox::getExtents() const
+    {
+        return (max - min) * 0.5f;
+    }
+
+    MeshBounds calculateMeshBounds(const std::vector<Vertex> & vertices)
+    {
+        if(vertices.empty())return MeshBounds{};
+
+        BoundingBox box{.min = vertices.front().position, .max = vertices.front().position};
+        for(const Vertex & vertex : vertices)
+        {
+            box.min = glm::min(box.min, vertex.position);
+            box.max = glm::max(box.max, vertex.position);
+        }
+
+        // farthest vertex from box center, tighter than half diagonal for round meshes
+        const glm::vec3 center = box.getCenter();
+        float radius_squared = 0.0f;
+        for(const Vertex & vertex : vertices)
+        {
+            const glm::vec3 delta = vertex.position - center;
+            radius_squared = std::max(radius_squared, glm::dot(delta, delta));
+        }
+
+        return MeshBounds{
+            .box = box,
+            .sphere = BoundingSphere{.center = center, .radius = std::sqrt(radius_squared)}
+        };
+    }
+
+    MeshBounds calculateMeshBounds(const Mesh & mesh)
+    {
+        return calculateMeshBounds(mesh.vertices);
+    }
+
+    BoundingBox transformBoundingBox(const BoundingBox & box, const glm::mat4 & model)
+    {
+        // center is transformed as point, extents by absolute value of linear part
+        const glm::vec3 center = glm::vec3(model * glm::vec4(box.getCenter(), 1.0f));
+        const glm::vec3 extents = box.getExtents();
+
+        glm::vec3 world_extents(0.0f);
+        for(int column = 0; column < 3; ++column)
+        {
+            world_extents += glm::abs(glm::vec3(model[column])) * extents[column];
+        }
+
+        return BoundingBox{.min = center - world_extents, .max = center + world_extents};
+    }
+
+    BoundingSphere transformBoundingSphere(const BoundingSphere & sphere, const glm::mat4 & model)
+    {
+        const float scale_squared = std::max({
+            glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+            glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+            glm::dot(glm::vec3(model[2]), glm::vec3(model[2]))});
+
+        return BoundingSphere{
+            .center = glm::vec3(model * glm::vec4(sphere.center, 1.0f)),
+            .radius = sphere.radius * std::sqrt(scale_squared)
+        };
+    }
+}
@@ -0,0 +1,140 @@
+#include "frustum_culler.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #define VELORA_FRUSTUM_CULLER_SSE
+    #include <emmintrin.h>
+#endif
+
+namespace velora
+{
+    Frustum Frustum::fromViewProjection(const glm::mat4 & view_projection)
+    {
+        // rows of column major matrix
+        const glm::mat4 rows = glm::transpose(view_projection);
+
+        Frustum frustum;
+        frustum.planes[Left] = rows[3] + rows[0];
+        frustum.planes[Right] = rows[3] - rows[0];
+        frustum.planes[Bottom] = rows[3] + rows[1];
+        frustum.planes[Top] = rows[3] - rows[1];
+        frustum.planes[Near] = rows[3] + rows[2];
+        frustum.planes[Far] = rows[3] - rows[2];
+
+        for(glm::vec4 & plane : frustum.planes)
+        {
+            const float length = glm::length(glm::vec3(plane));
+            if(length > 0.0f)plane /= length;
+        }
+        return frustum;
+    }
+
+    bool Frustum::intersects(const BoundingSphere & sphere) const
+    {
+        for(const glm::vec4 & plane : planes)
+        {
+            if(glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)return false;
+        }
+        return true;
+    }
+
+    bool Frustum::intersects(const BoundingBox & box) const
+    {
+        const glm::vec3 center = box.getCenter();
+        const glm::vec3 extents = box.getExtents();
+
+        for(const glm::vec4 & plane : planes)
+        {
+            // projected radius of box onto plane normal
+            const float radius = glm::dot(extents, glm::abs(glm::vec3(plane)));
+            if(glm::dot(glm::vec3(plane), center) + plane.w < -radius)return false;
+        }
+        return true;
+    }
+
+    void FrustumCuller::reserve(std::size_t size)
+    {
+        _x.reserve(size);
+        _y.reserve(size);
+        _z.reserve(size);
+        _radius.reserve(size);
+    }
+
+    void FrustumCuller::clear()
+    {
+        _x.clear();
+        _y.clear();
+        _z.clear();
+        _radius.clear();
+    }
+
+    uint32_t FrustumCuller::add(const BoundingSphere & sphere)
+    {
+        _x.emplace_back(sphere.center.x);
+        _y.emplace_back(sphere.center.y);
+        _z.emplace_back(sphere.center.z);
+        _radius.emplace_back(sphere.radius);
+        return (uint32_t)(_x.size() - 1);
+    }
+
+    std::size_t FrustumCuller::size() const
+    {
+        return _x.size();
+    }
+
+    FrustumCuller::Stats FrustumCuller::cull(const Frustum & frustum, std::vector<uint32_t> & visible) const
+    {
+        visible.clear();
+
+        const std::size_t count = size();
+        std::size_t i = 0;
+
+        #ifdef VELORA_FRUSTUM_CULLER_SSE
+        // plane components broadcast once, reused for every batch
+        __m128 nx[Frustum::Plane::Count], ny[Frustum::Plane::Count], nz[Frustum::Plane::Count], nw[Frustum::Plane::Count];
+        for(std::size_t p = 0; p < Frustum::Plane::Count; ++p)
+        {
+            nx[p] = _mm_set1_ps(frustum.planes[p].x);
+            ny[p] = _mm_set1_ps(frustum.planes[p].y);
+            nz[p] = _mm_set1_ps(frustum.planes[p].z);
+            nw[p] = _mm_set1_ps(frustum.planes[p].w);
+        }
+
+        for(; i + 4 <= count; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(_x.data() + i);
+            const __m128 y = _mm_loadu_ps(_y.data() + i);
+            const __m128 z = _mm_loadu_ps(_z.data() + i);
+            const __m128 negative_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(_radius.data() + i));
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for(std::size_t p = 0; p < Frustum::Plane::Count; ++p)
+            {
+                const __m128 distance = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(nx[p], x), _mm_mul_ps(ny[p], y)),
+                    _mm_add_ps(_mm_mul_ps(nz[p], z), nw[p]));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negative_radius));
+            }
+
+            // one bit per sphere of batch, set when sphere is inside of all planes
+            const int mask = _mm_movemask_ps(inside);
+            if(mask == 0)continue;
+            for(int lane = 0; lane < 4; ++lane)
+            {
+                if(mask & (1 << lane))visible.emplace_back((uint32_t)(i + lane));
+            }
+        }
+        #endif
+
+        // remainder of last batch, or all spheres without SSE
+        for(; i < count; ++i)
+        {
+            const BoundingSphere sphere{.center = glm::vec3(_x[i], _y[i], _z[i]), .radius = _radius[i]};
+            if(frustum.intersects(sphere))visible.emplace_back((uint32_t)i);
+        }
+
+        return Stats{
+            .visible = (uint32_t)visible.size(),
+            .culled = (uint32_t)(count - visible.size())
+        };
+    }
+}
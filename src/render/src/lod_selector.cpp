@@ -0,0 +1,64 @@
+#include "lod_selector.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace velora
+{
+    std::string getMeshLODName(const std::string & name, uint32_t level)
+    {
+        if(level == 0)return name;
+        return std::format("{}{}{}", name, MESH_LOD_SUFFIX, level);
+    }
+
+    LODSelector::LODSelector(Thresholds thresholds, float hysteresis)
+    :   _thresholds(thresholds),
+        _hysteresis(std::clamp(hysteresis, 0.0f, 0.9f))
+    {}
+
+    float LODSelector::projectedDiameter(const BoundingSphere & sphere, const glm::mat4 & view_projection, float viewport_height)
+    {
+        const float w = (view_projection * glm::vec4(sphere.center, 1.0f)).w;
+        if(w <= std::numeric_limits<float>::epsilon())return std::numeric_limits<float>::infinity();
+
+        // length of second row scales world units into clip space y, viewport spans 2 units of normalized y
+        const float scale_y = glm::length(glm::vec3(view_projection[0][1], view_projection[1][1], view_projection[2][1]));
+        return sphere.radius * scale_y / w * viewport_height;
+    }
+
+    uint32_t LODSelector::select(uint64_t key, float projected_diameter, uint32_t levels)
+    {
+        if(levels <= 1)return 0;
+
+        auto [it, inserted] = _selections.try_emplace(key);
+        Selection & selection = it->second;
+        if(selection.frame != _frame || inserted)_selected++;
+        selection.frame = _frame;
+
+        uint32_t level = std::min(selection.level, levels - 1);
+        if(inserted)
+        {
+            // first selection has nothing to stick to
+            level = 0;
+            while(level + 1 < levels && projected_diameter < _thresholds[level])level++;
+        }
+        else
+        {
+            while(level + 1 < levels && projected_diameter < _thresholds[level] * (1.0f - _hysteresis))level++;
+            while(level > 0 && projected_diameter > _thresholds[level - 1] * (1.0f + _hysteresis))level--;
+        }
+
+        selection.level = level;
+        return level;
+    }
+
+    void LODSelector::endFrame()
+    {
+        if(_selections.size() > std::max(_selected * 2, _MIN_KEPT_SELECTIONS))
+        {
+            absl::erase_if(_selections, [this](const auto & entry){ return entry.second.frame != _frame; });
+        }
+        _selected = 0;
+        _frame++;
+    }
+}
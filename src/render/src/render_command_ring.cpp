@@ -0,0 +1,138 @@
+#include "render_command_ring.hpp"
+
+#include <format>
+
+#include <spdlog/spdlog.h>
+
+namespace velora
+{
+    RenderCommandRing::RenderCommandRing()
+    :   _slots(std::make_unique<Slot[]>(CAPACITY))
+    {
+        // slot is free for producer of lap when its sequence equals position
+        for(std::size_t i = 0; i < CAPACITY; ++i)
+        {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RenderCommandRing::~RenderCommandRing()
+    {
+        // render thread is gone, pending commands are destroyed without running them
+        std::size_t discarded = 0;
+        while(empty() == false)
+        {
+            Slot & slot = _slots[_dequeue_position & _MASK];
+            slot.consume(slot.storage, false);
+            slot.sequence.store(_dequeue_position + CAPACITY, std::memory_order_release);
+            ++_dequeue_position;
+            ++discarded;
+        }
+
+        if(discarded > 0)
+        {
+            spdlog::warn(std::format("[render] [t:{}] render command ring destroyed with {} pending commands", std::this_thread::get_id(), discarded));
+        }
+    }
+
+    std::size_t RenderCommandRing::drain()
+    {
+        std::size_t executed = 0;
+        while(true)
+        {
+            Slot & slot = _slots[_dequeue_position & _MASK];
+            if(slot.sequence.load(std::memory_order_acquire) != _dequeue_position + 1)return executed;
+
+            slot.consume(slot.storage, true);
+
+            // free slot for producer of next lap
+            slot.sequence.store(_dequeue_position + CAPACITY, std::memory_order_release);
+            ++_dequeue_position;
+            ++executed;
+        }
+    }
+
+    bool RenderCommandRing::empty() const
+    {
+        const Slot & slot = _slots[_dequeue_position & _MASK];
+        return slot.sequence.load(std::memory_order_acquire) != _dequeue_position + 1;
+    }
+
+    void RenderCommandRing::run(asio::io_context & io_context)
+    {
+        _render_thread_id.store(std::this_thread::get_id(), std::memory_order_release);
+
+        while(true)
+        {
+            drain();
+
+            // handlers posted directly to io_context, eg. strand fallback and close
+            io_context.poll();
+            if(io_context.stopped())break;
+
+            if(empty() == false)continue;
+
+            // announce sleep, then check ring once more so push that raced with it is not missed
+            _sleeping.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(empty() == false)
+            {
+                _sleeping.store(false, std::memory_order_relaxed);
+                continue;
+            }
+
+            const std::size_t handlers = io_context.run_one();
+            _sleeping.store(false, std::memory_order_relaxed);
+
+            if(handlers == 0)break;
+        }
+
+        drain();
+
+        _render_thread_id.store(std::thread::id(), std::memory_order_release);
+    }
+
+    void RenderCommandRing::wake(asio::io_context & io_context)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(_sleeping.load(std::memory_order_seq_cst) == false)return;
+
+        // only one producer posts wake up handler
+        if(_sleeping.exchange(false, std::memory_order_acq_rel))
+        {
+            asio::post(io_context, [](){});
+        }
+    }
+
+    bool RenderCommandRing::isRenderThread() const
+    {
+        return _render_thread_id.load(std::memory_order_acquire) == std::this_thread::get_id();
+    }
+
+    asio::awaitable<void> RenderCommandRing::enter(asio::io_context & io_context, const asio::strand<asio::io_context::executor_type> & strand)
+    {
+        if(isRenderThread() || strand.running_in_this_thread())co_return;
+
+        co_await asio::async_initiate<const asio::use_awaitable_t<> &, void()>(
+            [this, &io_context, &strand](auto handler)
+            {
+                // handler is invoked directly by render thread, coroutine continues there
+                if(tryPush(std::move(handler)))
+                {
+                    wake(io_context);
+                    return;
+                }
+
+                _overflow_count.fetch_add(1, std::memory_order_relaxed);
+                asio::dispatch(strand, asio::bind_executor(strand, std::move(handler)));
+            },
+            asio::use_awaitable);
+
+        co_return;
+    }
+
+    uint64_t RenderCommandRing::getOverflowCount() const
+    {
+        return _overflow_count.load(std::memory_order_relaxed);
+    }
+}
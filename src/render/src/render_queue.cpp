@@ -0,0 +1,126 @@
+#include "render_queue.hpp"
+
+#include <array>
+
+namespace velora
+{
+    void RenderQueue::reserve(std::size_t size)
+    {
+        _items.reserve(size);
+        _push_indices.reserve(size);
+        _order.reserve(size);
+        _scratch.reserve(size);
+    }
+
+    void RenderQueue::push(DrawItem item)
+    {
+        const uint64_t key = item.key;
+
+        // keys usually arrive partially ordered, keep track so sort can be skipped
+        if(_order.empty() == false && key < _order.back().first) _sorted = false;
+
+        _order.emplace_back(key, (uint32_t)_items.size());
+        _push_indices.emplace_back((uint32_t)_items.size());
+        _items.emplace_back(std::move(item));
+    }
+
+    void RenderQueue::clear()
+    {
+        _items.clear();
+        _push_indices.clear();
+        _order.clear();
+        _sorted = true;
+    }
+
+    std::size_t RenderQueue::size() const
+    {
+        return _items.size();
+    }
+
+    bool RenderQueue::empty() const
+    {
+        return _items.empty();
+    }
+
+    void RenderQueue::sort()
+    {
+        if(_sorted) return;
+        _sorted = true;
+
+        const std::size_t count = _order.size();
+        _scratch.resize(count);
+
+        // histograms of all digits in single pass over keys
+        std::array<std::array<uint32_t, _RADIX_SIZE>, _RADIX_PASSES> histograms{};
+        for(const auto & [key, index] : _order)
+        {
+            for(uint32_t pass = 0; pass < _RADIX_PASSES; ++pass)
+            {
+                ++histograms[pass][(key >> (pass * _RADIX_BITS)) & (_RADIX_SIZE - 1)];
+            }
+        }
+
+        for(uint32_t pass = 0; pass < _RADIX_PASSES; ++pass)
+        {
+            auto & histogram = histograms[pass];
+            const uint32_t shift = pass * _RADIX_BITS;
+
+            // all keys share this digit, pass would not change order
+            if(histogram[(_order.front().first >> shift) & (_RADIX_SIZE - 1)] == count) continue;
+
+            // exclusive prefix sum gives first output position of every digit
+            uint32_t offset = 0;
+            for(auto & bucket : histogram)
+            {
+                const uint32_t bucket_count = bucket;
+                bucket = offset;
+                offset += bucket_count;
+            }
+
+            for(const auto & entry : _order)
+            {
+                _scratch[histogram[(entry.first >> shift) & (_RADIX_SIZE - 1)]++] = entry;
+            }
+
+            std::swap(_order, _scratch);
+        }
+
+        // move items into key order once, so they can be submitted as contiguous list
+        _scratch_items.clear();
+        _scratch_items.reserve(count);
+        _scratch_push_indices.resize(count);
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const uint32_t index = _order[i].second;
+            _scratch_items.emplace_back(std::move(_items[index]));
+            _scratch_push_indices[i] = _push_indices[index];
+            _order[i].second = (uint32_t)i;
+        }
+        std::swap(_items, _scratch_items);
+        std::swap(_push_indices, _scratch_push_indices);
+    }
+
+    const DrawItem & RenderQueue::operator[](std::size_t index) const
+    {
+        return _items[index];
+    }
+
+    std::size_t RenderQueue::getPushIndex(std::size_t index) const
+    {
+        return _push_indices[index];
+    }
+
+    std::span<const DrawItem> RenderQueue::getItems() const
+    {
+        return _items;
+    }
+
+    asio::awaitable<void> RenderQueue::submit(IRenderer & renderer)
+    {
+        sort();
+
+        co_await renderer.submit(_items);
+
+        co_return;
+    }
+}
@@ -0,0 +1,149 @@
+#include "shader.hpp"
+
+#include <deque>
+#include <mutex>
+#include <type_traits>
+
+#include <spdlog/spdlog.h>
+
+namespace velora
+{
+    namespace
+    {
+        struct ShaderUniformRegistry
+        {
+            std::mutex mutex;
+            // deque keeps names at stable address, `getName` returns references into it
+            std::deque<std::string> names;
+            absl::flat_hash_map<std::string, uint32_t> ids;
+        };
+
+        ShaderUniformRegistry & getRegistry()
+        {
+            static ShaderUniformRegistry registry;
+            return registry;
+        }
+
+        template<class T>
+        bool sameValue(const T & lhs, const T & rhs)
+        {
+            if constexpr (std::is_same_v<T, std::span<const glm::mat4>>)
+            {
+                return lhs.data() == rhs.data() && lhs.size() == rhs.size();
+            }
+            else if constexpr (std::is_same_v<T, ShaderInputs::Sampler>)
+            {
+                return lhs.texture == rhs.texture;
+            }
+            else if constexpr (std::is_same_v<T, ShaderInputs::SamplerArray>)
+            {
+                return lhs.textures.data() == rhs.textures.data() && lhs.textures.size() == rhs.textures.size();
+            }
+            else
+            {
+                return lhs == rhs;
+            }
+        }
+    }
+
+    ShaderUniform::ShaderUniform(std::string_view name)
+    {
+        ShaderUniformRegistry & registry = getRegistry();
+        std::scoped_lock lock(registry.mutex);
+
+        auto [it, inserted] = registry.ids.try_emplace(std::string(name), (uint32_t)registry.names.size());
+        if(inserted)
+        {
+            registry.names.emplace_back(name);
+        }
+        _id = it->second;
+    }
+
+    const std::string & ShaderUniform::getName() const
+    {
+        static const std::string invalid_name = "<invalid>";
+        if(_id == INVALID_ID)return invalid_name;
+
+        ShaderUniformRegistry & registry = getRegistry();
+        std::scoped_lock lock(registry.mutex);
+        return registry.names.at(_id);
+    }
+
+    std::size_t ShaderUniform::getCount()
+    {
+        ShaderUniformRegistry & registry = getRegistry();
+        std::scoped_lock lock(registry.mutex);
+        return registry.names.size();
+    }
+
+    ShaderInputs::ShaderInputs(std::initializer_list<Input> inputs, std::initializer_list<std::size_t> storage_buffers)
+    {
+        for(const Input & input : inputs)
+        {
+            set(input.uniform, input.value);
+        }
+
+        for(const std::size_t storage_buffer : storage_buffers)
+        {
+            addStorageBuffer(storage_buffer);
+        }
+    }
+
+    bool ShaderInputs::set(ShaderUniform uniform, Value value)
+    {
+        for(std::size_t i = 0; i < _inputs_count; ++i)
+        {
+            if(_inputs[i].uniform == uniform)
+            {
+                _inputs[i].value = std::move(value);
+                return true;
+            }
+        }
+
+        if(_inputs_count == MAX_UNIFORMS)
+        {
+            spdlog::error("Shader inputs are full, uniform {} dropped", uniform.getName());
+            return false;
+        }
+
+        _inputs[_inputs_count++] = Input{.uniform = uniform, .value = std::move(value)};
+        return true;
+    }
+
+    bool ShaderInputs::operator==(const ShaderInputs & other) const
+    {
+        if(_inputs_count != other._inputs_count || _storage_buffers_count != other._storage_buffers_count)return false;
+
+        for(std::size_t i = 0; i < _storage_buffers_count; ++i)
+        {
+            if(_storage_buffers[i] != other._storage_buffers[i])return false;
+        }
+
+        for(std::size_t i = 0; i < _inputs_count; ++i)
+        {
+            const Input & lhs = _inputs[i];
+            const Input & rhs = other._inputs[i];
+            if(lhs.uniform != rhs.uniform || lhs.value.index() != rhs.value.index())return false;
+
+            const bool same = std::visit([&rhs](const auto & value)
+            {
+                return sameValue(value, std::get<std::decay_t<decltype(value)>>(rhs.value));
+            }, lhs.value);
+            if(same == false)return false;
+        }
+
+        return true;
+    }
+
+    bool ShaderInputs::addStorageBuffer(std::size_t storage_buffer)
+    {
+        if(_storage_buffers_count == MAX_STORAGE_BUFFERS)
+        {
+            spdlog::error("Shader inputs are full, storage buffer {} dropped", storage_buffer);
+            return false;
+        }
+
+        _storage_buffers[_storage_buffers_count++] = storage_buffer;
+        return true;
+    }
+}
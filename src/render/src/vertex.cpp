@@ -1,9 +1,26 @@
 #include "vertex.hpp"
 
+#include <limits>
+#include <map>
+
+#include <glm/gtc/packing.hpp>
+
 namespace velora
 {
     namespace detail
     {
+        // grid of first simplified level, halved for every further level
+        constexpr static const unsigned int LOD_INITIAL_GRID_RESOLUTION = 32;
+        constexpr static const std::size_t LOD_MIN_TRIANGLES = 4;
+        // level is kept only when it has at most this share of triangles of previous level
+        constexpr static const float LOD_MAX_TRIANGLE_RATIO = 0.75f;
+
+        // largest rounding error of half float position, relative to longest extent of mesh
+        constexpr static const float COMPRESSED_POSITION_MAX_ERROR = 1.0f / 1024.0f;
+        // half float uvs above it lose more than thousandth of texture
+        constexpr static const float COMPRESSED_UV_MAX = 2.0f;
+        constexpr static const float HALF_FLOAT_MAX = 65504.0f;
+
         struct VertexHasher {
             /**
              * @brief Hashes a pair of uint32_t's to a uint64_t.
@@ -137,7 +154,9 @@ namespace velora
 
     const Mesh& getConePrefab(unsigned int segments)
     {
-        static Mesh cone;
+        // lower detail levels of cone are cones with less segments
+        static std::map<unsigned int, Mesh> cache;
+        auto& cone = cache[segments];
         if (!cone.vertices.empty()) return cone;
 
         const float radius = 0.5f;
@@ -214,7 +233,8 @@ namespace velora
 
     const Mesh& getCylinderPrefab(unsigned int segments)
     {
-        static Mesh cyl;
+        static std::map<unsigned int, Mesh> cache;
+        auto& cyl = cache[segments];
         if (!cyl.vertices.empty()) return cyl;
 
         float radius = 0.5f, height = 1.0f;
@@ -292,11 +312,10 @@ namespace velora
 
     const Mesh& getIcoSpherePrefab(unsigned int subdivisions, TriangleWinding winding, bool inward_normals)
     {
-        static std::vector<Mesh> cache;
-        if (cache.size() <= subdivisions) cache.resize(subdivisions + 1);
-        if (!cache[subdivisions].vertices.empty()) return cache[subdivisions];
-
+        // node based, references to meshes of other subdivisions stay valid when new one is added
+        static std::map<unsigned int, Mesh> cache;
         auto& mesh = cache[subdivisions];
+        if (!mesh.vertices.empty()) return mesh;
 
         // Golden ratio
         const float t = (1.0f + glm::sqrt(5.0f)) / 2.0f;
@@ -377,4 +396,180 @@ namespace velora
 
         return mesh;
     }
-}
\ No newline at end of file
+
+    Mesh simplifyMesh(const Mesh & mesh, unsigned int grid_resolution)
+    {
+        if (mesh.vertices.empty() || mesh.indices.size() < 3 || grid_resolution == 0) return mesh;
+
+        glm::vec3 min = mesh.vertices.front().position;
+        glm::vec3 max = min;
+        for (const Vertex & vertex : mesh.vertices)
+        {
+            min = glm::min(min, vertex.position);
+            max = glm::max(max, vertex.position);
+        }
+
+        // cubic cells sized by longest axis, flat meshes get a single layer of cells
+        const float cell_size = std::max({max.x - min.x, max.y - min.y, max.z - min.z}) / (float)grid_resolution;
+        if (cell_size <= 0.0f) return mesh;
+
+        struct Cluster
+        {
+            glm::vec3 position{0.0f};
+            glm::vec3 normal{0.0f};
+            glm::vec2 uv{0.0f};
+            float count = 0.0f;
+        };
+        std::vector<Cluster> clusters;
+        absl::flat_hash_map<uint64_t, uint32_t> cluster_of_cell;
+        std::vector<uint32_t> vertex_cluster(mesh.vertices.size());
+
+        for (std::size_t i = 0; i < mesh.vertices.size(); ++i)
+        {
+            const Vertex & vertex = mesh.vertices[i];
+            const glm::uvec3 cell = glm::uvec3(glm::clamp((vertex.position - min) / cell_size, glm::vec3(0.0f), glm::vec3((float)(grid_resolution - 1))));
+
+            // vertices of one cell facing different directions stay apart, so hard edges and thin walls survive
+            const glm::vec3 n = glm::abs(vertex.normal);
+            const int axis = (n.x >= n.y && n.x >= n.z) ? 0 : (n.y >= n.z ? 1 : 2);
+            const uint64_t facing = (uint64_t)(axis * 2 + (vertex.normal[axis] < 0.0f ? 1 : 0));
+
+            const uint64_t key = (uint64_t)cell.x | (uint64_t)cell.y << 20 | (uint64_t)cell.z << 40 | facing << 60;
+            auto [it, inserted] = cluster_of_cell.try_emplace(key, (uint32_t)clusters.size());
+            if (inserted) clusters.emplace_back();
+
+            Cluster & cluster = clusters[it->second];
+            cluster.position += vertex.position;
+            cluster.normal += vertex.normal;
+            cluster.uv += vertex.uv;
+            cluster.count += 1.0f;
+            vertex_cluster[i] = it->second;
+        }
+
+        Mesh simplified;
+        // cluster -> vertex of simplified mesh, clusters referenced only by collapsed triangles are dropped
+        std::vector<uint32_t> cluster_vertex(clusters.size(), std::numeric_limits<uint32_t>::max());
+        // triangles rotated to start at smallest index, winding is kept so two sided walls are not merged
+        absl::flat_hash_map<std::array<uint32_t, 3>, bool> triangles;
+
+        for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            std::array<uint32_t, 3> triangle = {
+                vertex_cluster[mesh.indices[i]],
+                vertex_cluster[mesh.indices[i + 1]],
+                vertex_cluster[mesh.indices[i + 2]]
+            };
+            if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) continue;
+
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            if (triangles.try_emplace(triangle, true).second == false) continue;
+
+            for (const uint32_t c : triangle)
+            {
+                if (cluster_vertex[c] == std::numeric_limits<uint32_t>::max())
+                {
+                    const Cluster & cluster = clusters[c];
+                    const glm::vec3 normal = cluster.normal / cluster.count;
+                    cluster_vertex[c] = (uint32_t)simplified.vertices.size();
+                    simplified.vertices.push_back({
+                        cluster.position / cluster.count,
+                        glm::length(normal) > 0.0f ? glm::normalize(normal) : normal,
+                        cluster.uv / cluster.count
+                    });
+                }
+                simplified.indices.push_back(cluster_vertex[c]);
+            }
+        }
+
+        return simplified;
+    }
+
+    std::vector<Mesh> generateLODChain(const Mesh & mesh, unsigned int max_levels)
+    {
+        std::vector<Mesh> chain;
+        if (max_levels == 0) return chain;
+        chain.push_back(mesh);
+
+        std::size_t previous_triangles = mesh.indices.size() / 3;
+        for (unsigned int resolution = detail::LOD_INITIAL_GRID_RESOLUTION; resolution >= 2 && chain.size() < max_levels; resolution /= 2)
+        {
+            // always from source mesh, so errors of levels do not add up
+            Mesh level = simplifyMesh(mesh, resolution);
+            const std::size_t triangles = level.indices.size() / 3;
+
+            // too coarse, every further level would be coarser still
+            if (triangles < detail::LOD_MIN_TRIANGLES) break;
+            // not worth a draw state of its own, try coarser grid
+            if ((float)triangles > (float)previous_triangles * detail::LOD_MAX_TRIANGLE_RATIO) continue;
+
+            previous_triangles = triangles;
+            chain.push_back(std::move(level));
+        }
+        return chain;
+    }
+
+    VertexFormat chooseVertexFormat(const std::vector<Vertex> & vertices)
+    {
+        if (vertices.empty()) return VertexFormat::Float;
+
+        glm::vec3 min = vertices.front().position;
+        glm::vec3 max = min;
+        float max_position = 0.0f;
+        float max_uv = 0.0f;
+        for (const Vertex & vertex : vertices)
+        {
+            min = glm::min(min, vertex.position);
+            max = glm::max(max, vertex.position);
+            const glm::vec3 position = glm::abs(vertex.position);
+            const glm::vec2 uv = glm::abs(vertex.uv);
+            max_position = std::max({max_position, position.x, position.y, position.z});
+            max_uv = std::max({max_uv, uv.x, uv.y});
+        }
+
+        const float extent = std::max({max.x - min.x, max.y - min.y, max.z - min.z});
+        if (max_position >= detail::HALF_FLOAT_MAX || max_uv > detail::COMPRESSED_UV_MAX) return VertexFormat::Float;
+
+        // half float keeps 11 significant bits, so rounding error is at most 2^-11 of value
+        const float position_error = max_position / 2048.0f;
+        if (position_error > extent * detail::COMPRESSED_POSITION_MAX_ERROR) return VertexFormat::Float;
+
+        return VertexFormat::Compressed;
+    }
+
+    IndexFormat chooseIndexFormat(std::size_t vertex_count)
+    {
+        return vertex_count <= (std::size_t)std::numeric_limits<uint16_t>::max() + 1 ? IndexFormat::UInt16 : IndexFormat::UInt32;
+    }
+
+    std::vector<CompressedVertex> compressVertices(const std::vector<Vertex> & vertices)
+    {
+        std::vector<CompressedVertex> compressed;
+        compressed.reserve(vertices.size());
+
+        for (const Vertex & vertex : vertices)
+        {
+            const glm::vec3 normal = glm::length(vertex.normal) > 0.0f ? glm::normalize(vertex.normal) : vertex.normal;
+            compressed.push_back(CompressedVertex{
+                .position = {
+                    glm::packHalf1x16(vertex.position.x),
+                    glm::packHalf1x16(vertex.position.y),
+                    glm::packHalf1x16(vertex.position.z)
+                },
+                .padding = 0,
+                .normal = glm::packSnorm3x10_1x2(glm::vec4(normal, 0.0f)),
+                .uv = {
+                    glm::packHalf1x16(vertex.uv.x),
+                    glm::packHalf1x16(vertex.uv.y)
+                }
+            });
+        }
+        return compressed;
+    }
+
+    std::vector<uint16_t> narrowIndices(const std::vector<unsigned int> & indices)
+    {
+        std::vector<uint16_t> narrowed(indices.size());
+        std::transform(indices.begin(), indices.end(), narrowed.begin(), [](unsigned int index){ return (uint16_t)index; });
+        return narrowed;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "native.hpp"
+#include "resolution.hpp"
+#include "process.hpp"
+
+#include <asio.hpp>
+#include <spdlog/spdlog.h>
+
+namespace velora::headless
+{
+    /**
+     * @brief Headless `IWindow` interface implementation, window without surface registered in `IProcess`
+     */
+    class HeadlessWindow
+    {
+        public:
+            ~HeadlessWindow();
+
+            HeadlessWindow(HeadlessWindow && other);
+
+            static asio::awaitable<HeadlessWindow> asyncConstructor(asio::io_context & io_context,
+                IProcess & process,
+                std::string name,
+                Resolution resolution
+                )
+            {
+                auto window_handle = co_await process.registerWindow(std::move(name), resolution);
+                co_return HeadlessWindow(io_context, process, window_handle, std::move(resolution));
+            }
+
+            bool good() const;
+
+            asio::awaitable<void> show();
+
+            asio::awaitable<void> hide();
+
+            asio::awaitable<void> close();
+            
+            const Resolution & getResolution() const;
+
+            native::window_handle getHandle() const;
+
+            // there is no surface to draw into, always returns nullptr
+            native::device_context acquireDeviceContext();
+
+            bool releaseDeviceContext(native::device_context device_context);
+
+            IProcess & getProcess();
+
+            bool isVisible() const;
+        
+        protected:
+
+            HeadlessWindow(asio::io_context & io_context, IProcess & process, native::window_handle window_handle, Resolution resolution);
+
+
+        private:
+            asio::io_context & _io_context;
+            asio::strand<asio::io_context::executor_type> _strand;
+            native::window_handle _window_handle;
+            IProcess & _process;
+
+            Resolution _resolution;
+            bool _visible;
+    };
+}
@@ -0,0 +1,101 @@
+#include "window_headless.hpp"
+
+namespace velora::headless
+{
+    HeadlessWindow::HeadlessWindow(asio::io_context & io_context, IProcess & process, native::window_handle window_handle, Resolution resolution)
+    :   _io_context(io_context),
+        _strand(asio::make_strand(io_context)),
+        _window_handle(window_handle),
+        _process(process),
+        _resolution(std::move(resolution)),
+        _visible(false)
+    {
+        spdlog::info("[window] Headless window created");
+    }
+
+    HeadlessWindow::HeadlessWindow(HeadlessWindow && other)
+    :   _io_context(other._io_context),
+        _strand(std::move(other._strand)),
+        _window_handle(other._window_handle),
+        _process(other._process),
+        _resolution(std::move(other._resolution)),
+        _visible(other._visible)
+    {
+        other._window_handle = nullptr;
+    }
+
+    HeadlessWindow::~HeadlessWindow()
+    {
+        assert(_window_handle == nullptr && "Headless window should be closed before destruction" );
+    }
+
+    IProcess & HeadlessWindow::getProcess()
+    {
+        return _process;
+    }
+
+    asio::awaitable<void> HeadlessWindow::show()
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        _visible = true;
+        co_return;
+    }
+
+    asio::awaitable<void> HeadlessWindow::hide()
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        _visible = false;
+        co_return;
+    }
+
+    bool HeadlessWindow::isVisible() const
+    {
+        return _visible;
+    }
+
+    native::window_handle HeadlessWindow::getHandle() const
+    {
+        return _window_handle;
+    }
+    
+    const Resolution & HeadlessWindow::getResolution() const
+    {
+        return _resolution;
+    }
+
+    bool HeadlessWindow::good() const
+    {
+        return _window_handle != nullptr;
+    }
+    
+    asio::awaitable<void> HeadlessWindow::close()
+    {
+        if(!_strand.running_in_this_thread()){
+            co_await asio::dispatch(asio::bind_executor(_strand, asio::use_awaitable));
+        }
+
+        if(_window_handle == nullptr)co_return;
+
+        auto handle = _window_handle;
+        _window_handle = nullptr;
+
+        co_await _process.unregisterWindow(handle);
+        co_return;
+    }
+
+    native::device_context HeadlessWindow::acquireDeviceContext()
+    {
+        return nullptr;
+    }
+
+    bool HeadlessWindow::releaseDeviceContext(native::device_context device_context)
+    {
+        return device_context == nullptr;
+    }
+}
@@ -0,0 +1,135 @@
+#include "unit_tests.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "fixed_step_loop.hpp"
+
+namespace velora::tests
+{
+    class FixedStepLoopTests : public UnitTest
+    {
+        protected:
+            constexpr static const std::chrono::duration<double> STEP = 20ms;
+
+            // counts calls and remembers deltas, loop runs while frames are below limit
+            struct Counters
+            {
+                uint64_t logic_calls = 0;
+                uint64_t wrong_deltas = 0;
+                uint64_t priority_calls = 0;
+                uint64_t max_frames = 0;
+                // wall time spent in each logic call, makes fast forward slower than real time
+                std::chrono::milliseconds logic_cost = 0ms;
+            };
+
+            static FixedStepLoop makeLoop(asio::io_context & io_context, Counters & counters)
+            {
+                return FixedStepLoop(io_context, STEP,
+                    [&counters]() -> bool
+                    {
+                        return counters.priority_calls < counters.max_frames;
+                    },
+                    [&counters](std::chrono::duration<double> delta) -> asio::awaitable<void>
+                    {
+                        counters.logic_calls++;
+                        if(delta != STEP)counters.wrong_deltas++;
+                        if(counters.logic_cost > 0ms)std::this_thread::sleep_for(counters.logic_cost);
+                        co_return;
+                    },
+                    [&counters](float) -> asio::awaitable<void>
+                    {
+                        counters.priority_calls++;
+                        co_return;
+                    },
+                    FixedStepLoop::Mode::Sequential);
+            }
+    };
+
+    TEST_F(FixedStepLoopTests, FastForwardRunsExactlyRequestedTicks)
+    {
+        asio::io_context io_context;
+        Counters counters{.max_frames = 1};
+        FixedStepLoop loop = makeLoop(io_context, counters);
+
+        FixedStepLoop::FastForwardReport report;
+        FixedStepLoop::FastForwardReport stopped_report;
+        asio::co_spawn(io_context, [&]() -> asio::awaitable<void>
+        {
+            report = co_await loop.fastForward(50);
+            // predicate is checked before every tick
+            stopped_report = co_await loop.fastForward(100, [&counters](){ return counters.logic_calls >= 60; });
+        }, asio::detached);
+        io_context.run();
+
+        EXPECT_EQ(report.ticks, 50);
+        EXPECT_EQ(report.simulated_time, STEP * 50);
+        EXPECT_EQ(stopped_report.ticks, 10);
+
+        EXPECT_EQ(counters.logic_calls, 60);
+        EXPECT_EQ(counters.wrong_deltas, 0);
+        EXPECT_EQ(loop.getTick(FixedStepLoop::PRIMARY_RATE), 60);
+        EXPECT_EQ(loop.getDroppedTicks(FixedStepLoop::PRIMARY_RATE), 0);
+        // priority never runs during fast forward
+        EXPECT_EQ(counters.priority_calls, 0);
+    }
+
+    TEST_F(FixedStepLoopTests, FastForwardRunsSlowerRatesAtTheirStep)
+    {
+        asio::io_context io_context;
+        Counters counters{.max_frames = 1};
+        FixedStepLoop loop = makeLoop(io_context, counters);
+
+        uint64_t slow_calls = 0;
+        uint64_t slow_wrong_deltas = 0;
+        const FixedStepLoop::RateID slow = loop.addRate(FixedStepLoop::RateConfig{
+            .name = "slow",
+            .step = STEP * 4,
+            .update = [&slow_calls, &slow_wrong_deltas](std::chrono::duration<double> delta) -> asio::awaitable<void>
+            {
+                slow_calls++;
+                if(delta != STEP * 4)slow_wrong_deltas++;
+                co_return;
+            }
+        });
+
+        asio::co_spawn(io_context, [&]() -> asio::awaitable<void>
+        {
+            co_await loop.fastForward(10);
+        }, asio::detached);
+        io_context.run();
+
+        EXPECT_EQ(counters.logic_calls, 10);
+        // leftover lag of slow rate is dropped when fast forward ends
+        EXPECT_EQ(slow_calls, 2);
+        EXPECT_EQ(slow_wrong_deltas, 0);
+        EXPECT_EQ(loop.getTick(slow), 2);
+    }
+
+    TEST_F(FixedStepLoopTests, NextFrameDoesNotReplayFastForwardTime)
+    {
+        asio::io_context io_context;
+        // fast forward takes 15 steps of wall time for 3 simulated steps
+        Counters counters{.max_frames = 2, .logic_cost = 100ms};
+        FixedStepLoop loop = makeLoop(io_context, counters);
+
+        FixedStepLoop::FastForwardReport report;
+        asio::co_spawn(io_context, [&]() -> asio::awaitable<void>
+        {
+            report = co_await loop.fastForward(3);
+            counters.logic_cost = 0ms;
+            co_await loop.run();
+        }, asio::detached);
+        io_context.run();
+
+        ASSERT_EQ(report.ticks, 3);
+        EXPECT_GE(report.wall_time, STEP * 15);
+        EXPECT_EQ(counters.priority_calls, 2);
+
+        // two back to back frames take far less than a step, slow machine may still fit one in
+        EXPECT_LE(loop.getTick(FixedStepLoop::PRIMARY_RATE), 4);
+        EXPECT_EQ(loop.getDroppedTicks(FixedStepLoop::PRIMARY_RATE), 0);
+        EXPECT_EQ(counters.wrong_deltas, 0);
+    }
+}
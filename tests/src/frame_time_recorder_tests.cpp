@@ -0,0 +1,188 @@
+#include "unit_tests.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "frame_time_recorder.hpp"
+
+namespace velora::tests
+{
+    class FrameTimeRecorderTests : public UnitTest
+    {
+        protected:
+            static std::chrono::duration<double> ns(uint64_t value)
+            {
+                return std::chrono::nanoseconds(value);
+            }
+
+            static uint64_t percentileNs(const FrameTimeRecorder & recorder, double percentile)
+            {
+                return (uint64_t)std::llround(recorder.getPercentile(percentile).count() * 1e9);
+            }
+
+            static std::string readFile(const std::filesystem::path & path)
+            {
+                std::ifstream in(path);
+                return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            }
+    };
+
+    TEST_F(FrameTimeRecorderTests, PercentilesOfEmptyRecorderAreZero)
+    {
+        FrameTimeRecorder recorder("empty");
+
+        EXPECT_EQ(recorder.getPercentile(50.0).count(), 0.0);
+        EXPECT_EQ(recorder.getSummary().samples, 0);
+        EXPECT_EQ(recorder.getSummary().max.count(), 0.0);
+    }
+
+    TEST_F(FrameTimeRecorderTests, PercentilesBelowFirstBucketBoundaryAreExact)
+    {
+        FrameTimeRecorder recorder("exact");
+        for(uint64_t value = 1; value <= 100; ++value)recorder.record(ns(value));
+
+        EXPECT_EQ(percentileNs(recorder, 0.0), 1);
+        EXPECT_EQ(percentileNs(recorder, 1.0), 1);
+        EXPECT_EQ(percentileNs(recorder, 50.0), 50);
+        EXPECT_EQ(percentileNs(recorder, 50.5), 51);
+        EXPECT_EQ(percentileNs(recorder, 99.0), 99);
+        EXPECT_EQ(percentileNs(recorder, 100.0), 100);
+    }
+
+    TEST_F(FrameTimeRecorderTests, PercentilesReportUpperBoundOfBucket)
+    {
+        // 127 is last exact value, 128 and 129 share first two wide bucket
+        {
+            FrameTimeRecorder recorder("first boundary");
+            recorder.record(ns(127));
+            recorder.record(ns(128));
+            recorder.record(ns(200));
+
+            EXPECT_EQ(percentileNs(recorder, 33.0), 127);
+            EXPECT_EQ(percentileNs(recorder, 66.0), 129);
+            EXPECT_EQ(percentileNs(recorder, 100.0), 200);
+        }
+
+        // 255 closes last bucket of its power of two, 256 opens four wide bucket
+        {
+            FrameTimeRecorder recorder("power of two boundary");
+            recorder.record(ns(254));
+            recorder.record(ns(256));
+            recorder.record(ns(1000));
+
+            EXPECT_EQ(percentileNs(recorder, 33.0), 255);
+            EXPECT_EQ(percentileNs(recorder, 66.0), 259);
+        }
+    }
+
+    TEST_F(FrameTimeRecorderTests, PercentileNeverExceedsLargestSample)
+    {
+        FrameTimeRecorder recorder("max");
+        recorder.record(ns(128));
+        // bucket of 256 ends at 259
+        recorder.record(ns(256));
+
+        EXPECT_EQ(percentileNs(recorder, 50.0), 129);
+        EXPECT_EQ(percentileNs(recorder, 100.0), 256);
+        EXPECT_EQ(recorder.getSummary().max, recorder.getPercentile(100.0));
+    }
+
+    TEST_F(FrameTimeRecorderTests, PercentilesStayWithinBucketPrecision)
+    {
+        FrameTimeRecorder recorder("precision");
+
+        std::mt19937_64 random(11);
+        // frame times between 100us and 200ms
+        std::lognormal_distribution<double> distribution(std::log(8'000'000.0), 1.0);
+
+        std::vector<uint64_t> samples(10'000);
+        for(auto & sample : samples)
+        {
+            const std::chrono::duration<double> duration = ns(std::clamp<uint64_t>((uint64_t)distribution(random), 100'000, 200'000'000));
+            recorder.record(duration);
+            // as recorder stores it, round trip through double seconds may lose nanosecond
+            sample = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        }
+        std::sort(samples.begin(), samples.end());
+
+        for(const double percentile : {1.0, 10.0, 50.0, 90.0, 99.0, 99.9})
+        {
+            const std::size_t rank = (std::size_t)std::ceil(percentile / 100.0 * (double)samples.size());
+            const uint64_t exact = samples[rank - 1];
+            const uint64_t reported = percentileNs(recorder, percentile);
+
+            // upper bound of bucket, bucket is at most 1/64 of its values wide
+            EXPECT_GE(reported, exact) << "p" << percentile;
+            EXPECT_LE((double)(reported - exact), (double)exact / 64.0) << "p" << percentile;
+        }
+    }
+
+    TEST_F(FrameTimeRecorderTests, ClampsOutOfRangeSamplesAndPercentiles)
+    {
+        FrameTimeRecorder recorder("overflow");
+        recorder.record(-5ms);
+        recorder.record(10ms);
+        // centuries long sample lands in one of last buckets
+        const uint64_t huge = 1ull << 62;
+        recorder.record(ns(huge));
+
+        EXPECT_EQ(percentileNs(recorder, -10.0), 0);
+        EXPECT_EQ(percentileNs(recorder, 0.0), 0);
+        EXPECT_EQ(recorder.getPercentile(150.0), recorder.getPercentile(100.0));
+
+        // relative to sample, conversion through double seconds is not exact for such value
+        const double largest = recorder.getPercentile(100.0).count() * 1e9;
+        EXPECT_NEAR(largest / (double)huge, 1.0, 1e-6);
+        EXPECT_EQ(recorder.getPercentile(100.0), recorder.getSummary().max);
+
+        const FrameTimeRecorder::Summary summary = recorder.getSummary();
+        EXPECT_EQ(summary.samples, 3);
+        ASSERT_EQ(summary.hitches.size(), 3);
+        EXPECT_EQ(summary.hitches[0].count, 1);
+        EXPECT_EQ(summary.hitches[2].count, 1);
+    }
+
+    TEST_F(FrameTimeRecorderTests, RingBufferKeepsLastSamplesOldestFirst)
+    {
+        FrameTimeRecorder recorder("ring", {}, 4);
+        for(uint64_t ms = 1; ms <= 6; ++ms)recorder.record(std::chrono::milliseconds(ms));
+
+        EXPECT_EQ(recorder.dumpCSV(), "sample,duration_ms\n0,3.000000\n1,4.000000\n2,5.000000\n3,6.000000\n");
+        // histogram still holds every sample
+        EXPECT_EQ(recorder.getSummary().samples, 6);
+
+        recorder.reset();
+        EXPECT_EQ(recorder.dumpCSV(), "sample,duration_ms\n");
+        EXPECT_EQ(recorder.getSummary().samples, 0);
+    }
+
+    TEST_F(FrameTimeRecorderTests, DumpWithUnknownExtensionKeepsFile)
+    {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path();
+        const std::filesystem::path unknown = directory / "velora_frame_time_recorder_tests.txt";
+        const std::filesystem::path csv = directory / "velora_frame_time_recorder_tests.csv";
+
+        FrameTimeRecorder recorder("dump");
+        recorder.record(1ms);
+
+        {
+            std::ofstream out(unknown, std::ios::out | std::ios::trunc);
+            out << "keep";
+        }
+        EXPECT_FALSE(recorder.dump(unknown));
+        EXPECT_EQ(readFile(unknown), "keep");
+
+        EXPECT_TRUE(recorder.dump(csv));
+        EXPECT_EQ(readFile(csv), recorder.dumpCSV());
+
+        std::filesystem::remove(unknown);
+        std::filesystem::remove(csv);
+    }
+}
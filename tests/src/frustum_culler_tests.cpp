@@ -0,0 +1,158 @@
+#include "unit_tests.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "frustum_culler.hpp"
+
+namespace velora::tests
+{
+    class FrustumCullerTests : public UnitTest
+    {
+        protected:
+            static void expectPlane(const glm::vec4 & plane, const glm::vec4 & expected, const char * name)
+            {
+                EXPECT_NEAR(plane.x, expected.x, 1e-5f) << name;
+                EXPECT_NEAR(plane.y, expected.y, 1e-5f) << name;
+                EXPECT_NEAR(plane.z, expected.z, 1e-5f) << name;
+                EXPECT_NEAR(plane.w, expected.w, 1e-5f) << name;
+            }
+
+            static float distance(const glm::vec4 & plane, const glm::vec3 & point)
+            {
+                return glm::dot(glm::vec3(plane), point) + plane.w;
+            }
+
+            // visible indices of scalar test, what culler must report on every path
+            static std::vector<uint32_t> cullScalar(const Frustum & frustum, const std::vector<BoundingSphere> & spheres)
+            {
+                std::vector<uint32_t> visible;
+                for(uint32_t i = 0; i < spheres.size(); ++i)
+                {
+                    if(frustum.intersects(spheres[i]))visible.emplace_back(i);
+                }
+                return visible;
+            }
+
+            static std::vector<uint32_t> cull(const Frustum & frustum, const std::vector<BoundingSphere> & spheres)
+            {
+                FrustumCuller culler;
+                for(const auto & sphere : spheres)culler.add(sphere);
+
+                std::vector<uint32_t> visible;
+                const auto stats = culler.cull(frustum, visible);
+                EXPECT_EQ(stats.visible, visible.size());
+                EXPECT_EQ(stats.visible + stats.culled, spheres.size());
+                return visible;
+            }
+    };
+
+    TEST_F(FrustumCullerTests, ExtractsPlanesOfPerspectiveProjection)
+    {
+        // 90 degrees, so side planes are at 45 degrees to view direction
+        const Frustum frustum = Frustum::fromViewProjection(glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 10.0f));
+        const float s = 1.0f / std::sqrt(2.0f);
+
+        // normals point inside, camera looks down negative z
+        expectPlane(frustum.planes[Frustum::Left], glm::vec4(s, 0.0f, -s, 0.0f), "left");
+        expectPlane(frustum.planes[Frustum::Right], glm::vec4(-s, 0.0f, -s, 0.0f), "right");
+        expectPlane(frustum.planes[Frustum::Bottom], glm::vec4(0.0f, s, -s, 0.0f), "bottom");
+        expectPlane(frustum.planes[Frustum::Top], glm::vec4(0.0f, -s, -s, 0.0f), "top");
+        expectPlane(frustum.planes[Frustum::Near], glm::vec4(0.0f, 0.0f, -1.0f, -1.0f), "near");
+        expectPlane(frustum.planes[Frustum::Far], glm::vec4(0.0f, 0.0f, 1.0f, 10.0f), "far");
+
+        // signed distances in world units, positive inside
+        const glm::vec3 point(0.0f, 0.0f, -4.0f);
+        EXPECT_NEAR(distance(frustum.planes[Frustum::Near], point), 3.0f, 1e-5f);
+        EXPECT_NEAR(distance(frustum.planes[Frustum::Far], point), 6.0f, 1e-5f);
+        EXPECT_LT(distance(frustum.planes[Frustum::Near], glm::vec3(0.0f, 0.0f, -0.5f)), 0.0f);
+        EXPECT_LT(distance(frustum.planes[Frustum::Far], glm::vec3(0.0f, 0.0f, -10.5f)), 0.0f);
+    }
+
+    TEST_F(FrustumCullerTests, ExtractsWorldSpacePlanesOfViewProjection)
+    {
+        // camera at z = 5 looking at origin
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const Frustum frustum = Frustum::fromViewProjection(glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 10.0f) * view);
+
+        expectPlane(frustum.planes[Frustum::Near], glm::vec4(0.0f, 0.0f, -1.0f, 4.0f), "near");
+        expectPlane(frustum.planes[Frustum::Far], glm::vec4(0.0f, 0.0f, 1.0f, 5.0f), "far");
+
+        EXPECT_TRUE(frustum.intersects(BoundingSphere{.center = glm::vec3(0.0f), .radius = 0.1f}));
+        EXPECT_FALSE(frustum.intersects(BoundingSphere{.center = glm::vec3(0.0f, 0.0f, 6.0f), .radius = 0.5f}));
+        EXPECT_FALSE(frustum.intersects(BoundingSphere{.center = glm::vec3(0.0f, 0.0f, -6.0f), .radius = 0.5f}));
+    }
+
+    TEST_F(FrustumCullerTests, CullMatchesScalarTestForEveryBatchRemainder)
+    {
+        const glm::mat4 view = glm::lookAt(glm::vec3(2.0f, 3.0f, 8.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const Frustum frustum = Frustum::fromViewProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 30.0f) * view);
+
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+        std::uniform_real_distribution<float> radius(0.0f, 3.0f);
+
+        std::size_t visible = 0;
+        std::size_t total = 0;
+
+        // every remainder of four wide batches, with and without full batches in front
+        for(const std::size_t count : {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 1021, 1022, 1023, 1024})
+        {
+            std::vector<BoundingSphere> spheres(count);
+            for(auto & sphere : spheres)
+            {
+                sphere.center = glm::vec3(position(random), position(random), position(random));
+                sphere.radius = radius(random);
+            }
+
+            const auto expected = cullScalar(frustum, spheres);
+            EXPECT_EQ(cull(frustum, spheres), expected) << count << " spheres";
+
+            visible += expected.size();
+            total += count;
+        }
+
+        // both outcomes are exercised
+        EXPECT_GT(visible, 0);
+        EXPECT_LT(visible, total);
+    }
+
+    TEST_F(FrustumCullerTests, SpheresTouchingPlaneAreVisible)
+    {
+        // power of two box, so planes and distances are exact
+        const Frustum frustum = Frustum::fromViewProjection(glm::ortho(-8.0f, 8.0f, -8.0f, 8.0f, -8.0f, 8.0f));
+        expectPlane(frustum.planes[Frustum::Left], glm::vec4(1.0f, 0.0f, 0.0f, 8.0f), "left");
+        expectPlane(frustum.planes[Frustum::Near], glm::vec4(0.0f, 0.0f, -1.0f, 8.0f), "near");
+
+        const std::vector<BoundingSphere> spheres = {
+            // centers exactly on planes
+            {.center = glm::vec3(-8.0f, 0.0f, 0.0f), .radius = 0.0f},
+            {.center = glm::vec3(8.0f, 0.0f, 0.0f), .radius = 0.0f},
+            {.center = glm::vec3(0.0f, -8.0f, 0.0f), .radius = 0.0f},
+            {.center = glm::vec3(0.0f, 0.0f, 8.0f), .radius = 0.0f},
+            // outside, surface exactly on plane
+            {.center = glm::vec3(-10.0f, 0.0f, 0.0f), .radius = 2.0f},
+            {.center = glm::vec3(0.0f, 12.0f, 0.0f), .radius = 4.0f},
+            {.center = glm::vec3(0.0f, 0.0f, -9.0f), .radius = 1.0f},
+            // outside, just off plane
+            {.center = glm::vec3(-10.5f, 0.0f, 0.0f), .radius = 2.0f},
+            {.center = glm::vec3(0.0f, 0.0f, 8.25f), .radius = 0.0f},
+            {.center = glm::vec3(0.0f, -12.5f, 0.0f), .radius = 4.0f}
+        };
+        const std::vector<uint32_t> expected = {0, 1, 2, 3, 4, 5, 6};
+
+        EXPECT_EQ(cullScalar(frustum, spheres), expected);
+        // ten spheres go through two full batches and remainder of two
+        EXPECT_EQ(cull(frustum, spheres), expected);
+
+        // every sphere alone goes through remainder only
+        for(uint32_t i = 0; i < spheres.size(); ++i)
+        {
+            const bool visible = i < 7;
+            EXPECT_EQ(cull(frustum, {spheres[i]}).size(), visible ? 1 : 0) << "sphere " << i;
+        }
+    }
+}
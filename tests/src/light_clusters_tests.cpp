@@ -0,0 +1,296 @@
+#include "unit_tests.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "light_clusters.hpp"
+
+namespace velora::tests
+{
+    using game::LightClusterGrid;
+
+    class LightClustersTests : public UnitTest
+    {
+        protected:
+            constexpr static const float NEAR_PLANE = 0.1f;
+            constexpr static const float FAR_PLANE = 100.0f;
+            constexpr static const uint32_t RECORDS_SIZE = LightClusterGrid::CLUSTERS_COUNT * 2;
+
+            void SetUp() override
+            {
+                _view = glm::lookAt(glm::vec3(3.0f, 2.0f, 10.0f), glm::vec3(0.0f, 0.0f, -10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+                _projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, NEAR_PLANE, FAR_PLANE);
+            }
+
+            // spheres around camera, some of them behind it or beyond far plane
+            static std::vector<BoundingSphere> randomLights(std::size_t count, uint32_t seed)
+            {
+                std::mt19937 random(seed);
+                std::uniform_real_distribution<float> xy(-25.0f, 25.0f);
+                std::uniform_real_distribution<float> z(-110.0f, 15.0f);
+                std::uniform_real_distribution<float> radius(0.25f, 8.0f);
+
+                std::vector<BoundingSphere> lights(count);
+                for(auto & light : lights)
+                {
+                    light.center = glm::vec3(xy(random), xy(random) * 0.25f, z(random));
+                    light.radius = radius(random);
+                }
+                return lights;
+            }
+
+            /**
+             * @brief Tests every light against every froxel, froxel bounds are computed from its corners.
+             * @return signed squared distance of sphere surface to view space box of froxel, per cluster and light
+             */
+            std::vector<std::vector<float>> bruteForce(const std::vector<BoundingSphere> & lights) const
+            {
+                std::vector<std::vector<float>> distances(LightClusterGrid::CLUSTERS_COUNT, std::vector<float>(lights.size(), std::numeric_limits<float>::infinity()));
+
+                for(uint32_t slice = 0; slice < LightClusterGrid::GRID_Z; ++slice)
+                {
+                    const float near_depth = NEAR_PLANE * std::pow(FAR_PLANE / NEAR_PLANE, (float)slice / (float)LightClusterGrid::GRID_Z);
+                    const float far_depth = NEAR_PLANE * std::pow(FAR_PLANE / NEAR_PLANE, (float)(slice + 1) / (float)LightClusterGrid::GRID_Z);
+
+                    for(uint32_t y = 0; y < LightClusterGrid::GRID_Y; ++y)
+                    {
+                        for(uint32_t x = 0; x < LightClusterGrid::GRID_X; ++x)
+                        {
+                            // unproject four tile corners at both depths of slice
+                            glm::vec3 box_min(std::numeric_limits<float>::max());
+                            glm::vec3 box_max(std::numeric_limits<float>::lowest());
+                            for(uint32_t corner = 0; corner < 8; ++corner)
+                            {
+                                const float ndc_x = -1.0f + 2.0f * (float)(x + (corner & 1)) / (float)LightClusterGrid::GRID_X;
+                                const float ndc_y = -1.0f + 2.0f * (float)(y + ((corner >> 1) & 1)) / (float)LightClusterGrid::GRID_Y;
+                                const float depth = (corner & 4) ? far_depth : near_depth;
+
+                                const glm::vec3 point(ndc_x * depth / _projection[0][0], ndc_y * depth / _projection[1][1], -depth);
+                                box_min = glm::min(box_min, point);
+                                box_max = glm::max(box_max, point);
+                            }
+
+                            const uint32_t cluster = x + LightClusterGrid::GRID_X * (y + LightClusterGrid::GRID_Y * slice);
+                            for(std::size_t l = 0; l < lights.size(); ++l)
+                            {
+                                const glm::vec3 center = glm::vec3(_view * glm::vec4(lights[l].center, 1.0f));
+                                const glm::vec3 delta = glm::clamp(center, box_min, box_max) - center;
+                                distances[cluster][l] = glm::dot(delta, delta) - lights[l].radius * lights[l].radius;
+                            }
+                        }
+                    }
+                }
+                return distances;
+            }
+
+            glm::mat4 _view;
+            glm::mat4 _projection;
+    };
+
+    TEST_F(LightClustersTests, AssignsLightsLikeBruteForce)
+    {
+        asio::io_context io_context;
+        LightClusterGrid grid(io_context, 0);
+
+        const auto lights = randomLights(96, 1);
+        grid.build(lights, _view, _projection, NEAR_PLANE, FAR_PLANE);
+
+        const auto buffer = grid.getBuffer();
+        const auto distances = bruteForce(lights);
+        ASSERT_GE(buffer.size(), RECORDS_SIZE);
+
+        std::size_t assigned = 0;
+        for(uint32_t cluster = 0; cluster < LightClusterGrid::CLUSTERS_COUNT; ++cluster)
+        {
+            const uint32_t offset = buffer[cluster * 2];
+            const uint32_t count = buffer[cluster * 2 + 1];
+            ASSERT_LE(RECORDS_SIZE + offset + count, buffer.size());
+
+            std::vector<bool> listed(lights.size(), false);
+            for(uint32_t i = 0; i < count; ++i)listed[buffer[RECORDS_SIZE + offset + i]] = true;
+
+            for(std::size_t l = 0; l < lights.size(); ++l)
+            {
+                const float distance = distances[cluster][l];
+                // spheres touching box within rounding may go either way
+                if(std::abs(distance) <= 1e-3f * lights[l].radius * lights[l].radius)continue;
+                EXPECT_EQ(listed[l], distance <= 0.0f) << "cluster " << cluster << " light " << l;
+            }
+            assigned += count;
+        }
+
+        EXPECT_GT(assigned, 0);
+        EXPECT_GT(grid.getStats().culled_lights, 0);
+        EXPECT_EQ(grid.getStats().light_indices, assigned);
+    }
+
+    TEST_F(LightClustersTests, GlobalLightsComeFirst)
+    {
+        asio::io_context io_context;
+        LightClusterGrid grid(io_context, 0);
+
+        auto lights = randomLights(48, 2);
+        const std::vector<uint32_t> global_lights = {0, 5, 17, 47};
+        for(const uint32_t l : global_lights)lights[l].radius = std::numeric_limits<float>::infinity();
+
+        grid.build(lights, _view, _projection, NEAR_PLANE, FAR_PLANE);
+
+        const auto buffer = grid.getBuffer();
+        ASSERT_EQ(grid.getGlobalLightsCount(), global_lights.size());
+        ASSERT_GE(buffer.size(), RECORDS_SIZE + global_lights.size());
+        for(std::size_t i = 0; i < global_lights.size(); ++i)
+        {
+            EXPECT_EQ(buffer[RECORDS_SIZE + i], global_lights[i]);
+        }
+
+        // clusters never reference global lights
+        for(uint32_t cluster = 0; cluster < LightClusterGrid::CLUSTERS_COUNT; ++cluster)
+        {
+            if(buffer[cluster * 2 + 1] == 0)continue;
+            EXPECT_GE(buffer[cluster * 2], global_lights.size());
+
+            for(uint32_t i = 0; i < buffer[cluster * 2 + 1]; ++i)
+            {
+                const uint32_t light = buffer[RECORDS_SIZE + buffer[cluster * 2] + i];
+                EXPECT_TRUE(std::isfinite(lights[light].radius));
+            }
+        }
+    }
+
+    TEST_F(LightClustersTests, RebasesSliceOffsetsIntoContiguousRanges)
+    {
+        asio::io_context io_context;
+        LightClusterGrid grid(io_context, 0);
+
+        auto lights = randomLights(64, 3);
+        lights[10].radius = std::numeric_limits<float>::infinity();
+        lights[20].radius = std::numeric_limits<float>::infinity();
+        grid.build(lights, _view, _projection, NEAR_PLANE, FAR_PLANE);
+
+        const auto buffer = grid.getBuffer();
+        const auto stats = grid.getStats();
+
+        // ranges of clusters follow each other in cluster order across all slices, right after global lights
+        uint32_t expected_offset = grid.getGlobalLightsCount();
+        uint32_t occupied_slices = 0;
+        for(uint32_t slice = 0; slice < LightClusterGrid::GRID_Z; ++slice)
+        {
+            bool occupied = false;
+            for(uint32_t tile = 0; tile < LightClusterGrid::GRID_X * LightClusterGrid::GRID_Y; ++tile)
+            {
+                const uint32_t cluster = tile + slice * LightClusterGrid::GRID_X * LightClusterGrid::GRID_Y;
+                const uint32_t count = buffer[cluster * 2 + 1];
+                if(count == 0)continue;
+
+                ASSERT_EQ(buffer[cluster * 2], expected_offset) << "cluster " << cluster;
+                expected_offset += count;
+                occupied = true;
+            }
+            if(occupied)occupied_slices++;
+        }
+
+        EXPECT_GT(occupied_slices, 1);
+        EXPECT_EQ(RECORDS_SIZE + expected_offset, buffer.size());
+        EXPECT_EQ(stats.light_indices, expected_offset - grid.getGlobalLightsCount());
+    }
+
+    TEST_F(LightClustersTests, NonPerspectiveProjectionMakesAllLightsGlobal)
+    {
+        asio::io_context io_context;
+        LightClusterGrid grid(io_context, 0);
+
+        const auto lights = randomLights(40, 4);
+        grid.build(lights, _view, glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, NEAR_PLANE, FAR_PLANE), NEAR_PLANE, FAR_PLANE);
+
+        EXPECT_EQ(grid.getGlobalLightsCount(), lights.size());
+        EXPECT_EQ(grid.getBuffer().size(), RECORDS_SIZE + lights.size());
+        EXPECT_EQ(grid.getStats().occupied_clusters, 0);
+    }
+
+    TEST_F(LightClustersTests, ParallelBuildMatchesSerialBuild)
+    {
+        asio::io_context io_context;
+        auto work = asio::make_work_guard(io_context);
+        std::vector<std::thread> threads;
+        for(uint32_t i = 0; i < LightClusterGrid::DEFAULT_HELPERS; ++i)threads.emplace_back([&io_context](){ io_context.run(); });
+
+        LightClusterGrid parallel(io_context);
+        LightClusterGrid serial(io_context, 0);
+
+        // lights beyond view are culled before parallel threshold is checked, so use lights in front of camera
+        const std::size_t MIN_LIGHTS = LightClusterGrid::PARALLEL_MIN_LIGHTS;
+        for(const std::size_t count : {MIN_LIGHTS - 1, MIN_LIGHTS, MIN_LIGHTS + 1, (std::size_t)256})
+        {
+            auto lights = randomLights(count, (uint32_t)count);
+            for(auto & light : lights)light.center = glm::vec3(glm::inverse(_view) * glm::vec4(light.center.x, light.center.y, -2.0f - std::abs(light.center.z) * 0.8f, 1.0f));
+            lights[count / 2].radius = std::numeric_limits<float>::infinity();
+
+            for(uint32_t run = 0; run < 4; ++run)
+            {
+                parallel.build(lights, _view, _projection, NEAR_PLANE, FAR_PLANE);
+                serial.build(lights, _view, _projection, NEAR_PLANE, FAR_PLANE);
+
+                EXPECT_EQ(parallel.getStats().culled_lights, 0);
+                const auto parallel_buffer = parallel.getBuffer();
+                const auto serial_buffer = serial.getBuffer();
+                ASSERT_TRUE(std::ranges::equal(parallel_buffer, serial_buffer)) << count << " lights";
+            }
+        }
+
+        work.reset();
+        for(auto & thread : threads)thread.join();
+    }
+
+    TEST_F(LightClustersTests, BuildFinishesWithoutFreeHelperThread)
+    {
+        // nothing runs io_context, so posted helpers never start
+        asio::io_context io_context;
+        LightClusterGrid grid(io_context);
+
+        const auto lights = randomLights(128, 5);
+        grid.build(lights, _view, _projection, NEAR_PLANE, FAR_PLANE);
+
+        EXPECT_GT(grid.getStats().light_indices, 0);
+
+        // helpers posted by build find no slice left and must not touch grid
+        io_context.run();
+    }
+
+    TEST_F(LightClustersTests, BuildTime)
+    {
+        constexpr const uint32_t RUNS = 200;
+
+        asio::io_context io_context;
+        auto work = asio::make_work_guard(io_context);
+        std::vector<std::thread> threads;
+        for(uint32_t i = 0; i < LightClusterGrid::DEFAULT_HELPERS; ++i)threads.emplace_back([&io_context](){ io_context.run(); });
+
+        const auto lights = randomLights(256, 6);
+
+        for(const std::size_t helpers : {(std::size_t)0, LightClusterGrid::DEFAULT_HELPERS})
+        {
+            LightClusterGrid grid(io_context, helpers);
+            // first build sizes scratch buffers
+            grid.build(lights, _view, _projection, NEAR_PLANE, FAR_PLANE);
+
+            const auto start = std::chrono::steady_clock::now();
+            for(uint32_t run = 0; run < RUNS; ++run)grid.build(lights, _view, _projection, NEAR_PLANE, FAR_PLANE);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(std::chrono::steady_clock::now() - start);
+
+            const double mean_build = elapsed.count() / (double)RUNS;
+            RecordProperty(std::format("mean_build_us_{}_helpers", helpers), std::to_string(mean_build));
+            spdlog::info(std::format("[light] light clusters: {} lights, {} helpers, mean build {:.1f} us, {} occupied clusters",
+                lights.size(), helpers, mean_build, grid.getStats().occupied_clusters));
+        }
+
+        work.reset();
+        for(auto & thread : threads)thread.join();
+    }
+}
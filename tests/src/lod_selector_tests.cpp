@@ -0,0 +1,133 @@
+#include "unit_tests.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "lod_selector.hpp"
+
+namespace velora::tests
+{
+    class LODSelectorTests : public UnitTest
+    {
+        protected:
+            constexpr static const float HYSTERESIS = 0.15f;
+            constexpr static const LODSelector::Thresholds THRESHOLDS = {256.0f, 96.0f, 32.0f};
+    };
+
+    TEST_F(LODSelectorTests, FirstSelectionUsesThresholdsWithoutHysteresis)
+    {
+        LODSelector selector(THRESHOLDS, HYSTERESIS);
+
+        EXPECT_EQ(selector.select(0, 300.0f, MAX_MESH_LODS), 0);
+        EXPECT_EQ(selector.select(1, 256.0f, MAX_MESH_LODS), 0);
+        EXPECT_EQ(selector.select(2, 255.0f, MAX_MESH_LODS), 1);
+        EXPECT_EQ(selector.select(3, 95.0f, MAX_MESH_LODS), 2);
+        EXPECT_EQ(selector.select(4, 31.0f, MAX_MESH_LODS), 3);
+        EXPECT_EQ(selector.select(5, 0.0f, MAX_MESH_LODS), 3);
+        EXPECT_EQ(selector.select(6, std::numeric_limits<float>::infinity(), MAX_MESH_LODS), 0);
+
+        // coarsest available level when mesh has fewer levels
+        EXPECT_EQ(selector.select(7, 31.0f, 2), 1);
+        EXPECT_EQ(selector.select(8, 31.0f, 1), 0);
+        EXPECT_EQ(selector.select(9, 31.0f, 0), 0);
+    }
+
+    TEST_F(LODSelectorTests, DoesNotFlickerAroundThreshold)
+    {
+        LODSelector selector(THRESHOLDS, HYSTERESIS);
+
+        // both keys swing across threshold 256 every frame, staying inside of hysteresis band
+        const uint64_t coming = 0;
+        const uint64_t leaving = 1;
+        EXPECT_EQ(selector.select(coming, 260.0f, MAX_MESH_LODS), 0);
+        EXPECT_EQ(selector.select(leaving, 250.0f, MAX_MESH_LODS), 1);
+        selector.endFrame();
+
+        for(uint32_t frame = 0; frame < 100; ++frame)
+        {
+            EXPECT_EQ(selector.select(coming, frame % 2 ? 220.0f : 262.0f, MAX_MESH_LODS), 0) << "frame " << frame;
+            EXPECT_EQ(selector.select(leaving, frame % 2 ? 290.0f : 250.0f, MAX_MESH_LODS), 1) << "frame " << frame;
+            selector.endFrame();
+        }
+
+        // the same for threshold between coarser levels
+        EXPECT_EQ(selector.select(2, 30.0f, MAX_MESH_LODS), 3);
+        for(uint32_t frame = 0; frame < 10; ++frame)
+        {
+            EXPECT_EQ(selector.select(2, frame % 2 ? 28.0f : 36.0f, MAX_MESH_LODS), 3) << "frame " << frame;
+            selector.endFrame();
+        }
+    }
+
+    TEST_F(LODSelectorTests, SwitchesLevelAfterCrossingHysteresisBand)
+    {
+        LODSelector selector(THRESHOLDS, HYSTERESIS);
+
+        EXPECT_EQ(selector.select(0, 300.0f, MAX_MESH_LODS), 0);
+        // 256 * 0.85 = 217.6
+        EXPECT_EQ(selector.select(0, 218.0f, MAX_MESH_LODS), 0);
+        EXPECT_EQ(selector.select(0, 217.0f, MAX_MESH_LODS), 1);
+        // 256 * 1.15 = 294.4
+        EXPECT_EQ(selector.select(0, 294.0f, MAX_MESH_LODS), 1);
+        EXPECT_EQ(selector.select(0, 295.0f, MAX_MESH_LODS), 0);
+
+        // large change skips levels in one selection
+        EXPECT_EQ(selector.select(0, 10.0f, MAX_MESH_LODS), 3);
+        EXPECT_EQ(selector.select(0, 1000.0f, MAX_MESH_LODS), 0);
+        EXPECT_EQ(selector.select(0, 90.0f, MAX_MESH_LODS), 1);
+        EXPECT_EQ(selector.select(0, 81.0f, MAX_MESH_LODS), 2);
+
+        // remembered level is clamped to levels of mesh
+        EXPECT_EQ(selector.select(0, 81.0f, 2), 1);
+    }
+
+    TEST_F(LODSelectorTests, ZeroHysteresisSwitchesAtThreshold)
+    {
+        LODSelector selector(THRESHOLDS, 0.0f);
+
+        EXPECT_EQ(selector.select(0, 260.0f, MAX_MESH_LODS), 0);
+        EXPECT_EQ(selector.select(0, 250.0f, MAX_MESH_LODS), 1);
+        EXPECT_EQ(selector.select(0, 260.0f, MAX_MESH_LODS), 0);
+    }
+
+    TEST_F(LODSelectorTests, ForgetsKeysNotSelectedAnymore)
+    {
+        constexpr const uint64_t KEYS = 300;
+        LODSelector selector(THRESHOLDS, HYSTERESIS);
+
+        for(uint64_t key = 0; key < KEYS; ++key)EXPECT_EQ(selector.select(key, 250.0f, MAX_MESH_LODS), 1);
+        selector.endFrame();
+
+        // only key 0 is drawn, stale keys outnumber it and are dropped at end of frame
+        EXPECT_EQ(selector.select(0, 262.0f, MAX_MESH_LODS), 1);
+        selector.endFrame();
+
+        EXPECT_EQ(selector.select(0, 262.0f, MAX_MESH_LODS), 1);
+        // forgotten key is selected as new one
+        EXPECT_EQ(selector.select(KEYS - 1, 262.0f, MAX_MESH_LODS), 0);
+    }
+
+    TEST_F(LODSelectorTests, ProjectsDiameterInPixels)
+    {
+        const BoundingSphere sphere{.center = glm::vec3(0.0f, 0.0f, -10.0f), .radius = 1.0f};
+
+        // 90 degrees, so half of viewport height spans distance of sphere
+        const glm::mat4 perspective = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        EXPECT_NEAR(LODSelector::projectedDiameter(sphere, perspective, 1000.0f), 100.0f, 1e-3f);
+
+        // view matrix changes distance only
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        EXPECT_NEAR(LODSelector::projectedDiameter(sphere, perspective * view, 1000.0f), 50.0f, 1e-3f);
+
+        // behind eye
+        const BoundingSphere behind{.center = glm::vec3(0.0f, 0.0f, 5.0f), .radius = 1.0f};
+        EXPECT_TRUE(std::isinf(LODSelector::projectedDiameter(behind, perspective, 1000.0f)));
+
+        // orthographic size does not depend on distance
+        const glm::mat4 orthographic = glm::ortho(-8.0f, 8.0f, -8.0f, 8.0f, 0.1f, 100.0f);
+        EXPECT_NEAR(LODSelector::projectedDiameter(sphere, orthographic, 800.0f), 100.0f, 1e-3f);
+        EXPECT_NEAR(LODSelector::projectedDiameter(behind, orthographic, 800.0f), 100.0f, 1e-3f);
+    }
+}
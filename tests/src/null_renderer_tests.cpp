@@ -0,0 +1,183 @@
+#include "unit_tests.hpp"
+
+#include <array>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "null_renderer.hpp"
+
+namespace velora::tests
+{
+    class NullRendererTests : public UnitTest
+    {
+        protected:
+            using Type = null::NullRenderCommand::Type;
+
+            // two triangles, 6 elements per draw
+            static Mesh quad()
+            {
+                Mesh mesh;
+                mesh.vertices = {
+                    Vertex{.position = {-1.0f, -1.0f, 0.0f}, .normal = {0.0f, 0.0f, 1.0f}, .uv = {0.0f, 0.0f}},
+                    Vertex{.position = { 1.0f, -1.0f, 0.0f}, .normal = {0.0f, 0.0f, 1.0f}, .uv = {1.0f, 0.0f}},
+                    Vertex{.position = { 1.0f,  1.0f, 0.0f}, .normal = {0.0f, 0.0f, 1.0f}, .uv = {1.0f, 1.0f}},
+                    Vertex{.position = {-1.0f,  1.0f, 0.0f}, .normal = {0.0f, 0.0f, 1.0f}, .uv = {0.0f, 1.0f}}};
+                mesh.indices = {0, 1, 2, 2, 3, 0};
+                return mesh;
+            }
+
+            struct Objects
+            {
+                std::optional<std::size_t> quad;
+                std::optional<std::size_t> shader;
+                std::optional<std::size_t> frame_uniforms;
+                std::optional<std::size_t> fbo;
+            };
+    };
+
+    TEST_F(NullRendererTests, RecordsCommandsInSubmissionOrder)
+    {
+        asio::io_context io_context;
+        null::NullRenderer renderer(io_context, Resolution{64, 64}, true);
+
+        static const ShaderUniform color_uniform("color");
+        static const ShaderUniform model_uniform("model");
+        static const ShaderUniform albedo_uniform("albedo");
+
+        Objects objects;
+        const std::array<float, 16> frame_data{};
+
+        // built outside of coroutine, so braced lists do not end up in coroutine frame
+        const std::vector<std::string> vertex_code = {"vertex"};
+        const std::vector<std::string> fragment_code = {"fragment"};
+        const std::initializer_list<FBOAttachment> attachments = {
+            {FBOAttachment::Type::Texture, FBOAttachment::Point::Color, TextureFormat::RGBA_8}};
+        const ShaderInputs gbuffer_inputs({
+            {color_uniform, glm::vec4(1.0f)}, {model_uniform, glm::mat4(1.0f)}, {albedo_uniform, ShaderInputs::Sampler{1}}});
+        const ShaderInputs color_inputs({{color_uniform, 0.5f}});
+        const RenderOptions wireframe{.mode = RenderMode::Wireframe, .polygon_offset = PolygonOffset{1.0f, 1.0f}};
+
+        asio::co_spawn(io_context, [&]() -> asio::awaitable<void>
+        {
+            objects.quad = co_await renderer.constructVertexBuffer("quad", quad());
+            objects.shader = co_await renderer.constructShader("shader", vertex_code, fragment_code);
+            objects.frame_uniforms = co_await renderer.constructUniformBuffer("frame", 0, sizeof(frame_data), frame_data.data());
+            objects.fbo = co_await renderer.constructFrameBufferObject("gbuffer", Resolution{64, 64}, attachments);
+
+            if(!objects.quad || !objects.shader || !objects.frame_uniforms || !objects.fbo)co_return;
+
+            // frame 0
+            co_await renderer.updateUniformBuffer(*objects.frame_uniforms, sizeof(frame_data), frame_data.data());
+            co_await renderer.clearScreen({0.0f, 0.0f, 0.0f, 1.0f}, *objects.fbo, std::nullopt);
+            co_await renderer.render(*objects.quad, *objects.shader, gbuffer_inputs, RenderOptions{}, *objects.fbo);
+            co_await renderer.renderInstanced(*objects.quad, *objects.shader, 4, ShaderInputs{}, wireframe, std::nullopt);
+            // unknown shader is dropped without command
+            co_await renderer.render(*objects.quad, *objects.shader + 100, ShaderInputs{}, RenderOptions{}, std::nullopt);
+            co_await renderer.present();
+
+            // frame 1, partial uniform update
+            co_await renderer.updateUniformBuffer(*objects.frame_uniforms, sizeof(float) * 4, frame_data.data());
+            co_await renderer.render(*objects.quad, *objects.shader, color_inputs, RenderOptions{}, std::nullopt);
+            co_await renderer.present();
+        }, asio::detached);
+        io_context.run();
+
+        ASSERT_TRUE(objects.quad && objects.shader && objects.frame_uniforms && objects.fbo);
+
+        const std::vector<null::NullRenderCommand> & log = renderer.getCommandLog();
+        const std::vector<Type> expected = {
+            Type::UpdateUniformBuffer, Type::Clear, Type::Draw, Type::Draw, Type::Present,
+            Type::UpdateUniformBuffer, Type::Draw, Type::Present};
+
+        ASSERT_EQ(log.size(), expected.size());
+        for(std::size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_EQ(log[i].type, expected[i]) << "command " << i;
+            EXPECT_EQ(log[i].frame, i < 5 ? 0 : 1) << "command " << i;
+        }
+
+        EXPECT_EQ(log[0].storage_buffer, *objects.frame_uniforms);
+        EXPECT_EQ(log[0].data_bytes, sizeof(frame_data));
+        EXPECT_EQ(log[1].fbo, objects.fbo);
+
+        // uniforms are counted by value, samplers separately
+        EXPECT_EQ(log[2].fbo, objects.fbo);
+        EXPECT_EQ(log[2].vertex_buffer, *objects.quad);
+        EXPECT_EQ(log[2].shader, *objects.shader);
+        EXPECT_EQ(log[2].elements, 6);
+        EXPECT_EQ(log[2].instances, 1);
+        EXPECT_EQ(log[2].uniforms, 2);
+        EXPECT_EQ(log[2].uniform_bytes, sizeof(glm::vec4) + sizeof(glm::mat4));
+        EXPECT_EQ(log[2].samplers, 1);
+
+        EXPECT_EQ(log[3].fbo, std::nullopt);
+        EXPECT_EQ(log[3].mode, RenderMode::Wireframe);
+        EXPECT_TRUE(log[3].polygon_offset);
+        EXPECT_EQ(log[3].instances, 4);
+        EXPECT_EQ(log[3].uniforms, 0);
+
+        EXPECT_EQ(log[5].data_bytes, sizeof(float) * 4);
+        EXPECT_EQ(log[6].uniforms, 1);
+        EXPECT_EQ(log[6].uniform_bytes, sizeof(float));
+
+        // counters of last presented frame
+        const null::NullFrameStats & stats = renderer.getFrameStats();
+        EXPECT_EQ(stats.frame, 1);
+        EXPECT_EQ(stats.draw_calls, 1);
+        EXPECT_EQ(stats.uniform_buffer_updates, 1);
+        EXPECT_EQ(stats.uniform_buffer_bytes, sizeof(float) * 4);
+
+        renderer.clearCommandLog();
+        EXPECT_TRUE(renderer.getCommandLog().empty());
+    }
+
+    TEST_F(NullRendererTests, CountsWithoutRecordingWhenDisabled)
+    {
+        asio::io_context io_context;
+        null::NullRenderer renderer(io_context, Resolution{64, 64}, false);
+
+        const std::vector<std::string> vertex_code = {"vertex"};
+
+        asio::co_spawn(io_context, [&]() -> asio::awaitable<void>
+        {
+            const auto quad_id = co_await renderer.constructVertexBuffer("quad", quad());
+            const auto shader_id = co_await renderer.constructShader("shader", vertex_code);
+            if(!quad_id || !shader_id)co_return;
+
+            co_await renderer.render(*quad_id, *shader_id, ShaderInputs{}, RenderOptions{}, std::nullopt);
+            co_await renderer.render(*quad_id, *shader_id, ShaderInputs{}, RenderOptions{}, std::nullopt);
+            co_await renderer.present();
+        }, asio::detached);
+        io_context.run();
+
+        EXPECT_TRUE(renderer.getCommandLog().empty());
+        EXPECT_EQ(renderer.getFrameStats().draw_calls, 2);
+        EXPECT_EQ(renderer.getFrameStats().triangles, 4);
+        EXPECT_EQ(renderer.getFrameStats().shader_switches, 1);
+    }
+
+    TEST_F(NullRendererTests, CloseStopsAcceptingCommands)
+    {
+        asio::io_context io_context;
+        null::NullRenderer renderer(io_context, Resolution{64, 64}, true);
+        EXPECT_TRUE(renderer.good());
+
+        asio::co_spawn(io_context, [&]() -> asio::awaitable<void>
+        {
+            co_await renderer.close();
+            co_await renderer.present();
+        }, asio::detached);
+        io_context.run();
+
+        EXPECT_FALSE(renderer.good());
+        EXPECT_TRUE(renderer.getCommandLog().empty());
+
+        // moved from renderer is not good either
+        null::NullRenderer other(io_context, Resolution{64, 64}, true);
+        null::NullRenderer moved(std::move(other));
+        EXPECT_TRUE(moved.good());
+        EXPECT_FALSE(other.good());
+    }
+}
@@ -0,0 +1,204 @@
+#include "unit_tests.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "render_command_ring.hpp"
+
+namespace velora::tests
+{
+    class RenderCommandRingTests : public UnitTest
+    {
+        protected:
+            using Strand = asio::strand<asio::io_context::executor_type>;
+
+            // pushes command, spins while ring is full, then wakes render thread
+            template<class F>
+            static void push(RenderCommandRing & ring, asio::io_context & io_context, F command)
+            {
+                while(ring.tryPush(command) == false)std::this_thread::yield();
+                ring.wake(io_context);
+            }
+    };
+
+    TEST_F(RenderCommandRingTests, ExecutesCommandsOfEveryProducerInPushOrder)
+    {
+        constexpr const uint32_t PRODUCERS = 4;
+        // several laps of ring per producer, so producers run into full ring
+        constexpr const uint32_t COMMANDS = (uint32_t)RenderCommandRing::CAPACITY * 8;
+
+        RenderCommandRing ring;
+        asio::io_context io_context;
+        auto work = asio::make_work_guard(io_context);
+
+        // written by render thread only
+        std::vector<std::vector<uint32_t>> received(PRODUCERS);
+        for(auto & sequence : received)sequence.reserve(COMMANDS);
+
+        std::thread render_thread([&ring, &io_context](){ ring.run(io_context); });
+
+        std::vector<std::thread> producers;
+        for(uint32_t producer = 0; producer < PRODUCERS; ++producer)
+        {
+            producers.emplace_back([&ring, &io_context, &received, producer]()
+            {
+                for(uint32_t i = 0; i < COMMANDS; ++i)
+                {
+                    push(ring, io_context, [&received, producer, i](){ received[producer].emplace_back(i); });
+                }
+            });
+        }
+
+        for(auto & producer : producers)producer.join();
+
+        // render thread returns once io_context runs out of work, remaining commands are executed before
+        work.reset();
+        render_thread.join();
+
+        EXPECT_TRUE(ring.empty());
+        for(uint32_t producer = 0; producer < PRODUCERS; ++producer)
+        {
+            ASSERT_EQ(received[producer].size(), COMMANDS) << "producer " << producer;
+            for(uint32_t i = 0; i < COMMANDS; ++i)
+            {
+                ASSERT_EQ(received[producer][i], i) << "producer " << producer;
+            }
+        }
+    }
+
+    TEST_F(RenderCommandRingTests, RejectsPushWhenFull)
+    {
+        RenderCommandRing ring;
+        std::size_t executed = 0;
+
+        for(std::size_t i = 0; i < RenderCommandRing::CAPACITY; ++i)
+        {
+            ASSERT_TRUE(ring.tryPush([&executed](){ executed++; }));
+        }
+        EXPECT_FALSE(ring.tryPush([&executed](){ executed++; }));
+
+        EXPECT_EQ(ring.drain(), RenderCommandRing::CAPACITY);
+        EXPECT_EQ(executed, RenderCommandRing::CAPACITY);
+        EXPECT_TRUE(ring.empty());
+
+        // freed slots are reused in next lap
+        EXPECT_TRUE(ring.tryPush([&executed](){ executed++; }));
+        EXPECT_EQ(ring.drain(), 1);
+        EXPECT_EQ(executed, RenderCommandRing::CAPACITY + 1);
+    }
+
+    TEST_F(RenderCommandRingTests, EnterFallsBackToStrandWhenFull)
+    {
+        RenderCommandRing ring;
+        asio::io_context render_context;
+        asio::io_context engine_context;
+        const Strand strand = asio::make_strand(render_context);
+        auto render_work = asio::make_work_guard(render_context);
+
+        std::size_t executed = 0;
+        for(std::size_t i = 0; i < RenderCommandRing::CAPACITY; ++i)
+        {
+            ASSERT_TRUE(ring.tryPush([&executed](){ executed++; }));
+        }
+
+        std::atomic<bool> resumed = false;
+        std::atomic<bool> resumed_on_strand = false;
+        asio::co_spawn(engine_context, [&]() -> asio::awaitable<void>
+        {
+            co_await ring.enter(render_context, strand);
+            resumed_on_strand = strand.running_in_this_thread();
+            resumed = true;
+            render_work.reset();
+        }, asio::detached);
+
+        // coroutine finds ring full and dispatches itself to strand of render io_context
+        std::thread engine_thread([&engine_context](){ engine_context.run(); });
+        while(ring.getOverflowCount() == 0)std::this_thread::yield();
+
+        ring.run(render_context);
+        engine_thread.join();
+
+        EXPECT_EQ(ring.getOverflowCount(), 1);
+        EXPECT_EQ(executed, RenderCommandRing::CAPACITY);
+        EXPECT_TRUE(resumed);
+        EXPECT_TRUE(resumed_on_strand);
+    }
+
+    TEST_F(RenderCommandRingTests, EnterThroughput)
+    {
+        constexpr const uint32_t HOPS = 100'000;
+
+        RenderCommandRing ring;
+        asio::io_context render_context;
+        asio::io_context engine_context;
+        const Strand strand = asio::make_strand(render_context);
+        auto render_work = asio::make_work_guard(render_context);
+
+        std::thread render_thread([&ring, &render_context](){ ring.run(render_context); });
+
+        uint32_t on_render_thread = 0;
+        const auto start = std::chrono::steady_clock::now();
+        asio::co_spawn(engine_context, [&]() -> asio::awaitable<void>
+        {
+            for(uint32_t i = 0; i < HOPS; ++i)
+            {
+                // to render thread through ring and back to engine, as renderer calls do
+                co_await ring.enter(render_context, strand);
+                if(ring.isRenderThread())on_render_thread++;
+                co_await asio::post(engine_context, asio::use_awaitable);
+            }
+            render_work.reset();
+        }, asio::detached);
+
+        engine_context.run();
+        render_thread.join();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start);
+
+        EXPECT_EQ(on_render_thread, HOPS);
+        EXPECT_EQ(ring.getOverflowCount(), 0);
+
+        const double hops_per_second = (double)HOPS / elapsed.count();
+        RecordProperty("enter_round_trips_per_second", std::to_string((uint64_t)hops_per_second));
+        spdlog::info(std::format("[render] render command ring: {} enter round trips in {:.3f} ms, {:.0f} per second",
+            HOPS, elapsed.count() * 1000.0, hops_per_second));
+    }
+
+    TEST_F(RenderCommandRingTests, RunThroughput)
+    {
+        constexpr const uint32_t PRODUCERS = 4;
+        constexpr const uint32_t COMMANDS = 250'000;
+
+        RenderCommandRing ring;
+        asio::io_context io_context;
+        auto work = asio::make_work_guard(io_context);
+
+        // written by render thread only
+        uint64_t executed = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        std::thread render_thread([&ring, &io_context](){ ring.run(io_context); });
+
+        std::vector<std::thread> producers;
+        for(uint32_t producer = 0; producer < PRODUCERS; ++producer)
+        {
+            producers.emplace_back([&ring, &io_context, &executed]()
+            {
+                for(uint32_t i = 0; i < COMMANDS; ++i)push(ring, io_context, [&executed](){ executed++; });
+            });
+        }
+
+        for(auto & producer : producers)producer.join();
+        work.reset();
+        render_thread.join();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start);
+
+        EXPECT_EQ(executed, (uint64_t)PRODUCERS * COMMANDS);
+
+        const double commands_per_second = (double)executed / elapsed.count();
+        RecordProperty("run_commands_per_second", std::to_string((uint64_t)commands_per_second));
+        spdlog::info(std::format("[render] render command ring: {} commands of {} producers executed in {:.3f} ms, {:.0f} per second",
+            executed, PRODUCERS, elapsed.count() * 1000.0, commands_per_second));
+    }
+}
@@ -0,0 +1,154 @@
+#include "unit_tests.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "render_queue.hpp"
+
+namespace velora::tests
+{
+    class RenderQueueTests : public UnitTest
+    {
+        protected:
+            // push index is kept in vertex buffer, so it travels with item through sort
+            static void pushAll(RenderQueue & queue, const std::vector<uint64_t> & keys)
+            {
+                for(std::size_t i = 0; i < keys.size(); ++i)
+                {
+                    queue.push(DrawItem{.key = keys[i], .vertex_buffer = i});
+                }
+            }
+
+            // sorts queue and compares it with std::stable_sort of the same keys
+            static void expectStableSorted(RenderQueue & queue, const std::vector<uint64_t> & keys)
+            {
+                std::vector<std::size_t> expected(keys.size());
+                for(std::size_t i = 0; i < expected.size(); ++i)expected[i] = i;
+                std::stable_sort(expected.begin(), expected.end(), [&keys](std::size_t lhs, std::size_t rhs){ return keys[lhs] < keys[rhs]; });
+
+                queue.sort();
+
+                ASSERT_EQ(queue.size(), keys.size());
+                ASSERT_EQ(queue.getItems().size(), keys.size());
+                for(std::size_t i = 0; i < expected.size(); ++i)
+                {
+                    ASSERT_EQ(queue[i].key, keys[expected[i]]) << "position " << i;
+                    ASSERT_EQ(queue[i].vertex_buffer, expected[i]) << "position " << i;
+                    ASSERT_EQ(queue.getPushIndex(i), expected[i]) << "position " << i;
+                }
+            }
+    };
+
+    TEST_F(RenderQueueTests, SortsRandomKeysLikeStableSort)
+    {
+        std::mt19937_64 random(3);
+
+        for(const std::size_t count : {0, 1, 2, 3, 255, 256, 257, 10'000})
+        {
+            std::vector<uint64_t> keys(count);
+            for(auto & key : keys)key = random();
+
+            RenderQueue queue;
+            pushAll(queue, keys);
+            expectStableSorted(queue, keys);
+        }
+    }
+
+    TEST_F(RenderQueueTests, SkipsDigitsSharedByAllKeys)
+    {
+        std::mt19937_64 random(5);
+
+        // every pattern leaves some bytes constant, so their passes are skipped
+        for(const uint64_t mask : {0x0000'0000'0000'00ffull, 0xff00'0000'0000'0000ull, 0x00ff'ff00'0000'ff00ull, 0xf0f0'0000'0f0f'0000ull})
+        {
+            const uint64_t constant = random() & ~mask;
+
+            std::vector<uint64_t> keys(5'000);
+            for(auto & key : keys)key = constant | (random() & mask);
+
+            RenderQueue queue;
+            pushAll(queue, keys);
+            expectStableSorted(queue, keys);
+        }
+
+        // all keys equal, every pass is skipped and push order stays
+        RenderQueue queue;
+        const std::vector<uint64_t> keys(1'000, 0x0123'4567'89ab'cdefull);
+        pushAll(queue, keys);
+        expectStableSorted(queue, keys);
+    }
+
+    TEST_F(RenderQueueTests, KeepsPushOrderOfEqualKeys)
+    {
+        std::mt19937_64 random(9);
+
+        // few distinct keys spread over all bytes, so every item has many equal neighbours
+        std::vector<uint64_t> distinct(16);
+        for(auto & key : distinct)key = random();
+
+        std::vector<uint64_t> keys(20'000);
+        std::uniform_int_distribution<std::size_t> pick(0, distinct.size() - 1);
+        for(auto & key : keys)key = distinct[pick(random)];
+
+        RenderQueue queue;
+        pushAll(queue, keys);
+        expectStableSorted(queue, keys);
+    }
+
+    TEST_F(RenderQueueTests, SortsKeysOfDrawState)
+    {
+        std::mt19937 random(13);
+        std::uniform_int_distribution<std::size_t> resource(0, 40);
+        std::uniform_real_distribution<float> distance(0.1f, 100.0f);
+
+        std::vector<uint64_t> keys(4'000);
+        for(auto & key : keys)
+        {
+            const RenderPass pass = resource(random) % 2 ? RenderPass::Opaque : RenderPass::Transparent;
+            key = RenderSortKey::make((uint32_t)(resource(random) % 3), pass, resource(random), resource(random), resource(random),
+                RenderSortKey::quantizeDepth(distance(random), 0.1f, 100.0f, pass));
+        }
+
+        RenderQueue queue;
+        pushAll(queue, keys);
+        expectStableSorted(queue, keys);
+    }
+
+    TEST_F(RenderQueueTests, SortedQueueKeepsPushOrder)
+    {
+        const std::vector<uint64_t> keys = {1, 1, 2, 5, 5, 5, 9, 100};
+
+        RenderQueue queue;
+        pushAll(queue, keys);
+        queue.sort();
+
+        for(std::size_t i = 0; i < keys.size(); ++i)
+        {
+            EXPECT_EQ(queue[i].vertex_buffer, i);
+            EXPECT_EQ(queue.getPushIndex(i), i);
+        }
+    }
+
+    TEST_F(RenderQueueTests, ReusesQueueBetweenFrames)
+    {
+        std::mt19937_64 random(17);
+        RenderQueue queue;
+        queue.reserve(2'000);
+
+        for(const std::size_t count : {2'000, 500, 3'000})
+        {
+            std::vector<uint64_t> keys(count);
+            for(auto & key : keys)key = random() >> (count % 7);
+
+            queue.clear();
+            EXPECT_TRUE(queue.empty());
+
+            pushAll(queue, keys);
+            expectStableSorted(queue, keys);
+
+            // second sort of the same frame is no-op
+            expectStableSorted(queue, keys);
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#include "unit_tests.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#include "software_rasterizer.hpp"
+#include "software_texture.hpp"
+
+namespace velora::tests
+{
+    class SoftwareRasterizerTests : public UnitTest
+    {
+        protected:
+            constexpr static const std::size_t SIZE = 8;
+            constexpr static const float CLEAR_DEPTH = 1.0f;
+
+            SoftwareRasterizerTests()
+            :   _color(Resolution{SIZE, SIZE}, TextureFormat::RGBA_32F),
+                _depth(Resolution{SIZE, SIZE}, TextureFormat::Depth_32F)
+            {
+                _color.clear(glm::vec4(0.0f));
+                _depth.clear(glm::vec4(CLEAR_DEPTH));
+            }
+
+            software::SoftwareRenderTarget target()
+            {
+                software::SoftwareRenderTarget render_target{.width = SIZE, .height = SIZE, .depth = &_depth};
+                render_target.colors[0] = &_color;
+                render_target.colors_count = 1;
+                return render_target;
+            }
+
+            // vertex at window coordinates of target, z in NDC
+            static Vertex pixel(float x, float y, float z = 0.0f)
+            {
+                return Vertex{.position = {x / (float)SIZE * 2.0f - 1.0f, y / (float)SIZE * 2.0f - 1.0f, z}};
+            }
+
+            static Mesh triangle(Vertex v0, Vertex v1, Vertex v2)
+            {
+                return Mesh{.indices = {0, 1, 2}, .vertices = {v0, v1, v2}};
+            }
+
+            // positions are already in clip space, every fragment gets the same color
+            static software::SoftwareProgram solidColor(glm::vec4 color)
+            {
+                return software::SoftwareProgram{
+                    .vertex = [](const Vertex & vertex, software::SoftwareVaryings &)
+                    {
+                        return glm::vec4(vertex.position, 1.0f);
+                    },
+                    .fragment = [color](const software::SoftwareVaryings &, software::SoftwareFragmentOutput & output)
+                    {
+                        output[0] = color;
+                        return true;
+                    }};
+            }
+
+            software::SoftwareTexture _color;
+            software::SoftwareTexture _depth;
+    };
+
+    TEST_F(SoftwareRasterizerTests, CoversPixelsWithCentersInsideTriangle)
+    {
+        software::SoftwareRasterizer rasterizer(2);
+
+        // right triangle over lower left half, depth grows from 0 at left edge to 1 at right edge
+        const Mesh mesh = triangle(pixel(0.0f, 0.0f, -1.0f), pixel(8.0f, 0.0f, 1.0f), pixel(0.0f, 8.0f, -1.0f));
+        const glm::vec4 red(1.0f, 0.0f, 0.0f, 1.0f);
+
+        const software::SoftwareRasterStats stats = rasterizer.draw(target(), mesh, solidColor(red), RenderOptions{});
+
+        EXPECT_EQ(stats.triangles_submitted, 1);
+        EXPECT_EQ(stats.triangles_rasterized, 1);
+        // centers on hypotenuse x + y = 7 lie on its edge, which is not top left edge
+        EXPECT_EQ(stats.fragments_shaded, 7 + 6 + 5 + 4 + 3 + 2 + 1);
+
+        for(std::size_t y = 0; y < SIZE; ++y)
+        {
+            for(std::size_t x = 0; x < SIZE; ++x)
+            {
+                const bool covered = x + y < 7;
+                const glm::vec4 color = _color.read(x, y);
+                const float depth = _depth.readDepth(x, y);
+
+                EXPECT_EQ(color.r, covered ? 1.0f : 0.0f) << x << "," << y;
+                EXPECT_EQ(color.a, covered ? 1.0f : 0.0f) << x << "," << y;
+                if(covered)
+                {
+                    EXPECT_NEAR(depth, ((float)x + 0.5f) / (float)SIZE, 1e-6f) << x << "," << y;
+                }
+                else
+                {
+                    EXPECT_EQ(depth, CLEAR_DEPTH) << x << "," << y;
+                }
+            }
+        }
+    }
+
+    TEST_F(SoftwareRasterizerTests, SharedEdgeIsRasterizedOnce)
+    {
+        software::SoftwareRasterizer rasterizer(2);
+        const glm::vec4 red(1.0f, 0.0f, 0.0f, 1.0f);
+        const glm::vec4 green(0.0f, 1.0f, 0.0f, 1.0f);
+
+        // two triangles of full screen quad split along diagonal x + y = 8
+        const Mesh lower = triangle(pixel(0.0f, 0.0f), pixel(8.0f, 0.0f), pixel(0.0f, 8.0f));
+        const Mesh upper = triangle(pixel(8.0f, 0.0f), pixel(8.0f, 8.0f), pixel(0.0f, 8.0f));
+
+        const uint64_t lower_fragments = rasterizer.draw(target(), lower, solidColor(red), RenderOptions{}).fragments_shaded;
+        // equal depth fails GL_LESS test, so overlap would keep color of lower triangle
+        const uint64_t upper_fragments = rasterizer.draw(target(), upper, solidColor(green), RenderOptions{}).fragments_shaded;
+
+        EXPECT_EQ(lower_fragments + upper_fragments, SIZE * SIZE);
+
+        for(std::size_t y = 0; y < SIZE; ++y)
+        {
+            for(std::size_t x = 0; x < SIZE; ++x)
+            {
+                const glm::vec4 expected = x + y < 7 ? red : green;
+                EXPECT_EQ(_color.read(x, y), expected) << x << "," << y;
+                EXPECT_EQ(_depth.readDepth(x, y), 0.5f) << x << "," << y;
+            }
+        }
+    }
+
+    TEST_F(SoftwareRasterizerTests, DepthTestRejectsFartherTriangle)
+    {
+        software::SoftwareRasterizer rasterizer(1);
+        const glm::vec4 red(1.0f, 0.0f, 0.0f, 1.0f);
+        const glm::vec4 blue(0.0f, 0.0f, 1.0f, 1.0f);
+
+        const Mesh closer = triangle(pixel(0.0f, 0.0f, 0.0f), pixel(8.0f, 0.0f, 0.0f), pixel(0.0f, 8.0f, 0.0f));
+        const Mesh farther = triangle(pixel(0.0f, 0.0f, 0.5f), pixel(8.0f, 0.0f, 0.5f), pixel(0.0f, 8.0f, 0.5f));
+
+        EXPECT_EQ(rasterizer.draw(target(), closer, solidColor(red), RenderOptions{}).fragments_shaded, 28);
+        EXPECT_EQ(rasterizer.draw(target(), farther, solidColor(blue), RenderOptions{}).fragments_shaded, 0);
+
+        EXPECT_EQ(_color.read(0, 0), red);
+        EXPECT_EQ(_depth.readDepth(0, 0), 0.5f);
+    }
+
+    TEST_F(SoftwareRasterizerTests, CullsClockwiseTriangle)
+    {
+        software::SoftwareRasterizer rasterizer(1);
+
+        const Mesh mesh = triangle(pixel(0.0f, 0.0f), pixel(0.0f, 8.0f), pixel(8.0f, 0.0f));
+        const software::SoftwareRasterStats stats = rasterizer.draw(target(), mesh, solidColor(glm::vec4(1.0f)), RenderOptions{});
+
+        EXPECT_EQ(stats.triangles_submitted, 1);
+        EXPECT_EQ(stats.triangles_rasterized, 0);
+        EXPECT_EQ(stats.fragments_shaded, 0);
+        EXPECT_EQ(_color.read(0, 0), glm::vec4(0.0f));
+        EXPECT_EQ(_depth.readDepth(0, 0), CLEAR_DEPTH);
+    }
+}